@@ -0,0 +1,61 @@
+#ifndef LLAISYS_GGUF_H
+#define LLAISYS_GGUF_H
+
+#include "models/qwen2.h"
+#include "tensor.h"
+
+// GGUF 模型文件（llama.cpp 格式）：映射文件，张量名映射为 HuggingFace 命名，
+// 量化张量按需反量化，或（Q4_0）直接拆成 llaisysLinearInt4 的布局
+__C {
+    typedef struct LlaisysGGUF *llaisysGGUF_t;
+
+    // 映射一个 .gguf 文件并解析头部，失败（包括不支持的版本）时返回 NULL
+    __export llaisysGGUF_t ggufOpen(
+        const char *path);
+
+    // 关闭句柄；已取出的零拷贝张量仍持有映射
+    __export void ggufClose(
+        llaisysGGUF_t gguf);
+
+    __export size_t ggufNumTensors(
+        llaisysGGUF_t gguf);
+
+    // 第 index 个张量的 HuggingFace 命名（无对应时为 GGUF 原名），指针在句柄关闭前有效
+    __export const char *ggufTensorName(
+        llaisysGGUF_t gguf,
+        size_t index);
+
+    // 张量的 ggml 类型名（如 "Q4_K"、"BF16"），按 HuggingFace 命名或 GGUF 原名查找，不存在时返回 NULL
+    __export const char *ggufTensorType(
+        llaisysGGUF_t gguf,
+        const char *name);
+
+    // 非量化张量在 dtype 为 LLAISYS_DTYPE_INVALID 或与存储类型相同时零拷贝，浮点之间按需转换；
+    // 量化张量反量化为 dtype（F32/F16/BF16，INVALID 时为 F32）。不存在时返回 NULL
+    __export llaisysTensor_t ggufGetTensor(
+        llaisysGGUF_t gguf,
+        const char *name,
+        llaisysDataType_t dtype);
+
+    // Q4_0 权重直接拆成 llaisysLinearInt4 的 weight/scales/zeros（组大小 32），返回 1；
+    // 其余类型或不存在时返回 0，不写输出
+    __export int ggufGetTensorInt4(
+        llaisysGGUF_t gguf,
+        const char *name,
+        llaisysTensor_t *q,
+        llaisysTensor_t *scales,
+        llaisysTensor_t *zeros);
+
+    // 标量元数据的字符串形式，数组元数据只提供 "<key>.length"；不存在时返回 NULL
+    __export const char *ggufGetMeta(
+        llaisysGGUF_t gguf,
+        const char *key);
+
+    // 由元数据填写模型配置，dtype 为 LLAISYS_DTYPE_INVALID 时取词嵌入的浮点类型（被量化时为 BF16）
+    __export void ggufQwen2Meta(
+        llaisysGGUF_t gguf,
+        llaisysDataType_t dtype,
+        struct LlaisysQwen2Meta *meta);
+}
+
+#endif // LLAISYS_GGUF_H
@@ -3,16 +3,57 @@
 
 #include "tensor.h"
 
+// 可单独设置精度策略的算子
+typedef enum {
+    LLAISYS_OP_LINEAR = 0,
+    LLAISYS_OP_RMS_NORM = 1,
+    LLAISYS_OP_SELF_ATTENTION = 2,
+    LLAISYS_OP_SWIGLU = 3,
+    LLAISYS_OP_TYPE_COUNT
+} llaisysOpType_t;
+
+// 外部 4 bit 分组量化权重的存储格式（llaisysRepackInt4 的输入）
+typedef enum {
+    // GPTQ（AutoGPTQ）：qweight [in / 8, out] I32，沿输入维每 8 个 4 bit 打包，低位在前；
+    // qzeros [n_groups, out / 8] I32 沿输出维打包，存储值为 zero - 1；scales [n_groups, out] F16
+    LLAISYS_INT4_GPTQ = 0,
+    // AWQ（GEMM 版本）：qweight [in, out / 8] I32、qzeros [n_groups, out / 8] I32，沿输出维打包，
+    // 每个 int32 内 8 列的次序为 0, 2, 4, 6, 1, 3, 5, 7；scales [n_groups, out] F16
+    LLAISYS_INT4_AWQ = 1,
+} llaisysInt4Format_t;
+
 __C {
     __export void llaisysAdd(llaisysTensor_t c, llaisysTensor_t a, llaisysTensor_t b);
     __export void llaisysArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t vals);
+    __export void llaisysCast(llaisysTensor_t out, llaisysTensor_t in);
     __export void llaisysEmbedding(llaisysTensor_t out, llaisysTensor_t index, llaisysTensor_t weight);
     __export void llaisysLinear(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias);
+    // weight 为 I8，weight_scale 为 [out_features] 的 F32 逐通道缩放，bias 可为 NULL
+    __export void llaisysLinearInt8(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t weight_scale, llaisysTensor_t bias);
+    __export void llaisysQuantizeInt8(llaisysTensor_t q, llaisysTensor_t scale, llaisysTensor_t weight);
+    // 4 bit 分组量化：weight [out, in / 2] U8，scales [out, n_groups] F32，zeros [out, n_groups] U8，
+    // 布局见 src/ops/linear/op.hpp；bias 可为 NULL
+    __export void llaisysLinearInt4(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t scales, llaisysTensor_t zeros, llaisysTensor_t bias);
+    __export void llaisysQuantizeInt4(llaisysTensor_t q, llaisysTensor_t scales, llaisysTensor_t zeros, llaisysTensor_t weight);
+    // 把 GPTQ/AWQ 的 qweight/qzeros/scales 重排为 llaisysLinearInt4 的布局，组大小由 scales 推出
+    __export void llaisysRepackInt4(llaisysTensor_t q, llaisysTensor_t scales, llaisysTensor_t zeros, llaisysTensor_t src_qweight, llaisysTensor_t src_qzeros, llaisysTensor_t src_scales, llaisysInt4Format_t format);
     __export void llaisysRearrange(llaisysTensor_t out, llaisysTensor_t in);
     __export void llaisysRmsNorm(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, float eps);
     __export void llaisysROPE(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t pos_ids, float theta);
     __export void llaisysSelfAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, float scale);
+    // 量化 KV cache：k、v 为 I8 或 F8（E4M3），k_scale、v_scale 为 [kvlen, nkvh] 的 F32 逐 token、逐 head 缩放
+    __export void llaisysSelfAttentionQuantKV(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, llaisysTensor_t k_scale, llaisysTensor_t v_scale, float scale);
+    // 把 src [seq, nkvh, hd] 量化写入 I8/F8 的 cache 视图，scales 为 [seq, nkvh] F32
+    __export void llaisysQuantizeKV(llaisysTensor_t cache, llaisysTensor_t scales, llaisysTensor_t src);
     __export void llaisysSwiGLU(llaisysTensor_t out, llaisysTensor_t gate, llaisysTensor_t up);
+
+    // 精度策略：存储类型由张量决定；compute 为逐元素中间结果的类型，accumulate 为归约的累加类型。
+    // 默认 compute = F32、accumulate = F32，走 SIMD 快路径；compute 取 BF16/F16 时每一步中间结果
+    // 都舍入到该类型（与 PyTorch 逐算子执行对齐），accumulate 取 F64 时用双精度累加。
+    // LINEAR 的 compute 可取 I8（W8A8）：int8 权重的 linear 把激活逐 token 动态量化为 int8，
+    // 做 int8×int8 点积、int32 累加，缩放在最后一步完成；此时 accumulate 须为 F32
+    __export void llaisysSetPrecision(llaisysOpType_t op, llaisysDataType_t compute, llaisysDataType_t accumulate);
+    __export void llaisysGetPrecision(llaisysOpType_t op, llaisysDataType_t *compute, llaisysDataType_t *accumulate);
 }
 
 #endif
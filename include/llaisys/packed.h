@@ -0,0 +1,108 @@
+#ifndef LLAISYS_PACKED_H
+#define LLAISYS_PACKED_H
+
+#include "tensor.h"
+
+// 预打包模型文件（.llaisys）：权重已是内核使用的布局与类型，按页对齐，加载时直接映射
+__C {
+    typedef struct LlaisysPackWriter *llaisysPackWriter_t;
+    typedef struct LlaisysPacked *llaisysPacked_t;
+    typedef struct LlaisysLayerStream *llaisysLayerStream_t;
+
+    // 逐层驻留的统计，hits / acquires 为预取命中率
+    typedef struct LlaisysLayerStreamStats {
+        size_t acquires;
+        size_t hits;
+        double wait_ms;
+        size_t nbytes_prefetched;
+        size_t nbytes_loaded;
+        size_t nbytes_released;
+    } LlaisysLayerStreamStats;
+
+    // 创建 .llaisys 文件，失败时返回 NULL
+    __export llaisysPackWriter_t packWriterCreate(
+        const char *path);
+
+    __export void packWriterSetMeta(
+        llaisysPackWriter_t writer,
+        const char *key,
+        const char *value);
+
+    // 把 nparts 个 CPU 张量沿第 0 维拼接后写为一个张量（nparts 为 1 时即原样写出），
+    // dtype 不为 LLAISYS_DTYPE_INVALID 时把浮点数据转换为 dtype
+    __export void packWriterAddTensor(
+        llaisysPackWriter_t writer,
+        const char *name,
+        llaisysTensor_t *parts,
+        size_t nparts,
+        llaisysDataType_t dtype);
+
+    // 与已写出的张量内容相同时不再写数据，两个名字指向同一份数据（见 packWriterAddAlias）
+
+    // name 与已写出的 target 共用同一份数据，如 tie_word_embeddings 时的 lm_head.weight
+    __export void packWriterAddAlias(
+        llaisysPackWriter_t writer,
+        const char *name,
+        const char *target);
+
+    // 因共用数据（别名与内容去重）而未写出的字节数
+    __export size_t packWriterSharedBytes(
+        llaisysPackWriter_t writer);
+
+    // 写出张量表并关闭文件，释放 writer；未调用 finish 就销毁时删除不完整的文件
+    __export void packWriterFinish(
+        llaisysPackWriter_t writer);
+
+    __export void packWriterDestroy(
+        llaisysPackWriter_t writer);
+
+    // 映射 .llaisys 文件，失败（包括版本不匹配）时返回 NULL
+    __export llaisysPacked_t packedOpen(
+        const char *path);
+
+    __export void packedClose(
+        llaisysPacked_t packed);
+
+    __export size_t packedNumTensors(
+        llaisysPacked_t packed);
+
+    __export const char *packedTensorName(
+        llaisysPacked_t packed,
+        size_t index);
+
+    // 返回直接指向映射内存的 CPU 张量，不存在时返回 NULL
+    __export llaisysTensor_t packedGetTensor(
+        llaisysPacked_t packed,
+        const char *name);
+
+    // 不存在时返回 NULL
+    __export const char *packedGetMeta(
+        llaisysPacked_t packed,
+        const char *key);
+
+    // 权重大于内存时逐层驻留 model.layers.N.* 的权重：layerStreamAcquire 阻塞直到该层读入，
+    // 同时由后台线程预取后续 depth 层；layerStreamRelease 把算完的层标记为内存紧张时优先回收
+    __export llaisysLayerStream_t packedStreamLayers(
+        llaisysPacked_t packed,
+        size_t depth);
+
+    __export void layerStreamDestroy(
+        llaisysLayerStream_t stream);
+
+    __export size_t layerStreamNumLayers(
+        llaisysLayerStream_t stream);
+
+    __export void layerStreamAcquire(
+        llaisysLayerStream_t stream,
+        size_t layer);
+
+    __export void layerStreamRelease(
+        llaisysLayerStream_t stream,
+        size_t layer);
+
+    __export void layerStreamGetStats(
+        llaisysLayerStream_t stream,
+        LlaisysLayerStreamStats *stats);
+}
+
+#endif // LLAISYS_PACKED_H
@@ -21,6 +21,21 @@ __C {
     // Memory copy
     typedef void (*memcpy_sync_api)(void *, const void *, size_t, llaisysMemcpyKind_t);
     typedef void (*memcpy_async_api)(void *, const void *, size_t, llaisysMemcpyKind_t, llaisysStream_t);
+    typedef void (*memcpy2d_sync_api)(void *, size_t, const void *, size_t, size_t, size_t, llaisysMemcpyKind_t);
+    typedef void (*memcpy2d_async_api)(void *, size_t, const void *, size_t, size_t, size_t, llaisysMemcpyKind_t,
+                                       llaisysStream_t);
+    typedef void (*memset_sync_api)(void *, int, size_t);
+    // Event
+    typedef llaisysEvent_t (*create_event_api)();
+    typedef void (*destroy_event_api)(llaisysEvent_t);
+    typedef void (*event_record_api)(llaisysEvent_t, llaisysStream_t);
+    typedef void (*stream_wait_event_api)(llaisysStream_t, llaisysEvent_t);
+    typedef int (*event_query_api)(llaisysEvent_t);
+    typedef void (*event_synchronize_api)(llaisysEvent_t);
+    typedef float (*event_elapsed_time_api)(llaisysEvent_t, llaisysEvent_t);
+    // Host function
+    typedef void (*host_func_t)(void *);
+    typedef void (*launch_host_func_api)(llaisysStream_t, host_func_t, void *);
 
     struct LlaisysRuntimeAPI {
         get_device_count_api get_device_count;
@@ -35,13 +50,168 @@ __C {
         free_host_api free_host;
         memcpy_sync_api memcpy_sync;
         memcpy_async_api memcpy_async;
+        // 流上的操作按提交顺序执行；空流（0）上的操作在调用返回前完成
+        create_event_api create_event;
+        destroy_event_api destroy_event;
+        // 在流上记录事件：流执行到此处时事件完成
+        event_record_api event_record;
+        // 之后提交到流上的操作等待事件（最近一次记录）完成后才执行，调用本身不阻塞
+        stream_wait_event_api stream_wait_event;
+        // 事件已完成（或从未记录）时返回非 0
+        event_query_api event_query;
+        event_synchronize_api event_synchronize;
+        // 两个已完成事件之间的毫秒数
+        event_elapsed_time_api event_elapsed_time;
+        // 在流上调用 fn(user_data)，用于把核函数等主机上的工作提交到流上
+        launch_host_func_api launch_host_func;
+        // memcpy2d(dst, dpitch, src, spitch, width, height, kind)：拷贝 height 行、每行 width 字节，
+        // 第 i 行从 src + i * spitch 拷到 dst + i * dpitch
+        memcpy2d_sync_api memcpy2d_sync;
+        memcpy2d_async_api memcpy2d_async;
+        // memset_sync(ptr, value, size)：设备内存的 size 个字节置为 value
+        memset_sync_api memset_sync;
     };
 
+    // 设备内存分配器
+    typedef enum {
+        LLAISYS_ALLOCATOR_NAIVE = 0,   // 每次直接 malloc_device/free_device
+        LLAISYS_ALLOCATOR_CACHING = 1, // 按大小分级缓存释放的块（默认）
+    } llaisysAllocatorType_t;
+
+    // 分配器统计，字节数按分配器实际占用的块大小计
+    typedef struct LlaisysAllocatorStats {
+        size_t allocated_bytes;
+        size_t reserved_bytes;
+        size_t peak_allocated_bytes;
+        size_t peak_reserved_bytes;
+        size_t num_allocs;
+        size_t num_frees;
+        size_t num_device_allocs;
+        size_t num_device_frees;
+    } LlaisysAllocatorStats;
+
+    // 内存用途，Runtime 上的每次分配都记在当前类别下
+    typedef enum {
+        LLAISYS_MEMORY_OTHER = 0,      // 未指明用途（默认）
+        LLAISYS_MEMORY_WEIGHTS = 1,    // 模型权重，含加载器映射的文件
+        LLAISYS_MEMORY_KV_CACHE = 2,   // KV cache
+        LLAISYS_MEMORY_ACTIVATION = 3, // 激活，arena 的 slab 总记在此类
+        LLAISYS_MEMORY_SCRATCH = 4,    // 核函数 scratch，workspace 总记在此类
+        LLAISYS_MEMORY_CATEGORY_COUNT = 5,
+    } llaisysMemoryCategory_t;
+
+    // 一个类别的用量，字节数按请求的大小计
+    typedef struct LlaisysMemoryCategoryStats {
+        size_t in_use_bytes;          // 当前仍在使用的字节
+        size_t peak_bytes;            // in_use_bytes 的峰值
+        size_t total_allocated_bytes; // 累计分配的字节
+        size_t num_allocs;
+        size_t num_frees;
+    } LlaisysMemoryCategoryStats;
+
+    typedef struct LlaisysMemoryStats {
+        LlaisysMemoryCategoryStats categories[LLAISYS_MEMORY_CATEGORY_COUNT];
+        size_t in_use_bytes;   // 所有类别之和
+        size_t peak_bytes;     // 所有类别之和的峰值
+        size_t reserved_bytes; // 设备分配器已向设备申请的字节（含缓存）
+        size_t peak_reserved_bytes;
+        size_t cached_bytes; // 设备分配器缓存中空闲、可复用的字节
+    } LlaisysMemoryStats;
+
+    // 在第 first 到第 last 步（含两端）之间使用的 size 字节缓冲
+    typedef struct LlaisysBufferLifetime {
+        size_t size;
+        size_t first;
+        size_t last;
+    } LlaisysBufferLifetime;
+
+    // CPU 主机内存的大页模式
+    typedef enum {
+        LLAISYS_HUGE_PAGES_NONE = 0,
+        LLAISYS_HUGE_PAGES_TRANSPARENT = 1, // 区域按 2 MiB 对齐并 madvise(MADV_HUGEPAGE)（默认）
+        LLAISYS_HUGE_PAGES_EXPLICIT = 2,    // hugetlbfs 预留的大页，预留不足时退回透明大页
+    } llaisysHugePages_t;
+
+    // CPU 主机内存在 NUMA 节点间的放置
+    typedef enum {
+        LLAISYS_NUMA_DEFAULT = 0,    // 由首次写入的线程所在节点决定（默认）
+        LLAISYS_NUMA_INTERLEAVE = 1, // 按页轮流放在所有节点
+        LLAISYS_NUMA_BLOCKED = 2,    // 均分为节点数个连续块，第 k 块优先放在第 k 个节点，配合 llaisysCpuBindThreads
+        LLAISYS_NUMA_NODE = 3,       // 优先放在 numa_node
+    } llaisysNumaPolicy_t;
+
+    typedef struct LlaisysHostMemoryOptions {
+        llaisysHugePages_t huge_pages;
+        llaisysNumaPolicy_t numa_policy;
+        int numa_node;
+        size_t min_size;  // 小于此大小的分配不使用大页与 NUMA 放置，默认 2 MiB
+        size_t alignment; // 所有分配起始地址的对齐字节数（2 的幂，不超过 2 MiB），默认 64
+    } LlaisysHostMemoryOptions;
+
     // Llaisys API for getting the runtime APIs
     __export const LlaisysRuntimeAPI *llaisysGetRuntimeAPI(llaisysDeviceType_t);
 
     // Llaisys API for switching device context
     __export void llaisysSetContextRuntime(llaisysDeviceType_t, int);
+
+    // 非 0 时各线程共用进程内每个设备的同一个 Runtime（分配器缓存与内存统计），流、arena、
+    // 核函数 scratch 和内存类别仍按线程分开，用于多线程服务共享一个内存池。只影响之后才取用
+    // Runtime 的线程，应在任何线程创建张量之前调用
+    __export void llaisysSetRuntimeSharing(int enable);
+
+    __export int llaisysGetRuntimeSharing();
+
+    // 以下作用于当前上下文的 Runtime（见 llaisysSetContextRuntime）
+    __export void llaisysRuntimeSetAllocator(llaisysAllocatorType_t type);
+
+    __export llaisysAllocatorType_t llaisysRuntimeGetAllocator();
+
+    // 把分配器缓存中未使用的内存归还设备
+    __export void llaisysRuntimeTrim();
+
+    __export void llaisysRuntimeGetAllocatorStats(LlaisysAllocatorStats *stats);
+
+    // 设置之后分配记入的内存类别，返回原来的类别
+    __export llaisysMemoryCategory_t llaisysRuntimeSetMemoryCategory(llaisysMemoryCategory_t category);
+
+    __export llaisysMemoryCategory_t llaisysRuntimeGetMemoryCategory();
+
+    __export void llaisysRuntimeMemoryStats(LlaisysMemoryStats *stats);
+
+    // 把各类别以及分配器的峰值重置为当前值，用于分段测量
+    __export void llaisysRuntimeResetPeakMemoryStats();
+
+    // Runtime 上每步复用的 arena：每步开始 reset，之后用 tensorCreateInArena 取张量
+    __export void llaisysRuntimeArenaReserve(size_t size);
+
+    __export void llaisysRuntimeArenaReset();
+
+    // capacity 为 slab 大小，used 为本步已用字节，peak 为各步用量的最大值
+    __export void llaisysRuntimeArenaGetStats(size_t *capacity, size_t *used, size_t *peak);
+
+    // CPU 主机内存选项，对进程内所有 CPU Runtime 生效，只影响之后的分配；Linux 以外的平台忽略
+    __export void llaisysCpuSetMemoryOptions(const LlaisysHostMemoryOptions *options);
+
+    __export void llaisysCpuGetMemoryOptions(LlaisysHostMemoryOptions *options);
+
+    __export int llaisysCpuNumaNodeCount();
+
+    // 把 OpenMP 线程按编号均分绑定到各 NUMA 节点的 CPU 上（调用线程即 0 号线程）
+    __export void llaisysCpuBindThreads();
+
+    // CPU 核函数 scratch（本线程上下文中 CPU Runtime 的 workspace）的总字节数
+    __export size_t llaisysCpuWorkspaceSize();
+
+    // 归还 CPU 核函数的 scratch，之后的调用按需重新分配
+    __export void llaisysCpuWorkspaceRelease();
+
+    // 为 n 个缓冲规划 arena 内的偏移，生命周期不重叠的缓冲共用地址；offsets 长度为 n，
+    // 返回所需的总字节数（作为 llaisysRuntimeArenaReserve 的参数）
+    __export size_t llaisysPlanArena(
+        const LlaisysBufferLifetime *buffers,
+        size_t n,
+        size_t alignment,
+        size_t *offsets);
 }
 
 #endif // LLAISYS_RUNTIME_H
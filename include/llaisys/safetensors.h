@@ -0,0 +1,62 @@
+#ifndef LLAISYS_SAFETENSORS_H
+#define LLAISYS_SAFETENSORS_H
+
+#include "tensor.h"
+
+__C {
+    typedef struct LlaisysSafetensors *llaisysSafetensors_t;
+
+    // 加载各阶段耗时（毫秒）与数据量
+    typedef struct LlaisysLoadStats {
+        double open_ms;
+        double convert_ms;
+        double copy_ms;
+        double total_ms;
+        size_t ntensors;
+        size_t nbytes_read;
+        size_t nbytes_converted;
+        size_t nbytes_shared;
+    } LlaisysLoadStats;
+
+    // 映射一个 .safetensors 文件并解析头部，失败时返回 NULL
+    __export llaisysSafetensors_t safetensorsOpen(
+        const char *path);
+
+    // 关闭句柄；已取出的张量仍持有映射，在其销毁后才解除映射
+    __export void safetensorsClose(
+        llaisysSafetensors_t st);
+
+    __export size_t safetensorsNumTensors(
+        llaisysSafetensors_t st);
+
+    // 按文件头中的顺序返回第 index 个张量的名字，指针在句柄关闭前有效
+    __export const char *safetensorsTensorName(
+        llaisysSafetensors_t st,
+        size_t index);
+
+    // 返回直接指向映射内存的 CPU 张量（零拷贝），不存在时返回 NULL
+    __export llaisysTensor_t safetensorsGetTensor(
+        llaisysSafetensors_t st,
+        const char *name);
+
+    // 以 dtype 放到指定设备上：类型相同且在 CPU 上时零拷贝，否则转换/拷贝；
+    // 只转换浮点张量，dtype 为 LLAISYS_DTYPE_INVALID 时保持原类型。不存在时返回 NULL
+    __export llaisysTensor_t safetensorsGetTensorAs(
+        llaisysSafetensors_t st,
+        const char *name,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id);
+
+    // 并行取出全部张量，tensors 按 safetensorsTensorName 的顺序填充（长度为 safetensorsNumTensors），
+    // stats 可为 NULL。内容相同的张量共用同一份存储
+    __export void safetensorsLoadAll(
+        llaisysSafetensors_t st,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        llaisysTensor_t *tensors,
+        LlaisysLoadStats *stats);
+}
+
+#endif // LLAISYS_SAFETENSORS_H
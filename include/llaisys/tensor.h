@@ -13,6 +13,24 @@ __C {
         llaisysDeviceType_t device_type,
         int device_id);
 
+    // 每行（最后一维）的起始地址按 row_alignment 字节对齐，行尾填充；row_alignment 为 0 时同 tensorCreate
+    __export llaisysTensor_t tensorCreatePadded(
+        size_t * shape,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        size_t row_alignment);
+
+    // 在当前 Runtime 的 arena 中创建连续张量，不经过分配器：offset 为 SIZE_MAX 时在 arena 中
+    // 顺序分配，否则取 slab 中该偏移处（通常来自 llaisysPlanArena，需先 reserve 足够容量）。
+    // 张量持有当时的 slab，arena reset 后其内存可能被后续张量复用
+    __export llaisysTensor_t tensorCreateInArena(
+        size_t * shape,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        size_t offset);
+
     __export void tensorDestroy(
         llaisysTensor_t tensor);
 
@@ -45,6 +63,11 @@ __C {
     __export uint8_t tensorIsContiguous(
         llaisysTensor_t tensor);
 
+    // 起始地址与每一行的起始地址都按 alignment 字节对齐
+    __export uint8_t tensorIsAligned(
+        llaisysTensor_t tensor,
+        size_t alignment);
+
     __export void tensorLoad(
         llaisysTensor_t tensor,
         const void *data);
@@ -63,6 +86,19 @@ __C {
         size_t dim,
         size_t start,
         size_t end);
+
+    __export llaisysTensor_t tensorReshape(
+        llaisysTensor_t tensor,
+        size_t * shape,
+        size_t ndim);
+
+    __export llaisysTensor_t tensorContiguous(
+        llaisysTensor_t tensor);
+
+    __export llaisysTensor_t tensorTo(
+        llaisysTensor_t tensor,
+        llaisysDeviceType_t device_type,
+        int device_id);
 }
 
 #endif // LLAISYS_TENSOR_H
@@ -1,20 +1,69 @@
 from .runtime import RuntimeAPI
+from .runtime import set_runtime_sharing, runtime_sharing
+from .runtime import set_allocator, get_allocator, trim_allocator, allocator_stats
+from .runtime import set_memory_category, get_memory_category, memory_category, memory_stats, reset_peak_memory_stats
+from .runtime import set_host_memory_options, host_memory_options, numa_node_count, bind_threads
+from .runtime import cpu_workspace_size, release_cpu_workspace
+from .runtime import plan_arena, arena_reserve, arena_reset, arena_tensor, arena_stats
 from .libllaisys import DeviceType
 from .libllaisys import DataType
 from .libllaisys import MemcpyKind
+from .libllaisys import OpType
+from .libllaisys import Int4Format
+from .libllaisys import AllocatorType
+from .libllaisys import HugePages
+from .libllaisys import NumaPolicy
+from .libllaisys import MemoryCategory
 from .libllaisys import llaisysStream_t as Stream
 from .tensor import Tensor
 from .ops import Ops
+from .safetensors import SafeTensors
+from .gguf import GGUFModel
+from .packed import LayerStream, PackedModel, PackWriter, pack
 from . import models
 from .models import *
 
 __all__ = [
     "RuntimeAPI",
+    "set_runtime_sharing",
+    "runtime_sharing",
+    "set_allocator",
+    "get_allocator",
+    "trim_allocator",
+    "allocator_stats",
+    "set_memory_category",
+    "get_memory_category",
+    "memory_category",
+    "memory_stats",
+    "reset_peak_memory_stats",
+    "set_host_memory_options",
+    "host_memory_options",
+    "numa_node_count",
+    "bind_threads",
+    "cpu_workspace_size",
+    "release_cpu_workspace",
+    "plan_arena",
+    "arena_reserve",
+    "arena_reset",
+    "arena_tensor",
+    "arena_stats",
     "DeviceType",
     "DataType",
     "MemcpyKind",
+    "OpType",
+    "Int4Format",
+    "AllocatorType",
+    "HugePages",
+    "NumaPolicy",
+    "MemoryCategory",
     "Stream",
     "Tensor",
     "Ops",
+    "SafeTensors",
+    "GGUFModel",
+    "PackedModel",
+    "LayerStream",
+    "PackWriter",
+    "pack",
     "models",
 ]
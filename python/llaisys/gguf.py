@@ -0,0 +1,80 @@
+from typing import Dict, List, Optional, Tuple
+
+from .libllaisys import (
+    LIB_LLAISYS,
+    llaisysGGUF_t,
+    llaisysTensor_t,
+    llaisysDataType_t,
+    LlaisysQwen2Meta,
+    DataType,
+)
+from .tensor import Tensor
+from ctypes import byref
+
+
+class GGUFModel:
+    """Memory-mapped .gguf (llama.cpp) file. Tensor names are mapped to the
+    HuggingFace names used by the safetensors and .llaisys loaders; the
+    original GGUF names are accepted as well."""
+
+    def __init__(self, path):
+        self._gguf: llaisysGGUF_t = LIB_LLAISYS.ggufOpen(str(path).encode())
+        if not self._gguf:
+            raise RuntimeError(f"Failed to open gguf file: {path}")
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        if getattr(self, "_gguf", None):
+            LIB_LLAISYS.ggufClose(self._gguf)
+            self._gguf = None
+
+    def keys(self) -> List[str]:
+        n = LIB_LLAISYS.ggufNumTensors(self._gguf)
+        return [LIB_LLAISYS.ggufTensorName(self._gguf, i).decode() for i in range(n)]
+
+    def tensor_type(self, name: str) -> str:
+        """The ggml type name of a tensor, e.g. "Q4_K" or "BF16"."""
+        t = LIB_LLAISYS.ggufTensorType(self._gguf, name.encode())
+        if t is None:
+            raise KeyError(name)
+        return t.decode()
+
+    def get_tensor(self, name: str, dtype: Optional[DataType] = None) -> Tensor:
+        """Zero-copy for unquantized tensors when dtype matches (or is None);
+        quantized tensors are dequantized to dtype (f32 when None)."""
+        tensor = LIB_LLAISYS.ggufGetTensor(
+            self._gguf, name.encode(), llaisysDataType_t(DataType.INVALID if dtype is None else dtype)
+        )
+        if not tensor:
+            raise KeyError(name)
+        return Tensor(tensor=tensor)
+
+    def get_int4(self, name: str) -> Optional[Tuple[Tensor, Tensor, Tensor]]:
+        """(q, scales, zeros) in the Ops.linear_int4 layout for tensors the
+        int4 kernel runs directly (Q4_0), None otherwise."""
+        q, scales, zeros = llaisysTensor_t(), llaisysTensor_t(), llaisysTensor_t()
+        if not LIB_LLAISYS.ggufGetTensorInt4(self._gguf, name.encode(), byref(q), byref(scales), byref(zeros)):
+            return None
+        return Tensor(tensor=q), Tensor(tensor=scales), Tensor(tensor=zeros)
+
+    def meta(self, key: str) -> Optional[str]:
+        value = LIB_LLAISYS.ggufGetMeta(self._gguf, key.encode())
+        return None if value is None else value.decode()
+
+    def qwen2_meta(self, dtype: Optional[DataType] = None) -> Dict[str, object]:
+        """Model configuration in LlaisysQwen2Meta field names."""
+        meta = LlaisysQwen2Meta()
+        LIB_LLAISYS.ggufQwen2Meta(
+            self._gguf, llaisysDataType_t(DataType.INVALID if dtype is None else dtype), byref(meta)
+        )
+        out = {name: getattr(meta, name) for name, _ in LlaisysQwen2Meta._fields_}
+        out["dtype"] = DataType(out["dtype"])
+        return out
@@ -4,14 +4,27 @@ import ctypes
 from pathlib import Path
 
 from .runtime import load_runtime
-from .runtime import LlaisysRuntimeAPI
+from .runtime import LlaisysRuntimeAPI, LlaisysAllocatorStats, LlaisysBufferLifetime, LlaisysHostMemoryOptions
+from .runtime import LlaisysMemoryCategoryStats, LlaisysMemoryStats, host_func_t
 from .llaisys_types import llaisysDeviceType_t, DeviceType
 from .llaisys_types import llaisysDataType_t, DataType
 from .llaisys_types import llaisysMemcpyKind_t, MemcpyKind
-from .llaisys_types import llaisysStream_t
+from .llaisys_types import llaisysOpType_t, OpType
+from .llaisys_types import llaisysInt4Format_t, Int4Format
+from .llaisys_types import llaisysAllocatorType_t, AllocatorType
+from .llaisys_types import llaisysHugePages_t, HugePages
+from .llaisys_types import llaisysNumaPolicy_t, NumaPolicy
+from .llaisys_types import llaisysMemoryCategory_t, MemoryCategory
+from .llaisys_types import llaisysStream_t, llaisysEvent_t
 from .tensor import llaisysTensor_t
 from .tensor import load_tensor
 from .ops import load_ops
+from .safetensors import llaisysSafetensors_t, LlaisysLoadStats
+from .safetensors import load_safetensors
+from .packed import llaisysPackWriter_t, llaisysPacked_t, llaisysLayerStream_t, LlaisysLayerStreamStats
+from .packed import load_packed
+from .gguf import llaisysGGUF_t, LlaisysQwen2Meta
+from .gguf import load_gguf
 
 
 def load_shared_library():
@@ -38,18 +51,48 @@ LIB_LLAISYS = load_shared_library()
 load_runtime(LIB_LLAISYS)
 load_tensor(LIB_LLAISYS)
 load_ops(LIB_LLAISYS)
+load_safetensors(LIB_LLAISYS)
+load_packed(LIB_LLAISYS)
+load_gguf(LIB_LLAISYS)
 
 
 __all__ = [
     "LIB_LLAISYS",
     "LlaisysRuntimeAPI",
+    "LlaisysAllocatorStats",
+    "LlaisysBufferLifetime",
+    "LlaisysHostMemoryOptions",
+    "LlaisysMemoryCategoryStats",
+    "LlaisysMemoryStats",
+    "host_func_t",
     "llaisysStream_t",
+    "llaisysEvent_t",
     "llaisysTensor_t",
+    "llaisysSafetensors_t",
+    "LlaisysLoadStats",
+    "llaisysPackWriter_t",
+    "llaisysPacked_t",
+    "llaisysLayerStream_t",
+    "LlaisysLayerStreamStats",
+    "llaisysGGUF_t",
+    "LlaisysQwen2Meta",
     "llaisysDataType_t",
     "DataType",
     "llaisysDeviceType_t",
     "DeviceType",
     "llaisysMemcpyKind_t",
     "MemcpyKind",
+    "llaisysOpType_t",
+    "OpType",
+    "llaisysInt4Format_t",
+    "Int4Format",
+    "llaisysAllocatorType_t",
+    "AllocatorType",
+    "llaisysHugePages_t",
+    "HugePages",
+    "llaisysNumaPolicy_t",
+    "NumaPolicy",
+    "llaisysMemoryCategory_t",
+    "MemoryCategory",
     "llaisysStream_t",
 ]
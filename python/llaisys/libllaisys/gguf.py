@@ -0,0 +1,59 @@
+from ctypes import POINTER, Structure, c_char_p, c_float, c_int, c_int64, c_size_t, c_void_p
+from .llaisys_types import llaisysDataType_t
+from .tensor import llaisysTensor_t
+
+# Handle type
+llaisysGGUF_t = c_void_p
+
+
+# Mirrors struct LlaisysQwen2Meta in include/llaisys/models/qwen2.h
+class LlaisysQwen2Meta(Structure):
+    _fields_ = [
+        ("dtype", llaisysDataType_t),
+        ("nlayer", c_size_t),
+        ("hs", c_size_t),
+        ("nh", c_size_t),
+        ("nkvh", c_size_t),
+        ("dh", c_size_t),
+        ("di", c_size_t),
+        ("maxseq", c_size_t),
+        ("voc", c_size_t),
+        ("epsilon", c_float),
+        ("theta", c_float),
+        ("end_token", c_int64),
+    ]
+
+
+def load_gguf(lib):
+    lib.ggufOpen.argtypes = [c_char_p]
+    lib.ggufOpen.restype = llaisysGGUF_t
+
+    lib.ggufClose.argtypes = [llaisysGGUF_t]
+    lib.ggufClose.restype = None
+
+    lib.ggufNumTensors.argtypes = [llaisysGGUF_t]
+    lib.ggufNumTensors.restype = c_size_t
+
+    lib.ggufTensorName.argtypes = [llaisysGGUF_t, c_size_t]
+    lib.ggufTensorName.restype = c_char_p
+
+    lib.ggufTensorType.argtypes = [llaisysGGUF_t, c_char_p]
+    lib.ggufTensorType.restype = c_char_p
+
+    lib.ggufGetTensor.argtypes = [llaisysGGUF_t, c_char_p, llaisysDataType_t]
+    lib.ggufGetTensor.restype = llaisysTensor_t
+
+    lib.ggufGetTensorInt4.argtypes = [
+        llaisysGGUF_t,
+        c_char_p,  # name
+        POINTER(llaisysTensor_t),  # q
+        POINTER(llaisysTensor_t),  # scales
+        POINTER(llaisysTensor_t),  # zeros
+    ]
+    lib.ggufGetTensorInt4.restype = c_int
+
+    lib.ggufGetMeta.argtypes = [llaisysGGUF_t, c_char_p]
+    lib.ggufGetMeta.restype = c_char_p
+
+    lib.ggufQwen2Meta.argtypes = [llaisysGGUF_t, llaisysDataType_t, POINTER(LlaisysQwen2Meta)]
+    lib.ggufQwen2Meta.restype = None
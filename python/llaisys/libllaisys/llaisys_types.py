@@ -49,8 +49,72 @@ class MemcpyKind(IntEnum):
 
 llaisysMemcpyKind_t = ctypes.c_int
 
+# Op Type enum (precision policy)
+class OpType(IntEnum):
+    LINEAR = 0
+    RMS_NORM = 1
+    SELF_ATTENTION = 2
+    SWIGLU = 3
+    COUNT = 4
+
+
+llaisysOpType_t = ctypes.c_int
+
+
+# External 4-bit weight formats accepted by llaisysRepackInt4
+class Int4Format(IntEnum):
+    GPTQ = 0
+    AWQ = 1
+
+
+llaisysInt4Format_t = ctypes.c_int
+
+
+# Device memory allocator of a runtime
+class AllocatorType(IntEnum):
+    NAIVE = 0
+    CACHING = 1
+
+
+llaisysAllocatorType_t = ctypes.c_int
+
+
+# CPU host memory placement
+class HugePages(IntEnum):
+    NONE = 0
+    TRANSPARENT = 1
+    EXPLICIT = 2
+
+
+llaisysHugePages_t = ctypes.c_int
+
+
+class NumaPolicy(IntEnum):
+    DEFAULT = 0
+    INTERLEAVE = 1
+    BLOCKED = 2
+    NODE = 3
+
+
+llaisysNumaPolicy_t = ctypes.c_int
+
+
+# What an allocation is used for, for memory accounting
+class MemoryCategory(IntEnum):
+    OTHER = 0
+    WEIGHTS = 1
+    KV_CACHE = 2
+    ACTIVATION = 3
+    SCRATCH = 4
+    COUNT = 5
+
+
+llaisysMemoryCategory_t = ctypes.c_int
+
 # Stream type (opaque pointer)
 llaisysStream_t = ctypes.c_void_p
+# Event type (opaque pointer)
+llaisysEvent_t = ctypes.c_void_p
 
 __all__ = [
     "llaisysDeviceType_t",
@@ -59,5 +123,18 @@ __all__ = [
     "DataType",
     "llaisysMemcpyKind_t",
     "MemcpyKind",
+    "llaisysOpType_t",
+    "OpType",
+    "llaisysInt4Format_t",
+    "Int4Format",
+    "llaisysAllocatorType_t",
+    "AllocatorType",
+    "llaisysHugePages_t",
+    "HugePages",
+    "llaisysNumaPolicy_t",
+    "NumaPolicy",
+    "llaisysMemoryCategory_t",
+    "MemoryCategory",
     "llaisysStream_t",
+    "llaisysEvent_t",
 ]
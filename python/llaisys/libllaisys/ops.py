@@ -1,5 +1,6 @@
 from .tensor import llaisysTensor_t
-from ctypes import c_float
+from .llaisys_types import llaisysOpType_t, llaisysDataType_t, llaisysInt4Format_t
+from ctypes import c_float, POINTER
 
 def load_ops(lib):
     lib.llaisysAdd.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
@@ -8,12 +9,51 @@ def load_ops(lib):
     lib.llaisysArgmax.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysArgmax.restype = None
 
+    lib.llaisysCast.argtypes = [llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysCast.restype = None
+
     lib.llaisysEmbedding.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysEmbedding.restype = None
 
     lib.llaisysLinear.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysLinear.restype = None
 
+    lib.llaisysLinearInt8.argtypes = [
+        llaisysTensor_t,  # out
+        llaisysTensor_t,  # in
+        llaisysTensor_t,  # weight
+        llaisysTensor_t,  # weight_scale
+        llaisysTensor_t,  # bias (nullable)
+    ]
+    lib.llaisysLinearInt8.restype = None
+
+    lib.llaisysQuantizeInt8.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysQuantizeInt8.restype = None
+
+    lib.llaisysLinearInt4.argtypes = [
+        llaisysTensor_t,  # out
+        llaisysTensor_t,  # in
+        llaisysTensor_t,  # weight
+        llaisysTensor_t,  # scales
+        llaisysTensor_t,  # zeros
+        llaisysTensor_t,  # bias (nullable)
+    ]
+    lib.llaisysLinearInt4.restype = None
+
+    lib.llaisysQuantizeInt4.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysQuantizeInt4.restype = None
+
+    lib.llaisysRepackInt4.argtypes = [
+        llaisysTensor_t,  # q
+        llaisysTensor_t,  # scales
+        llaisysTensor_t,  # zeros
+        llaisysTensor_t,  # src_qweight
+        llaisysTensor_t,  # src_qzeros
+        llaisysTensor_t,  # src_scales
+        llaisysInt4Format_t,
+    ]
+    lib.llaisysRepackInt4.restype = None
+
     lib.llaisysRearrange.argtypes = [llaisysTensor_t, llaisysTensor_t]
     lib.llaisysRearrange.restype = None
 
@@ -32,5 +72,29 @@ def load_ops(lib):
     ]
     lib.llaisysSelfAttention.restype = None
 
+    lib.llaisysSelfAttentionQuantKV.argtypes = [
+        llaisysTensor_t,  # attn_val
+        llaisysTensor_t,  # q
+        llaisysTensor_t,  # k
+        llaisysTensor_t,  # v
+        llaisysTensor_t,  # k_scale
+        llaisysTensor_t,  # v_scale
+        c_float,  # scale
+    ]
+    lib.llaisysSelfAttentionQuantKV.restype = None
+
+    lib.llaisysQuantizeKV.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysQuantizeKV.restype = None
+
     lib.llaisysSwiGLU.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysSwiGLU.restype = None
+
+    lib.llaisysSetPrecision.argtypes = [llaisysOpType_t, llaisysDataType_t, llaisysDataType_t]
+    lib.llaisysSetPrecision.restype = None
+
+    lib.llaisysGetPrecision.argtypes = [
+        llaisysOpType_t,
+        POINTER(llaisysDataType_t),  # compute
+        POINTER(llaisysDataType_t),  # accumulate
+    ]
+    lib.llaisysGetPrecision.restype = None
@@ -0,0 +1,84 @@
+from ctypes import POINTER, Structure, c_char_p, c_double, c_size_t, c_void_p
+from .llaisys_types import llaisysDataType_t
+from .tensor import llaisysTensor_t
+
+# Handle types
+llaisysPackWriter_t = c_void_p
+llaisysPacked_t = c_void_p
+llaisysLayerStream_t = c_void_p
+
+
+class LlaisysLayerStreamStats(Structure):
+    _fields_ = [
+        ("acquires", c_size_t),
+        ("hits", c_size_t),
+        ("wait_ms", c_double),
+        ("nbytes_prefetched", c_size_t),
+        ("nbytes_loaded", c_size_t),
+        ("nbytes_released", c_size_t),
+    ]
+
+
+def load_packed(lib):
+    lib.packWriterCreate.argtypes = [c_char_p]
+    lib.packWriterCreate.restype = llaisysPackWriter_t
+
+    lib.packWriterSetMeta.argtypes = [llaisysPackWriter_t, c_char_p, c_char_p]
+    lib.packWriterSetMeta.restype = None
+
+    lib.packWriterAddTensor.argtypes = [
+        llaisysPackWriter_t,
+        c_char_p,  # name
+        POINTER(llaisysTensor_t),  # parts
+        c_size_t,  # nparts
+        llaisysDataType_t,  # dtype
+    ]
+    lib.packWriterAddTensor.restype = None
+
+    lib.packWriterAddAlias.argtypes = [llaisysPackWriter_t, c_char_p, c_char_p]
+    lib.packWriterAddAlias.restype = None
+
+    lib.packWriterSharedBytes.argtypes = [llaisysPackWriter_t]
+    lib.packWriterSharedBytes.restype = c_size_t
+
+    lib.packWriterFinish.argtypes = [llaisysPackWriter_t]
+    lib.packWriterFinish.restype = None
+
+    lib.packWriterDestroy.argtypes = [llaisysPackWriter_t]
+    lib.packWriterDestroy.restype = None
+
+    lib.packedOpen.argtypes = [c_char_p]
+    lib.packedOpen.restype = llaisysPacked_t
+
+    lib.packedClose.argtypes = [llaisysPacked_t]
+    lib.packedClose.restype = None
+
+    lib.packedNumTensors.argtypes = [llaisysPacked_t]
+    lib.packedNumTensors.restype = c_size_t
+
+    lib.packedTensorName.argtypes = [llaisysPacked_t, c_size_t]
+    lib.packedTensorName.restype = c_char_p
+
+    lib.packedGetTensor.argtypes = [llaisysPacked_t, c_char_p]
+    lib.packedGetTensor.restype = llaisysTensor_t
+
+    lib.packedGetMeta.argtypes = [llaisysPacked_t, c_char_p]
+    lib.packedGetMeta.restype = c_char_p
+
+    lib.packedStreamLayers.argtypes = [llaisysPacked_t, c_size_t]
+    lib.packedStreamLayers.restype = llaisysLayerStream_t
+
+    lib.layerStreamDestroy.argtypes = [llaisysLayerStream_t]
+    lib.layerStreamDestroy.restype = None
+
+    lib.layerStreamNumLayers.argtypes = [llaisysLayerStream_t]
+    lib.layerStreamNumLayers.restype = c_size_t
+
+    lib.layerStreamAcquire.argtypes = [llaisysLayerStream_t, c_size_t]
+    lib.layerStreamAcquire.restype = None
+
+    lib.layerStreamRelease.argtypes = [llaisysLayerStream_t, c_size_t]
+    lib.layerStreamRelease.restype = None
+
+    lib.layerStreamGetStats.argtypes = [llaisysLayerStream_t, POINTER(LlaisysLayerStreamStats)]
+    lib.layerStreamGetStats.restype = None
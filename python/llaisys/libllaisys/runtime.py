@@ -1,5 +1,5 @@
 import ctypes
-from ctypes import c_void_p, c_size_t, c_int, Structure, CFUNCTYPE
+from ctypes import c_void_p, c_size_t, c_int, c_float, Structure, CFUNCTYPE
 from .llaisys_types import *
 
 # Define function pointer types
@@ -18,6 +18,24 @@ free_host_api = CFUNCTYPE(None, c_void_p)
 
 memcpy_sync_api = CFUNCTYPE(None, c_void_p, c_void_p, c_size_t, llaisysMemcpyKind_t)
 memcpy_async_api = CFUNCTYPE(None, c_void_p, c_void_p, c_size_t, llaisysMemcpyKind_t, llaisysStream_t)
+memcpy2d_sync_api = CFUNCTYPE(
+    None, c_void_p, c_size_t, c_void_p, c_size_t, c_size_t, c_size_t, llaisysMemcpyKind_t
+)
+memcpy2d_async_api = CFUNCTYPE(
+    None, c_void_p, c_size_t, c_void_p, c_size_t, c_size_t, c_size_t, llaisysMemcpyKind_t, llaisysStream_t
+)
+memset_sync_api = CFUNCTYPE(None, c_void_p, c_int, c_size_t)
+
+create_event_api = CFUNCTYPE(llaisysEvent_t)
+destroy_event_api = CFUNCTYPE(None, llaisysEvent_t)
+event_record_api = CFUNCTYPE(None, llaisysEvent_t, llaisysStream_t)
+stream_wait_event_api = CFUNCTYPE(None, llaisysStream_t, llaisysEvent_t)
+event_query_api = CFUNCTYPE(c_int, llaisysEvent_t)
+event_synchronize_api = CFUNCTYPE(None, llaisysEvent_t)
+event_elapsed_time_api = CFUNCTYPE(c_float, llaisysEvent_t, llaisysEvent_t)
+
+host_func_t = CFUNCTYPE(None, c_void_p)
+launch_host_func_api = CFUNCTYPE(None, llaisysStream_t, host_func_t, c_void_p)
 
 
 # Define the struct matching LlaisysRuntimeAPI
@@ -35,6 +53,69 @@ class LlaisysRuntimeAPI(Structure):
         ("free_host", free_host_api),
         ("memcpy_sync", memcpy_sync_api),
         ("memcpy_async", memcpy_async_api),
+        ("create_event", create_event_api),
+        ("destroy_event", destroy_event_api),
+        ("event_record", event_record_api),
+        ("stream_wait_event", stream_wait_event_api),
+        ("event_query", event_query_api),
+        ("event_synchronize", event_synchronize_api),
+        ("event_elapsed_time", event_elapsed_time_api),
+        ("launch_host_func", launch_host_func_api),
+        ("memcpy2d_sync", memcpy2d_sync_api),
+        ("memcpy2d_async", memcpy2d_async_api),
+        ("memset_sync", memset_sync_api),
+    ]
+
+
+class LlaisysAllocatorStats(Structure):
+    _fields_ = [
+        ("allocated_bytes", c_size_t),
+        ("reserved_bytes", c_size_t),
+        ("peak_allocated_bytes", c_size_t),
+        ("peak_reserved_bytes", c_size_t),
+        ("num_allocs", c_size_t),
+        ("num_frees", c_size_t),
+        ("num_device_allocs", c_size_t),
+        ("num_device_frees", c_size_t),
+    ]
+
+
+class LlaisysMemoryCategoryStats(Structure):
+    _fields_ = [
+        ("in_use_bytes", c_size_t),
+        ("peak_bytes", c_size_t),
+        ("total_allocated_bytes", c_size_t),
+        ("num_allocs", c_size_t),
+        ("num_frees", c_size_t),
+    ]
+
+
+class LlaisysMemoryStats(Structure):
+    _fields_ = [
+        ("categories", LlaisysMemoryCategoryStats * MemoryCategory.COUNT),
+        ("in_use_bytes", c_size_t),
+        ("peak_bytes", c_size_t),
+        ("reserved_bytes", c_size_t),
+        ("peak_reserved_bytes", c_size_t),
+        ("cached_bytes", c_size_t),
+    ]
+
+
+class LlaisysBufferLifetime(Structure):
+    _fields_ = [
+        ("size", c_size_t),
+        ("first", c_size_t),
+        ("last", c_size_t),
+    ]
+
+
+class LlaisysHostMemoryOptions(Structure):
+    _fields_ = [
+        ("huge_pages", llaisysHugePages_t),
+        ("numa_policy", llaisysNumaPolicy_t),
+        ("numa_node", c_int),
+        ("min_size", c_size_t),
+        ("alignment", c_size_t),
     ]
 
 
@@ -46,3 +127,72 @@ def load_runtime(lib):
 
     lib.llaisysSetContextRuntime.argtypes = [llaisysDeviceType_t, c_int]
     lib.llaisysSetContextRuntime.restype = None
+
+    lib.llaisysSetRuntimeSharing.argtypes = [c_int]
+    lib.llaisysSetRuntimeSharing.restype = None
+
+    lib.llaisysGetRuntimeSharing.argtypes = []
+    lib.llaisysGetRuntimeSharing.restype = c_int
+
+    lib.llaisysRuntimeSetAllocator.argtypes = [llaisysAllocatorType_t]
+    lib.llaisysRuntimeSetAllocator.restype = None
+
+    lib.llaisysRuntimeGetAllocator.argtypes = []
+    lib.llaisysRuntimeGetAllocator.restype = llaisysAllocatorType_t
+
+    lib.llaisysRuntimeTrim.argtypes = []
+    lib.llaisysRuntimeTrim.restype = None
+
+    lib.llaisysRuntimeGetAllocatorStats.argtypes = [ctypes.POINTER(LlaisysAllocatorStats)]
+    lib.llaisysRuntimeGetAllocatorStats.restype = None
+
+    lib.llaisysRuntimeSetMemoryCategory.argtypes = [llaisysMemoryCategory_t]
+    lib.llaisysRuntimeSetMemoryCategory.restype = llaisysMemoryCategory_t
+
+    lib.llaisysRuntimeGetMemoryCategory.argtypes = []
+    lib.llaisysRuntimeGetMemoryCategory.restype = llaisysMemoryCategory_t
+
+    lib.llaisysRuntimeMemoryStats.argtypes = [ctypes.POINTER(LlaisysMemoryStats)]
+    lib.llaisysRuntimeMemoryStats.restype = None
+
+    lib.llaisysRuntimeResetPeakMemoryStats.argtypes = []
+    lib.llaisysRuntimeResetPeakMemoryStats.restype = None
+
+    lib.llaisysRuntimeArenaReserve.argtypes = [c_size_t]
+    lib.llaisysRuntimeArenaReserve.restype = None
+
+    lib.llaisysRuntimeArenaReset.argtypes = []
+    lib.llaisysRuntimeArenaReset.restype = None
+
+    lib.llaisysRuntimeArenaGetStats.argtypes = [
+        ctypes.POINTER(c_size_t),
+        ctypes.POINTER(c_size_t),
+        ctypes.POINTER(c_size_t),
+    ]
+    lib.llaisysRuntimeArenaGetStats.restype = None
+
+    lib.llaisysPlanArena.argtypes = [
+        ctypes.POINTER(LlaisysBufferLifetime),
+        c_size_t,
+        c_size_t,
+        ctypes.POINTER(c_size_t),
+    ]
+    lib.llaisysPlanArena.restype = c_size_t
+
+    lib.llaisysCpuSetMemoryOptions.argtypes = [ctypes.POINTER(LlaisysHostMemoryOptions)]
+    lib.llaisysCpuSetMemoryOptions.restype = None
+
+    lib.llaisysCpuGetMemoryOptions.argtypes = [ctypes.POINTER(LlaisysHostMemoryOptions)]
+    lib.llaisysCpuGetMemoryOptions.restype = None
+
+    lib.llaisysCpuNumaNodeCount.argtypes = []
+    lib.llaisysCpuNumaNodeCount.restype = c_int
+
+    lib.llaisysCpuBindThreads.argtypes = []
+    lib.llaisysCpuBindThreads.restype = None
+
+    lib.llaisysCpuWorkspaceSize.argtypes = []
+    lib.llaisysCpuWorkspaceSize.restype = c_size_t
+
+    lib.llaisysCpuWorkspaceRelease.argtypes = []
+    lib.llaisysCpuWorkspaceRelease.restype = None
@@ -0,0 +1,55 @@
+from ctypes import POINTER, Structure, c_char_p, c_double, c_int, c_size_t, c_void_p
+from .llaisys_types import llaisysDataType_t, llaisysDeviceType_t
+from .tensor import llaisysTensor_t
+
+# Handle type
+llaisysSafetensors_t = c_void_p
+
+
+class LlaisysLoadStats(Structure):
+    _fields_ = [
+        ("open_ms", c_double),
+        ("convert_ms", c_double),
+        ("copy_ms", c_double),
+        ("total_ms", c_double),
+        ("ntensors", c_size_t),
+        ("nbytes_read", c_size_t),
+        ("nbytes_converted", c_size_t),
+        ("nbytes_shared", c_size_t),
+    ]
+
+
+def load_safetensors(lib):
+    lib.safetensorsOpen.argtypes = [c_char_p]
+    lib.safetensorsOpen.restype = llaisysSafetensors_t
+
+    lib.safetensorsClose.argtypes = [llaisysSafetensors_t]
+    lib.safetensorsClose.restype = None
+
+    lib.safetensorsNumTensors.argtypes = [llaisysSafetensors_t]
+    lib.safetensorsNumTensors.restype = c_size_t
+
+    lib.safetensorsTensorName.argtypes = [llaisysSafetensors_t, c_size_t]
+    lib.safetensorsTensorName.restype = c_char_p
+
+    lib.safetensorsGetTensor.argtypes = [llaisysSafetensors_t, c_char_p]
+    lib.safetensorsGetTensor.restype = llaisysTensor_t
+
+    lib.safetensorsGetTensorAs.argtypes = [
+        llaisysSafetensors_t,
+        c_char_p,  # name
+        llaisysDataType_t,  # dtype
+        llaisysDeviceType_t,  # device_type
+        c_int,  # device_id
+    ]
+    lib.safetensorsGetTensorAs.restype = llaisysTensor_t
+
+    lib.safetensorsLoadAll.argtypes = [
+        llaisysSafetensors_t,
+        llaisysDataType_t,  # dtype
+        llaisysDeviceType_t,  # device_type
+        c_int,  # device_id
+        POINTER(llaisysTensor_t),  # tensors
+        POINTER(LlaisysLoadStats),  # stats
+    ]
+    lib.safetensorsLoadAll.restype = None
@@ -15,6 +15,26 @@ def load_tensor(lib):
     ]
     lib.tensorCreate.restype = llaisysTensor_t
 
+    # Function: tensorCreatePadded
+    lib.tensorCreatePadded.argtypes = [
+        POINTER(c_size_t),  # shape
+        c_size_t,  # ndim
+        llaisysDataType_t,  # dtype
+        llaisysDeviceType_t,  # device_type
+        c_int,  # device_id
+        c_size_t,  # row_alignment
+    ]
+    lib.tensorCreatePadded.restype = llaisysTensor_t
+
+    # Function: tensorCreateInArena
+    lib.tensorCreateInArena.argtypes = [
+        POINTER(c_size_t),  # shape
+        c_size_t,  # ndim
+        llaisysDataType_t,  # dtype
+        c_size_t,  # offset, SIZE_MAX to bump-allocate
+    ]
+    lib.tensorCreateInArena.restype = llaisysTensor_t
+
     # Function: tensorDestroy
     lib.tensorDestroy.argtypes = [llaisysTensor_t]
     lib.tensorDestroy.restype = None
@@ -55,6 +75,10 @@ def load_tensor(lib):
     lib.tensorIsContiguous.argtypes = [llaisysTensor_t]
     lib.tensorIsContiguous.restype = c_uint8
 
+    # Function: tensorIsAligned
+    lib.tensorIsAligned.argtypes = [llaisysTensor_t, c_size_t]
+    lib.tensorIsAligned.restype = c_uint8
+
     # Function: tensorLoad
     lib.tensorLoad.argtypes = [llaisysTensor_t, c_void_p]
     lib.tensorLoad.restype = None
@@ -76,3 +100,16 @@ def load_tensor(lib):
         c_size_t,  # end  : exclusive
     ]
     lib.tensorSlice.restype = llaisysTensor_t
+
+    # Function: tensorReshape(llaisysTensor_t tensor, size_t *shape, size_t ndim);
+    lib.tensorReshape.argtypes = [llaisysTensor_t, POINTER(c_size_t), c_size_t]
+    lib.tensorReshape.restype = llaisysTensor_t
+
+    # Function: tensorContiguous(llaisysTensor_t tensor);
+    lib.tensorContiguous.argtypes = [llaisysTensor_t]
+    lib.tensorContiguous.restype = llaisysTensor_t
+
+    # Function: tensorTo(llaisysTensor_t tensor,
+    #                    llaisysDeviceType_t device_type, int device_id);
+    lib.tensorTo.argtypes = [llaisysTensor_t, llaisysDeviceType_t, c_int]
+    lib.tensorTo.restype = llaisysTensor_t
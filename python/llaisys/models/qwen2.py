@@ -1,9 +1,57 @@
-from typing import Sequence
+from typing import Dict, Mapping, Sequence, Tuple
 from ..libllaisys import LIB_LLAISYS
-from ..libllaisys import DeviceType
+from ..libllaisys import DeviceType, DataType
+from ..safetensors import SafeTensors
+from ..runtime import plan_arena
 
 from pathlib import Path
-import safetensors
+
+
+def activation_lifetimes(
+    meta: Mapping[str, object], ntoken: int
+) -> Dict[str, Tuple[Tuple[int, ...], int, int]]:
+    """Activations of one forward pass over ntoken tokens, as
+    name -> (shape, first step, last step) in op order. Decoder layers run one
+    after another, so one layer's buffers are reused by every layer; only the
+    residual stream x lives across the whole pass. Attention K/V go to the KV
+    cache and are not included."""
+    hs, nh, nkvh, dh, di, voc = (meta[k] for k in ("hs", "nh", "nkvh", "dh", "di", "voc"))
+    return {
+        "x": ((ntoken, hs), 0, 16),  # embedding, residual adds in place, read by the final norm
+        "h": ((ntoken, hs), 1, 4),  # input_layernorm
+        "q": ((ntoken, nh, dh), 2, 5),
+        "k": ((ntoken, nkvh, dh), 3, 6),
+        "v": ((ntoken, nkvh, dh), 4, 7),
+        "q_rope": ((ntoken, nh, dh), 5, 7),
+        "k_rope": ((ntoken, nkvh, dh), 6, 7),
+        "attn": ((ntoken, nh * dh), 7, 8),
+        "o": ((ntoken, hs), 8, 9),
+        "h2": ((ntoken, hs), 10, 12),  # post_attention_layernorm
+        "gate": ((ntoken, di), 11, 13),
+        "up": ((ntoken, di), 12, 13),
+        "act": ((ntoken, di), 13, 14),
+        "down": ((ntoken, hs), 14, 15),
+        "hn": ((1, hs), 16, 17),  # final norm of the last token only
+        "logits": ((1, voc), 17, 17),
+    }
+
+
+def plan_activations(
+    meta: Mapping[str, object], ntoken: int, alignment: int = 64
+) -> Tuple[Dict[str, Tuple[Tuple[int, ...], int]], int]:
+    """Plan activation_lifetimes() into one arena: name -> (shape, offset) and
+    the arena size. Reserve the largest ntoken (the prefill) once and every
+    decode step fits in the same slab."""
+    esize = 4 if meta["dtype"] == DataType.F32 else 2
+    acts = activation_lifetimes(meta, ntoken)
+    lifetimes = []
+    for shape, first, last in acts.values():
+        size = esize
+        for d in shape:
+            size *= d
+        lifetimes.append((size, first, last))
+    offsets, total = plan_arena(lifetimes, alignment)
+    return {name: (shape, off) for (name, (shape, _, _)), off in zip(acts.items(), offsets)}, total
 
 
 class Qwen2:
@@ -13,8 +61,28 @@ class Qwen2:
 
         model_path = Path(model_path)
 
+        if model_path.suffix == ".llaisys":
+            # Prepacked by llaisys.packed: PackedModel(model_path) gives the
+            # weights already fused, converted and aligned, used straight from
+            # the mapping. For models larger than memory, stream_layers() keeps
+            # only the layer being computed resident: acquire(i) before layer
+            # i, release(i) after it, the next layer prefetching meanwhile
+            raise NotImplementedError("Qwen2: loading .llaisys models is not implemented")
+
+        if model_path.suffix == ".gguf":
+            # llama.cpp checkpoint: GGUFModel(model_path) maps names to the
+            # HuggingFace ones, the configuration comes from qwen2_meta(), Q4_0
+            # linear weights load directly for Ops.linear_int4 via get_int4()
+            # and other quantized tensors are dequantized by get_tensor()
+            raise NotImplementedError("Qwen2: loading .gguf models is not implemented")
+
+        # Tied embeddings (tie_word_embeddings, no lm_head.weight in the
+        # checkpoint; .llaisys files carry lm_head.weight as an alias of the
+        # same data): out_embed is given the in_embed tensor, so the one
+        # [voc, hs] matrix serves the embedding lookup and the lm_head linear
         for file in sorted(model_path.glob("*.safetensors")):
-            data_ = safetensors.safe_open(file, framework="numpy", device="cpu")
+            # Weights are memory-mapped from the file, no copy through Python
+            data_ = SafeTensors(file)
             for name_ in data_.keys():
                 ## TODO: load the model weights
                 pass
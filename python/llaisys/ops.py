@@ -1,6 +1,6 @@
-from .libllaisys import LIB_LLAISYS
+from .libllaisys import LIB_LLAISYS, DataType, OpType, Int4Format, llaisysDataType_t, llaisysInt4Format_t
 from .tensor import Tensor
-from ctypes import c_float, c_int
+from ctypes import byref, c_float, c_int
 
 
 class Ops:
@@ -12,6 +12,10 @@ class Ops:
     def argmax(max_idx: Tensor, max_val: Tensor, vals: Tensor):
         LIB_LLAISYS.llaisysArgmax(max_idx.lib_tensor(), max_val.lib_tensor(), vals.lib_tensor())
 
+    @staticmethod
+    def cast(out: Tensor, inp: Tensor):
+        LIB_LLAISYS.llaisysCast(out.lib_tensor(), inp.lib_tensor())
+
     @staticmethod
     def embedding(out: Tensor, index: Tensor, weight: Tensor):
         LIB_LLAISYS.llaisysEmbedding(
@@ -24,6 +28,59 @@ class Ops:
             out.lib_tensor(), inp.lib_tensor(), weight.lib_tensor(), bias.lib_tensor()
         )
 
+    @staticmethod
+    def linear_int8(out: Tensor, inp: Tensor, weight: Tensor, weight_scale: Tensor, bias: Tensor = None):
+        LIB_LLAISYS.llaisysLinearInt8(
+            out.lib_tensor(),
+            inp.lib_tensor(),
+            weight.lib_tensor(),
+            weight_scale.lib_tensor(),
+            None if bias is None else bias.lib_tensor(),
+        )
+
+    @staticmethod
+    def quantize_int8(q: Tensor, scale: Tensor, weight: Tensor):
+        LIB_LLAISYS.llaisysQuantizeInt8(q.lib_tensor(), scale.lib_tensor(), weight.lib_tensor())
+
+    @staticmethod
+    def linear_int4(
+        out: Tensor, inp: Tensor, weight: Tensor, scales: Tensor, zeros: Tensor, bias: Tensor = None
+    ):
+        LIB_LLAISYS.llaisysLinearInt4(
+            out.lib_tensor(),
+            inp.lib_tensor(),
+            weight.lib_tensor(),
+            scales.lib_tensor(),
+            zeros.lib_tensor(),
+            None if bias is None else bias.lib_tensor(),
+        )
+
+    @staticmethod
+    def quantize_int4(q: Tensor, scales: Tensor, zeros: Tensor, weight: Tensor):
+        LIB_LLAISYS.llaisysQuantizeInt4(
+            q.lib_tensor(), scales.lib_tensor(), zeros.lib_tensor(), weight.lib_tensor()
+        )
+
+    @staticmethod
+    def repack_int4(
+        q: Tensor,
+        scales: Tensor,
+        zeros: Tensor,
+        src_qweight: Tensor,
+        src_qzeros: Tensor,
+        src_scales: Tensor,
+        format: Int4Format,
+    ):
+        LIB_LLAISYS.llaisysRepackInt4(
+            q.lib_tensor(),
+            scales.lib_tensor(),
+            zeros.lib_tensor(),
+            src_qweight.lib_tensor(),
+            src_qzeros.lib_tensor(),
+            src_scales.lib_tensor(),
+            llaisysInt4Format_t(format),
+        )
+
     @staticmethod
     def rearrange(out: Tensor, inp: Tensor):
         LIB_LLAISYS.llaisysRearrange(out.lib_tensor(), inp.lib_tensor())
@@ -50,6 +107,37 @@ class Ops:
             c_float(scale),
         )
 
+    @staticmethod
+    def self_attention_quant_kv(
+        attn_val: Tensor, q: Tensor, k: Tensor, v: Tensor, k_scale: Tensor, v_scale: Tensor, scale: float
+    ):
+        LIB_LLAISYS.llaisysSelfAttentionQuantKV(
+            attn_val.lib_tensor(),
+            q.lib_tensor(),
+            k.lib_tensor(),
+            v.lib_tensor(),
+            k_scale.lib_tensor(),
+            v_scale.lib_tensor(),
+            c_float(scale),
+        )
+
+    @staticmethod
+    def quantize_kv(cache: Tensor, scales: Tensor, src: Tensor):
+        LIB_LLAISYS.llaisysQuantizeKV(cache.lib_tensor(), scales.lib_tensor(), src.lib_tensor())
+
     @staticmethod
     def swiglu(out: Tensor, gate: Tensor, up: Tensor):
         LIB_LLAISYS.llaisysSwiGLU(out.lib_tensor(), gate.lib_tensor(), up.lib_tensor())
+
+    @staticmethod
+    def set_precision(op: OpType, compute: DataType = DataType.F32, accumulate: DataType = DataType.F32):
+        LIB_LLAISYS.llaisysSetPrecision(
+            llaisysDataType_t(op), llaisysDataType_t(compute), llaisysDataType_t(accumulate)
+        )
+
+    @staticmethod
+    def get_precision(op: OpType):
+        compute = llaisysDataType_t()
+        accumulate = llaisysDataType_t()
+        LIB_LLAISYS.llaisysGetPrecision(llaisysDataType_t(op), byref(compute), byref(accumulate))
+        return DataType(compute.value), DataType(accumulate.value)
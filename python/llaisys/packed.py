@@ -0,0 +1,405 @@
+import json
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence
+
+from .libllaisys import (
+    LIB_LLAISYS,
+    llaisysPackWriter_t,
+    llaisysPacked_t,
+    llaisysLayerStream_t,
+    LlaisysLayerStreamStats,
+    llaisysTensor_t,
+    llaisysDataType_t,
+    DataType,
+    Int4Format,
+)
+from .safetensors import SafeTensors
+from .gguf import GGUFModel
+from .tensor import Tensor
+from .ops import Ops
+from contextlib import contextmanager
+from ctypes import byref, c_size_t
+
+
+# Weights concatenated along dim 0 at pack time so one linear computes them
+# all: fused name suffix -> part suffixes, applied per layer prefix.
+QWEN2_FUSIONS = [
+    (
+        "self_attn.qkv_proj.weight",
+        ("self_attn.q_proj.weight", "self_attn.k_proj.weight", "self_attn.v_proj.weight"),
+    ),
+    (
+        "self_attn.qkv_proj.bias",
+        ("self_attn.q_proj.bias", "self_attn.k_proj.bias", "self_attn.v_proj.bias"),
+    ),
+    ("mlp.gate_up_proj.weight", ("mlp.gate_proj.weight", "mlp.up_proj.weight")),
+]
+
+
+class PackWriter:
+    """Writes a .llaisys file: page-aligned weights in kernel-native layout."""
+
+    def __init__(self, path):
+        self._writer: llaisysPackWriter_t = LIB_LLAISYS.packWriterCreate(str(path).encode())
+        if not self._writer:
+            raise RuntimeError(f"Failed to create packed file: {path}")
+
+    def __del__(self):
+        # Unfinished files are incomplete and get removed
+        if getattr(self, "_writer", None):
+            LIB_LLAISYS.packWriterDestroy(self._writer)
+            self._writer = None
+
+    def set_meta(self, key: str, value: str):
+        LIB_LLAISYS.packWriterSetMeta(self._writer, key.encode(), value.encode())
+
+    def add(self, name: str, parts: Sequence[Tensor], dtype: Optional[DataType] = None):
+        handles = (llaisysTensor_t * len(parts))(*[p.lib_tensor() for p in parts])
+        LIB_LLAISYS.packWriterAddTensor(
+            self._writer,
+            name.encode(),
+            handles,
+            c_size_t(len(parts)),
+            llaisysDataType_t(DataType.INVALID if dtype is None else dtype),
+        )
+
+    def alias(self, name: str, target: str):
+        """Add name as another entry for the already written target's data."""
+        LIB_LLAISYS.packWriterAddAlias(self._writer, name.encode(), target.encode())
+
+    def shared_bytes(self) -> int:
+        """Bytes not written because an entry reuses existing data, either
+        through alias() or because add() found identical content."""
+        return LIB_LLAISYS.packWriterSharedBytes(self._writer)
+
+    def finish(self):
+        LIB_LLAISYS.packWriterFinish(self._writer)
+        self._writer = None
+
+
+class LayerStream:
+    """Keeps only the layers being computed (plus prefetched ones) of an
+    out-of-core model in memory; see PackedModel.stream_layers."""
+
+    def __init__(self, stream: llaisysLayerStream_t):
+        self._stream = stream
+
+    def __del__(self):
+        if getattr(self, "_stream", None):
+            LIB_LLAISYS.layerStreamDestroy(self._stream)
+            self._stream = None
+
+    def num_layers(self) -> int:
+        return LIB_LLAISYS.layerStreamNumLayers(self._stream)
+
+    def acquire(self, layer: int):
+        """Block until the layer is resident; prefetch the following layers."""
+        LIB_LLAISYS.layerStreamAcquire(self._stream, c_size_t(layer))
+
+    def release(self, layer: int):
+        """The layer is done; its pages are reclaimed first under memory pressure."""
+        LIB_LLAISYS.layerStreamRelease(self._stream, c_size_t(layer))
+
+    @contextmanager
+    def layer(self, layer: int):
+        self.acquire(layer)
+        try:
+            yield
+        finally:
+            self.release(layer)
+
+    def stats(self) -> Dict[str, float]:
+        """Counters plus hit_rate, the fraction of acquires whose layer was
+        already prefetched."""
+        stats = LlaisysLayerStreamStats()
+        LIB_LLAISYS.layerStreamGetStats(self._stream, byref(stats))
+        result = {name: getattr(stats, name) for name, _ in LlaisysLayerStreamStats._fields_}
+        result["hit_rate"] = stats.hits / stats.acquires if stats.acquires else 0.0
+        return result
+
+
+class PackedModel:
+    """Memory-mapped .llaisys file. Tensors point directly into the mapping."""
+
+    def __init__(self, path):
+        self._packed: llaisysPacked_t = LIB_LLAISYS.packedOpen(str(path).encode())
+        if not self._packed:
+            raise RuntimeError(f"Failed to open packed file: {path}")
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        if getattr(self, "_packed", None):
+            LIB_LLAISYS.packedClose(self._packed)
+            self._packed = None
+
+    def keys(self) -> List[str]:
+        n = LIB_LLAISYS.packedNumTensors(self._packed)
+        return [LIB_LLAISYS.packedTensorName(self._packed, i).decode() for i in range(n)]
+
+    def get_tensor(self, name: str) -> Tensor:
+        tensor = LIB_LLAISYS.packedGetTensor(self._packed, name.encode())
+        if not tensor:
+            raise KeyError(name)
+        return Tensor(tensor=tensor)
+
+    def meta(self, key: str) -> Optional[str]:
+        value = LIB_LLAISYS.packedGetMeta(self._packed, key.encode())
+        return None if value is None else value.decode()
+
+    def stream_layers(self, depth: int = 1) -> LayerStream:
+        """Out-of-core mode for models larger than memory: weights of
+        model.layers.N stay in the file and are paged in per layer, with the
+        next depth layers prefetched on a background thread while the
+        current one computes."""
+        return LayerStream(LIB_LLAISYS.packedStreamLayers(self._packed, c_size_t(depth)))
+
+
+# Weights quantized when packing with quantize="int8"/"int4". An int8 weight
+# <name> gets a per-output-channel f32 scale <name>_scale; an int4 weight gets
+# per-group <name>_scale (f32) and <name>_zero (u8), see Ops.linear_int4.
+QUANTIZE_SUFFIX = "_proj.weight"
+
+# Tensors of a GPTQ/AWQ layer <prefix>, replaced by <prefix>.weight in int4
+INT4_SOURCE_SUFFIXES = (".qweight", ".qzeros", ".scales", ".g_idx")
+
+
+def quantize_int8(weight: Tensor):
+    """Per-output-channel symmetric int8 quantization, returns (q, scale)."""
+    rows = weight.shape()[0]
+    q = Tensor(weight.shape(), dtype=DataType.I8)
+    scale = Tensor((rows,), dtype=DataType.F32)
+    Ops.quantize_int8(q, scale, weight)
+    return q, scale
+
+
+def quantize_int4(weight: Tensor, group_size: int = 128):
+    """Asymmetric 4-bit group quantization, returns (q, scales, zeros)."""
+    rows, cols = weight.shape()
+    q = Tensor((rows, cols // 2), dtype=DataType.U8)
+    scales = Tensor((rows, cols // group_size), dtype=DataType.F32)
+    zeros = Tensor((rows, cols // group_size), dtype=DataType.U8)
+    Ops.quantize_int4(q, scales, zeros, weight)
+    return q, scales, zeros
+
+
+def repack_int4(qweight: Tensor, qzeros: Tensor, scales: Tensor, format: Int4Format):
+    """Convert a GPTQ/AWQ layer to the llaisys int4 layout, returns (q, scales, zeros)."""
+    n_groups, rows = scales.shape()
+    cols = qweight.shape()[0] * 8 if format == Int4Format.GPTQ else qweight.shape()[0]
+    q = Tensor((rows, cols // 2), dtype=DataType.U8)
+    new_scales = Tensor((rows, n_groups), dtype=DataType.F32)
+    zeros = Tensor((rows, n_groups), dtype=DataType.U8)
+    Ops.repack_int4(q, new_scales, zeros, qweight, qzeros, scales, format)
+    return q, new_scales, zeros
+
+
+def int4_format(model_path) -> Optional[Int4Format]:
+    """Detect a GPTQ/AWQ 4-bit checkpoint from config.json (quantization_config)
+    or AutoGPTQ's quantize_config.json."""
+    model_path = Path(model_path)
+    qc = None
+    if (model_path / "config.json").is_file():
+        qc = json.loads((model_path / "config.json").read_text()).get("quantization_config")
+    if qc is None and (model_path / "quantize_config.json").is_file():
+        qc = json.loads((model_path / "quantize_config.json").read_text())
+    if qc is None:
+        return None
+
+    method = qc.get("quant_method", "gptq").lower()
+    if qc.get("bits", qc.get("w_bit", 4)) != 4:
+        raise ValueError(f"Only 4-bit {method} checkpoints are supported")
+    if method == "gptq":
+        if qc.get("desc_act", False):
+            raise ValueError("GPTQ checkpoints with desc_act (act-order) are not supported")
+        return Int4Format.GPTQ
+    if method == "awq":
+        if qc.get("version", "gemm").lower() != "gemm":
+            raise ValueError("Only GEMM-packed AWQ checkpoints are supported")
+        return Int4Format.AWQ
+    raise ValueError(f"Unsupported quantization method: {method}")
+
+
+def gguf_config(gguf: GGUFModel, has_lm_head: bool) -> str:
+    """A HuggingFace-style config.json for a Qwen2 model read from GGUF."""
+    meta = gguf.qwen2_meta()
+    return json.dumps(
+        {
+            "architectures": ["Qwen2ForCausalLM"],
+            "model_type": "qwen2",
+            "num_hidden_layers": meta["nlayer"],
+            "hidden_size": meta["hs"],
+            "num_attention_heads": meta["nh"],
+            "num_key_value_heads": meta["nkvh"],
+            "intermediate_size": meta["di"],
+            "max_position_embeddings": meta["maxseq"],
+            "vocab_size": meta["voc"],
+            "rms_norm_eps": meta["epsilon"],
+            "rope_theta": meta["theta"],
+            "eos_token_id": meta["end_token"],
+            "tie_word_embeddings": not has_lm_head,
+        }
+    )
+
+
+def pack(
+    model_path,
+    output,
+    dtype: Optional[DataType] = None,
+    fusions=QWEN2_FUSIONS,
+    quantize: Optional[str] = None,
+    group_size: int = 128,
+):
+    """Pack a directory of .safetensors files (plus config.json), or a .gguf
+    file, into one .llaisys file, converting floating-point weights to dtype
+    and fusing weights according to fusions. With quantize="int8"/"int4" the
+    linear weights are quantized instead; GPTQ/AWQ 4-bit checkpoints are
+    detected from their config and repacked to the llaisys int4 layout.
+
+    GGUF Q4_0 linear weights are split into the int4 layout as they are
+    (unless quantize="int8"); other quantized GGUF tensors are dequantized
+    to dtype (f32 when None) and then quantized again if quantize is set.
+
+    Tensors with identical content are stored once, and a checkpoint with
+    tied embeddings (no lm_head.weight) gets lm_head.weight as an alias of
+    model.embed_tokens.weight. Returns the number of bytes saved that way."""
+    if quantize not in (None, "int8", "int4"):
+        raise ValueError(f"Unsupported quantization: {quantize}")
+    model_path = Path(model_path)
+    gguf = GGUFModel(model_path) if model_path.suffix == ".gguf" else None
+    files = [SafeTensors(f) for f in sorted(model_path.glob("*.safetensors"))] if gguf is None else [gguf]
+    sources: Dict[str, object] = {}
+    for f in files:
+        for name in f.keys():
+            sources[name] = f
+    source_format = int4_format(model_path) if gguf is None else None
+
+    def get(name):
+        if gguf is not None:
+            return gguf.get_tensor(name, dtype)
+        return sources[name].get_tensor(name)
+
+    def gguf_int4(name):
+        if gguf is None or quantize == "int8" or not name.endswith(QUANTIZE_SUFFIX):
+            return None
+        return gguf.get_int4(name)
+
+    # Each weight loads as pieces (suffix, tensor, dtype to convert to); a
+    # quantized weight has its scales and zeros as extra pieces.
+    def load_float(name):
+        native = gguf_int4(name)
+        if native is not None:
+            return list(zip(["", "_scale", "_zero"], native, [None] * 3))
+        if quantize and name.endswith(QUANTIZE_SUFFIX):
+            if quantize == "int8":
+                pieces = quantize_int8(get(name))
+            else:
+                pieces = quantize_int4(get(name), group_size)
+            return list(zip(["", "_scale", "_zero"], pieces, [None] * 3))
+        return [("", get(name), dtype)]
+
+    def load_int4(prefix):
+        pieces = repack_int4(
+            get(prefix + ".qweight"), get(prefix + ".qzeros"), get(prefix + ".scales"), source_format
+        )
+        return list(zip(["", "_scale", "_zero"], pieces, [None] * 3))
+
+    # How each weight is stored ("int4", "int8", "float", or "q4_0" for the
+    # group-32 int4 split from GGUF); only weights stored the same way can be
+    # fused
+    loaders, kinds = {}, {}
+    for name in sources:
+        if source_format is not None and name.endswith(".qweight"):
+            prefix = name[: -len(".qweight")]
+            loaders[prefix + ".weight"] = lambda prefix=prefix: load_int4(prefix)
+            kinds[prefix + ".weight"] = "int4"
+        elif source_format is None or not name.endswith(INT4_SOURCE_SUFFIXES):
+            loaders[name] = lambda name=name: load_float(name)
+            if gguf is not None and name.endswith(QUANTIZE_SUFFIX) and gguf.tensor_type(name) == "Q4_0":
+                kinds[name] = "int8" if quantize == "int8" else "q4_0"
+            else:
+                kinds[name] = quantize if quantize and name.endswith(QUANTIZE_SUFFIX) else "float"
+
+    writer = PackWriter(output)
+    config = model_path / "config.json"
+    if gguf is not None:
+        writer.set_meta("config", gguf_config(gguf, "lm_head.weight" in sources))
+    elif config.is_file():
+        writer.set_meta("config", config.read_text())
+
+    fused: Dict[str, List[str]] = {}
+    consumed = set()
+    for name in loaders:
+        for fused_suffix, part_suffixes in fusions:
+            if not name.endswith(part_suffixes[0]):
+                continue
+            prefix = name[: -len(part_suffixes[0])]
+            part_names = [prefix + s for s in part_suffixes]
+            if all(p in loaders for p in part_names) and len({kinds[p] for p in part_names}) == 1:
+                fused[prefix + fused_suffix] = part_names
+                consumed.update(part_names)
+
+    def add(name, part_names):
+        # Quantization is per output row (or per row group), so the pieces of
+        # the parts concatenate along dim 0 just like the weights themselves
+        parts = [loaders[p]() for p in part_names]
+        for k, (suffix, _, piece_dtype) in enumerate(parts[0]):
+            writer.add(name + suffix, [part[k][1] for part in parts], piece_dtype)
+        return [part[0][1].shape()[0] for part in parts]
+
+    # Records which tensors were fused and the dim-0 size of each part, so a
+    # loader can take per-part views of a fused weight
+    fusion_meta = {}
+    for fused_name, part_names in fused.items():
+        fusion_meta[fused_name] = [list(p) for p in zip(part_names, add(fused_name, part_names))]
+    for name in loaders:
+        if name not in consumed:
+            add(name, [name])
+
+    # Tied embeddings: the [voc, hs] embedding matrix is also the lm_head
+    # weight ([out, in] for linear), so one copy serves both the row gather
+    # and the projection
+    if "lm_head.weight" not in loaders and "model.embed_tokens.weight" in loaders:
+        writer.alias("lm_head.weight", "model.embed_tokens.weight")
+
+    writer.set_meta("fusions", json.dumps(fusion_meta))
+    if source_format is not None or "q4_0" in kinds.values():
+        writer.set_meta("quantize", "int4")
+    elif quantize:
+        writer.set_meta("quantize", quantize)
+    shared = writer.shared_bytes()
+    writer.finish()
+    return shared
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(
+        description="Pack a model (safetensors directory or .gguf file) into a .llaisys file"
+    )
+    parser.add_argument("model_path", type=str)
+    parser.add_argument("output", type=str)
+    parser.add_argument("--dtype", default=None, choices=["f32", "f16", "bf16"], type=str)
+    parser.add_argument("--no-fuse", action="store_true")
+    parser.add_argument("--quantize", default=None, choices=["int8", "int4"], type=str)
+    parser.add_argument("--group-size", default=128, choices=[32, 64, 128], type=int)
+    args = parser.parse_args()
+    dtypes = {"f32": DataType.F32, "f16": DataType.F16, "bf16": DataType.BF16}
+    shared = pack(
+        args.model_path,
+        args.output,
+        dtypes.get(args.dtype),
+        [] if args.no_fuse else QWEN2_FUSIONS,
+        args.quantize,
+        args.group_size,
+    )
+    if shared:
+        print(f"{shared / 2**20:.1f} MiB shared between tied or identical tensors")
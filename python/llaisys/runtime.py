@@ -1,6 +1,9 @@
 from . import libllaisys
 from .libllaisys import LIB_LLAISYS
-from ctypes import c_void_p
+from .tensor import Tensor
+from contextlib import contextmanager
+from ctypes import byref, c_size_t, c_void_p
+from typing import Callable, Dict, Iterator, List, Optional, Sequence, Tuple
 
 
 class RuntimeAPI:
@@ -8,6 +11,9 @@ class RuntimeAPI:
         self._api = LIB_LLAISYS.llaisysGetRuntimeAPI(
             libllaisys.llaisysDeviceType_t(device_type)
         )
+        # Callbacks passed to launch_host_func, kept alive until their
+        # stream is synchronized
+        self._host_funcs: Dict[int, List[object]] = {}
 
     def get_device_count(self) -> int:
         result = self._api.contents.get_device_count()
@@ -25,9 +31,11 @@ class RuntimeAPI:
 
     def destroy_stream(self, stream: libllaisys.llaisysStream_t) -> None:
         self._api.contents.destroy_stream(stream)
+        self._host_funcs.pop(stream, None)
 
     def stream_synchronize(self, stream: libllaisys.llaisysStream_t) -> None:
         self._api.contents.stream_synchronize(stream)
+        self._host_funcs.pop(stream, None)
 
     def malloc_device(self, size: int) -> c_void_p:
         ptr = self._api.contents.malloc_device(size)
@@ -66,3 +74,292 @@ class RuntimeAPI:
         self._api.contents.memcpy_async(
             dst, src, size, libllaisys.llaisysMemcpyKind_t(kind), stream
         )
+
+    def memcpy2d_sync(
+        self,
+        dst: c_void_p,
+        dpitch: int,
+        src: c_void_p,
+        spitch: int,
+        width: int,
+        height: int,
+        kind: libllaisys.MemcpyKind,
+    ) -> None:
+        """Copy height rows of width bytes, row i from src + i * spitch to
+        dst + i * dpitch."""
+        self._api.contents.memcpy2d_sync(
+            dst, dpitch, src, spitch, width, height, libllaisys.llaisysMemcpyKind_t(kind)
+        )
+
+    def memcpy2d_async(
+        self,
+        dst: c_void_p,
+        dpitch: int,
+        src: c_void_p,
+        spitch: int,
+        width: int,
+        height: int,
+        kind: libllaisys.MemcpyKind,
+        stream: libllaisys.llaisysStream_t,
+    ) -> None:
+        self._api.contents.memcpy2d_async(
+            dst, dpitch, src, spitch, width, height, libllaisys.llaisysMemcpyKind_t(kind), stream
+        )
+
+    def memset_sync(self, ptr: c_void_p, value: int, size: int) -> None:
+        self._api.contents.memset_sync(ptr, value, size)
+
+    # Work submitted to a stream runs in submission order on the stream's
+    # worker and the call returns immediately; on the null stream it runs
+    # before the call returns.
+
+    def create_event(self) -> libllaisys.llaisysEvent_t:
+        return self._api.contents.create_event()
+
+    def destroy_event(self, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.destroy_event(event)
+
+    def event_record(
+        self, event: libllaisys.llaisysEvent_t, stream: libllaisys.llaisysStream_t
+    ) -> None:
+        """Complete event when stream reaches this point."""
+        self._api.contents.event_record(event, stream)
+
+    def stream_wait_event(
+        self, stream: libllaisys.llaisysStream_t, event: libllaisys.llaisysEvent_t
+    ) -> None:
+        """Hold back work submitted to stream after this call until the last
+        record of event completes, without blocking the caller."""
+        self._api.contents.stream_wait_event(stream, event)
+
+    def event_query(self, event: libllaisys.llaisysEvent_t) -> bool:
+        return bool(self._api.contents.event_query(event))
+
+    def event_synchronize(self, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.event_synchronize(event)
+
+    def event_elapsed_time(
+        self, start: libllaisys.llaisysEvent_t, end: libllaisys.llaisysEvent_t
+    ) -> float:
+        """Milliseconds between two completed events."""
+        return self._api.contents.event_elapsed_time(start, end)
+
+    def launch_host_func(
+        self, stream: libllaisys.llaisysStream_t, fn: Callable[[], None]
+    ) -> None:
+        """Run fn() on stream, e.g. a sequence of Ops calls. The ops release
+        the GIL, so the calling thread can meanwhile do other work. fn runs on
+        the stream's worker thread, which has its own context (see
+        llaisysSetContextRuntime)."""
+        callback = libllaisys.host_func_t(lambda _: fn())
+        if stream:
+            self._host_funcs.setdefault(stream, []).append(callback)
+        self._api.contents.launch_host_func(stream, callback, None)
+
+
+def set_runtime_sharing(enable: bool) -> None:
+    """Let every thread use one process-wide runtime per device, so that a
+    multi-threaded server shares a single allocator cache and one set of
+    memory statistics. Streams, the arena, the CPU kernel scratch and the
+    memory category stay per thread. Only affects threads that have not used
+    the device yet, so call it before any thread creates tensors."""
+    LIB_LLAISYS.llaisysSetRuntimeSharing(1 if enable else 0)
+
+
+def runtime_sharing() -> bool:
+    return bool(LIB_LLAISYS.llaisysGetRuntimeSharing())
+
+
+# The functions below act on the runtime of the current thread's context,
+# i.e. the device most recently selected with llaisysSetContextRuntime.
+
+
+def set_allocator(allocator_type: libllaisys.AllocatorType) -> None:
+    """Select the device memory allocator. Storage allocated before the switch
+    is still returned to the allocator it came from."""
+    LIB_LLAISYS.llaisysRuntimeSetAllocator(libllaisys.llaisysAllocatorType_t(allocator_type))
+
+
+def get_allocator() -> libllaisys.AllocatorType:
+    return libllaisys.AllocatorType(LIB_LLAISYS.llaisysRuntimeGetAllocator())
+
+
+def trim_allocator() -> None:
+    """Return memory cached by the allocator but not in use to the device."""
+    LIB_LLAISYS.llaisysRuntimeTrim()
+
+
+def allocator_stats() -> Dict[str, int]:
+    stats = libllaisys.LlaisysAllocatorStats()
+    LIB_LLAISYS.llaisysRuntimeGetAllocatorStats(byref(stats))
+    return {name: getattr(stats, name) for name, _ in libllaisys.LlaisysAllocatorStats._fields_}
+
+
+# Memory accounting. Every allocation made on the runtime is counted under its
+# current category; the arena slab always counts as ACTIVATION, the CPU kernel
+# scratch as SCRATCH and tensors created by the model loaders as WEIGHTS.
+
+
+def set_memory_category(category: libllaisys.MemoryCategory) -> libllaisys.MemoryCategory:
+    """Count later allocations under category; returns the previous one."""
+    return libllaisys.MemoryCategory(
+        LIB_LLAISYS.llaisysRuntimeSetMemoryCategory(libllaisys.llaisysMemoryCategory_t(category))
+    )
+
+
+def get_memory_category() -> libllaisys.MemoryCategory:
+    return libllaisys.MemoryCategory(LIB_LLAISYS.llaisysRuntimeGetMemoryCategory())
+
+
+@contextmanager
+def memory_category(category: libllaisys.MemoryCategory) -> Iterator[None]:
+    """Count allocations made inside the with block under category, e.g.
+
+        with llaisys.memory_category(llaisys.MemoryCategory.KV_CACHE):
+            k_cache = llaisys.Tensor(...)
+    """
+    previous = set_memory_category(category)
+    try:
+        yield
+    finally:
+        set_memory_category(previous)
+
+
+def memory_stats() -> Dict[str, object]:
+    """Bytes in use, peak, bytes allocated in total and allocation counts per
+    category (requested sizes), plus the device allocator's reserved and
+    cached-but-free bytes."""
+    stats = libllaisys.LlaisysMemoryStats()
+    LIB_LLAISYS.llaisysRuntimeMemoryStats(byref(stats))
+    result = {
+        name: getattr(stats, name)
+        for name, _ in libllaisys.LlaisysMemoryStats._fields_
+        if name != "categories"
+    }
+    result["categories"] = {
+        category.name.lower(): {
+            name: getattr(stats.categories[category], name)
+            for name, _ in libllaisys.LlaisysMemoryCategoryStats._fields_
+        }
+        for category in libllaisys.MemoryCategory
+        if category != libllaisys.MemoryCategory.COUNT
+    }
+    return result
+
+
+def reset_peak_memory_stats() -> None:
+    """Set every peak to the current value, to measure the peak of one phase."""
+    LIB_LLAISYS.llaisysRuntimeResetPeakMemoryStats()
+
+
+# CPU host memory. These settings are process-wide and apply to allocations
+# made after the call; they are ignored on platforms other than Linux.
+
+
+def set_host_memory_options(
+    huge_pages: Optional[libllaisys.HugePages] = None,
+    numa_policy: Optional[libllaisys.NumaPolicy] = None,
+    numa_node: Optional[int] = None,
+    min_size: Optional[int] = None,
+    alignment: Optional[int] = None,
+) -> None:
+    """Huge pages and NUMA placement for CPU allocations of at least min_size
+    bytes, and the alignment of every CPU allocation; arguments left as None
+    keep their current value."""
+    options = libllaisys.LlaisysHostMemoryOptions()
+    LIB_LLAISYS.llaisysCpuGetMemoryOptions(byref(options))
+    if huge_pages is not None:
+        options.huge_pages = huge_pages
+    if numa_policy is not None:
+        options.numa_policy = numa_policy
+    if numa_node is not None:
+        options.numa_node = numa_node
+    if min_size is not None:
+        options.min_size = min_size
+    if alignment is not None:
+        options.alignment = alignment
+    LIB_LLAISYS.llaisysCpuSetMemoryOptions(byref(options))
+
+
+def host_memory_options() -> Dict[str, object]:
+    options = libllaisys.LlaisysHostMemoryOptions()
+    LIB_LLAISYS.llaisysCpuGetMemoryOptions(byref(options))
+    return {
+        "huge_pages": libllaisys.HugePages(options.huge_pages),
+        "numa_policy": libllaisys.NumaPolicy(options.numa_policy),
+        "numa_node": options.numa_node,
+        "min_size": options.min_size,
+        "alignment": options.alignment,
+    }
+
+
+def numa_node_count() -> int:
+    return LIB_LLAISYS.llaisysCpuNumaNodeCount()
+
+
+def bind_threads() -> None:
+    """Pin the OpenMP threads evenly to the NUMA nodes, in thread order, so
+    that statically scheduled loops read weights placed with
+    NumaPolicy.BLOCKED from their own node. The calling thread is thread 0."""
+    LIB_LLAISYS.llaisysCpuBindThreads()
+
+
+def cpu_workspace_size() -> int:
+    """Bytes of scratch held for CPU kernels (attention scores, rope tables,
+    quantized activations). It grows to the largest call and is reused."""
+    return LIB_LLAISYS.llaisysCpuWorkspaceSize()
+
+
+def release_cpu_workspace() -> None:
+    LIB_LLAISYS.llaisysCpuWorkspaceRelease()
+
+
+# Per-step activation arena. Call arena_reset() at the start of every step and
+# take activations from arena_tensor(); after the first step the slab is large
+# enough and no further device allocations happen. A tensor keeps the slab it
+# was created in alive, but its memory is reused by the next step.
+
+
+def plan_arena(
+    lifetimes: Sequence[Tuple[int, int, int]], alignment: int = 64
+) -> Tuple[List[int], int]:
+    """Assign arena offsets to buffers given as (size, first, last) step ranges,
+    letting buffers whose ranges do not overlap share memory. Returns the
+    offsets and the total size to pass to arena_reserve()."""
+    n = len(lifetimes)
+    buffers = (libllaisys.LlaisysBufferLifetime * n)(
+        *[libllaisys.LlaisysBufferLifetime(*lt) for lt in lifetimes]
+    )
+    offsets = (c_size_t * n)()
+    total = LIB_LLAISYS.llaisysPlanArena(buffers, n, alignment, offsets)
+    return list(offsets), total
+
+
+def arena_reserve(size: int) -> None:
+    LIB_LLAISYS.llaisysRuntimeArenaReserve(size)
+
+
+def arena_reset() -> None:
+    LIB_LLAISYS.llaisysRuntimeArenaReset()
+
+
+def arena_tensor(
+    shape: Sequence[int],
+    dtype: libllaisys.DataType = libllaisys.DataType.F32,
+    offset: Optional[int] = None,
+) -> Tensor:
+    """Create a contiguous tensor in the arena, either at a planned offset or,
+    when offset is None, after the tensors already taken this step."""
+    _shape = (c_size_t * len(shape))(*shape)
+    _offset = c_size_t(-1).value if offset is None else offset
+    return Tensor(
+        tensor=LIB_LLAISYS.tensorCreateInArena(
+            _shape, len(shape), libllaisys.llaisysDataType_t(dtype), _offset
+        )
+    )
+
+
+def arena_stats() -> Dict[str, int]:
+    capacity, used, peak = c_size_t(), c_size_t(), c_size_t()
+    LIB_LLAISYS.llaisysRuntimeArenaGetStats(byref(capacity), byref(used), byref(peak))
+    return {"capacity": capacity.value, "used": used.value, "peak": peak.value}
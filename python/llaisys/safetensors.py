@@ -0,0 +1,88 @@
+from typing import Dict, List, Optional, Tuple
+
+from .libllaisys import (
+    LIB_LLAISYS,
+    llaisysSafetensors_t,
+    llaisysTensor_t,
+    llaisysDataType_t,
+    llaisysDeviceType_t,
+    LlaisysLoadStats,
+    DataType,
+    DeviceType,
+)
+from .tensor import Tensor
+from ctypes import byref, c_int
+
+
+class SafeTensors:
+    """Memory-mapped .safetensors file. Tensors returned by get_tensor point
+    directly into the mapping and stay valid after the file is closed."""
+
+    def __init__(self, path):
+        self._st: llaisysSafetensors_t = LIB_LLAISYS.safetensorsOpen(str(path).encode())
+        if not self._st:
+            raise RuntimeError(f"Failed to open safetensors file: {path}")
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        if getattr(self, "_st", None):
+            LIB_LLAISYS.safetensorsClose(self._st)
+            self._st = None
+
+    def keys(self) -> List[str]:
+        n = LIB_LLAISYS.safetensorsNumTensors(self._st)
+        return [LIB_LLAISYS.safetensorsTensorName(self._st, i).decode() for i in range(n)]
+
+    def get_tensor(
+        self,
+        name: str,
+        dtype: Optional[DataType] = None,
+        device: DeviceType = DeviceType.CPU,
+        device_id: int = 0,
+    ) -> Tensor:
+        """Zero-copy when dtype matches (or is None) and device is CPU;
+        floating-point tensors are converted to dtype otherwise."""
+        if dtype is None and device == DeviceType.CPU:
+            tensor = LIB_LLAISYS.safetensorsGetTensor(self._st, name.encode())
+        else:
+            tensor = LIB_LLAISYS.safetensorsGetTensorAs(
+                self._st,
+                name.encode(),
+                llaisysDataType_t(DataType.INVALID if dtype is None else dtype),
+                llaisysDeviceType_t(device),
+                c_int(device_id),
+            )
+        if not tensor:
+            raise KeyError(name)
+        return Tensor(tensor=tensor)
+
+    def load_all(
+        self,
+        dtype: Optional[DataType] = None,
+        device: DeviceType = DeviceType.CPU,
+        device_id: int = 0,
+    ) -> Tuple[Dict[str, Tensor], Dict[str, float]]:
+        """Load every tensor in parallel. Returns the tensors by name and a
+        per-phase timing breakdown (milliseconds) with byte counts. Tensors
+        identical to an earlier one share its storage (nbytes_shared)."""
+        names = self.keys()
+        handles = (llaisysTensor_t * len(names))()
+        stats = LlaisysLoadStats()
+        LIB_LLAISYS.safetensorsLoadAll(
+            self._st,
+            llaisysDataType_t(DataType.INVALID if dtype is None else dtype),
+            llaisysDeviceType_t(device),
+            c_int(device_id),
+            handles,
+            byref(stats),
+        )
+        tensors = {name: Tensor(tensor=handles[i]) for i, name in enumerate(names)}
+        return tensors, {name: getattr(stats, name) for name, _ in LlaisysLoadStats._fields_}
@@ -19,18 +19,22 @@ class Tensor:
         device: DeviceType = DeviceType.CPU,
         device_id: int = 0,
         tensor: llaisysTensor_t = None,
+        row_alignment: int = 0,
     ):
+        # row_alignment > 0 pads every row (last dimension) so that rows start
+        # on row_alignment-byte boundaries; such a tensor is not contiguous
         if tensor:
             self._tensor = tensor
         else:
             _ndim = 0 if shape is None else len(shape)
             _shape = None if shape is None else (c_size_t * len(shape))(*shape)
-            self._tensor: llaisysTensor_t = LIB_LLAISYS.tensorCreate(
+            self._tensor: llaisysTensor_t = LIB_LLAISYS.tensorCreatePadded(
                 _shape,
                 c_size_t(_ndim),
                 llaisysDataType_t(dtype),
                 llaisysDeviceType_t(device),
                 c_int(device_id),
+                c_size_t(row_alignment),
             )
 
     def __del__(self):
@@ -78,6 +82,9 @@ class Tensor:
     def is_contiguous(self) -> bool:
         return bool(LIB_LLAISYS.tensorIsContiguous(self._tensor))
 
+    def is_aligned(self, alignment: int = 64) -> bool:
+        return bool(LIB_LLAISYS.tensorIsAligned(self._tensor, c_size_t(alignment)))
+
     def view(self, *shape: int) -> llaisysTensor_t:
         _shape = (c_size_t * len(shape))(*shape)
         return Tensor(
@@ -95,3 +102,19 @@ class Tensor:
                 self._tensor, c_size_t(dim), c_size_t(start), c_size_t(end)
             )
         )
+
+    def reshape(self, *shape: int):
+        _shape = (c_size_t * len(shape))(*shape)
+        return Tensor(
+            tensor=LIB_LLAISYS.tensorReshape(self._tensor, _shape, c_size_t(len(shape)))
+        )
+
+    def contiguous(self):
+        return Tensor(tensor=LIB_LLAISYS.tensorContiguous(self._tensor))
+
+    def to(self, device: DeviceType, device_id: int = -1):
+        return Tensor(
+            tensor=LIB_LLAISYS.tensorTo(
+                self._tensor, llaisysDeviceType_t(device), c_int(device_id)
+            )
+        )
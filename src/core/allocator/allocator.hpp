@@ -5,6 +5,18 @@
 #include "../storage/storage.hpp"
 
 namespace llaisys::core {
+// 分配器统计，字节数按分配器实际占用的块大小计
+struct AllocatorStats {
+    size_t allocated_bytes = 0;      // 正在被 Storage 使用的字节
+    size_t reserved_bytes = 0;       // 已向设备申请、尚未归还的字节（含缓存）
+    size_t peak_allocated_bytes = 0;
+    size_t peak_reserved_bytes = 0;
+    size_t num_allocs = 0;           // allocate 次数
+    size_t num_frees = 0;            // release 次数
+    size_t num_device_allocs = 0;    // malloc_device 次数
+    size_t num_device_frees = 0;     // free_device 次数
+};
+
 class MemoryAllocator {
 protected:
     const LlaisysRuntimeAPI *_api;
@@ -14,6 +26,11 @@ public:
     virtual ~MemoryAllocator() = default;
     virtual std::byte *allocate(size_t size) = 0;
     virtual void release(std::byte *memory) = 0;
+    // 把缓存中未使用的内存归还设备，不缓存的分配器无需处理
+    virtual void trim() {}
+    virtual AllocatorStats stats() const = 0;
+    // 把峰值重置为当前值
+    virtual void resetPeak() = 0;
 };
 
 } // namespace llaisys::core
@@ -0,0 +1,166 @@
+#include "caching_allocator.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+
+namespace llaisys::core::allocators {
+namespace {
+size_t round_up(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+} // namespace
+
+CachingAllocator::CachingAllocator(const LlaisysRuntimeAPI *runtime_api) : MemoryAllocator(runtime_api) {
+}
+
+CachingAllocator::~CachingAllocator() {
+    // 仍在使用的块所在的段无法归还，只释放整段空闲的段
+    trimLocked();
+}
+
+size_t CachingAllocator::binIndex(size_t size) {
+    size_t bin = 0;
+    while (size >>= 1) {
+        bin++;
+    }
+    return bin;
+}
+
+void CachingAllocator::insertFree(Block *block) {
+    pool(block->small)[binIndex(block->size)].insert(block);
+}
+
+void CachingAllocator::eraseFree(Block *block) {
+    pool(block->small)[binIndex(block->size)].erase(block);
+}
+
+CachingAllocator::Block *CachingAllocator::findFree(bool small, size_t size) {
+    Pool &bins = pool(small);
+    Block key{nullptr, size, true, small, nullptr, nullptr};
+    for (size_t bin = binIndex(size); bin < NBINS; bin++) {
+        auto it = bins[bin].lower_bound(&key);
+        if (it != bins[bin].end()) {
+            Block *block = *it;
+            bins[bin].erase(it);
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+CachingAllocator::Block *CachingAllocator::newSegment(bool small, size_t size) {
+    std::byte *memory = static_cast<std::byte *>(_api->malloc_device(size));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    _stats.reserved_bytes += size;
+    _stats.peak_reserved_bytes = std::max(_stats.peak_reserved_bytes, _stats.reserved_bytes);
+    _stats.num_device_allocs++;
+    return new Block{memory, size, true, small, nullptr, nullptr};
+}
+
+std::byte *CachingAllocator::allocate(size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size = round_up(std::max<size_t>(size, 1), MIN_BLOCK);
+    bool small = size <= SMALL_SIZE;
+
+    Block *block = findFree(small, size);
+    if (block == nullptr) {
+        size_t segment = small ? SEGMENT_SIZE : round_up(size, SEGMENT_SIZE);
+        block = newSegment(small, segment);
+        if (block == nullptr) {
+            // 归还缓存后再试一次
+            trimLocked();
+            block = newSegment(small, segment);
+        }
+        ASSERT(block != nullptr, "caching allocator: out of device memory");
+    }
+
+    size_t remaining = block->size - size;
+    if (small ? remaining >= MIN_BLOCK : remaining > SMALL_SIZE) {
+        Block *rest = new Block{block->ptr + size, remaining, true, small, block, block->next};
+        if (block->next) {
+            block->next->prev = rest;
+        }
+        block->next = rest;
+        block->size = size;
+        insertFree(rest);
+    }
+
+    block->free = false;
+    _active[block->ptr] = block;
+    _stats.allocated_bytes += block->size;
+    _stats.peak_allocated_bytes = std::max(_stats.peak_allocated_bytes, _stats.allocated_bytes);
+    _stats.num_allocs++;
+    return block->ptr;
+}
+
+void CachingAllocator::release(std::byte *memory) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _active.find(memory);
+    ASSERT(it != _active.end(), "caching allocator: releasing memory it does not own");
+    Block *block = it->second;
+    _active.erase(it);
+    _stats.allocated_bytes -= block->size;
+    _stats.num_frees++;
+    block->free = true;
+
+    // 与地址相邻的空闲块合并
+    if (Block *next = block->next; next && next->free) {
+        eraseFree(next);
+        block->size += next->size;
+        block->next = next->next;
+        if (next->next) {
+            next->next->prev = block;
+        }
+        delete next;
+    }
+    if (Block *prev = block->prev; prev && prev->free) {
+        eraseFree(prev);
+        prev->size += block->size;
+        prev->next = block->next;
+        if (block->next) {
+            block->next->prev = prev;
+        }
+        delete block;
+        block = prev;
+    }
+    insertFree(block);
+}
+
+void CachingAllocator::trimLocked() {
+    for (Pool *bins : {&_small, &_large}) {
+        for (auto &bin : *bins) {
+            for (auto it = bin.begin(); it != bin.end();) {
+                Block *block = *it;
+                if (block->prev == nullptr && block->next == nullptr) {
+                    _api->free_device(block->ptr);
+                    _stats.reserved_bytes -= block->size;
+                    _stats.num_device_frees++;
+                    delete block;
+                    it = bin.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+}
+
+void CachingAllocator::trim() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    trimLocked();
+}
+
+AllocatorStats CachingAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void CachingAllocator::resetPeak() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.peak_allocated_bytes = _stats.allocated_bytes;
+    _stats.peak_reserved_bytes = _stats.reserved_bytes;
+}
+} // namespace llaisys::core::allocators
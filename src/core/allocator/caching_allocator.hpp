@@ -0,0 +1,70 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include <array>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::core::allocators {
+// 缓存分配器：释放的块留在按大小分级的空闲链表中，之后的请求直接复用，稳态下（如逐 token
+// 解码，每步的临时张量大小相同）不再调用 malloc_device/free_device。
+//
+// 向设备申请的一整段内存（segment）被切分为按地址相连的块：
+//     小请求（<= 1 MiB）  从 2 MiB 的段中切分，剩余 >= 512 字节就切出去
+//     大请求             段大小向上取整到 2 MiB，剩余 > 1 MiB 才切出去，避免大块被碎片化
+// 小块与大块分池。空闲块按 floor(log2(size)) 分级，级内按 (size, 地址) 有序，分配时从请求
+// 所在级开始取最小的足够大的块；释放时与地址相邻的空闲块合并。整段都空闲的段只在 trim()
+// 或设备分配失败时归还。
+class CachingAllocator : public MemoryAllocator {
+public:
+    // 块在段内的偏移都是 MIN_BLOCK 的整数倍，设备内存不超过 512 字节的对齐对每个块同样成立
+    static constexpr size_t MIN_BLOCK = 512;
+    static constexpr size_t SMALL_SIZE = size_t(1) << 20;
+    static constexpr size_t SEGMENT_SIZE = size_t(2) << 20;
+
+private:
+    struct Block {
+        std::byte *ptr;
+        size_t size;
+        bool free;
+        bool small;
+        Block *prev; // 同一段中地址相邻的块
+        Block *next;
+    };
+
+    struct BlockLess {
+        bool operator()(const Block *a, const Block *b) const {
+            return a->size != b->size ? a->size < b->size : a->ptr < b->ptr;
+        }
+    };
+
+    static constexpr size_t NBINS = 64;
+    using Pool = std::array<std::set<Block *, BlockLess>, NBINS>;
+
+    mutable std::mutex _mutex;
+    Pool _small;
+    Pool _large;
+    std::unordered_map<std::byte *, Block *> _active;
+    AllocatorStats _stats;
+
+    static size_t binIndex(size_t size);
+    Pool &pool(bool small) { return small ? _small : _large; }
+    Block *findFree(bool small, size_t size);
+    Block *newSegment(bool small, size_t size);
+    void insertFree(Block *block);
+    void eraseFree(Block *block);
+    void trimLocked();
+
+public:
+    CachingAllocator(const LlaisysRuntimeAPI *runtime_api);
+    ~CachingAllocator();
+    std::byte *allocate(size_t size) override;
+    void release(std::byte *memory) override;
+    void trim() override;
+    AllocatorStats stats() const override;
+    void resetPeak() override;
+};
+} // namespace llaisys::core::allocators
@@ -0,0 +1,39 @@
+#include "memory_tracker.hpp"
+
+#include <algorithm>
+
+namespace llaisys::core {
+void MemoryTracker::allocate(llaisysMemoryCategory_t category, size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &c = _categories[category];
+    c.in_use_bytes += size;
+    c.peak_bytes = std::max(c.peak_bytes, c.in_use_bytes);
+    c.total_allocated_bytes += size;
+    c.num_allocs++;
+    _in_use += size;
+    _peak = std::max(_peak, _in_use);
+}
+
+void MemoryTracker::release(llaisysMemoryCategory_t category, size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &c = _categories[category];
+    c.in_use_bytes -= size;
+    c.num_frees++;
+    _in_use -= size;
+}
+
+void MemoryTracker::stats(LlaisysMemoryStats &stats) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::copy(std::begin(_categories), std::end(_categories), std::begin(stats.categories));
+    stats.in_use_bytes = _in_use;
+    stats.peak_bytes = _peak;
+}
+
+void MemoryTracker::resetPeak() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &c : _categories) {
+        c.peak_bytes = c.in_use_bytes;
+    }
+    _peak = _in_use;
+}
+} // namespace llaisys::core
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "llaisys/runtime.h"
+
+#include <cstddef>
+#include <mutex>
+
+namespace llaisys::core {
+// Runtime 上按用途（llaisysMemoryCategory_t）分类的内存用量。记录的是 Storage、arena
+// slab 与 workspace 请求的字节数，与分配器按块计的统计互为补充：两者之差即取整与缓存
+class MemoryTracker {
+private:
+    mutable std::mutex _mutex;
+    LlaisysMemoryCategoryStats _categories[LLAISYS_MEMORY_CATEGORY_COUNT] = {};
+    size_t _in_use = 0;
+    size_t _peak = 0;
+
+public:
+    void allocate(llaisysMemoryCategory_t category, size_t size);
+    void release(llaisysMemoryCategory_t category, size_t size);
+
+    // 填写 stats 中的各类别与总量，分配器相关的字段由 Runtime 填写
+    void stats(LlaisysMemoryStats &stats) const;
+    void resetPeak();
+};
+} // namespace llaisys::core
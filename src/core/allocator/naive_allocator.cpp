@@ -2,15 +2,46 @@
 
 #include "../runtime/runtime.hpp"
 
+#include <algorithm>
+
 namespace llaisys::core::allocators {
 NaiveAllocator::NaiveAllocator(const LlaisysRuntimeAPI *runtime_api) : MemoryAllocator(runtime_api) {
 }
 
 std::byte *NaiveAllocator::allocate(size_t size) {
-    return static_cast<std::byte *>(_api->malloc_device(size));
+    std::byte *memory = static_cast<std::byte *>(_api->malloc_device(size));
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sizes[memory] = size;
+    _stats.allocated_bytes += size;
+    _stats.reserved_bytes += size;
+    _stats.peak_allocated_bytes = std::max(_stats.peak_allocated_bytes, _stats.allocated_bytes);
+    _stats.peak_reserved_bytes = std::max(_stats.peak_reserved_bytes, _stats.reserved_bytes);
+    _stats.num_allocs++;
+    _stats.num_device_allocs++;
+    return memory;
 }
 
 void NaiveAllocator::release(std::byte *memory) {
     _api->free_device(memory);
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _sizes.find(memory);
+    if (it != _sizes.end()) {
+        _stats.allocated_bytes -= it->second;
+        _stats.reserved_bytes -= it->second;
+        _sizes.erase(it);
+    }
+    _stats.num_frees++;
+    _stats.num_device_frees++;
+}
+
+AllocatorStats NaiveAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void NaiveAllocator::resetPeak() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.peak_allocated_bytes = _stats.allocated_bytes;
+    _stats.peak_reserved_bytes = _stats.reserved_bytes;
 }
-} // namespace llaisys::core::allocators
\ No newline at end of file
+} // namespace llaisys::core::allocators
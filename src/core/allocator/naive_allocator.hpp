@@ -2,12 +2,23 @@
 
 #include "allocator.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace llaisys::core::allocators {
+// 每次分配、释放都直接调用 malloc_device/free_device
 class NaiveAllocator : public MemoryAllocator {
+private:
+    mutable std::mutex _mutex;
+    std::unordered_map<std::byte *, size_t> _sizes;
+    AllocatorStats _stats;
+
 public:
     NaiveAllocator(const LlaisysRuntimeAPI *runtime_api);
     ~NaiveAllocator() = default;
     std::byte *allocate(size_t size) override;
     void release(std::byte *memory) override;
+    AllocatorStats stats() const override;
+    void resetPeak() override;
 };
-} // namespace llaisys::core::allocators
\ No newline at end of file
+} // namespace llaisys::core::allocators
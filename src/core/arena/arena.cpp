@@ -0,0 +1,95 @@
+#include "arena.hpp"
+
+#include "../runtime/runtime.hpp"
+#include "../storage/storage.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace llaisys::core {
+namespace {
+size_t align_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+size_t planArena(const std::vector<BufferLifetime> &buffers, std::vector<size_t> &offsets, size_t alignment) {
+    CHECK_ARGUMENT(alignment > 0 && (alignment & (alignment - 1)) == 0, "planArena: alignment must be a power of two");
+    for (const auto &b : buffers) {
+        CHECK_ARGUMENT(b.first <= b.last, "planArena: buffer used after its last step");
+    }
+    std::vector<size_t> order(buffers.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buffers[a].size > buffers[b].size; });
+
+    offsets.assign(buffers.size(), 0);
+    std::vector<size_t> placed; // 按偏移排序
+    size_t total = 0;
+    for (size_t i : order) {
+        const BufferLifetime &b = buffers[i];
+        size_t size = align_up(b.size, alignment);
+        // 在与 b 同时存活的已放置缓冲之间找最小的足够大的空隙
+        size_t best = SIZE_MAX, best_gap = SIZE_MAX, end = 0;
+        for (size_t j : placed) {
+            const BufferLifetime &p = buffers[j];
+            if (p.last < b.first || b.last < p.first) {
+                continue;
+            }
+            if (offsets[j] >= end) {
+                size_t gap = offsets[j] - end;
+                if (gap >= size && gap < best_gap) {
+                    best = end;
+                    best_gap = gap;
+                }
+            }
+            end = std::max(end, offsets[j] + align_up(p.size, alignment));
+        }
+        offsets[i] = best != SIZE_MAX ? best : end;
+        total = std::max(total, offsets[i] + size);
+        placed.insert(std::upper_bound(placed.begin(), placed.end(), offsets[i],
+                                       [&](size_t off, size_t j) { return off < offsets[j]; }),
+                      i);
+    }
+    return total;
+}
+
+Arena::Arena(Runtime &runtime) : _runtime(runtime) {}
+
+size_t Arena::capacity() const {
+    return _slab ? _slab->size() - _base : 0;
+}
+
+void Arena::reserve(size_t size) {
+    if (size > capacity()) {
+        MemoryCategoryScope scope(_runtime, LLAISYS_MEMORY_ACTIVATION);
+        _slab = _runtime.allocateDeviceStorage(size + SLAB_ALIGNMENT);
+        auto addr = reinterpret_cast<uintptr_t>(_slab->memory());
+        _base = align_up(addr, SLAB_ALIGNMENT) - addr;
+    }
+}
+
+void Arena::reset() {
+    // 上一步中途换过 slab 时，换成一块能容下整步的 slab
+    reserve(_peak);
+    _top = 0;
+    _used = 0;
+}
+
+size_t Arena::allocate(size_t size, size_t alignment) {
+    CHECK_ARGUMENT(alignment > 0 && (alignment & (alignment - 1)) == 0, "arena: alignment must be a power of two");
+    size_t offset = align_up(_top, alignment);
+    if (offset + size > capacity()) {
+        // 本步剩余的请求从新 slab 的开头分配
+        reserve(std::max(capacity() * 2, _used + size + alignment));
+        offset = 0;
+        _top = 0;
+    }
+    _used += offset - _top + size;
+    _top = offset + size;
+    _peak = std::max(_peak, _used);
+    return offset;
+}
+} // namespace llaisys::core
@@ -0,0 +1,53 @@
+#pragma once
+#include "../core.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace llaisys::core {
+// 一个缓冲在第 first 到第 last 步（含两端）之间被使用
+struct BufferLifetime {
+    size_t size;
+    size_t first;
+    size_t last;
+};
+
+// 为一组生命周期已知的缓冲（如一次前向中的激活）在同一块内存中分配偏移，生命周期不重叠的
+// 缓冲共用地址。按大小从大到小放置，每个缓冲放进与其生命周期重叠的已放置缓冲之间最小的
+// 可用空隙（best fit），没有时接在它们之后。偏移按 alignment 对齐，返回所需的总字节数
+size_t planArena(const std::vector<BufferLifetime> &buffers, std::vector<size_t> &offsets, size_t alignment = 64);
+
+// 附着在 Runtime 上、每步复用的一块 slab。每步开始 reset()，之后 allocate() 只移动指针，
+// 或按 planArena 给出的偏移直接取用。容量不足时换一块更大的 slab（已取出的张量继续持有
+// 旧 slab），下一次 reset() 时 slab 扩到能容下各步用量的峰值，此后不再向分配器申请内存。
+// 偏移都相对于 slab 中第一个按 SLAB_ALIGNMENT 对齐的字节（base()），分配器返回的地址
+// 不一定满足该对齐
+class Arena {
+public:
+    static constexpr size_t SLAB_ALIGNMENT = 64;
+
+private:
+    Runtime &_runtime;
+    storage_t _slab;
+    size_t _base = 0;
+    size_t _top = 0;  // 当前 slab 中的下一个空闲偏移
+    size_t _used = 0; // 本步累计使用的字节（含对齐空隙与换 slab 前的部分）
+    size_t _peak = 0;
+
+public:
+    explicit Arena(Runtime &runtime);
+
+    // 保证容量至少为 size，不改变已分配的偏移
+    void reserve(size_t size);
+    void reset();
+    // 返回 storage() 中按 alignment 对齐的偏移，可能更换 storage()
+    size_t allocate(size_t size, size_t alignment = 64);
+
+    const storage_t &storage() const { return _slab; }
+    // 偏移 0 在 storage() 中的位置
+    size_t base() const { return _base; }
+    size_t capacity() const;
+    size_t used() const { return _used; }
+    size_t peak() const { return _peak; }
+};
+} // namespace llaisys::core
@@ -1,8 +1,44 @@
 #include "context.hpp"
 #include "../../utils.hpp"
+#include <atomic>
+#include <mutex>
 #include <thread>
 
 namespace llaisys::core {
+namespace {
+std::atomic<bool> runtime_sharing{false};
+} // namespace
+
+void setRuntimeSharing(bool enable) {
+    runtime_sharing.store(enable);
+}
+
+bool runtimeSharing() {
+    return runtime_sharing.load();
+}
+
+// 线程退出顺序不定，有线程仍可能持有共享 Runtime 的 Storage，故不析构
+Runtime *Context::sharedRuntime(llaisysDeviceType_t device_type, int device_id) {
+    static std::mutex mutex;
+    static auto *runtimes = new std::unordered_map<llaisysDeviceType_t, std::vector<Runtime *>>();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &slots = (*runtimes)[device_type];
+    if (slots.empty()) {
+        slots.resize(llaisysGetRuntimeAPI(device_type)->get_device_count(), nullptr);
+    }
+    CHECK_ARGUMENT((size_t)device_id < slots.size() && device_id >= 0, "invalid device id");
+    if (slots[device_id] == nullptr) {
+        slots[device_id] = new Runtime(device_type, device_id, true);
+    }
+    return slots[device_id];
+}
+
+Runtime *Context::newRuntime(llaisysDeviceType_t device_type, int device_id) {
+    if (runtime_sharing.load()) {
+        return sharedRuntime(device_type, device_id);
+    }
+    return new Runtime(device_type, device_id);
+}
 
 Context::Context() {
     // All device types, put CPU at the end
@@ -21,7 +57,7 @@ Context::Context() {
         for (int device_id = 0; device_id < device_count; device_id++) {
 
             if (_current_runtime == nullptr) {
-                auto runtime = new Runtime(device_type, device_id);
+                auto runtime = newRuntime(device_type, device_id);
                 runtime->_activate();
                 runtimes_[device_id] = runtime;
                 _current_runtime = runtime;
@@ -32,13 +68,15 @@ Context::Context() {
 }
 
 Context::~Context() {
-    // Destroy current runtime first.
-    delete _current_runtime;
+    // Destroy current runtime first. Shared runtimes outlive every context.
+    if (_current_runtime != nullptr && !_current_runtime->isShared()) {
+        delete _current_runtime;
+    }
 
     for (auto &runtime_entry : _runtime_map) {
         std::vector<Runtime *> runtimes = runtime_entry.second;
         for (auto runtime : runtimes) {
-            if (runtime != nullptr && runtime != _current_runtime) {
+            if (runtime != nullptr && runtime != _current_runtime && !runtime->isShared()) {
                 runtime->_activate();
                 delete runtime;
             }
@@ -52,17 +90,22 @@ Context::~Context() {
 void Context::setDevice(llaisysDeviceType_t device_type, int device_id) {
     // If doest not match the current runtime.
     if (_current_runtime == nullptr || _current_runtime->deviceType() != device_type || _current_runtime->deviceId() != device_id) {
-        auto runtimes = _runtime_map[device_type];
-        CHECK_ARGUMENT((size_t)device_id < runtimes.size() && device_id >= 0, "invalid device id");
+        Runtime &runtime = this->runtime(device_type, device_id);
         if (_current_runtime != nullptr) {
             _current_runtime->_deactivate();
         }
-        if (runtimes[device_id] == nullptr) {
-            runtimes[device_id] = new Runtime(device_type, device_id);
-        }
-        runtimes[device_id]->_activate();
-        _current_runtime = runtimes[device_id];
+        runtime._activate();
+        _current_runtime = &runtime;
+    }
+}
+
+Runtime &Context::runtime(llaisysDeviceType_t device_type, int device_id) {
+    auto &runtimes = _runtime_map[device_type];
+    CHECK_ARGUMENT((size_t)device_id < runtimes.size() && device_id >= 0, "invalid device id");
+    if (runtimes[device_id] == nullptr) {
+        runtimes[device_id] = newRuntime(device_type, device_id);
     }
+    return *runtimes[device_id];
 }
 
 Runtime &Context::runtime() {
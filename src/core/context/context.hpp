@@ -15,6 +15,10 @@ private:
     std::unordered_map<llaisysDeviceType_t, std::vector<Runtime *>> _runtime_map;
     Runtime *_current_runtime;
     Context();
+    // 进程内每个设备共享的 Runtime，按需创建
+    static Runtime *sharedRuntime(llaisysDeviceType_t device_type, int device_id);
+    // 按当前模式新建本线程的 Runtime 或取共享的 Runtime
+    static Runtime *newRuntime(llaisysDeviceType_t device_type, int device_id);
 
 public:
     ~Context();
@@ -29,7 +33,13 @@ public:
 
     void setDevice(llaisysDeviceType_t device_type, int device_id);
     Runtime &runtime();
+    // 指定设备的 Runtime，不切换当前设备（如 CPU 核函数取 CPU Runtime 的 workspace）
+    Runtime &runtime(llaisysDeviceType_t device_type, int device_id);
 
     friend Context &context();
 };
+
+// 开启后各线程之后取用的 Runtime 为进程内每个设备共享的一个，见 llaisysSetRuntimeSharing
+void setRuntimeSharing(bool enable);
+bool runtimeSharing();
 } // namespace llaisys::core
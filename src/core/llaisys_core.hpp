@@ -4,6 +4,8 @@
 
 #include "core.hpp"
 
+#include "arena/arena.hpp"
 #include "context/context.hpp"
 #include "runtime/runtime.hpp"
 #include "storage/storage.hpp"
+#include "workspace/workspace.hpp"
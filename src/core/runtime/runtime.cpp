@@ -1,23 +1,48 @@
 #include "runtime.hpp"
 
 #include "../../device/runtime_api.hpp"
+#include "../../utils.hpp"
+#include "../allocator/caching_allocator.hpp"
 #include "../allocator/naive_allocator.hpp"
 
+#include <unordered_map>
+
 namespace llaisys::core {
-Runtime::Runtime(llaisysDeviceType_t device_type, int device_id)
-    : _device_type(device_type), _device_id(device_id), _is_active(false) {
+Runtime::Local::Local(Runtime &runtime) : runtime(runtime) {
+    stream = runtime._api->create_stream();
+}
+
+Runtime::Local::~Local() {
+    // slab 由分配器释放，先于流销毁并交还分配器
+    arena.reset();
+    workspace.reset();
+    runtime._api->destroy_stream(stream);
+}
+
+Runtime::Runtime(llaisysDeviceType_t device_type, int device_id, bool shared)
+    : _device_type(device_type), _device_id(device_id), _shared(shared), _is_active(false) {
     _api = llaisys::device::getRuntimeAPI(_device_type);
-    _stream = _api->create_stream();
-    _allocator = new allocators::NaiveAllocator(_api);
+    _allocator = new allocators::CachingAllocator(_api);
+    _allocator_type = LLAISYS_ALLOCATOR_CACHING;
+    if (_shared) {
+        // 共享的 Runtime 不随线程切换，一直可用
+        _is_active = true;
+    } else {
+        _local = std::make_unique<Local>(*this);
+    }
 }
 
 Runtime::~Runtime() {
     if (!_is_active) {
         std::cerr << "Mallicious destruction of inactive runtime." << std::endl;
     }
-    delete _allocator;
+    _local.reset();
+    delete _allocator.load();
     _allocator = nullptr;
-    _api->destroy_stream(_stream);
+    for (auto *allocator : _retired_allocators) {
+        delete allocator;
+    }
+    _retired_allocators.clear();
     _api = nullptr;
 }
 
@@ -27,7 +52,26 @@ void Runtime::_activate() {
 }
 
 void Runtime::_deactivate() {
-    _is_active = false;
+    if (!_shared) {
+        _is_active = false;
+    }
+}
+
+Runtime::Local &Runtime::local() {
+    if (!_shared) {
+        return *_local;
+    }
+    // 共享的 Runtime 进程内不析构，线程退出时销毁本线程的部分即可
+    thread_local std::unordered_map<const Runtime *, std::unique_ptr<Local>> locals;
+    auto &entry = locals[this];
+    if (!entry) {
+        entry = std::make_unique<Local>(*this);
+    }
+    return *entry;
+}
+
+bool Runtime::isShared() const {
+    return _shared;
 }
 
 bool Runtime::isActive() const {
@@ -46,28 +90,142 @@ const LlaisysRuntimeAPI *Runtime::api() const {
     return _api;
 }
 
+void Runtime::setAllocator(llaisysAllocatorType_t type) {
+    std::lock_guard<std::mutex> lock(_allocator_mutex);
+    if (type == _allocator_type) {
+        return;
+    }
+    MemoryAllocator *allocator = nullptr;
+    switch (type) {
+    case LLAISYS_ALLOCATOR_NAIVE:
+        allocator = new allocators::NaiveAllocator(_api);
+        break;
+    case LLAISYS_ALLOCATOR_CACHING:
+        allocator = new allocators::CachingAllocator(_api);
+        break;
+    default:
+        CHECK_ARGUMENT(false, "unknown allocator type");
+    }
+    MemoryAllocator *previous = _allocator.exchange(allocator);
+    previous->trim();
+    _retired_allocators.push_back(previous);
+    _allocator_type = type;
+}
+
+llaisysAllocatorType_t Runtime::allocatorType() const {
+    std::lock_guard<std::mutex> lock(_allocator_mutex);
+    return _allocator_type;
+}
+
+MemoryAllocator &Runtime::allocator() {
+    return *_allocator;
+}
+
+Arena &Runtime::arena() {
+    Local &l = local();
+    if (!l.arena) {
+        l.arena = std::make_unique<Arena>(*this);
+    }
+    return *l.arena;
+}
+
+Workspace &Runtime::workspace() {
+    Local &l = local();
+    if (!l.workspace) {
+        l.workspace = std::make_unique<Workspace>(*this);
+    }
+    return *l.workspace;
+}
+
+llaisysMemoryCategory_t Runtime::setMemoryCategory(llaisysMemoryCategory_t category) {
+    CHECK_ARGUMENT(category >= 0 && category < LLAISYS_MEMORY_CATEGORY_COUNT, "unknown memory category");
+    Local &l = local();
+    llaisysMemoryCategory_t previous = l.memory_category;
+    l.memory_category = category;
+    return previous;
+}
+
+llaisysMemoryCategory_t Runtime::memoryCategory() {
+    return local().memory_category;
+}
+
+MemoryTracker &Runtime::memoryTracker() {
+    return _memory_tracker;
+}
+
+LlaisysMemoryStats Runtime::memoryStats() const {
+    LlaisysMemoryStats stats{};
+    _memory_tracker.stats(stats);
+    auto add = [&](const MemoryAllocator *allocator) {
+        AllocatorStats s = allocator->stats();
+        stats.reserved_bytes += s.reserved_bytes;
+        stats.peak_reserved_bytes += s.peak_reserved_bytes;
+        stats.cached_bytes += s.reserved_bytes - s.allocated_bytes;
+    };
+    std::lock_guard<std::mutex> lock(_allocator_mutex);
+    add(_allocator.load());
+    for (auto *allocator : _retired_allocators) {
+        add(allocator);
+    }
+    return stats;
+}
+
+void Runtime::resetPeakMemoryStats() {
+    _memory_tracker.resetPeak();
+    std::lock_guard<std::mutex> lock(_allocator_mutex);
+    _allocator.load()->resetPeak();
+    for (auto *allocator : _retired_allocators) {
+        allocator->resetPeak();
+    }
+}
+
 storage_t Runtime::allocateDeviceStorage(size_t size) {
-    return std::shared_ptr<Storage>(new Storage(_allocator->allocate(size), size, *this, false));
+    llaisysMemoryCategory_t category = memoryCategory();
+    MemoryAllocator *allocator = _allocator.load();
+    auto *storage = new Storage(allocator->allocate(size), size, *this, false, category);
+    storage->_allocator = allocator;
+    _memory_tracker.allocate(category, size);
+    return std::shared_ptr<Storage>(storage);
 }
 
 storage_t Runtime::allocateHostStorage(size_t size) {
-    return std::shared_ptr<Storage>(new Storage((std::byte *)_api->malloc_host(size), size, *this, true));
+    llaisysMemoryCategory_t category = memoryCategory();
+    auto *storage = new Storage((std::byte *)_api->malloc_host(size), size, *this, true, category);
+    _memory_tracker.allocate(category, size);
+    return std::shared_ptr<Storage>(storage);
+}
+
+storage_t Runtime::wrapHostStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner) {
+    llaisysMemoryCategory_t category = memoryCategory();
+    auto *storage = new Storage(memory, size, *this, true, category, std::move(owner));
+    _memory_tracker.allocate(category, size);
+    return std::shared_ptr<Storage>(storage);
 }
 
 void Runtime::freeStorage(Storage *storage) {
+    _memory_tracker.release(storage->_category, storage->size());
+    if (storage->_owner) {
+        // 内存由 owner 释放
+        return;
+    }
     if (storage->isHost()) {
         _api->free_host(storage->memory());
     } else {
-        _allocator->release(storage->memory());
+        MemoryAllocator *allocator = storage->_allocator;
+        allocator->release(storage->memory());
+        if (allocator != _allocator.load()) {
+            // 已被替换的分配器不再复用缓存
+            allocator->trim();
+        }
     }
 }
 
-llaisysStream_t Runtime::stream() const {
-    return _stream;
+llaisysStream_t Runtime::stream() {
+    return local().stream;
 }
 
-void Runtime::synchronize() const {
-    _api->stream_synchronize(_stream);
+void Runtime::synchronize() {
+    _api->stream_synchronize(local().stream);
 }
 
 } // namespace llaisys::core
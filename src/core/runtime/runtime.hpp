@@ -3,19 +3,51 @@
 
 #include "../../device/runtime_api.hpp"
 #include "../allocator/allocator.hpp"
+#include "../allocator/memory_tracker.hpp"
+#include "../arena/arena.hpp"
+#include "../workspace/workspace.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace llaisys::core {
+// 设备的运行时：分配器、内存统计，以及每个线程各自的流、arena、核函数 scratch 和内存类别。
+// 默认每个线程的 Context 有自己的 Runtime；共享模式（见 setRuntimeSharing）下进程内每个
+// 设备只有一个 Runtime，分配器缓存与统计为所有线程共用，每线程的部分按线程分开
 class Runtime {
 private:
+    // 只属于一个线程的部分
+    struct Local {
+        Runtime &runtime;
+        llaisysStream_t stream;
+        std::unique_ptr<Arena> arena;
+        std::unique_ptr<Workspace> workspace;
+        llaisysMemoryCategory_t memory_category = LLAISYS_MEMORY_OTHER;
+
+        explicit Local(Runtime &runtime);
+        ~Local();
+    };
+
     llaisysDeviceType_t _device_type;
     int _device_id;
     const LlaisysRuntimeAPI *_api;
-    MemoryAllocator *_allocator;
+    bool _shared;
+    // 切换分配器与读取已替换的分配器时持有
+    mutable std::mutex _allocator_mutex;
+    std::atomic<MemoryAllocator *> _allocator;
+    llaisysAllocatorType_t _allocator_type;
+    // 切换前的分配器，仍有 Storage 从中分配，Runtime 析构时才删除
+    std::vector<MemoryAllocator *> _retired_allocators;
     bool _is_active;
     void _activate();
     void _deactivate();
-    llaisysStream_t _stream;
-    Runtime(llaisysDeviceType_t device_type, int device_id);
+    MemoryTracker _memory_tracker;
+    // 非共享的 Runtime 只有这一份；共享的 Runtime 每个线程一份，见 local()
+    std::unique_ptr<Local> _local;
+    Runtime(llaisysDeviceType_t device_type, int device_id, bool shared = false);
+
+    Local &local();
 
 public:
     friend class Context;
@@ -33,15 +65,53 @@ public:
     llaisysDeviceType_t deviceType() const;
     int deviceId() const;
     bool isActive() const;
+    // 进程内共享的 Runtime
+    bool isShared() const;
 
     const LlaisysRuntimeAPI *api() const;
 
+    // 设备内存分配器，默认为缓存分配器。切换后已有的 Storage 仍由原分配器释放，
+    // 原分配器的缓存立即归还
+    void setAllocator(llaisysAllocatorType_t type);
+    llaisysAllocatorType_t allocatorType() const;
+    MemoryAllocator &allocator();
+    // 每步复用的激活内存，见 arena.hpp；共享时每个线程一份
+    Arena &arena();
+    // CPU 核函数的 scratch，见 workspace.hpp；共享时每个线程一份
+    Workspace &workspace();
+
+    // 本线程之后的分配记入的内存类别，返回原来的类别
+    llaisysMemoryCategory_t setMemoryCategory(llaisysMemoryCategory_t category);
+    llaisysMemoryCategory_t memoryCategory();
+    MemoryTracker &memoryTracker();
+    // 各类别的用量以及所有分配器（含已替换的）的缓存
+    LlaisysMemoryStats memoryStats() const;
+    void resetPeakMemoryStats();
+
     storage_t allocateDeviceStorage(size_t size);
-    ;
     storage_t allocateHostStorage(size_t size);
+    // 把外部主机内存包装为 Storage，不拷贝；owner 保证内存在所有引用释放前有效
+    storage_t wrapHostStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner);
     void freeStorage(Storage *storage);
 
-    llaisysStream_t stream() const;
-    void synchronize() const;
+    // 本线程的流
+    llaisysStream_t stream();
+    void synchronize();
+};
+
+// 作用域内 Runtime 的分配记入 category，退出时恢复原来的类别：
+//     MemoryCategoryScope scope(runtime, LLAISYS_MEMORY_WEIGHTS);
+class MemoryCategoryScope {
+private:
+    Runtime &_runtime;
+    llaisysMemoryCategory_t _previous;
+
+public:
+    MemoryCategoryScope(Runtime &runtime, llaisysMemoryCategory_t category)
+        : _runtime(runtime), _previous(runtime.setMemoryCategory(category)) {}
+    ~MemoryCategoryScope() { _runtime.setMemoryCategory(_previous); }
+
+    MemoryCategoryScope(const MemoryCategoryScope &) = delete;
+    MemoryCategoryScope &operator=(const MemoryCategoryScope &) = delete;
 };
 } // namespace llaisys::core
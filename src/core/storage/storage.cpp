@@ -3,8 +3,9 @@
 #include "../runtime/runtime.hpp"
 
 namespace llaisys::core {
-Storage::Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host)
-    : _memory(memory), _size(size), _runtime(runtime), _is_host(is_host) {}
+Storage::Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host, llaisysMemoryCategory_t category,
+                 std::shared_ptr<void> owner)
+    : _memory(memory), _size(size), _runtime(runtime), _is_host(is_host), _owner(std::move(owner)), _category(category) {}
 
 Storage::~Storage() {
     _runtime.freeStorage(this);
@@ -1,5 +1,6 @@
 #pragma once
 #include "llaisys.h"
+#include "llaisys/runtime.h"
 
 #include "../core.hpp"
 
@@ -12,7 +13,14 @@ private:
     size_t _size;
     Runtime &_runtime;
     bool _is_host;
-    Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host);
+    // 非空时内存由 owner 持有（如文件映射），析构时不经过 Runtime 释放
+    std::shared_ptr<void> _owner;
+    // 设备内存来自的分配器，Runtime 切换分配器后仍由它释放
+    MemoryAllocator *_allocator = nullptr;
+    // 分配时 Runtime 的内存类别，释放时从该类别的用量中扣除
+    llaisysMemoryCategory_t _category;
+    Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host, llaisysMemoryCategory_t category,
+            std::shared_ptr<void> owner = nullptr);
 
 public:
     friend class Runtime;
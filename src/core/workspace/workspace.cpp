@@ -0,0 +1,70 @@
+#include "workspace.hpp"
+
+#include "../runtime/runtime.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+
+namespace llaisys::core {
+Workspace::Workspace(Runtime &runtime) : _runtime(runtime) {}
+
+Workspace::~Workspace() {
+    release();
+}
+
+void Workspace::grow(Buffer &buffer, size_t size) {
+    if (size <= buffer.size) {
+        return;
+    }
+    // 按 2 倍增长，长度逐步变化的调用（如解码中的 kvlen）不会每次重新分配
+    size = std::max(size, buffer.size * 2);
+    releaseBuffer(buffer);
+    buffer.data = static_cast<std::byte *>(_runtime.api()->malloc_host(size));
+    ASSERT(buffer.data != nullptr, "workspace: out of host memory");
+    buffer.size = size;
+    _runtime.memoryTracker().allocate(LLAISYS_MEMORY_SCRATCH, size);
+}
+
+void Workspace::releaseBuffer(Buffer &buffer) {
+    if (buffer.data != nullptr) {
+        _runtime.api()->free_host(buffer.data);
+        _runtime.memoryTracker().release(LLAISYS_MEMORY_SCRATCH, buffer.size);
+    }
+    buffer = Buffer{};
+}
+
+void Workspace::reserve(size_t nworkers, size_t size) {
+    if (_workers.size() < nworkers) {
+        _workers.resize(nworkers);
+    }
+    for (size_t i = 0; i < nworkers; i++) {
+        grow(_workers[i], size);
+    }
+}
+
+std::byte *Workspace::worker(size_t worker) const {
+    return _workers[worker].data;
+}
+
+std::byte *Workspace::shared(size_t size) {
+    grow(_shared, size);
+    return _shared.data;
+}
+
+size_t Workspace::size() const {
+    size_t total = _shared.size;
+    for (const auto &buffer : _workers) {
+        total += buffer.size;
+    }
+    return total;
+}
+
+void Workspace::release() {
+    for (auto &buffer : _workers) {
+        releaseBuffer(buffer);
+    }
+    _workers.clear();
+    releaseBuffer(_shared);
+}
+} // namespace llaisys::core
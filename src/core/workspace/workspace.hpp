@@ -0,0 +1,67 @@
+#pragma once
+#include "../core.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace llaisys::core {
+// 附着在 Runtime 上、供 CPU 核函数使用的 scratch 内存，按需增长、跨调用复用。
+// 核函数在并行区之前 reserve，并行区内各线程用 worker(线程号) 取自己的一块，不再分配：
+//     ws.reserve(omp_get_max_threads(), Workspace::bytes<float>(n));
+//     #pragma omp parallel
+//     {
+//         std::byte *p = ws.worker(omp_get_thread_num());
+//         float *buf = Workspace::take<float>(p, n);
+//     }
+// 内容在调用之间不保留。同一 Runtime 上同一时刻只能有一个核函数使用
+class Workspace {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    // n 个 T 占用的字节数（按 ALIGNMENT 取整），多个数组的 bytes 之和即 reserve 的大小
+    template <typename T>
+    static size_t bytes(size_t n) {
+        return (n * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // 从 p 处切出 n 个 T，p 前移 bytes<T>(n)
+    template <typename T>
+    static T *take(std::byte *&p, size_t n) {
+        T *out = reinterpret_cast<T *>(p);
+        p += bytes<T>(n);
+        return out;
+    }
+
+private:
+    struct Buffer {
+        std::byte *data = nullptr;
+        size_t size = 0;
+    };
+
+    Runtime &_runtime;
+    std::vector<Buffer> _workers;
+    Buffer _shared;
+
+    void grow(Buffer &buffer, size_t size);
+    void releaseBuffer(Buffer &buffer);
+
+public:
+    explicit Workspace(Runtime &runtime);
+    ~Workspace();
+
+    Workspace(const Workspace &) = delete;
+    Workspace &operator=(const Workspace &) = delete;
+
+    // 保证 0 .. nworkers-1 号线程的 scratch 各至少 size 字节
+    void reserve(size_t nworkers, size_t size);
+    // 第 worker 号线程的 scratch，不分配，可在并行区内调用
+    std::byte *worker(size_t worker) const;
+    // 整个调用共用的 scratch（如量化后的激活），至少 size 字节，在并行区之外取
+    std::byte *shared(size_t size);
+
+    // 所有 scratch 的总字节数
+    size_t size() const;
+    // 归还全部 scratch
+    void release();
+};
+} // namespace llaisys::core
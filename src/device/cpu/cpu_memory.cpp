@@ -0,0 +1,359 @@
+#include "cpu_memory.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <fstream>
+#include <sched.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/mempolicy.h>
+#endif
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace llaisys::device::cpu {
+namespace {
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+// 选项的只读快照：allocate 无锁读取当前快照，setMemoryOptions 发布新快照。旧快照可能
+// 仍被并发的 allocate 读取，不释放（设置选项很少发生；进程退出时的分配也能安全读取）
+const LlaisysHostMemoryOptions default_options{LLAISYS_HUGE_PAGES_TRANSPARENT, LLAISYS_NUMA_DEFAULT, 0,
+                                               HUGE_PAGE_SIZE, 64};
+std::atomic<const LlaisysHostMemoryOptions *> current_options{&default_options};
+
+size_t align_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+#if defined(__linux__)
+// mmap 得到的区域及其长度，free 时据此 munmap。按地址分片加锁，不同线程的释放互不阻塞；
+// 没有区域时释放不查表
+class Regions {
+private:
+    static constexpr size_t SHARDS = 16;
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<void *, size_t> lengths;
+    };
+    std::array<Shard, SHARDS> _shards;
+    std::atomic<size_t> _count{0};
+
+    Shard &shard(void *addr) {
+        // 区域按页对齐，低 12 位总为 0
+        return _shards[(reinterpret_cast<uintptr_t>(addr) >> 12) % SHARDS];
+    }
+
+public:
+    void insert(void *addr, size_t len) {
+        Shard &s = shard(addr);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.lengths[addr] = len;
+        _count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // addr 是区域时移除并返回其长度，否则返回 0
+    size_t take(void *addr) {
+        if (_count.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        Shard &s = shard(addr);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.lengths.find(addr);
+        if (it == s.lengths.end()) {
+            return 0;
+        }
+        size_t len = it->second;
+        s.lengths.erase(it);
+        _count.fetch_sub(1, std::memory_order_relaxed);
+        return len;
+    }
+};
+
+Regions regions;
+
+// 解析 sysfs 中 "0-3,8-11" 形式的列表
+std::vector<int> parseList(const std::string &path) {
+    std::vector<int> out;
+    std::ifstream in(path);
+    std::string text;
+    if (!(in >> text)) {
+        return out;
+    }
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t comma = text.find(',', pos);
+        std::string item = text.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        size_t dash = item.find('-');
+        int lo = std::stoi(item.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+        for (int i = lo; i <= hi; i++) {
+            out.push_back(i);
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return out;
+}
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+// 有 CPU 的在线节点，按编号排序；读取失败时为空
+const std::vector<NumaNode> &topology() {
+    static const std::vector<NumaNode> nodes = [] {
+        std::vector<NumaNode> out;
+        try {
+            for (int id : parseList("/sys/devices/system/node/online")) {
+                auto cpus = parseList("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+                if (!cpus.empty()) {
+                    out.push_back({id, std::move(cpus)});
+                }
+            }
+        } catch (const std::exception &) {
+            out.clear();
+        }
+        return out;
+    }();
+    return nodes;
+}
+
+// 设置 [addr, addr + size) 的内存策略，须在首次写入前调用。mbind 失败（内核不支持、
+// 容器禁止等）时保持默认策略，放置只是提示
+void bindRange(void *addr, size_t size, int mode, const std::vector<int> &node_ids) {
+    constexpr size_t BITS = 8 * sizeof(unsigned long);
+    int max_id = 0;
+    for (int id : node_ids) {
+        max_id = std::max(max_id, id);
+    }
+    std::vector<unsigned long> mask(max_id / BITS + 1, 0);
+    for (int id : node_ids) {
+        mask[id / BITS] |= 1UL << (id % BITS);
+    }
+    // 内核只读取 maxnode - 1 位
+    ::syscall(SYS_mbind, addr, size, mode, mask.data(), mask.size() * BITS + 1, 0);
+}
+
+void place(void *addr, size_t size, const LlaisysHostMemoryOptions &opts) {
+    const auto &nodes = topology();
+    if (nodes.size() <= 1) {
+        return;
+    }
+    switch (opts.numa_policy) {
+    case LLAISYS_NUMA_INTERLEAVE: {
+        std::vector<int> ids;
+        for (const auto &node : nodes) {
+            ids.push_back(node.id);
+        }
+        bindRange(addr, size, MPOL_INTERLEAVE, ids);
+        break;
+    }
+    case LLAISYS_NUMA_BLOCKED: {
+        // 块边界按大页对齐，避免一个大页跨两个节点
+        size_t block = align_up((size + nodes.size() - 1) / nodes.size(), HUGE_PAGE_SIZE);
+        for (size_t k = 0; k < nodes.size() && k * block < size; k++) {
+            bindRange(static_cast<std::byte *>(addr) + k * block, std::min(block, size - k * block),
+                      MPOL_PREFERRED, {nodes[k].id});
+        }
+        break;
+    }
+    case LLAISYS_NUMA_NODE:
+        bindRange(addr, size, MPOL_PREFERRED, {opts.numa_node});
+        break;
+    default:
+        break;
+    }
+}
+
+void *mapRegion(size_t size, const LlaisysHostMemoryOptions &opts) {
+    if (opts.huge_pages == LLAISYS_HUGE_PAGES_EXPLICIT) {
+        size_t len = align_up(size, HUGE_PAGE_SIZE);
+        void *addr = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED) {
+            place(addr, len, opts);
+            regions.insert(addr, len);
+            return addr;
+        }
+        // 预留的大页不足，退回透明大页
+    }
+
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    bool huge = opts.huge_pages != LLAISYS_HUGE_PAGES_NONE;
+    size_t alignment = huge ? HUGE_PAGE_SIZE : std::max(page, opts.alignment);
+    size_t len = align_up(size, alignment);
+    size_t slack = alignment > page ? alignment : 0;
+    void *raw = ::mmap(nullptr, len + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    // 多映射一段，裁掉首尾使区域按 alignment 对齐（大页时为 2 MiB，透明大页才能覆盖整个区域）
+    auto begin = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = align_up(begin, slack == 0 ? page : slack);
+    if (aligned > begin) {
+        ::munmap(raw, aligned - begin);
+    }
+    if (begin + slack > aligned) {
+        ::munmap(reinterpret_cast<void *>(aligned + len), begin + slack - aligned);
+    }
+    void *addr = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (huge) {
+        ::madvise(addr, len, MADV_HUGEPAGE);
+    }
+#endif
+    place(addr, len, opts);
+    regions.insert(addr, len);
+    return addr;
+}
+#endif
+} // namespace
+
+void setMemoryOptions(const LlaisysHostMemoryOptions &opts) {
+    CHECK_ARGUMENT(opts.huge_pages >= LLAISYS_HUGE_PAGES_NONE && opts.huge_pages <= LLAISYS_HUGE_PAGES_EXPLICIT,
+                   "host memory: invalid huge page mode");
+    CHECK_ARGUMENT(opts.numa_policy >= LLAISYS_NUMA_DEFAULT && opts.numa_policy <= LLAISYS_NUMA_NODE,
+                   "host memory: invalid NUMA policy");
+    CHECK_ARGUMENT(opts.numa_policy != LLAISYS_NUMA_NODE || opts.numa_node >= 0, "host memory: invalid NUMA node");
+    CHECK_ARGUMENT(opts.alignment >= sizeof(void *) && opts.alignment <= HUGE_PAGE_SIZE
+                       && (opts.alignment & (opts.alignment - 1)) == 0,
+                   "host memory: alignment must be a power of two between pointer size and 2 MiB");
+    current_options.store(new LlaisysHostMemoryOptions(opts), std::memory_order_release);
+}
+
+LlaisysHostMemoryOptions memoryOptions() {
+    return *current_options.load(std::memory_order_acquire);
+}
+
+void *allocate(size_t size) {
+#if defined(__linux__)
+    auto opts = memoryOptions();
+    bool hinted = opts.huge_pages != LLAISYS_HUGE_PAGES_NONE || opts.numa_policy != LLAISYS_NUMA_DEFAULT;
+    if (hinted && size >= opts.min_size && size > 0) {
+        return mapRegion(size, opts);
+    }
+    // aligned_alloc 要求大小是对齐的整数倍
+    return std::aligned_alloc(opts.alignment, align_up(std::max<size_t>(size, 1), opts.alignment));
+#elif defined(_WIN32)
+    auto opts = memoryOptions();
+    return _aligned_malloc(std::max<size_t>(size, 1), opts.alignment);
+#else
+    auto opts = memoryOptions();
+    return std::aligned_alloc(opts.alignment, align_up(std::max<size_t>(size, 1), opts.alignment));
+#endif
+}
+
+void release(void *ptr) {
+#if defined(__linux__)
+    // 在锁外 munmap，拆页表不阻塞其他线程的释放
+    if (size_t len = regions.take(ptr)) {
+        ::munmap(ptr, len);
+        return;
+    }
+#endif
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+int numaNodeCount() {
+#if defined(__linux__)
+    return std::max<int>(1, static_cast<int>(topology().size()));
+#else
+    return 1;
+#endif
+}
+
+namespace {
+// 总量小于该值时单线程完成
+constexpr size_t PARALLEL_MIN_BYTES = size_t(1) << 16;
+// 一行超过该长度时再切分，使少量的长行也能分给多个线程
+constexpr size_t CHUNK_BYTES = size_t(1) << 18;
+} // namespace
+
+void copy2d(std::byte *dst, size_t dpitch, const std::byte *src, size_t spitch, size_t width, size_t height) {
+    if (width == 0 || height == 0) {
+        return;
+    }
+    if (dpitch == width && spitch == width) {
+        // 行首尾相接，按一行处理
+        width *= height;
+        height = 1;
+        dpitch = spitch = width;
+    }
+    if (width * height < PARALLEL_MIN_BYTES) {
+        for (size_t i = 0; i < height; i++) {
+            std::memcpy(dst + i * dpitch, src + i * spitch, width);
+        }
+        return;
+    }
+    size_t nchunks = (width + CHUNK_BYTES - 1) / CHUNK_BYTES;
+    size_t chunk = (width + nchunks - 1) / nchunks;
+    ptrdiff_t n = static_cast<ptrdiff_t>(height * nchunks);
+#pragma omp parallel for schedule(static)
+    for (ptrdiff_t i = 0; i < n; i++) {
+        size_t row = static_cast<size_t>(i) / nchunks;
+        size_t begin = static_cast<size_t>(i) % nchunks * chunk;
+        size_t len = std::min(chunk, width - begin);
+        std::memcpy(dst + row * dpitch + begin, src + row * spitch + begin, len);
+    }
+}
+
+void fill(std::byte *dst, int value, size_t size) {
+    if (size < PARALLEL_MIN_BYTES) {
+        std::memset(dst, value, size);
+        return;
+    }
+    ptrdiff_t n = static_cast<ptrdiff_t>((size + CHUNK_BYTES - 1) / CHUNK_BYTES);
+#pragma omp parallel for schedule(static)
+    for (ptrdiff_t i = 0; i < n; i++) {
+        size_t begin = static_cast<size_t>(i) * CHUNK_BYTES;
+        std::memset(dst + begin, value, std::min(CHUNK_BYTES, size - begin));
+    }
+}
+
+void bindThreads() {
+#if defined(__linux__) && defined(_OPENMP)
+    const auto &nodes = topology();
+    if (nodes.size() <= 1) {
+        return;
+    }
+#pragma omp parallel
+    {
+        size_t t = static_cast<size_t>(omp_get_thread_num());
+        size_t n = static_cast<size_t>(omp_get_num_threads());
+        const auto &node = nodes[t * nodes.size() / n];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : node.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        ::sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+}
+} // namespace llaisys::device::cpu
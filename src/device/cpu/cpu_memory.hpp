@@ -0,0 +1,28 @@
+#pragma once
+#include "llaisys/runtime.h"
+
+#include <cstddef>
+
+namespace llaisys::device::cpu {
+// CPU 上的主机内存。所有分配按 alignment 对齐，默认 64 字节（缓存行，AVX-512 宽度）。
+// 不小于 min_size 的分配按选项使用大页并指定 NUMA 节点，其余分配（以及未开启任何
+// 选项时）用对齐的 malloc。选项对进程内所有 CPU Runtime 生效，只影响之后的分配
+void setMemoryOptions(const LlaisysHostMemoryOptions &options);
+LlaisysHostMemoryOptions memoryOptions();
+
+void *allocate(size_t size);
+void release(void *ptr);
+
+// 拷贝 height 行、每行 width 字节；dpitch == spitch == width 时即一段连续拷贝。
+// 总量较大时按行、行内按块分给多个线程
+void copy2d(std::byte *dst, size_t dpitch, const std::byte *src, size_t spitch, size_t width, size_t height);
+// 把 size 个字节置为 value，总量较大时分块并行
+void fill(std::byte *dst, int value, size_t size);
+
+// 在线的 NUMA 节点数，非 Linux 或无法读取拓扑时为 1
+int numaNodeCount();
+// 把 OpenMP 线程按编号均分到各节点并绑定到节点的 CPU 上：第 t 个线程（共 T 个）绑定节点
+// t * N / T。静态调度的并行循环中每个线程处理连续的一段，与 LLAISYS_NUMA_BLOCKED 的
+// 分块对应，线程读到的权重位于本节点。调用线程即 0 号线程，同样被绑定
+void bindThreads();
+} // namespace llaisys::device::cpu
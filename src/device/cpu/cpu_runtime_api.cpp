@@ -1,4 +1,6 @@
 #include "../runtime_api.hpp"
+#include "cpu_memory.hpp"
+#include "cpu_stream.hpp"
 
 #include <cstdlib>
 #include <cstring>
@@ -6,6 +8,15 @@
 namespace llaisys::device::cpu {
 
 namespace runtime_api {
+// 事件句柄，流上的任务另外持有事件的引用
+struct EventHandle {
+    std::shared_ptr<Event> event;
+};
+
+Event &event(llaisysEvent_t e) {
+    return *static_cast<EventHandle *>(e)->event;
+}
+
 int getDeviceCount() {
     return 1;
 }
@@ -15,26 +26,28 @@ void setDevice(int) {
 }
 
 void deviceSynchronize() {
-    // do nothing
+    synchronizeStreams();
 }
 
 llaisysStream_t createStream() {
-    return (llaisysStream_t)0; // null stream
+    return new Stream();
 }
 
 void destroyStream(llaisysStream_t stream) {
-    // do nothing
+    delete static_cast<Stream *>(stream);
 }
 void streamSynchronize(llaisysStream_t stream) {
-    // do nothing
+    if (stream != nullptr) {
+        static_cast<Stream *>(stream)->synchronize();
+    }
 }
 
 void *mallocDevice(size_t size) {
-    return std::malloc(size);
+    return cpu::allocate(size);
 }
 
 void freeDevice(void *ptr) {
-    std::free(ptr);
+    cpu::release(ptr);
 }
 
 void *mallocHost(size_t size) {
@@ -45,12 +58,66 @@ void freeHost(void *ptr) {
     freeDevice(ptr);
 }
 
+void memcpy2dSync(void *dst, size_t dpitch, const void *src, size_t spitch, size_t width, size_t height,
+                  llaisysMemcpyKind_t kind) {
+    cpu::copy2d(static_cast<std::byte *>(dst), dpitch, static_cast<const std::byte *>(src), spitch, width, height);
+}
+
+void memcpy2dAsync(void *dst, size_t dpitch, const void *src, size_t spitch, size_t width, size_t height,
+                   llaisysMemcpyKind_t kind, llaisysStream_t stream) {
+    if (stream == nullptr) {
+        memcpy2dSync(dst, dpitch, src, spitch, width, height, kind);
+        return;
+    }
+    static_cast<Stream *>(stream)->enqueue([=] { memcpy2dSync(dst, dpitch, src, spitch, width, height, kind); });
+}
+
 void memcpySync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kind) {
-    std::memcpy(dst, src, size);
+    memcpy2dSync(dst, size, src, size, size, 1, kind);
 }
 
 void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kind, llaisysStream_t stream) {
-    memcpySync(dst, src, size, kind);
+    memcpy2dAsync(dst, size, src, size, size, 1, kind, stream);
+}
+
+void memsetSync(void *ptr, int value, size_t size) {
+    cpu::fill(static_cast<std::byte *>(ptr), value, size);
+}
+
+llaisysEvent_t createEvent() {
+    return new EventHandle{std::make_shared<Event>()};
+}
+
+void destroyEvent(llaisysEvent_t event) {
+    delete static_cast<EventHandle *>(event);
+}
+
+void eventRecord(llaisysEvent_t e, llaisysStream_t stream) {
+    event(e).record(static_cast<Stream *>(stream));
+}
+
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t e) {
+    event(e).block(static_cast<Stream *>(stream));
+}
+
+int eventQuery(llaisysEvent_t e) {
+    return event(e).query() ? 1 : 0;
+}
+
+void eventSynchronize(llaisysEvent_t e) {
+    event(e).synchronize();
+}
+
+float eventElapsedTime(llaisysEvent_t start, llaisysEvent_t end) {
+    return Event::elapsed(event(start), event(end));
+}
+
+void launchHostFunc(llaisysStream_t stream, host_func_t fn, void *user_data) {
+    if (stream == nullptr) {
+        fn(user_data);
+        return;
+    }
+    static_cast<Stream *>(stream)->enqueue([=] { fn(user_data); });
 }
 
 static const LlaisysRuntimeAPI RUNTIME_API = {
@@ -65,7 +132,18 @@ static const LlaisysRuntimeAPI RUNTIME_API = {
     &mallocHost,
     &freeHost,
     &memcpySync,
-    &memcpyAsync};
+    &memcpyAsync,
+    &createEvent,
+    &destroyEvent,
+    &eventRecord,
+    &streamWaitEvent,
+    &eventQuery,
+    &eventSynchronize,
+    &eventElapsedTime,
+    &launchHostFunc,
+    &memcpy2dSync,
+    &memcpy2dAsync,
+    &memsetSync};
 
 } // namespace runtime_api
 
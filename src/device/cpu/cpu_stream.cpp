@@ -0,0 +1,202 @@
+#include "cpu_stream.hpp"
+
+#include "../../utils.hpp"
+
+#include <set>
+#include <vector>
+
+namespace llaisys::device::cpu {
+namespace {
+// 所有存活的流，供 deviceSynchronize 使用
+struct Registry {
+    std::mutex mutex;
+    std::condition_variable unpinned;
+    std::set<Stream *> streams;
+};
+
+Registry &registry() {
+    static Registry registry;
+    return registry;
+}
+
+// 当前线程作为后台线程所执行的流
+thread_local Stream *current_stream = nullptr;
+} // namespace
+
+Stream::Stream() {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    registry().streams.insert(this);
+}
+
+Stream::~Stream() {
+    {
+        // 等 synchronizeStreams 不再使用本流
+        std::unique_lock<std::mutex> lock(registry().mutex);
+        registry().streams.erase(this);
+        registry().unpinned.wait(lock, [&] { return _pins == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void Stream::run() {
+    current_stream = this;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        // 停止前先执行完队列中的任务
+        _cv.wait(lock, [&] { return _stop || !_tasks.empty(); });
+        if (_tasks.empty()) {
+            return;
+        }
+        auto task = std::move(_tasks.front());
+        _tasks.pop_front();
+        _busy = true;
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            lock.lock();
+            if (!_error) {
+                _error = std::current_exception();
+            }
+            lock.unlock();
+        }
+        lock.lock();
+        _busy = false;
+        _cv.notify_all();
+    }
+}
+
+void Stream::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_worker.joinable()) {
+            _worker = std::thread(&Stream::run, this);
+        }
+        _tasks.push_back(std::move(task));
+    }
+    _cv.notify_all();
+}
+
+void Stream::synchronize() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&] { return _tasks.empty() && !_busy; });
+    if (_error) {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void synchronizeStreams() {
+    // 在锁外等待：流上的任务可能创建新的流而需要注册表的锁
+    Registry &r = registry();
+    std::vector<Stream *> streams;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (Stream *stream : r.streams) {
+            if (stream != current_stream) {
+                stream->_pins++;
+                streams.push_back(stream);
+            }
+        }
+    }
+    std::exception_ptr error;
+    for (Stream *stream : streams) {
+        try {
+            stream->synchronize();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (Stream *stream : streams) {
+            stream->_pins--;
+        }
+    }
+    r.unpinned.notify_all();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void Event::complete(uint64_t seq) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (seq > _completed) {
+            _completed = seq;
+            _time = std::chrono::steady_clock::now();
+        }
+    }
+    _cv.notify_all();
+}
+
+void Event::wait(uint64_t seq) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&] { return _completed >= seq; });
+}
+
+void Event::record(Stream *stream) {
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        seq = ++_recorded;
+    }
+    if (stream == nullptr) {
+        complete(seq);
+    } else {
+        stream->enqueue([self = shared_from_this(), seq] { self->complete(seq); });
+    }
+}
+
+void Event::block(Stream *stream) {
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        seq = _recorded;
+    }
+    if (stream == nullptr) {
+        wait(seq);
+    } else {
+        stream->enqueue([self = shared_from_this(), seq] { self->wait(seq); });
+    }
+}
+
+bool Event::query() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _completed >= _recorded;
+}
+
+void Event::synchronize() {
+    uint64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        seq = _recorded;
+    }
+    wait(seq);
+}
+
+float Event::elapsed(Event &start, Event &end) {
+    // start 与 end 可以是同一个事件
+    std::unique_lock<std::mutex> start_lock(start._mutex, std::defer_lock);
+    std::unique_lock<std::mutex> end_lock(end._mutex, std::defer_lock);
+    if (&start == &end) {
+        start_lock.lock();
+    } else {
+        std::lock(start_lock, end_lock);
+    }
+    CHECK_ARGUMENT(start._recorded > 0 && end._recorded > 0, "event: elapsed time of an event never recorded");
+    CHECK_ARGUMENT(start._completed >= start._recorded && end._completed >= end._recorded,
+                   "event: elapsed time of an event not yet completed");
+    return std::chrono::duration<float, std::milli>(end._time - start._time).count();
+}
+} // namespace llaisys::device::cpu
@@ -0,0 +1,71 @@
+#pragma once
+#include "llaisys.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace llaisys::device::cpu {
+// CPU 流：一个后台线程按提交顺序执行的任务队列。线程在第一次提交时才启动，
+// 只创建不使用的流（如每个 Runtime 的默认流）不占用线程
+class Stream {
+private:
+    std::deque<std::function<void()>> _tasks;
+    bool _busy = false; // 后台线程正在执行任务
+    bool _stop = false;
+    std::exception_ptr _error; // 任务抛出的第一个异常，synchronize 时重新抛出
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::thread _worker;
+    // synchronizeStreams 正在等待本流的次数，由注册表的锁保护；析构等其归零
+    size_t _pins = 0;
+
+    void run();
+
+    friend void synchronizeStreams();
+
+public:
+    Stream();
+    // 等待已提交的任务执行完
+    ~Stream();
+
+    Stream(const Stream &) = delete;
+    Stream &operator=(const Stream &) = delete;
+
+    void enqueue(std::function<void()> task);
+    void synchronize();
+};
+
+// 事件记录一个流上的位置。每次 record 生成新的序号，流执行到该位置时序号完成；
+// 等待事件即等待调用时最近一次记录的序号完成。流上的任务持有事件的引用，
+// 事件在任务执行前被销毁也是安全的
+class Event : public std::enable_shared_from_this<Event> {
+private:
+    uint64_t _recorded = 0;
+    uint64_t _completed = 0;
+    std::chrono::steady_clock::time_point _time;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+
+    void complete(uint64_t seq);
+    void wait(uint64_t seq);
+
+public:
+    void record(Stream *stream);
+    // stream 之后的任务等待事件，stream 为空时在调用线程等待
+    void block(Stream *stream);
+    bool query();
+    void synchronize();
+    // 从 start 完成到 end 完成的毫秒数
+    static float elapsed(Event &start, Event &end);
+};
+
+// 等待所有流的任务执行完。在流的任务中调用时跳过该流本身
+void synchronizeStreams();
+} // namespace llaisys::device::cpu
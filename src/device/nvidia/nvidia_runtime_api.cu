@@ -49,7 +49,53 @@ void memcpySync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kin
     TO_BE_IMPLEMENTED();
 }
 
-void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kind) {
+void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kind, llaisysStream_t stream) {
+    TO_BE_IMPLEMENTED();
+}
+
+llaisysEvent_t createEvent() {
+    TO_BE_IMPLEMENTED();
+}
+
+void destroyEvent(llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+void eventRecord(llaisysEvent_t event, llaisysStream_t stream) {
+    TO_BE_IMPLEMENTED();
+}
+
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+int eventQuery(llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+void eventSynchronize(llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+float eventElapsedTime(llaisysEvent_t start, llaisysEvent_t end) {
+    TO_BE_IMPLEMENTED();
+}
+
+void launchHostFunc(llaisysStream_t stream, host_func_t fn, void *user_data) {
+    TO_BE_IMPLEMENTED();
+}
+
+void memcpy2dSync(void *dst, size_t dpitch, const void *src, size_t spitch, size_t width, size_t height,
+                  llaisysMemcpyKind_t kind) {
+    TO_BE_IMPLEMENTED();
+}
+
+void memcpy2dAsync(void *dst, size_t dpitch, const void *src, size_t spitch, size_t width, size_t height,
+                   llaisysMemcpyKind_t kind, llaisysStream_t stream) {
+    TO_BE_IMPLEMENTED();
+}
+
+void memsetSync(void *ptr, int value, size_t size) {
     TO_BE_IMPLEMENTED();
 }
 
@@ -65,7 +111,18 @@ static const LlaisysRuntimeAPI RUNTIME_API = {
     &mallocHost,
     &freeHost,
     &memcpySync,
-    &memcpyAsync};
+    &memcpyAsync,
+    &createEvent,
+    &destroyEvent,
+    &eventRecord,
+    &streamWaitEvent,
+    &eventQuery,
+    &eventSynchronize,
+    &eventElapsedTime,
+    &launchHostFunc,
+    &memcpy2dSync,
+    &memcpy2dAsync,
+    &memsetSync};
 
 } // namespace runtime_api
 
@@ -52,6 +52,55 @@ void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t ki
     EXCEPTION_UNSUPPORTED_DEVICE;
 }
 
+llaisysEvent_t createEvent() {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+    return nullptr;
+}
+
+void destroyEvent(llaisysEvent_t event) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+void eventRecord(llaisysEvent_t event, llaisysStream_t stream) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t event) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+int eventQuery(llaisysEvent_t event) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+    return 0;
+}
+
+void eventSynchronize(llaisysEvent_t event) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+float eventElapsedTime(llaisysEvent_t start, llaisysEvent_t end) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+    return 0;
+}
+
+void launchHostFunc(llaisysStream_t stream, host_func_t fn, void *user_data) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+void memcpy2dSync(void *dst, size_t dpitch, const void *src, size_t spitch, size_t width, size_t height,
+                  llaisysMemcpyKind_t kind) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+void memcpy2dAsync(void *dst, size_t dpitch, const void *src, size_t spitch, size_t width, size_t height,
+                   llaisysMemcpyKind_t kind, llaisysStream_t stream) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
+void memsetSync(void *ptr, int value, size_t size) {
+    EXCEPTION_UNSUPPORTED_DEVICE;
+}
+
 static const LlaisysRuntimeAPI NOOP_RUNTIME_API = {
     &getDeviceCount,
     &setDevice,
@@ -64,7 +113,18 @@ static const LlaisysRuntimeAPI NOOP_RUNTIME_API = {
     &mallocHost,
     &freeHost,
     &memcpySync,
-    &memcpyAsync};
+    &memcpyAsync,
+    &createEvent,
+    &destroyEvent,
+    &eventRecord,
+    &streamWaitEvent,
+    &eventQuery,
+    &eventSynchronize,
+    &eventElapsedTime,
+    &launchHostFunc,
+    &memcpy2dSync,
+    &memcpy2dAsync,
+    &memsetSync};
 
 const LlaisysRuntimeAPI *getUnsupportedRuntimeAPI() {
     return &NOOP_RUNTIME_API;
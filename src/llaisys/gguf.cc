@@ -0,0 +1,94 @@
+#include "llaisys/gguf.h"
+
+#include "llaisys_tensor.hpp"
+
+#include "../loader/ggml_quants.hpp"
+#include "../loader/gguf.hpp"
+
+#include <exception>
+
+__C {
+    typedef struct LlaisysGGUF {
+        std::shared_ptr<llaisys::loader::GGUFFile> gguf;
+    } LlaisysGGUF;
+
+    llaisysGGUF_t ggufOpen(
+        const char *path) {
+        try {
+            return new LlaisysGGUF{llaisys::loader::GGUFFile::open(path)};
+        } catch (const std::exception &) {
+            // 错误信息已由检查宏输出
+            return nullptr;
+        }
+    }
+
+    void ggufClose(
+        llaisysGGUF_t gguf) {
+        delete gguf;
+    }
+
+    size_t ggufNumTensors(
+        llaisysGGUF_t gguf) {
+        return gguf->gguf->entries().size();
+    }
+
+    const char *ggufTensorName(
+        llaisysGGUF_t gguf,
+        size_t index) {
+        return gguf->gguf->entries().at(index).name.c_str();
+    }
+
+    const char *ggufTensorType(
+        llaisysGGUF_t gguf,
+        const char *name) {
+        const auto *entry = gguf->gguf->find(name);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        const auto *traits = llaisys::loader::ggml::traits(entry->type);
+        return traits ? traits->name : "unknown";
+    }
+
+    llaisysTensor_t ggufGetTensor(
+        llaisysGGUF_t gguf,
+        const char *name,
+        llaisysDataType_t dtype) {
+        const auto *entry = gguf->gguf->find(name);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        return new LlaisysTensor{gguf->gguf->tensor(*entry, dtype)};
+    }
+
+    int ggufGetTensorInt4(
+        llaisysGGUF_t gguf,
+        const char *name,
+        llaisysTensor_t *q,
+        llaisysTensor_t *scales,
+        llaisysTensor_t *zeros) {
+        const auto *entry = gguf->gguf->find(name);
+        llaisys::tensor_t q_, scales_, zeros_;
+        if (entry == nullptr || !gguf->gguf->int4(*entry, q_, scales_, zeros_)) {
+            return 0;
+        }
+        *q = new LlaisysTensor{q_};
+        *scales = new LlaisysTensor{scales_};
+        *zeros = new LlaisysTensor{zeros_};
+        return 1;
+    }
+
+    const char *ggufGetMeta(
+        llaisysGGUF_t gguf,
+        const char *key) {
+        const auto &meta = gguf->gguf->metadata();
+        auto it = meta.find(key);
+        return it == meta.end() ? nullptr : it->second.c_str();
+    }
+
+    void ggufQwen2Meta(
+        llaisysGGUF_t gguf,
+        llaisysDataType_t dtype,
+        struct LlaisysQwen2Meta *meta) {
+        *meta = gguf->gguf->qwen2Meta(dtype);
+    }
+}
@@ -4,8 +4,11 @@
 
 #include "../ops/add/op.hpp"
 #include "../ops/argmax/op.hpp"
+#include "../ops/cast/op.hpp"
 #include "../ops/embedding/op.hpp"
 #include "../ops/linear/op.hpp"
+#include "../ops/precision/precision.hpp"
+#include "../ops/quantize/op.hpp"
 #include "../ops/rearrange/op.hpp"
 #include "../ops/rms_norm/op.hpp"
 #include "../ops/rope/op.hpp"
@@ -19,12 +22,30 @@ __C {
     void llaisysArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t vals) {
         llaisys::ops::argmax(max_idx->tensor, max_val->tensor, vals->tensor);
     }
+    void llaisysCast(llaisysTensor_t out, llaisysTensor_t in) {
+        llaisys::ops::cast(out->tensor, in->tensor);
+    }
     void llaisysEmbedding(llaisysTensor_t out, llaisysTensor_t index, llaisysTensor_t weight) {
         llaisys::ops::embedding(out->tensor, index->tensor, weight->tensor);
     }
     void llaisysLinear(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias) {
         llaisys::ops::linear(out->tensor, in->tensor, weight->tensor, bias->tensor);
     }
+    void llaisysLinearInt8(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t weight_scale, llaisysTensor_t bias) {
+        llaisys::ops::linear(out->tensor, in->tensor, weight->tensor, bias ? bias->tensor : nullptr, weight_scale->tensor);
+    }
+    void llaisysQuantizeInt8(llaisysTensor_t q, llaisysTensor_t scale, llaisysTensor_t weight) {
+        llaisys::ops::quantize_int8(q->tensor, scale->tensor, weight->tensor);
+    }
+    void llaisysLinearInt4(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t scales, llaisysTensor_t zeros, llaisysTensor_t bias) {
+        llaisys::ops::linear_int4(out->tensor, in->tensor, weight->tensor, scales->tensor, zeros->tensor, bias ? bias->tensor : nullptr);
+    }
+    void llaisysQuantizeInt4(llaisysTensor_t q, llaisysTensor_t scales, llaisysTensor_t zeros, llaisysTensor_t weight) {
+        llaisys::ops::quantize_int4(q->tensor, scales->tensor, zeros->tensor, weight->tensor);
+    }
+    void llaisysRepackInt4(llaisysTensor_t q, llaisysTensor_t scales, llaisysTensor_t zeros, llaisysTensor_t src_qweight, llaisysTensor_t src_qzeros, llaisysTensor_t src_scales, llaisysInt4Format_t format) {
+        llaisys::ops::repack_int4(q->tensor, scales->tensor, zeros->tensor, src_qweight->tensor, src_qzeros->tensor, src_scales->tensor, format);
+    }
     void llaisysRearrange(llaisysTensor_t out, llaisysTensor_t in) {
         llaisys::ops::rearrange(out->tensor, in->tensor);
     }
@@ -37,7 +58,21 @@ __C {
     void llaisysSelfAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, float scale) {
         llaisys::ops::self_attention(attn_val->tensor, q->tensor, k->tensor, v->tensor, scale);
     }
+    void llaisysSelfAttentionQuantKV(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, llaisysTensor_t k_scale, llaisysTensor_t v_scale, float scale) {
+        llaisys::ops::self_attention(attn_val->tensor, q->tensor, k->tensor, v->tensor, scale, k_scale->tensor, v_scale->tensor);
+    }
+    void llaisysQuantizeKV(llaisysTensor_t cache, llaisysTensor_t scales, llaisysTensor_t src) {
+        llaisys::ops::quantize_kv(cache->tensor, scales->tensor, src->tensor);
+    }
     void llaisysSwiGLU(llaisysTensor_t out, llaisysTensor_t gate, llaisysTensor_t up) {
         llaisys::ops::swiglu(out->tensor, gate->tensor, up->tensor);
     }
+    void llaisysSetPrecision(llaisysOpType_t op, llaisysDataType_t compute, llaisysDataType_t accumulate) {
+        llaisys::ops::setPrecision(op, {compute, accumulate});
+    }
+    void llaisysGetPrecision(llaisysOpType_t op, llaisysDataType_t *compute, llaisysDataType_t *accumulate) {
+        llaisys::ops::Precision p = llaisys::ops::precision(op);
+        *compute = p.compute;
+        *accumulate = p.accumulate;
+    }
 }
@@ -0,0 +1,153 @@
+#include "llaisys/packed.h"
+
+#include "llaisys_tensor.hpp"
+
+#include "../loader/packed.hpp"
+
+#include <exception>
+
+__C {
+    typedef struct LlaisysPackWriter {
+        llaisys::loader::PackWriter writer;
+    } LlaisysPackWriter;
+
+    typedef struct LlaisysPacked {
+        std::shared_ptr<llaisys::loader::PackedFile> packed;
+    } LlaisysPacked;
+
+    typedef struct LlaisysLayerStream {
+        std::shared_ptr<llaisys::loader::LayerStream> stream;
+    } LlaisysLayerStream;
+
+    llaisysPackWriter_t packWriterCreate(
+        const char *path) {
+        try {
+            return new LlaisysPackWriter{llaisys::loader::PackWriter(path)};
+        } catch (const std::exception &) {
+            return nullptr;
+        }
+    }
+
+    void packWriterSetMeta(
+        llaisysPackWriter_t writer,
+        const char *key,
+        const char *value) {
+        writer->writer.setMetadata(key, value);
+    }
+
+    void packWriterAddTensor(
+        llaisysPackWriter_t writer,
+        const char *name,
+        llaisysTensor_t *parts,
+        size_t nparts,
+        llaisysDataType_t dtype) {
+        std::vector<llaisys::tensor_t> parts_vec;
+        for (size_t i = 0; i < nparts; i++) {
+            parts_vec.push_back(parts[i]->tensor);
+        }
+        writer->writer.add(name, parts_vec, dtype);
+    }
+
+    void packWriterAddAlias(
+        llaisysPackWriter_t writer,
+        const char *name,
+        const char *target) {
+        writer->writer.alias(name, target);
+    }
+
+    size_t packWriterSharedBytes(
+        llaisysPackWriter_t writer) {
+        return writer->writer.sharedBytes();
+    }
+
+    void packWriterFinish(
+        llaisysPackWriter_t writer) {
+        writer->writer.finish();
+        delete writer;
+    }
+
+    void packWriterDestroy(
+        llaisysPackWriter_t writer) {
+        delete writer;
+    }
+
+    llaisysPacked_t packedOpen(
+        const char *path) {
+        try {
+            return new LlaisysPacked{llaisys::loader::PackedFile::open(path)};
+        } catch (const std::exception &) {
+            // 错误信息已由检查宏输出
+            return nullptr;
+        }
+    }
+
+    void packedClose(
+        llaisysPacked_t packed) {
+        delete packed;
+    }
+
+    size_t packedNumTensors(
+        llaisysPacked_t packed) {
+        return packed->packed->entries().size();
+    }
+
+    const char *packedTensorName(
+        llaisysPacked_t packed,
+        size_t index) {
+        return packed->packed->entries().at(index).name.c_str();
+    }
+
+    llaisysTensor_t packedGetTensor(
+        llaisysPacked_t packed,
+        const char *name) {
+        const auto *entry = packed->packed->find(name);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        return new LlaisysTensor{packed->packed->tensor(*entry)};
+    }
+
+    const char *packedGetMeta(
+        llaisysPacked_t packed,
+        const char *key) {
+        const auto &meta = packed->packed->metadata();
+        auto it = meta.find(key);
+        return it == meta.end() ? nullptr : it->second.c_str();
+    }
+
+    llaisysLayerStream_t packedStreamLayers(
+        llaisysPacked_t packed,
+        size_t depth) {
+        return new LlaisysLayerStream{packed->packed->streamLayers(depth)};
+    }
+
+    void layerStreamDestroy(
+        llaisysLayerStream_t stream) {
+        delete stream;
+    }
+
+    size_t layerStreamNumLayers(
+        llaisysLayerStream_t stream) {
+        return stream->stream->numLayers();
+    }
+
+    void layerStreamAcquire(
+        llaisysLayerStream_t stream,
+        size_t layer) {
+        stream->stream->acquire(layer);
+    }
+
+    void layerStreamRelease(
+        llaisysLayerStream_t stream,
+        size_t layer) {
+        stream->stream->release(layer);
+    }
+
+    void layerStreamGetStats(
+        llaisysLayerStream_t stream,
+        LlaisysLayerStreamStats *stats) {
+        auto s = stream->stream->stats();
+        *stats = LlaisysLayerStreamStats{s.acquires, s.hits, s.wait_ms,
+                                         s.nbytes_prefetched, s.nbytes_loaded, s.nbytes_released};
+    }
+}
@@ -1,6 +1,10 @@
 #include "llaisys/runtime.h"
 #include "../core/context/context.hpp"
 #include "../device/runtime_api.hpp"
+#include "../device/cpu/cpu_memory.hpp"
+
+#include <algorithm>
+#include <vector>
 
 // Llaisys API for setting context runtime.
 __C void llaisysSetContextRuntime(llaisysDeviceType_t device_type, int device_id) {
@@ -10,4 +14,95 @@ __C void llaisysSetContextRuntime(llaisysDeviceType_t device_type, int device_id
 // Llaisys API for getting the runtime APIs
 __C const LlaisysRuntimeAPI *llaisysGetRuntimeAPI(llaisysDeviceType_t device_type) {
     return llaisys::device::getRuntimeAPI(device_type);
-}
\ No newline at end of file
+}
+__C void llaisysSetRuntimeSharing(int enable) {
+    llaisys::core::setRuntimeSharing(enable != 0);
+}
+
+__C int llaisysGetRuntimeSharing() {
+    return llaisys::core::runtimeSharing() ? 1 : 0;
+}
+
+__C void llaisysRuntimeSetAllocator(llaisysAllocatorType_t type) {
+    llaisys::core::context().runtime().setAllocator(type);
+}
+
+__C llaisysAllocatorType_t llaisysRuntimeGetAllocator() {
+    return llaisys::core::context().runtime().allocatorType();
+}
+
+__C void llaisysRuntimeTrim() {
+    llaisys::core::context().runtime().allocator().trim();
+}
+
+__C void llaisysRuntimeGetAllocatorStats(LlaisysAllocatorStats *stats) {
+    auto s = llaisys::core::context().runtime().allocator().stats();
+    *stats = LlaisysAllocatorStats{s.allocated_bytes, s.reserved_bytes, s.peak_allocated_bytes, s.peak_reserved_bytes,
+                                   s.num_allocs, s.num_frees, s.num_device_allocs, s.num_device_frees};
+}
+
+__C llaisysMemoryCategory_t llaisysRuntimeSetMemoryCategory(llaisysMemoryCategory_t category) {
+    return llaisys::core::context().runtime().setMemoryCategory(category);
+}
+
+__C llaisysMemoryCategory_t llaisysRuntimeGetMemoryCategory() {
+    return llaisys::core::context().runtime().memoryCategory();
+}
+
+__C void llaisysRuntimeMemoryStats(LlaisysMemoryStats *stats) {
+    *stats = llaisys::core::context().runtime().memoryStats();
+}
+
+__C void llaisysRuntimeResetPeakMemoryStats() {
+    llaisys::core::context().runtime().resetPeakMemoryStats();
+}
+
+__C void llaisysRuntimeArenaReserve(size_t size) {
+    llaisys::core::context().runtime().arena().reserve(size);
+}
+
+__C void llaisysRuntimeArenaReset() {
+    llaisys::core::context().runtime().arena().reset();
+}
+
+__C void llaisysRuntimeArenaGetStats(size_t *capacity, size_t *used, size_t *peak) {
+    auto &arena = llaisys::core::context().runtime().arena();
+    *capacity = arena.capacity();
+    *used = arena.used();
+    *peak = arena.peak();
+}
+
+__C void llaisysCpuSetMemoryOptions(const LlaisysHostMemoryOptions *options) {
+    llaisys::device::cpu::setMemoryOptions(*options);
+}
+
+__C void llaisysCpuGetMemoryOptions(LlaisysHostMemoryOptions *options) {
+    *options = llaisys::device::cpu::memoryOptions();
+}
+
+__C int llaisysCpuNumaNodeCount() {
+    return llaisys::device::cpu::numaNodeCount();
+}
+
+__C void llaisysCpuBindThreads() {
+    llaisys::device::cpu::bindThreads();
+}
+
+__C size_t llaisysCpuWorkspaceSize() {
+    return llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace().size();
+}
+
+__C void llaisysCpuWorkspaceRelease() {
+    llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace().release();
+}
+
+__C size_t llaisysPlanArena(const LlaisysBufferLifetime *buffers, size_t n, size_t alignment, size_t *offsets) {
+    std::vector<llaisys::core::BufferLifetime> lifetimes;
+    for (size_t i = 0; i < n; i++) {
+        lifetimes.push_back({buffers[i].size, buffers[i].first, buffers[i].last});
+    }
+    std::vector<size_t> planned;
+    size_t total = llaisys::core::planArena(lifetimes, planned, alignment);
+    std::copy(planned.begin(), planned.end(), offsets);
+    return total;
+}
@@ -0,0 +1,80 @@
+#include "llaisys/safetensors.h"
+
+#include "llaisys_tensor.hpp"
+
+#include "../loader/safetensors.hpp"
+
+#include <exception>
+
+__C {
+    typedef struct LlaisysSafetensors {
+        std::shared_ptr<llaisys::loader::SafeTensors> st;
+    } LlaisysSafetensors;
+
+    llaisysSafetensors_t safetensorsOpen(
+        const char *path) {
+        try {
+            return new LlaisysSafetensors{llaisys::loader::SafeTensors::open(path)};
+        } catch (const std::exception &) {
+            // 错误信息已由检查宏输出
+            return nullptr;
+        }
+    }
+
+    void safetensorsClose(
+        llaisysSafetensors_t st) {
+        delete st;
+    }
+
+    size_t safetensorsNumTensors(
+        llaisysSafetensors_t st) {
+        return st->st->entries().size();
+    }
+
+    const char *safetensorsTensorName(
+        llaisysSafetensors_t st,
+        size_t index) {
+        return st->st->entries().at(index).name.c_str();
+    }
+
+    llaisysTensor_t safetensorsGetTensor(
+        llaisysSafetensors_t st,
+        const char *name) {
+        const auto *entry = st->st->find(name);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        return new LlaisysTensor{st->st->tensor(*entry)};
+    }
+
+    llaisysTensor_t safetensorsGetTensorAs(
+        llaisysSafetensors_t st,
+        const char *name,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id) {
+        const auto *entry = st->st->find(name);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        return new LlaisysTensor{st->st->tensor(*entry, dtype, device_type, device_id)};
+    }
+
+    void safetensorsLoadAll(
+        llaisysSafetensors_t st,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        llaisysTensor_t *tensors,
+        LlaisysLoadStats *stats) {
+        llaisys::loader::SafeTensors::LoadStats s;
+        auto out = st->st->loadAll(dtype, device_type, device_id, &s);
+        for (size_t i = 0; i < out.size(); i++) {
+            tensors[i] = new LlaisysTensor{out[i]};
+        }
+        if (stats) {
+            *stats = LlaisysLoadStats{s.open_ms, s.convert_ms, s.copy_ms, s.total_ms,
+                                      s.ntensors, s.nbytes_read, s.nbytes_converted, s.nbytes_shared};
+        }
+    }
+}
@@ -1,5 +1,11 @@
 #include "llaisys_tensor.hpp"
 
+#include "../core/context/context.hpp"
+#include "../utils.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <numeric>
 #include <vector>
 
 __C {
@@ -13,6 +19,33 @@ __C {
         return new LlaisysTensor{llaisys::Tensor::create(shape_vec, dtype, device_type, device_id)};
     }
 
+    llaisysTensor_t tensorCreatePadded(
+        size_t * shape,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        size_t row_alignment) {
+        std::vector<size_t> shape_vec(shape, shape + ndim);
+        return new LlaisysTensor{llaisys::Tensor::create(shape_vec, dtype, device_type, device_id, row_alignment)};
+    }
+
+    llaisysTensor_t tensorCreateInArena(
+        size_t * shape,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        size_t offset) {
+        std::vector<size_t> shape_vec(shape, shape + ndim);
+        size_t nbytes = std::accumulate(shape_vec.begin(), shape_vec.end(), llaisys::utils::dsize(dtype),
+                                        std::multiplies<size_t>());
+        auto &arena = llaisys::core::context().runtime().arena();
+        if (offset == SIZE_MAX) {
+            offset = arena.allocate(nbytes);
+        }
+        CHECK_ARGUMENT(arena.storage() && offset + nbytes <= arena.capacity(), "arena: tensor exceeds reserved capacity");
+        return new LlaisysTensor{llaisys::Tensor::create(shape_vec, dtype, arena.storage(), arena.base() + offset)};
+    }
+
     void tensorDestroy(
         llaisysTensor_t tensor) {
         delete tensor;
@@ -65,6 +98,12 @@ __C {
         return uint8_t(tensor->tensor->isContiguous());
     }
 
+    uint8_t tensorIsAligned(
+        llaisysTensor_t tensor,
+        size_t alignment) {
+        return uint8_t(tensor->tensor->isAligned(alignment));
+    }
+
     void tensorLoad(
         llaisysTensor_t tensor,
         const void *data) {
@@ -93,4 +132,24 @@ __C {
         size_t end) {
         return new LlaisysTensor{tensor->tensor->slice(dim, start, end)};
     }
+
+    llaisysTensor_t tensorReshape(
+        llaisysTensor_t tensor,
+        size_t * shape,
+        size_t ndim) {
+        std::vector<size_t> shape_vec(shape, shape + ndim);
+        return new LlaisysTensor{tensor->tensor->reshape(shape_vec)};
+    }
+
+    llaisysTensor_t tensorContiguous(
+        llaisysTensor_t tensor) {
+        return new LlaisysTensor{tensor->tensor->contiguous()};
+    }
+
+    llaisysTensor_t tensorTo(
+        llaisysTensor_t tensor,
+        llaisysDeviceType_t device_type,
+        int device_id) {
+        return new LlaisysTensor{tensor->tensor->to(device_type, device_id)};
+    }
 }
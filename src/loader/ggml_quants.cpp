@@ -0,0 +1,275 @@
+#include "ggml_quants.hpp"
+
+#include "../utils.hpp"
+
+#include <cstring>
+
+// 块格式与 ggml-quants.c 中的 dequantize_row_* 一致，全部为小端
+namespace llaisys::loader::ggml {
+
+namespace {
+constexpr size_t QK = 32;   // Q4_0/Q4_1/Q5_0/Q5_1/Q8_0 的块大小
+constexpr size_t QK_K = 256; // K 系列超块大小
+
+float f16(const std::byte *p) {
+    fp16_t h;
+    std::memcpy(&h._v, p, sizeof(h._v));
+    return utils::cast<float>(h);
+}
+
+const uint8_t *u8(const std::byte *p) {
+    return reinterpret_cast<const uint8_t *>(p);
+}
+
+// block_q4_0 { f16 d; u8 qs[16]; }：x = (q - 8) * d
+void dequantize_q4_0(const std::byte *b, float *y) {
+    float d = f16(b);
+    const uint8_t *qs = u8(b + 2);
+    for (size_t j = 0; j < QK / 2; j++) {
+        y[j] = (static_cast<int>(qs[j] & 0x0F) - 8) * d;
+        y[j + QK / 2] = (static_cast<int>(qs[j] >> 4) - 8) * d;
+    }
+}
+
+// block_q4_1 { f16 d; f16 m; u8 qs[16]; }：x = q * d + m
+void dequantize_q4_1(const std::byte *b, float *y) {
+    float d = f16(b), m = f16(b + 2);
+    const uint8_t *qs = u8(b + 4);
+    for (size_t j = 0; j < QK / 2; j++) {
+        y[j] = (qs[j] & 0x0F) * d + m;
+        y[j + QK / 2] = (qs[j] >> 4) * d + m;
+    }
+}
+
+// block_q5_0 { f16 d; u8 qh[4]; u8 qs[16]; }：第 5 位来自 qh，x = (q - 16) * d
+void dequantize_q5_0(const std::byte *b, float *y) {
+    float d = f16(b);
+    uint32_t qh;
+    std::memcpy(&qh, b + 2, sizeof(qh));
+    const uint8_t *qs = u8(b + 6);
+    for (size_t j = 0; j < QK / 2; j++) {
+        int x0 = static_cast<int>((qs[j] & 0x0F) | (((qh >> j) << 4) & 0x10)) - 16;
+        int x1 = static_cast<int>((qs[j] >> 4) | ((qh >> (j + 12)) & 0x10)) - 16;
+        y[j] = x0 * d;
+        y[j + QK / 2] = x1 * d;
+    }
+}
+
+// block_q5_1 { f16 d; f16 m; u8 qh[4]; u8 qs[16]; }：x = q * d + m
+void dequantize_q5_1(const std::byte *b, float *y) {
+    float d = f16(b), m = f16(b + 2);
+    uint32_t qh;
+    std::memcpy(&qh, b + 4, sizeof(qh));
+    const uint8_t *qs = u8(b + 8);
+    for (size_t j = 0; j < QK / 2; j++) {
+        uint32_t x0 = (qs[j] & 0x0F) | (((qh >> j) << 4) & 0x10);
+        uint32_t x1 = (qs[j] >> 4) | ((qh >> (j + 12)) & 0x10);
+        y[j] = x0 * d + m;
+        y[j + QK / 2] = x1 * d + m;
+    }
+}
+
+// block_q8_0 { f16 d; i8 qs[32]; }：x = q * d
+void dequantize_q8_0(const std::byte *b, float *y) {
+    float d = f16(b);
+    const int8_t *qs = reinterpret_cast<const int8_t *>(b + 2);
+    for (size_t j = 0; j < QK; j++) {
+        y[j] = qs[j] * d;
+    }
+}
+
+// K 系列 12 字节中打包的 8 组 6 位 scale 与 min
+void scale_min_k4(size_t j, const uint8_t *q, uint8_t &sc, uint8_t &m) {
+    if (j < 4) {
+        sc = q[j] & 63;
+        m = q[j + 4] & 63;
+    } else {
+        sc = static_cast<uint8_t>((q[j + 4] & 0x0F) | ((q[j - 4] >> 6) << 4));
+        m = static_cast<uint8_t>((q[j + 4] >> 4) | ((q[j] >> 6) << 4));
+    }
+}
+
+// block_q4_K { f16 d; f16 dmin; u8 scales[12]; u8 qs[128]; }：
+// 8 个 32 元素子块，x = d * sc * q - dmin * m
+void dequantize_q4_k(const std::byte *b, float *y) {
+    float d = f16(b), dmin = f16(b + 2);
+    const uint8_t *scales = u8(b + 4);
+    const uint8_t *q = u8(b + 16);
+    for (size_t j = 0, is = 0; j < QK_K; j += 64, is += 2, q += 32) {
+        uint8_t sc, m;
+        scale_min_k4(is, scales, sc, m);
+        float d1 = d * sc, m1 = dmin * m;
+        scale_min_k4(is + 1, scales, sc, m);
+        float d2 = d * sc, m2 = dmin * m;
+        for (size_t l = 0; l < 32; l++) {
+            *y++ = d1 * (q[l] & 0x0F) - m1;
+        }
+        for (size_t l = 0; l < 32; l++) {
+            *y++ = d2 * (q[l] >> 4) - m2;
+        }
+    }
+}
+
+// block_q5_K { f16 d; f16 dmin; u8 scales[12]; u8 qh[32]; u8 qs[128]; }
+void dequantize_q5_k(const std::byte *b, float *y) {
+    float d = f16(b), dmin = f16(b + 2);
+    const uint8_t *scales = u8(b + 4);
+    const uint8_t *qh = u8(b + 16);
+    const uint8_t *ql = u8(b + 48);
+    uint8_t u1 = 1, u2 = 2;
+    for (size_t j = 0, is = 0; j < QK_K; j += 64, is += 2, ql += 32) {
+        uint8_t sc, m;
+        scale_min_k4(is, scales, sc, m);
+        float d1 = d * sc, m1 = dmin * m;
+        scale_min_k4(is + 1, scales, sc, m);
+        float d2 = d * sc, m2 = dmin * m;
+        for (size_t l = 0; l < 32; l++) {
+            *y++ = d1 * ((ql[l] & 0x0F) + (qh[l] & u1 ? 16 : 0)) - m1;
+        }
+        for (size_t l = 0; l < 32; l++) {
+            *y++ = d2 * ((ql[l] >> 4) + (qh[l] & u2 ? 16 : 0)) - m2;
+        }
+        u1 = static_cast<uint8_t>(u1 << 2);
+        u2 = static_cast<uint8_t>(u2 << 2);
+    }
+}
+
+// block_q6_K { u8 ql[128]; u8 qh[64]; i8 scales[16]; f16 d; }：x = d * sc * (q - 32)
+void dequantize_q6_k(const std::byte *b, float *y) {
+    const uint8_t *ql = u8(b);
+    const uint8_t *qh = u8(b + 128);
+    const int8_t *sc = reinterpret_cast<const int8_t *>(b + 192);
+    float d = f16(b + 208);
+    for (size_t n = 0; n < QK_K; n += 128, y += 128, ql += 64, qh += 32, sc += 8) {
+        for (size_t l = 0; l < 32; l++) {
+            size_t is = l / 16;
+            int q1 = static_cast<int>((ql[l] & 0x0F) | (((qh[l] >> 0) & 3) << 4)) - 32;
+            int q2 = static_cast<int>((ql[l + 32] & 0x0F) | (((qh[l] >> 2) & 3) << 4)) - 32;
+            int q3 = static_cast<int>((ql[l] >> 4) | (((qh[l] >> 4) & 3) << 4)) - 32;
+            int q4 = static_cast<int>((ql[l + 32] >> 4) | (((qh[l] >> 6) & 3) << 4)) - 32;
+            y[l] = d * sc[is] * q1;
+            y[l + 32] = d * sc[is + 2] * q2;
+            y[l + 64] = d * sc[is + 4] * q3;
+            y[l + 96] = d * sc[is + 6] * q4;
+        }
+    }
+}
+} // namespace
+
+const TypeTraits *traits(uint32_t type) {
+    static const TypeTraits F32_{"F32", 1, 4}, F16_{"F16", 1, 2}, Q4_0_{"Q4_0", QK, 18}, Q4_1_{"Q4_1", QK, 20},
+        Q5_0_{"Q5_0", QK, 22}, Q5_1_{"Q5_1", QK, 24}, Q8_0_{"Q8_0", QK, 34}, Q8_1_{"Q8_1", QK, 36},
+        Q2_K_{"Q2_K", QK_K, 84}, Q3_K_{"Q3_K", QK_K, 110}, Q4_K_{"Q4_K", QK_K, 144}, Q5_K_{"Q5_K", QK_K, 176},
+        Q6_K_{"Q6_K", QK_K, 210}, Q8_K_{"Q8_K", QK_K, 292}, I8_{"I8", 1, 1}, I16_{"I16", 1, 2}, I32_{"I32", 1, 4},
+        I64_{"I64", 1, 8}, F64_{"F64", 1, 8}, BF16_{"BF16", 1, 2};
+    switch (type) {
+    case F32:
+        return &F32_;
+    case F16:
+        return &F16_;
+    case Q4_0:
+        return &Q4_0_;
+    case Q4_1:
+        return &Q4_1_;
+    case Q5_0:
+        return &Q5_0_;
+    case Q5_1:
+        return &Q5_1_;
+    case Q8_0:
+        return &Q8_0_;
+    case Q8_1:
+        return &Q8_1_;
+    case Q2_K:
+        return &Q2_K_;
+    case Q3_K:
+        return &Q3_K_;
+    case Q4_K:
+        return &Q4_K_;
+    case Q5_K:
+        return &Q5_K_;
+    case Q6_K:
+        return &Q6_K_;
+    case Q8_K:
+        return &Q8_K_;
+    case I8:
+        return &I8_;
+    case I16:
+        return &I16_;
+    case I32:
+        return &I32_;
+    case I64:
+        return &I64_;
+    case F64:
+        return &F64_;
+    case BF16:
+        return &BF16_;
+    default:
+        return nullptr;
+    }
+}
+
+bool is_quantized(uint32_t type) {
+    const TypeTraits *t = traits(type);
+    return t == nullptr || t->block_size > 1;
+}
+
+bool can_dequantize(uint32_t type) {
+    switch (type) {
+    case Q4_0:
+    case Q4_1:
+    case Q5_0:
+    case Q5_1:
+    case Q8_0:
+    case Q4_K:
+    case Q5_K:
+    case Q6_K:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void dequantize_row(uint32_t type, const std::byte *src, float *dst, size_t n) {
+    const TypeTraits *t = traits(type);
+    CHECK_ARGUMENT(can_dequantize(type), std::string("gguf: cannot dequantize ggml type ") + (t ? t->name : "unknown"));
+    void (*block)(const std::byte *, float *) = nullptr;
+    switch (type) {
+    case Q4_0:
+        block = dequantize_q4_0;
+        break;
+    case Q4_1:
+        block = dequantize_q4_1;
+        break;
+    case Q5_0:
+        block = dequantize_q5_0;
+        break;
+    case Q5_1:
+        block = dequantize_q5_1;
+        break;
+    case Q8_0:
+        block = dequantize_q8_0;
+        break;
+    case Q4_K:
+        block = dequantize_q4_k;
+        break;
+    case Q5_K:
+        block = dequantize_q5_k;
+        break;
+    case Q6_K:
+        block = dequantize_q6_k;
+        break;
+    }
+    for (size_t i = 0; i < n / t->block_size; i++) {
+        block(src + i * t->type_size, dst + i * t->block_size);
+    }
+}
+
+void split_q4_0_row(const std::byte *src, uint8_t *q, float *scales, uint8_t *zeros, size_t n) {
+    for (size_t i = 0; i < n / QK; i++) {
+        const std::byte *b = src + i * 18;
+        scales[i] = f16(b);
+        zeros[i] = 8;
+        std::memcpy(q + i * (QK / 2), b + 2, QK / 2);
+    }
+}
+} // namespace llaisys::loader::ggml
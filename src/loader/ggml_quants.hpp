@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace llaisys::loader::ggml {
+// ggml（GGUF）张量类型编号，与 ggml.h 中的 enum ggml_type 一致
+enum Type : uint32_t {
+    F32 = 0,
+    F16 = 1,
+    Q4_0 = 2,
+    Q4_1 = 3,
+    Q5_0 = 6,
+    Q5_1 = 7,
+    Q8_0 = 8,
+    Q8_1 = 9,
+    Q2_K = 10,
+    Q3_K = 11,
+    Q4_K = 12,
+    Q5_K = 13,
+    Q6_K = 14,
+    Q8_K = 15,
+    I8 = 24,
+    I16 = 25,
+    I32 = 26,
+    I64 = 27,
+    F64 = 28,
+    BF16 = 30,
+};
+
+struct TypeTraits {
+    const char *name;
+    size_t block_size; // 每块元素数，非量化类型为 1
+    size_t type_size;  // 每块字节数
+};
+
+// 未知类型返回 nullptr
+const TypeTraits *traits(uint32_t type);
+
+bool is_quantized(uint32_t type);
+
+// 本仓库能反量化的类型（Q4_0/Q4_1/Q5_0/Q5_1/Q8_0/Q4_K/Q5_K/Q6_K）
+bool can_dequantize(uint32_t type);
+
+// 把一行 n 个元素（n 为块大小的整数倍）反量化为 float
+void dequantize_row(uint32_t type, const std::byte *src, float *dst, size_t n);
+
+// Q4_0 的一行拆成 linear_int4 的布局：块内 qs 的字节顺序（第 j 个字节低 4 位为第 j 个元素、
+// 高 4 位为第 j + 16 个元素）与之相同，直接拷贝；scale 取块的 d，zero 恒为 8
+void split_q4_0_row(const std::byte *src, uint8_t *q, float *scales, uint8_t *zeros, size_t n);
+} // namespace llaisys::loader::ggml
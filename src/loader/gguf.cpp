@@ -0,0 +1,391 @@
+#include "gguf.hpp"
+
+#include "ggml_quants.hpp"
+
+#include "../ops/cast/op.hpp"
+#include "../utils.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace llaisys::loader {
+
+namespace {
+constexpr uint32_t GGUF_MAGIC = 0x46554747; // "GGUF"
+constexpr size_t GGUF_DEFAULT_ALIGNMENT = 32;
+
+// 元数据值类型
+enum ValueType : uint32_t {
+    GGUF_UINT8 = 0,
+    GGUF_INT8 = 1,
+    GGUF_UINT16 = 2,
+    GGUF_INT16 = 3,
+    GGUF_UINT32 = 4,
+    GGUF_INT32 = 5,
+    GGUF_FLOAT32 = 6,
+    GGUF_BOOL = 7,
+    GGUF_STRING = 8,
+    GGUF_ARRAY = 9,
+    GGUF_UINT64 = 10,
+    GGUF_INT64 = 11,
+    GGUF_FLOAT64 = 12,
+};
+
+// 带越界检查的顺序读取
+class Reader {
+private:
+    const std::byte *_p;
+    const std::byte *_end;
+
+public:
+    Reader(const std::byte *begin, const std::byte *end) : _p(begin), _end(end) {}
+
+    const std::byte *take(size_t n) {
+        CHECK_ARGUMENT(static_cast<size_t>(_end - _p) >= n, "gguf: unexpected end of file");
+        const std::byte *p = _p;
+        _p += n;
+        return p;
+    }
+
+    template <typename T>
+    T read() {
+        T v;
+        std::memcpy(&v, take(sizeof(T)), sizeof(T));
+        return v;
+    }
+
+    std::string string() {
+        uint64_t len = read<uint64_t>();
+        const std::byte *p = take(len);
+        return std::string(reinterpret_cast<const char *>(p), len);
+    }
+
+    size_t offset(const std::byte *base) const { return static_cast<size_t>(_p - base); }
+};
+
+std::string format_float(double v, int digits) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.*g", digits, v);
+    return buf;
+}
+
+// 读一个 type 类型的值；标量转为字符串，数组跳过并返回长度
+std::string read_value(Reader &r, uint32_t type) {
+    switch (type) {
+    case GGUF_UINT8:
+        return std::to_string(r.read<uint8_t>());
+    case GGUF_INT8:
+        return std::to_string(r.read<int8_t>());
+    case GGUF_UINT16:
+        return std::to_string(r.read<uint16_t>());
+    case GGUF_INT16:
+        return std::to_string(r.read<int16_t>());
+    case GGUF_UINT32:
+        return std::to_string(r.read<uint32_t>());
+    case GGUF_INT32:
+        return std::to_string(r.read<int32_t>());
+    case GGUF_UINT64:
+        return std::to_string(r.read<uint64_t>());
+    case GGUF_INT64:
+        return std::to_string(r.read<int64_t>());
+    case GGUF_FLOAT32:
+        return format_float(r.read<float>(), 9);
+    case GGUF_FLOAT64:
+        return format_float(r.read<double>(), 17);
+    case GGUF_BOOL:
+        return r.read<uint8_t>() ? "true" : "false";
+    case GGUF_STRING:
+        return r.string();
+    case GGUF_ARRAY: {
+        uint32_t elem_type = r.read<uint32_t>();
+        uint64_t n = r.read<uint64_t>();
+        for (uint64_t i = 0; i < n; i++) {
+            read_value(r, elem_type);
+        }
+        return std::to_string(n);
+    }
+    default:
+        CHECK_ARGUMENT(false, "gguf: unknown metadata value type " + std::to_string(type));
+    }
+}
+
+// llama.cpp 张量名 -> HuggingFace 张量名
+std::string hf_name(const std::string &name) {
+    static const std::unordered_map<std::string, std::string> global{
+        {"token_embd.weight", "model.embed_tokens.weight"},
+        {"output_norm.weight", "model.norm.weight"},
+        {"output.weight", "lm_head.weight"},
+    };
+    static const std::unordered_map<std::string, std::string> layer{
+        {"attn_norm.weight", "input_layernorm.weight"},
+        {"attn_q.weight", "self_attn.q_proj.weight"},
+        {"attn_q.bias", "self_attn.q_proj.bias"},
+        {"attn_k.weight", "self_attn.k_proj.weight"},
+        {"attn_k.bias", "self_attn.k_proj.bias"},
+        {"attn_v.weight", "self_attn.v_proj.weight"},
+        {"attn_v.bias", "self_attn.v_proj.bias"},
+        {"attn_output.weight", "self_attn.o_proj.weight"},
+        {"ffn_norm.weight", "post_attention_layernorm.weight"},
+        {"ffn_gate.weight", "mlp.gate_proj.weight"},
+        {"ffn_up.weight", "mlp.up_proj.weight"},
+        {"ffn_down.weight", "mlp.down_proj.weight"},
+    };
+    if (auto it = global.find(name); it != global.end()) {
+        return it->second;
+    }
+    // blk.<N>.<rest>
+    if (name.rfind("blk.", 0) == 0) {
+        size_t dot = name.find('.', 4);
+        if (dot != std::string::npos && dot > 4 &&
+            name.find_first_not_of("0123456789", 4) == dot) {
+            if (auto it = layer.find(name.substr(dot + 1)); it != layer.end()) {
+                return "model.layers." + name.substr(4, dot - 4) + "." + it->second;
+            }
+        }
+    }
+    return name;
+}
+
+llaisysDataType_t llaisys_dtype(uint32_t type) {
+    switch (type) {
+    case ggml::F32:
+        return LLAISYS_DTYPE_F32;
+    case ggml::F16:
+        return LLAISYS_DTYPE_F16;
+    case ggml::BF16:
+        return LLAISYS_DTYPE_BF16;
+    case ggml::F64:
+        return LLAISYS_DTYPE_F64;
+    case ggml::I8:
+        return LLAISYS_DTYPE_I8;
+    case ggml::I16:
+        return LLAISYS_DTYPE_I16;
+    case ggml::I32:
+        return LLAISYS_DTYPE_I32;
+    case ggml::I64:
+        return LLAISYS_DTYPE_I64;
+    default:
+        return LLAISYS_DTYPE_INVALID;
+    }
+}
+
+bool is_float(llaisysDataType_t dtype) {
+    return dtype == LLAISYS_DTYPE_F32 || dtype == LLAISYS_DTYPE_F16 || dtype == LLAISYS_DTYPE_BF16;
+}
+
+std::string type_name(uint32_t type) {
+    const ggml::TypeTraits *t = ggml::traits(type);
+    return t ? t->name : "type " + std::to_string(type);
+}
+
+template <typename T>
+void store_row(std::byte *dst, const float *src, size_t n) {
+    T *out = reinterpret_cast<T *>(dst);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = utils::cast<T>(src[i]);
+    }
+}
+} // namespace
+
+std::shared_ptr<GGUFFile> GGUFFile::open(const std::string &path) {
+    std::shared_ptr<GGUFFile> gguf(new GGUFFile());
+    gguf->_file = MappedFile::open(path);
+    const std::byte *data = gguf->_file->data();
+    size_t file_size = gguf->_file->size();
+    Reader r(data, data + file_size);
+
+    CHECK_ARGUMENT(r.read<uint32_t>() == GGUF_MAGIC, "gguf: bad magic: " + path);
+    gguf->_version = r.read<uint32_t>();
+    CHECK_ARGUMENT(gguf->_version == 2 || gguf->_version == 3,
+                   "gguf: unsupported version " + std::to_string(gguf->_version) + ": " + path);
+    uint64_t ntensors = r.read<uint64_t>();
+    uint64_t nmeta = r.read<uint64_t>();
+
+    size_t alignment = GGUF_DEFAULT_ALIGNMENT;
+    for (uint64_t i = 0; i < nmeta; i++) {
+        std::string key = r.string();
+        uint32_t type = r.read<uint32_t>();
+        std::string value = read_value(r, type);
+        if (type == GGUF_ARRAY) {
+            gguf->_metadata[key + ".length"] = value;
+            continue;
+        }
+        if (key == "general.alignment") {
+            alignment = std::stoull(value);
+            CHECK_ARGUMENT(alignment > 0 && (alignment & (alignment - 1)) == 0, "gguf: bad general.alignment");
+        }
+        gguf->_metadata[key] = std::move(value);
+    }
+
+    std::vector<uint64_t> offsets;
+    for (uint64_t i = 0; i < ntensors; i++) {
+        Entry entry;
+        entry.gguf_name = r.string();
+        entry.name = hf_name(entry.gguf_name);
+        uint32_t ndim = r.read<uint32_t>();
+        CHECK_ARGUMENT(ndim >= 1 && ndim <= 4, "gguf: bad ndim for " + entry.gguf_name);
+        entry.shape.resize(ndim);
+        for (uint32_t d = 0; d < ndim; d++) {
+            entry.shape[ndim - 1 - d] = r.read<uint64_t>();
+        }
+        entry.type = r.read<uint32_t>();
+        offsets.push_back(r.read<uint64_t>());
+
+        size_t numel = 0;
+        CHECK_ARGUMENT(utils::checked_numel(entry.shape, numel), "gguf: shape too large for " + entry.gguf_name);
+        entry.nbytes = 0;
+        if (const ggml::TypeTraits *t = ggml::traits(entry.type)) {
+            CHECK_ARGUMENT(entry.shape.back() % t->block_size == 0,
+                           "gguf: row size is not a multiple of the block size for " + entry.gguf_name);
+            CHECK_ARGUMENT(utils::checked_mul(numel / t->block_size, t->type_size, entry.nbytes),
+                           "gguf: shape too large for " + entry.gguf_name);
+        }
+        gguf->_entries.push_back(std::move(entry));
+    }
+
+    size_t data_begin = (r.offset(data) + alignment - 1) / alignment * alignment;
+    for (size_t i = 0; i < gguf->_entries.size(); i++) {
+        Entry &entry = gguf->_entries[i];
+        CHECK_ARGUMENT(offsets[i] % alignment == 0 && data_begin <= file_size && offsets[i] <= file_size - data_begin
+                           && entry.nbytes <= file_size - data_begin - offsets[i],
+                       "gguf: bad data offset for " + entry.gguf_name);
+        entry.begin = data_begin + offsets[i];
+        gguf->_index[entry.name] = i;
+        gguf->_index[entry.gguf_name] = i;
+    }
+
+    // 映射记为权重
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+    gguf->_storage = core::context().runtime().wrapHostStorage(gguf->_file->data(), file_size, gguf->_file);
+    return gguf;
+}
+
+const std::vector<GGUFFile::Entry> &GGUFFile::entries() const {
+    return _entries;
+}
+
+const std::map<std::string, std::string> &GGUFFile::metadata() const {
+    return _metadata;
+}
+
+const GGUFFile::Entry *GGUFFile::find(const std::string &name) const {
+    auto it = _index.find(name);
+    return it == _index.end() ? nullptr : &_entries[it->second];
+}
+
+tensor_t GGUFFile::tensor(const Entry &entry, llaisysDataType_t dtype) const {
+    // 转换、反量化出的张量记为权重
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+    llaisysDataType_t stored = llaisys_dtype(entry.type);
+    if (stored != LLAISYS_DTYPE_INVALID) {
+        tensor_t src = Tensor::create(entry.shape, stored, _storage, entry.begin);
+        if (dtype != LLAISYS_DTYPE_INVALID && dtype != stored && is_float(stored)) {
+            tensor_t dst = Tensor::create(entry.shape, dtype);
+            ops::cast(dst, src);
+            return dst;
+        }
+        return src;
+    }
+
+    CHECK_ARGUMENT(ggml::can_dequantize(entry.type),
+                   "gguf: unsupported ggml type " + type_name(entry.type) + " for " + entry.gguf_name);
+    if (dtype == LLAISYS_DTYPE_INVALID) {
+        dtype = LLAISYS_DTYPE_F32;
+    }
+    CHECK_ARGUMENT(is_float(dtype), "gguf: quantized tensors can only be dequantized to F32/F16/BF16");
+
+    const ggml::TypeTraits *t = ggml::traits(entry.type);
+    size_t cols = entry.shape.back();
+    size_t rows = entry.nbytes / (cols / t->block_size * t->type_size);
+    size_t src_row_bytes = cols / t->block_size * t->type_size;
+    size_t dst_row_bytes = cols * utils::dsize(dtype);
+    const std::byte *src = _file->data() + entry.begin;
+    _file->prefetch(entry.begin, entry.nbytes);
+
+    // 分配依赖线程局部的 Context，在主线程完成
+    tensor_t dst = Tensor::create(entry.shape, dtype);
+    std::byte *out = dst->data();
+#pragma omp parallel
+    {
+        std::vector<float> row(cols);
+#pragma omp for schedule(static)
+        for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(rows); i++) {
+            float *y = dtype == LLAISYS_DTYPE_F32 ? reinterpret_cast<float *>(out + i * dst_row_bytes) : row.data();
+            ggml::dequantize_row(entry.type, src + i * src_row_bytes, y, cols);
+            if (dtype == LLAISYS_DTYPE_BF16) {
+                store_row<bf16_t>(out + i * dst_row_bytes, y, cols);
+            } else if (dtype == LLAISYS_DTYPE_F16) {
+                store_row<fp16_t>(out + i * dst_row_bytes, y, cols);
+            }
+        }
+    }
+    return dst;
+}
+
+bool GGUFFile::int4(const Entry &entry, tensor_t &q, tensor_t &scales, tensor_t &zeros) const {
+    if (entry.type != ggml::Q4_0 || entry.shape.size() != 2) {
+        return false;
+    }
+    size_t rows = entry.shape[0];
+    size_t cols = entry.shape[1];
+    size_t n_groups = cols / 32;
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+    q = Tensor::create({rows, cols / 2}, LLAISYS_DTYPE_U8);
+    scales = Tensor::create({rows, n_groups}, LLAISYS_DTYPE_F32);
+    zeros = Tensor::create({rows, n_groups}, LLAISYS_DTYPE_U8);
+
+    const std::byte *src = _file->data() + entry.begin;
+    size_t row_bytes = n_groups * 18;
+    uint8_t *q_ = reinterpret_cast<uint8_t *>(q->data());
+    float *scales_ = reinterpret_cast<float *>(scales->data());
+    uint8_t *zeros_ = reinterpret_cast<uint8_t *>(zeros->data());
+#pragma omp parallel for schedule(static)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(rows); i++) {
+        ggml::split_q4_0_row(src + i * row_bytes, q_ + i * (cols / 2), scales_ + i * n_groups,
+                             zeros_ + i * n_groups, cols);
+    }
+    return true;
+}
+
+LlaisysQwen2Meta GGUFFile::qwen2Meta(llaisysDataType_t dtype) const {
+    auto get = [this](const std::string &key) -> const std::string * {
+        auto it = _metadata.find(key);
+        return it == _metadata.end() ? nullptr : &it->second;
+    };
+    const std::string *arch_value = get("general.architecture");
+    CHECK_ARGUMENT(arch_value != nullptr, "gguf: missing general.architecture");
+    const std::string arch = *arch_value + ".";
+    auto required = [&](const std::string &key) -> const std::string & {
+        const std::string *v = get(arch + key);
+        CHECK_ARGUMENT(v != nullptr, "gguf: missing " + arch + key);
+        return *v;
+    };
+    auto number = [&](const std::string &key, double fallback) {
+        const std::string *v = get(key);
+        return v ? std::stod(*v) : fallback;
+    };
+
+    const Entry *embed = find("model.embed_tokens.weight");
+    CHECK_ARGUMENT(embed != nullptr && embed->shape.size() == 2, "gguf: missing token_embd.weight");
+
+    LlaisysQwen2Meta meta{};
+    meta.nlayer = std::stoull(required("block_count"));
+    meta.hs = std::stoull(required("embedding_length"));
+    meta.nh = std::stoull(required("attention.head_count"));
+    meta.nkvh = static_cast<size_t>(number(arch + "attention.head_count_kv", static_cast<double>(meta.nh)));
+    meta.dh = static_cast<size_t>(number(arch + "attention.key_length", static_cast<double>(meta.hs / meta.nh)));
+    meta.di = std::stoull(required("feed_forward_length"));
+    meta.maxseq = std::stoull(required("context_length"));
+    meta.voc = embed->shape[0];
+    meta.epsilon = std::stof(required("attention.layer_norm_rms_epsilon"));
+    meta.theta = static_cast<float>(number(arch + "rope.freq_base", 10000.0));
+    meta.end_token = static_cast<int64_t>(number("tokenizer.ggml.eos_token_id", -1));
+    if (dtype == LLAISYS_DTYPE_INVALID) {
+        llaisysDataType_t embed_dtype = llaisys_dtype(embed->type);
+        dtype = is_float(embed_dtype) ? embed_dtype : LLAISYS_DTYPE_BF16;
+    }
+    meta.dtype = dtype;
+    return meta;
+}
+
+} // namespace llaisys::loader
@@ -0,0 +1,69 @@
+#pragma once
+#include "mapped_file.hpp"
+
+#include "../tensor/tensor.hpp"
+
+#include "llaisys/models/qwen2.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::loader {
+// GGUF 文件读取器（llama.cpp 的模型格式，版本 2/3）。
+//
+// 文件布局（小端）：
+//     u32 magic "GGUF"，u32 version，u64 ntensors，u64 nmeta
+//     元数据       nmeta 个 (string key, u32 type, value)，string 为 u64 长度 + 字节
+//     张量信息     ntensors 个 (string name, u32 ndim, u64 ne[ndim], u32 ggml_type, u64 offset)
+//     数据区       按 general.alignment（默认 32）对齐，offset 相对数据区起点
+//
+// ne[0] 是最内层维度，因此张量形状为 ne 的逆序；[out, in] 的权重与 HuggingFace 布局一致。
+// 张量名按 llama.cpp 的命名（blk.N.attn_q.weight 等）映射为 HuggingFace 命名
+// （model.layers.N.self_attn.q_proj.weight 等），与 safetensors/.llaisys 的加载路径共用一套名字。
+class GGUFFile {
+public:
+    struct Entry {
+        std::string name;      // HuggingFace 命名，无对应时与 gguf_name 相同
+        std::string gguf_name;
+        uint32_t type;         // ggml 类型，见 ggml_quants.hpp
+        std::vector<size_t> shape;
+        size_t begin;          // 相对文件起点的字节偏移
+        size_t nbytes;         // 类型未知时为 0
+    };
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    uint32_t _version = 0;
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, size_t> _index;
+    // 标量元数据转为字符串（整数十进制、浮点 %.9g、布尔 true/false）；数组只记录长度，
+    // 键为 "<key>.length"
+    std::map<std::string, std::string> _metadata;
+    core::storage_t _storage;
+
+    GGUFFile() = default;
+
+public:
+    static std::shared_ptr<GGUFFile> open(const std::string &path);
+
+    uint32_t version() const { return _version; }
+    const std::vector<Entry> &entries() const;
+    const std::map<std::string, std::string> &metadata() const;
+    // 按 HuggingFace 命名或 GGUF 原名查找，不存在时返回 nullptr
+    const Entry *find(const std::string &name) const;
+
+    // 非量化类型：dtype 为 INVALID 或与存储类型相同时零拷贝，浮点之间按需转换。
+    // 量化类型：逐行反量化为 dtype（F32/F16/BF16，INVALID 时为 F32）
+    tensor_t tensor(const Entry &entry, llaisysDataType_t dtype = LLAISYS_DTYPE_INVALID) const;
+
+    // Q4_0 可直接由 linear_int4 计算：拆成 q [out, in / 2] U8、scales [out, in / 32] F32、
+    // zeros [out, in / 32] U8（恒为 8），只拷贝不重新量化。其余类型返回 false
+    bool int4(const Entry &entry, tensor_t &q, tensor_t &scales, tensor_t &zeros) const;
+
+    // 由 <arch>.* 元数据与张量形状填写模型配置，dtype 为 INVALID 时取词嵌入的浮点类型，
+    // 词嵌入被量化时取 BF16
+    LlaisysQwen2Meta qwen2Meta(llaisysDataType_t dtype = LLAISYS_DTYPE_INVALID) const;
+};
+} // namespace llaisys::loader
@@ -0,0 +1,136 @@
+#include "layer_stream.hpp"
+
+#include "../utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace llaisys::loader {
+
+LayerStream::LayerStream(std::shared_ptr<MappedFile> file, std::vector<std::vector<Range>> layers, size_t depth)
+    : _file(std::move(file)), _layers(std::move(layers)), _states(_layers.size(), State::IDLE) {
+    // 预取的层数超过总层数没有意义（会预取到正在计算的层）
+    _depth = _layers.empty() ? 0 : std::min(depth, _layers.size() - 1);
+    for (const auto &ranges : _layers) {
+        for (const auto &r : ranges) {
+            CHECK_ARGUMENT(r.offset <= _file->size() && r.size <= _file->size() - r.offset,
+                           "layer stream: range exceeds file size");
+        }
+    }
+    if (_depth > 0) {
+        _worker = std::thread(&LayerStream::run, this);
+    }
+}
+
+LayerStream::~LayerStream() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+size_t LayerStream::touch(size_t layer) const {
+    // 先对整层发起异步预读，再逐页访问等待读入；按 4 KiB 步进对更大的页同样有效
+    constexpr size_t STEP = 4096;
+    const volatile std::byte *data = _file->data();
+    size_t nbytes = 0;
+    for (const auto &r : _layers[layer]) {
+        _file->prefetch(r.offset, r.size);
+    }
+    for (const auto &r : _layers[layer]) {
+        if (r.size == 0) {
+            continue;
+        }
+        for (size_t off = r.offset; off < r.offset + r.size; off += STEP) {
+            (void)data[off];
+        }
+        (void)data[r.offset + r.size - 1];
+        nbytes += r.size;
+    }
+    return nbytes;
+}
+
+void LayerStream::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [&] { return _stop || !_queue.empty(); });
+        if (_stop) {
+            return;
+        }
+        size_t layer = _queue.front();
+        _queue.pop_front();
+        // 出队前可能已被 release 或由 acquire 自行读入
+        if (_states[layer] != State::QUEUED) {
+            continue;
+        }
+        _states[layer] = State::LOADING;
+        lock.unlock();
+        size_t nbytes = touch(layer);
+        lock.lock();
+        _stats.nbytes_prefetched += nbytes;
+        if (_states[layer] == State::LOADING) {
+            _states[layer] = State::READY;
+        }
+        _cv.notify_all();
+    }
+}
+
+void LayerStream::acquire(size_t layer) {
+    CHECK_ARGUMENT(layer < _layers.size(), "layer stream: layer index out of range");
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _stats.acquires++;
+
+    // 先排队后续层，本层未命中时与本层的读入重叠
+    for (size_t k = 1; k <= _depth; k++) {
+        size_t next = (layer + k) % _layers.size();
+        if (_states[next] == State::IDLE) {
+            _states[next] = State::QUEUED;
+            _queue.push_back(next);
+        }
+    }
+    if (!_queue.empty()) {
+        _cv.notify_all();
+    }
+
+    if (_states[layer] == State::READY) {
+        _stats.hits++;
+        return;
+    }
+    _cv.wait(lock, [&] { return _states[layer] != State::LOADING; });
+    if (_states[layer] != State::READY) {
+        // 未排队、仍在排队或已被释放：在调用线程读入
+        _states[layer] = State::LOADING;
+        lock.unlock();
+        size_t nbytes = touch(layer);
+        lock.lock();
+        _stats.nbytes_loaded += nbytes;
+        _states[layer] = State::READY;
+        _cv.notify_all();
+    }
+    _stats.wait_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LayerStream::release(size_t layer) {
+    CHECK_ARGUMENT(layer < _layers.size(), "layer stream: layer index out of range");
+    size_t nbytes = 0;
+    for (const auto &r : _layers[layer]) {
+        _file->release(r.offset, r.size);
+        nbytes += r.size;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _states[layer] = State::IDLE;
+    _stats.nbytes_released += nbytes;
+    _cv.notify_all();
+}
+
+LayerStream::Stats LayerStream::stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+} // namespace llaisys::loader
@@ -0,0 +1,71 @@
+#pragma once
+#include "mapped_file.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace llaisys::loader {
+// 按层流式驻留映射文件中的权重，用于权重大于内存的模型（out-of-core）。
+//
+// 权重始终留在文件中（mmap），只有正在计算的层和预取的后续层占用内存：
+//     acquire(L)  阻塞直到第 L 层的页全部读入，并让后台线程预取 L+1 .. L+depth 层
+//                 （越过最后一层时回到第 0 层，对应下一步解码）
+//     release(L)  第 L 层算完，其页标记为冷页，内存紧张时优先回收
+// acquire 时该层已由后台线程读完记为命中，命中率反映预取能否跟上计算。
+class LayerStream {
+public:
+    // 文件中的一段字节区间
+    struct Range {
+        size_t offset;
+        size_t size;
+    };
+
+    struct Stats {
+        size_t acquires = 0;
+        size_t hits = 0;                 // acquire 时该层已预取完成
+        double wait_ms = 0;              // acquire 中等待读盘的总时间
+        size_t nbytes_prefetched = 0;    // 后台线程读入的字节数
+        size_t nbytes_loaded = 0;        // 未命中时在调用线程读入的字节数
+        size_t nbytes_released = 0;
+    };
+
+private:
+    enum class State {
+        IDLE,    // 不保证驻留
+        QUEUED,  // 等待后台线程预取
+        LOADING, // 后台线程正在读
+        READY,   // 已读入，直到 release
+    };
+
+    std::shared_ptr<MappedFile> _file;
+    std::vector<std::vector<Range>> _layers;
+    size_t _depth;
+    std::vector<State> _states;
+    std::deque<size_t> _queue;
+    Stats _stats;
+    bool _stop = false;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::thread _worker;
+
+    // 逐页读一个字节，把层的所有页读入并建立映射
+    size_t touch(size_t layer) const;
+    void run();
+
+public:
+    // layers[i] 为第 i 层权重占用的区间；depth 为 acquire 时向后预取的层数，0 表示不预取
+    LayerStream(std::shared_ptr<MappedFile> file, std::vector<std::vector<Range>> layers, size_t depth = 1);
+    ~LayerStream();
+
+    LayerStream(const LayerStream &) = delete;
+    LayerStream &operator=(const LayerStream &) = delete;
+
+    size_t numLayers() const { return _layers.size(); }
+    void acquire(size_t layer);
+    void release(size_t layer);
+    Stats stats() const;
+};
+} // namespace llaisys::loader
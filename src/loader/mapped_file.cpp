@@ -0,0 +1,137 @@
+#include "mapped_file.hpp"
+
+#include "../utils.hpp"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace llaisys::loader {
+
+#if defined(_WIN32)
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->_path = path;
+
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    CHECK_ARGUMENT(handle != INVALID_HANDLE_VALUE, "cannot open file: " + path);
+    file->_file = handle;
+
+    LARGE_INTEGER size;
+    ASSERT(GetFileSizeEx(handle, &size), "cannot stat file: " + path);
+    file->_size = static_cast<size_t>(size.QuadPart);
+    if (file->_size == 0) {
+        return file;
+    }
+
+    // PAGE_WRITECOPY + FILE_MAP_COPY 对应写时复制
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    ASSERT(mapping != nullptr, "cannot map file: " + path);
+    file->_mapping = mapping;
+    file->_data = static_cast<std::byte *>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+    ASSERT(file->_data != nullptr, "cannot map file: " + path);
+    return file;
+}
+
+void MappedFile::prefetch(size_t offset, size_t size) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    WIN32_MEMORY_RANGE_ENTRY range{_data + offset, (std::min)(size, _size - offset)};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedFile::release(size_t offset, size_t size) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    // 对未锁定的页，VirtualUnlock 把它们移出工作集
+    VirtualUnlock(_data + offset, (std::min)(size, _size - offset));
+}
+
+MappedFile::~MappedFile() {
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping) {
+        CloseHandle(static_cast<HANDLE>(_mapping));
+    }
+    if (_file) {
+        CloseHandle(static_cast<HANDLE>(_file));
+    }
+}
+
+#else
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->_path = path;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    CHECK_ARGUMENT(fd >= 0, "cannot open file: " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        ASSERT(false, "cannot stat file: " + path);
+    }
+    file->_size = static_cast<size_t>(st.st_size);
+    if (file->_size > 0) {
+        void *addr = ::mmap(nullptr, file->_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        ASSERT(addr != MAP_FAILED, "cannot map file: " + path);
+        file->_data = static_cast<std::byte *>(addr);
+    } else {
+        ::close(fd);
+    }
+    return file;
+}
+
+void MappedFile::prefetch(size_t offset, size_t size) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    // madvise 要求起始地址按页对齐
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    size_t end = std::min(offset + size, _size);
+    ::madvise(_data + begin, end - begin, MADV_WILLNEED);
+}
+
+void MappedFile::release(size_t offset, size_t size) const {
+    if (!_data || offset >= _size) {
+        return;
+    }
+    // 只处理完整落在范围内的页，不影响相邻数据。MAP_PRIVATE 下 MADV_DONTNEED 会丢弃
+    // 写入过的页，所以用 MADV_COLD（Linux 5.4+），旧内核上不做处理
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = std::min(offset + size, _size) / page * page;
+#ifdef MADV_COLD
+    if (begin < end) {
+        ::madvise(_data + begin, end - begin, MADV_COLD);
+    }
+#else
+    (void)begin;
+    (void)end;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (_data) {
+        ::munmap(_data, _size);
+    }
+}
+
+#endif
+
+} // namespace llaisys::loader
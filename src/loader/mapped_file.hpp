@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace llaisys::loader {
+// 只读打开并整体映射一个文件。映射为写时复制（MAP_PRIVATE），未被写入的页在进程间共享，
+// 对映射内存的写入只影响本进程。对象析构时解除映射，通过 shared_ptr 在多个 Storage 间共享。
+class MappedFile {
+private:
+    std::byte *_data = nullptr;
+    size_t _size = 0;
+    std::string _path;
+#if defined(_WIN32)
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#endif
+    MappedFile() = default;
+
+public:
+    static std::shared_ptr<MappedFile> open(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // 提示内核异步预读 [offset, offset + size)，不阻塞
+    void prefetch(size_t offset, size_t size) const;
+    // 把 [offset, offset + size) 标记为冷页：内容不变，内存紧张时优先回收，再次访问时从文件读回
+    void release(size_t offset, size_t size) const;
+
+    std::byte *data() const { return _data; }
+    size_t size() const { return _size; }
+    const std::string &path() const { return _path; }
+};
+} // namespace llaisys::loader
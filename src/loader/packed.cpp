@@ -0,0 +1,339 @@
+#include "packed.hpp"
+
+#include "../ops/cast/op.hpp"
+#include "../utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace llaisys::loader {
+
+namespace {
+template <typename T>
+void put(std::vector<std::byte> &buf, T value) {
+    const std::byte *p = reinterpret_cast<const std::byte *>(&value);
+    buf.insert(buf.end(), p, p + sizeof(T));
+}
+
+void put_string(std::vector<std::byte> &buf, const std::string &s) {
+    put<uint32_t>(buf, static_cast<uint32_t>(s.size()));
+    const std::byte *p = reinterpret_cast<const std::byte *>(s.data());
+    buf.insert(buf.end(), p, p + s.size());
+}
+
+// 64 位内容摘要，只用来筛选可能相同的张量，命中后仍逐字节比较
+uint64_t digest(uint64_t h, const void *data, size_t n) {
+    constexpr uint64_t K = 0x9E3779B97F4A7C15ull;
+    const std::byte *p = static_cast<const std::byte *>(data);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+        uint64_t w;
+        std::memcpy(&w, p + i, sizeof(w));
+        h = (h ^ w) * K;
+        h ^= h >> 29;
+    }
+    for (; i < n; i++) {
+        h = (h ^ static_cast<uint64_t>(p[i])) * K;
+    }
+    return h;
+}
+
+// 64 位的文件定位，long 在 Windows 上只有 32 位，超过 2 GiB 的偏移不能用 fseek
+int seek64(std::FILE *fp, uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(fp, static_cast<__int64>(offset), SEEK_SET);
+#else
+    return fseeko(fp, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+// 带边界检查的顺序读取
+class Reader {
+private:
+    const std::byte *_p;
+    const std::byte *_end;
+
+public:
+    Reader(const std::byte *begin, const std::byte *end) : _p(begin), _end(end) {}
+
+    template <typename T>
+    T get() {
+        ASSERT(static_cast<size_t>(_end - _p) >= sizeof(T), "packed: truncated table");
+        T value;
+        std::memcpy(&value, _p, sizeof(T));
+        _p += sizeof(T);
+        return value;
+    }
+
+    std::string string() {
+        uint32_t len = get<uint32_t>();
+        ASSERT(static_cast<size_t>(_end - _p) >= len, "packed: truncated table");
+        std::string s(reinterpret_cast<const char *>(_p), len);
+        _p += len;
+        return s;
+    }
+};
+} // namespace
+
+// ---------- PackWriter ----------
+
+PackWriter::PackWriter(const std::string &path) : _path(path) {
+    // 去重时要读回已写出的数据做比较，不必为此保留源张量
+    _fp = std::fopen(path.c_str(), "w+b");
+    CHECK_ARGUMENT(_fp != nullptr, "cannot create file: " + path);
+    // 先占位，finish() 时回填
+    PackFileHeader header{};
+    write(&header, sizeof(header));
+}
+
+PackWriter::~PackWriter() {
+    if (_fp) {
+        // 未 finish 的文件不完整，删除
+        std::fclose(_fp);
+        std::remove(_path.c_str());
+    }
+}
+
+void PackWriter::write(const void *data, size_t size) {
+    ASSERT(_fp != nullptr, "packed: writer already finished");
+    ASSERT(std::fwrite(data, 1, size, _fp) == size, "packed: write failed: " + _path);
+    _pos += size;
+}
+
+void PackWriter::pad() {
+    static const std::byte zeros[PACK_ALIGNMENT] = {};
+    size_t n = (PACK_ALIGNMENT - _pos % PACK_ALIGNMENT) % PACK_ALIGNMENT;
+    write(zeros, n);
+}
+
+void PackWriter::setMetadata(const std::string &key, const std::string &value) {
+    _metadata[key] = value;
+}
+
+void PackWriter::record(Record rec) {
+    CHECK_ARGUMENT(_index.find(rec.name) == _index.end(), "packed: duplicate tensor " + rec.name);
+    _index[rec.name] = _records.size();
+    _records.push_back(std::move(rec));
+}
+
+bool PackWriter::equals(uint64_t offset, const std::byte *data, size_t nbytes) {
+    constexpr size_t CHUNK = size_t(1) << 20;
+    std::vector<std::byte> buf(std::min(nbytes, CHUNK));
+    ASSERT(seek64(_fp, offset) == 0, "packed: seek failed: " + _path);
+    bool same = true;
+    for (size_t done = 0; same && done < nbytes; done += buf.size()) {
+        size_t n = std::min(buf.size(), nbytes - done);
+        ASSERT(std::fread(buf.data(), 1, n, _fp) == n, "packed: read back failed: " + _path);
+        same = std::memcmp(buf.data(), data + done, n) == 0;
+    }
+    // 回到文件末尾继续写
+    ASSERT(seek64(_fp, _pos) == 0, "packed: seek failed: " + _path);
+    return same;
+}
+
+void PackWriter::add(const std::string &name, const std::vector<tensor_t> &parts, llaisysDataType_t dtype) {
+    CHECK_ARGUMENT(!parts.empty(), "packed: no tensor given for " + name);
+    const tensor_t &first = parts[0];
+    llaisysDataType_t src_dtype = first->dtype();
+    std::vector<size_t> shape = first->shape();
+    CHECK_ARGUMENT(!shape.empty() || parts.size() == 1, "packed: cannot concatenate scalars for " + name);
+    for (size_t i = 1; i < parts.size(); i++) {
+        CHECK_ARGUMENT(parts[i]->dtype() == src_dtype, "packed: parts of " + name + " differ in dtype");
+        CHECK_ARGUMENT(parts[i]->ndim() == shape.size()
+                           && std::equal(shape.begin() + 1, shape.end(), parts[i]->shape().begin() + 1),
+                       "packed: parts of " + name + " differ in trailing shape");
+        shape[0] += parts[i]->shape()[0];
+    }
+    bool convert = dtype != LLAISYS_DTYPE_INVALID && dtype != src_dtype
+                && (src_dtype == LLAISYS_DTYPE_F32 || src_dtype == LLAISYS_DTYPE_F16 || src_dtype == LLAISYS_DTYPE_BF16);
+    llaisysDataType_t out_dtype = convert ? dtype : src_dtype;
+
+    // 转换是确定的，源数据与转换方式相同则输出相同，所以摘要按转换前的数据计算
+    std::vector<tensor_t> srcs;
+    uint64_t h = digest(0, shape.data(), shape.size() * sizeof(size_t));
+    uint32_t types[2] = {static_cast<uint32_t>(src_dtype), static_cast<uint32_t>(out_dtype)};
+    h = digest(h, types, sizeof(types));
+    for (const auto &part : parts) {
+        CHECK_ARGUMENT(part->deviceType() == LLAISYS_DEVICE_CPU, "packed: tensors must be on CPU");
+        srcs.push_back(part->isContiguous() ? part : part->contiguous());
+        h = digest(h, srcs.back()->data(), srcs.back()->numel() * srcs.back()->elementSize());
+    }
+    auto converted = [&](const tensor_t &src) {
+        if (!convert) {
+            return src;
+        }
+        tensor_t dst = Tensor::create(src->shape(), out_dtype);
+        ops::cast(dst, src);
+        return dst;
+    };
+
+    auto [lo, hi] = _digests.equal_range(h);
+    for (auto it = lo; it != hi; ++it) {
+        const Record &rec = _records[it->second];
+        if (rec.dtype != out_dtype || rec.shape != shape) {
+            continue;
+        }
+        bool same = true;
+        uint64_t offset = rec.offset;
+        for (size_t i = 0; same && i < srcs.size(); i++) {
+            tensor_t data = converted(srcs[i]);
+            size_t n = data->numel() * data->elementSize();
+            same = equals(offset, data->data(), n);
+            offset += n;
+        }
+        if (same) {
+            _shared_bytes += rec.nbytes;
+            record({name, out_dtype, shape, rec.offset, rec.nbytes});
+            return;
+        }
+    }
+
+    pad();
+    uint64_t offset = _pos;
+    for (const auto &src : srcs) {
+        tensor_t data = converted(src);
+        write(data->data(), data->numel() * data->elementSize());
+    }
+    record({name, out_dtype, shape, offset, _pos - offset});
+    _digests.emplace(h, _records.size() - 1);
+}
+
+void PackWriter::alias(const std::string &name, const std::string &target) {
+    auto it = _index.find(target);
+    CHECK_ARGUMENT(it != _index.end(), "packed: no tensor named " + target + " to alias as " + name);
+    Record rec = _records[it->second];
+    rec.name = name;
+    _shared_bytes += rec.nbytes;
+    record(std::move(rec));
+}
+
+void PackWriter::finish() {
+    pad();
+    uint64_t table_offset = _pos;
+    std::vector<std::byte> table;
+    for (const auto &[key, value] : _metadata) {
+        put_string(table, key);
+        put_string(table, value);
+    }
+    for (const auto &rec : _records) {
+        put_string(table, rec.name);
+        put<uint32_t>(table, static_cast<uint32_t>(rec.dtype));
+        put<uint32_t>(table, static_cast<uint32_t>(PackLayout::ROW_MAJOR));
+        put<uint32_t>(table, static_cast<uint32_t>(rec.shape.size()));
+        for (size_t d : rec.shape) {
+            put<uint64_t>(table, d);
+        }
+        put<uint64_t>(table, rec.offset);
+        put<uint64_t>(table, rec.nbytes);
+    }
+    write(table.data(), table.size());
+
+    PackFileHeader header{};
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.alignment = PACK_ALIGNMENT;
+    header.ntensors = _records.size();
+    header.nmeta = _metadata.size();
+    header.table_offset = table_offset;
+    header.table_size = table.size();
+    ASSERT(seek64(_fp, 0) == 0, "packed: seek failed: " + _path);
+    ASSERT(std::fwrite(&header, 1, sizeof(header), _fp) == sizeof(header), "packed: write failed: " + _path);
+    ASSERT(std::fclose(_fp) == 0, "packed: close failed: " + _path);
+    _fp = nullptr;
+}
+
+// ---------- PackedFile ----------
+
+std::shared_ptr<PackedFile> PackedFile::open(const std::string &path) {
+    std::shared_ptr<PackedFile> pf(new PackedFile());
+    pf->_file = MappedFile::open(path);
+    const std::byte *data = pf->_file->data();
+    size_t file_size = pf->_file->size();
+
+    CHECK_ARGUMENT(file_size >= sizeof(PackFileHeader), "packed: file too small: " + path);
+    PackFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    CHECK_ARGUMENT(std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0, "packed: not a .llaisys file: " + path);
+    CHECK_ARGUMENT(header.version == PACK_VERSION,
+                   "packed: unsupported version " + std::to_string(header.version) + " in " + path);
+    CHECK_ARGUMENT(header.table_offset <= file_size && header.table_size <= file_size - header.table_offset,
+                   "packed: table exceeds file size: " + path);
+
+    Reader reader(data + header.table_offset, data + header.table_offset + header.table_size);
+    for (uint64_t i = 0; i < header.nmeta; i++) {
+        std::string key = reader.string();
+        pf->_metadata[key] = reader.string();
+    }
+    for (uint64_t i = 0; i < header.ntensors; i++) {
+        Entry entry;
+        entry.name = reader.string();
+        entry.dtype = static_cast<llaisysDataType_t>(reader.get<uint32_t>());
+        entry.layout = static_cast<PackLayout>(reader.get<uint32_t>());
+        uint32_t ndim = reader.get<uint32_t>();
+        for (uint32_t d = 0; d < ndim; d++) {
+            entry.shape.push_back(reader.get<uint64_t>());
+        }
+        entry.begin = reader.get<uint64_t>();
+        entry.nbytes = reader.get<uint64_t>();
+        CHECK_ARGUMENT(entry.layout == PackLayout::ROW_MAJOR, "packed: unsupported layout for " + entry.name);
+        CHECK_ARGUMENT(entry.begin <= header.table_offset && entry.nbytes <= header.table_offset - entry.begin,
+                       "packed: bad data range for " + entry.name);
+        size_t numel = 0, nbytes = 0;
+        CHECK_ARGUMENT(utils::checked_numel(entry.shape, numel) && utils::checked_mul(numel, utils::dsize(entry.dtype), nbytes),
+                       "packed: shape too large for " + entry.name);
+        CHECK_ARGUMENT(entry.nbytes == nbytes, "packed: size mismatch for " + entry.name);
+        pf->_index[entry.name] = pf->_entries.size();
+        pf->_entries.push_back(std::move(entry));
+    }
+
+    // 映射记为权重
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+    pf->_storage = core::context().runtime().wrapHostStorage(pf->_file->data(), file_size, pf->_file);
+    return pf;
+}
+
+const std::vector<PackedFile::Entry> &PackedFile::entries() const {
+    return _entries;
+}
+
+const std::map<std::string, std::string> &PackedFile::metadata() const {
+    return _metadata;
+}
+
+const PackedFile::Entry *PackedFile::find(const std::string &name) const {
+    auto it = _index.find(name);
+    return it == _index.end() ? nullptr : &_entries[it->second];
+}
+
+tensor_t PackedFile::tensor(const Entry &entry) const {
+    return Tensor::create(entry.shape, entry.dtype, _storage, entry.begin);
+}
+
+tensor_t PackedFile::tensor(const std::string &name) const {
+    const Entry *entry = find(name);
+    CHECK_ARGUMENT(entry != nullptr, "packed: no tensor named " + name);
+    return tensor(*entry);
+}
+
+std::shared_ptr<LayerStream> PackedFile::streamLayers(size_t depth) const {
+    static const std::string prefix = "model.layers.";
+    std::vector<std::vector<LayerStream::Range>> layers;
+    for (const auto &entry : _entries) {
+        if (entry.name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        size_t end = entry.name.find('.', prefix.size());
+        std::string index = entry.name.substr(prefix.size(), end - prefix.size());
+        if (index.empty() || index.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        size_t layer = std::stoul(index);
+        if (layer >= layers.size()) {
+            layers.resize(layer + 1);
+        }
+        layers[layer].push_back({entry.begin, entry.nbytes});
+    }
+    return std::make_shared<LayerStream>(_file, std::move(layers), depth);
+}
+
+} // namespace llaisys::loader
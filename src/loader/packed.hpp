@@ -0,0 +1,128 @@
+#pragma once
+#include "layer_stream.hpp"
+#include "mapped_file.hpp"
+
+#include "../tensor/tensor.hpp"
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::loader {
+// 预打包模型格式（.llaisys），离线生成，加载时只需映射文件，不做任何转换。
+//
+// 文件布局（小端）：
+//     [0, 64)        FileHeader
+//     数据区         每个张量的数据按 alignment（页大小）对齐，已是内核直接使用的布局与类型
+//     元数据表       nmeta 个 (u32 key_len, key, u32 value_len, value)
+//     张量表         ntensors 个 (u32 name_len, name, u32 dtype, u32 layout, u32 ndim,
+//                    u64 shape[ndim], u64 offset, u64 nbytes)
+//
+// 格式变化时增加 PACK_VERSION，读取端拒绝不匹配的版本。
+constexpr char PACK_MAGIC[8] = {'L', 'L', 'A', 'I', 'S', 'Y', 'S', '\0'};
+constexpr uint32_t PACK_VERSION = 1;
+constexpr uint32_t PACK_ALIGNMENT = 4096;
+
+// 张量数据的布局
+enum class PackLayout : uint32_t {
+    ROW_MAJOR = 0, // 行主序连续存储
+};
+
+struct PackFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t alignment;
+    uint64_t ntensors;
+    uint64_t nmeta;
+    uint64_t table_offset; // 元数据表起点，张量表紧随其后
+    uint64_t table_size;
+    uint64_t reserved[2];
+};
+static_assert(sizeof(PackFileHeader) == 64, "PackFileHeader must be 64 bytes");
+
+// 顺序写出 .llaisys 文件：依次 add() 张量，最后 finish() 写出元数据表与张量表。
+// 张量表中的多个条目可以指向同一段数据（见 alias() 与 add() 的去重），加载后共享同一块映射
+class PackWriter {
+private:
+    struct Record {
+        std::string name;
+        llaisysDataType_t dtype;
+        std::vector<size_t> shape;
+        uint64_t offset;
+        uint64_t nbytes;
+    };
+
+    std::FILE *_fp = nullptr;
+    std::string _path;
+    uint64_t _pos = 0;
+    std::vector<Record> _records;
+    std::unordered_map<std::string, size_t> _index;
+    // 已写出数据的内容摘要 -> 记录下标，用于发现内容相同的张量
+    std::unordered_multimap<uint64_t, size_t> _digests;
+    std::map<std::string, std::string> _metadata;
+    uint64_t _shared_bytes = 0;
+
+    void write(const void *data, size_t size);
+    void pad();
+    void record(Record rec);
+    // 已写出的 [offset, offset + nbytes) 是否与 data 逐字节相同
+    bool equals(uint64_t offset, const std::byte *data, size_t nbytes);
+
+public:
+    explicit PackWriter(const std::string &path);
+    ~PackWriter();
+
+    PackWriter(const PackWriter &) = delete;
+    PackWriter &operator=(const PackWriter &) = delete;
+
+    void setMetadata(const std::string &key, const std::string &value);
+    // 把 parts 沿第 0 维拼接为一个张量写出（如把 q/k/v 权重融合为 qkv），
+    // dtype 不为 INVALID 时把浮点数据转换为 dtype。
+    // 与已写出的张量类型、形状、内容都相同时不再写数据，条目指向已有的那一份
+    void add(const std::string &name, const std::vector<tensor_t> &parts, llaisysDataType_t dtype);
+    // name 与已写出的 target 共用数据（如 tie_word_embeddings 时 lm_head 与词嵌入是同一矩阵）
+    void alias(const std::string &name, const std::string &target);
+    // 因共用数据而未写出的字节数
+    uint64_t sharedBytes() const { return _shared_bytes; }
+    void finish();
+};
+
+// 只读映射 .llaisys 文件，tensor() 返回直接指向映射的 CPU 张量
+class PackedFile {
+public:
+    struct Entry {
+        std::string name;
+        llaisysDataType_t dtype;
+        PackLayout layout;
+        std::vector<size_t> shape;
+        size_t begin;
+        size_t nbytes;
+    };
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, size_t> _index;
+    std::map<std::string, std::string> _metadata;
+    core::storage_t _storage;
+
+    PackedFile() = default;
+
+public:
+    static std::shared_ptr<PackedFile> open(const std::string &path);
+
+    const std::vector<Entry> &entries() const;
+    const std::map<std::string, std::string> &metadata() const;
+    // 不存在时返回 nullptr
+    const Entry *find(const std::string &name) const;
+
+    tensor_t tensor(const Entry &entry) const;
+    tensor_t tensor(const std::string &name) const;
+
+    // 按 model.layers.N. 前缀把张量分层，返回逐层驻留的 LayerStream（见 layer_stream.hpp），
+    // 其余张量（词嵌入、最后的 norm、lm_head）不参与分层，照常按需读入
+    std::shared_ptr<LayerStream> streamLayers(size_t depth = 1) const;
+};
+} // namespace llaisys::loader
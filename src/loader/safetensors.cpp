@@ -0,0 +1,481 @@
+#include "safetensors.hpp"
+
+#include "../ops/cast/op.hpp"
+#include "../utils.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace llaisys::loader {
+
+namespace {
+// safetensors 头部所需的最小 JSON 解析器：对象、数组、字符串、非负整数，
+// 其余值（true/false/null/小数）仅跳过
+class HeaderParser {
+private:
+    const char *_p;
+    const char *_end;
+
+    [[noreturn]] void fail(const char *what) const {
+        std::cerr << "[ERROR] safetensors: malformed header, " << what << EXCEPTION_LOCATION_MSG << std::endl;
+        throw std::runtime_error("malformed safetensors header");
+    }
+
+    void skipSpace() {
+        while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) {
+            _p++;
+        }
+    }
+
+    void expect(char c) {
+        skipSpace();
+        if (_p >= _end || *_p != c) {
+            fail("unexpected character");
+        }
+        _p++;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (_p < _end && *_p == c) {
+            _p++;
+            return true;
+        }
+        return false;
+    }
+
+    void appendUtf8(std::string &out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    uint32_t hex4() {
+        if (_end - _p < 4) {
+            fail("truncated escape");
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++, _p++) {
+            char c = *_p;
+            v <<= 4;
+            if (c >= '0' && c <= '9') {
+                v |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                v |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                v |= c - 'A' + 10;
+            } else {
+                fail("bad escape");
+            }
+        }
+        return v;
+    }
+
+public:
+    HeaderParser(const char *begin, const char *end) : _p(begin), _end(end) {}
+
+    std::string string() {
+        expect('"');
+        std::string out;
+        while (true) {
+            if (_p >= _end) {
+                fail("unterminated string");
+            }
+            char c = *_p++;
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (_p >= _end) {
+                fail("unterminated string");
+            }
+            switch (char e = *_p++) {
+            case '"':
+            case '\\':
+            case '/':
+                out += e;
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                uint32_t cp = hex4();
+                // 代理对
+                if (cp >= 0xD800 && cp < 0xDC00 && _end - _p >= 6 && _p[0] == '\\' && _p[1] == 'u') {
+                    _p += 2;
+                    uint32_t lo = hex4();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default:
+                fail("bad escape");
+            }
+        }
+    }
+
+    size_t integer() {
+        skipSpace();
+        if (_p >= _end || *_p < '0' || *_p > '9') {
+            fail("expected a non-negative integer");
+        }
+        size_t v = 0;
+        while (_p < _end && *_p >= '0' && *_p <= '9') {
+            size_t digit = static_cast<size_t>(*_p++ - '0');
+            if (v > (SIZE_MAX - digit) / 10) {
+                fail("integer out of range");
+            }
+            v = v * 10 + digit;
+        }
+        return v;
+    }
+
+    std::vector<size_t> integers() {
+        std::vector<size_t> out;
+        expect('[');
+        if (consume(']')) {
+            return out;
+        }
+        do {
+            out.push_back(integer());
+        } while (consume(','));
+        expect(']');
+        return out;
+    }
+
+    // 依次对对象的每个键调用 f(key)，f 负责解析对应的值
+    template <typename F>
+    void object(F &&f) {
+        expect('{');
+        if (consume('}')) {
+            return;
+        }
+        do {
+            std::string key = string();
+            expect(':');
+            f(key);
+        } while (consume(','));
+        expect('}');
+    }
+
+    void skipValue() {
+        skipSpace();
+        if (_p >= _end) {
+            fail("unexpected end");
+        }
+        switch (*_p) {
+        case '"':
+            string();
+            break;
+        case '{':
+            object([this](const std::string &) { skipValue(); });
+            break;
+        case '[':
+            _p++;
+            if (consume(']')) {
+                break;
+            }
+            do {
+                skipValue();
+            } while (consume(','));
+            expect(']');
+            break;
+        default:
+            while (_p < _end && *_p != ',' && *_p != '}' && *_p != ']') {
+                _p++;
+            }
+        }
+    }
+
+    bool done() {
+        skipSpace();
+        return _p == _end;
+    }
+};
+
+// 小于该字节数的张量不单独开多线程，而是与相邻的小张量一起并行转换
+constexpr size_t SMALL_TENSOR_BYTES = size_t(1) << 20;
+// 预读窗口：转换当前张量时，保证其后这么多字节已经提交预读
+constexpr size_t PREFETCH_BYTES = size_t(256) << 20;
+
+bool is_float(llaisysDataType_t dtype) {
+    return dtype == LLAISYS_DTYPE_F32 || dtype == LLAISYS_DTYPE_F16 || dtype == LLAISYS_DTYPE_BF16;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+llaisysDataType_t parse_dtype(const std::string &s) {
+    static const std::unordered_map<std::string, llaisysDataType_t> table{
+        {"BOOL", LLAISYS_DTYPE_BOOL},
+        {"U8", LLAISYS_DTYPE_U8},
+        {"I8", LLAISYS_DTYPE_I8},
+        {"U16", LLAISYS_DTYPE_U16},
+        {"I16", LLAISYS_DTYPE_I16},
+        {"U32", LLAISYS_DTYPE_U32},
+        {"I32", LLAISYS_DTYPE_I32},
+        {"U64", LLAISYS_DTYPE_U64},
+        {"I64", LLAISYS_DTYPE_I64},
+        {"F8_E4M3", LLAISYS_DTYPE_F8},
+        {"F16", LLAISYS_DTYPE_F16},
+        {"BF16", LLAISYS_DTYPE_BF16},
+        {"F32", LLAISYS_DTYPE_F32},
+        {"F64", LLAISYS_DTYPE_F64},
+    };
+    auto it = table.find(s);
+    CHECK_ARGUMENT(it != table.end(), "safetensors: unsupported dtype " + s);
+    return it->second;
+}
+} // namespace
+
+std::shared_ptr<SafeTensors> SafeTensors::open(const std::string &path) {
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<SafeTensors> st(new SafeTensors());
+    st->_file = MappedFile::open(path);
+
+    const std::byte *data = st->_file->data();
+    size_t file_size = st->_file->size();
+    CHECK_ARGUMENT(file_size >= 8, "safetensors: file too small: " + path);
+
+    uint64_t header_len = 0;
+    for (int i = 7; i >= 0; i--) {
+        header_len = (header_len << 8) | static_cast<uint8_t>(data[i]);
+    }
+    CHECK_ARGUMENT(header_len <= file_size - 8, "safetensors: header exceeds file size: " + path);
+    size_t data_begin = 8 + header_len;
+    size_t data_size = file_size - data_begin;
+
+    const char *header = reinterpret_cast<const char *>(data + 8);
+    HeaderParser parser(header, header + header_len);
+    parser.object([&](const std::string &key) {
+        if (key == "__metadata__") {
+            parser.object([&](const std::string &meta_key) {
+                st->_metadata[meta_key] = parser.string();
+            });
+            return;
+        }
+
+        Entry entry{key, LLAISYS_DTYPE_INVALID, {}, 0, 0};
+        std::vector<size_t> offsets;
+        parser.object([&](const std::string &field) {
+            if (field == "dtype") {
+                entry.dtype = parse_dtype(parser.string());
+            } else if (field == "shape") {
+                entry.shape = parser.integers();
+            } else if (field == "data_offsets") {
+                offsets = parser.integers();
+            } else {
+                parser.skipValue();
+            }
+        });
+
+        CHECK_ARGUMENT(entry.dtype != LLAISYS_DTYPE_INVALID, "safetensors: missing dtype for " + key);
+        CHECK_ARGUMENT(offsets.size() == 2 && offsets[0] <= offsets[1] && offsets[1] <= data_size,
+                       "safetensors: bad data_offsets for " + key);
+        size_t numel = 0, nbytes = 0;
+        CHECK_ARGUMENT(utils::checked_numel(entry.shape, numel) && utils::checked_mul(numel, utils::dsize(entry.dtype), nbytes),
+                       "safetensors: shape too large for " + key);
+        entry.begin = data_begin + offsets[0];
+        entry.nbytes = offsets[1] - offsets[0];
+        CHECK_ARGUMENT(entry.nbytes == nbytes, "safetensors: size mismatch for " + key);
+
+        st->_index[key] = st->_entries.size();
+        st->_entries.push_back(std::move(entry));
+    });
+    ASSERT(parser.done(), "safetensors: trailing data in header");
+
+    // 整个映射作为一块主机 Storage，所有张量共享；Storage 持有映射的引用，记为权重
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+    st->_storage = core::context().runtime().wrapHostStorage(st->_file->data(), file_size, st->_file);
+    st->_open_ms = elapsed_ms(start);
+    return st;
+}
+
+const std::vector<SafeTensors::Entry> &SafeTensors::entries() const {
+    return _entries;
+}
+
+const std::map<std::string, std::string> &SafeTensors::metadata() const {
+    return _metadata;
+}
+
+const SafeTensors::Entry *SafeTensors::find(const std::string &name) const {
+    auto it = _index.find(name);
+    return it == _index.end() ? nullptr : &_entries[it->second];
+}
+
+tensor_t SafeTensors::tensor(const Entry &entry) const {
+    return Tensor::create(entry.shape, entry.dtype, _storage, entry.begin);
+}
+
+tensor_t SafeTensors::tensor(const std::string &name) const {
+    const Entry *entry = find(name);
+    CHECK_ARGUMENT(entry != nullptr, "safetensors: no tensor named " + name);
+    return tensor(*entry);
+}
+
+tensor_t SafeTensors::tensor(const Entry &entry, llaisysDataType_t dtype,
+                             llaisysDeviceType_t device_type, int device) const {
+    // 转换、拷贝出的张量记为权重
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+    tensor_t src = tensor(entry);
+    if (dtype != LLAISYS_DTYPE_INVALID && dtype != entry.dtype && is_float(entry.dtype)) {
+        tensor_t dst = Tensor::create(entry.shape, dtype);
+        ops::cast(dst, src);
+        src = dst;
+    }
+    if (device_type != LLAISYS_DEVICE_CPU) {
+        core::MemoryCategoryScope device_weights(core::context().runtime(device_type, device), LLAISYS_MEMORY_WEIGHTS);
+        src = src->to(device_type, device);
+    }
+    return src;
+}
+
+std::vector<tensor_t> SafeTensors::loadAll(llaisysDataType_t dtype, llaisysDeviceType_t device_type, int device,
+                                           LoadStats *stats) const {
+    auto start = std::chrono::steady_clock::now();
+    LoadStats local;
+    local.open_ms = _open_ms;
+    core::MemoryCategoryScope weights(core::context().runtime(), LLAISYS_MEMORY_WEIGHTS);
+
+    local.ntensors = _entries.size();
+
+    std::vector<tensor_t> out(_entries.size());
+
+    // 与前面某个张量类型、形状、内容都相同时记下那个张量的下标，只处理第一个。
+    // 内容不同的张量一般在开头就不同，memcmp 很快返回
+    std::vector<size_t> first(_entries.size());
+    std::map<std::pair<llaisysDataType_t, std::vector<size_t>>, std::vector<size_t>> groups;
+    for (size_t i = 0; i < _entries.size(); i++) {
+        const Entry &e = _entries[i];
+        auto &group = groups[{e.dtype, e.shape}];
+        first[i] = i;
+        for (size_t j : group) {
+            if (std::memcmp(_file->data() + e.begin, _file->data() + _entries[j].begin, e.nbytes) == 0) {
+                first[i] = j;
+                break;
+            }
+        }
+        if (first[i] == i) {
+            group.push_back(i);
+        } else {
+            local.nbytes_shared += e.nbytes;
+        }
+    }
+
+    auto needs_cast = [&](const Entry &e) {
+        return dtype != LLAISYS_DTYPE_INVALID && dtype != e.dtype && is_float(e.dtype);
+    };
+
+    // 预读：保证 [当前位置, 当前位置 + PREFETCH_BYTES) 已提交
+    size_t prefetched = 0;
+    auto prefetch_until = [&](size_t end) {
+        if (end > prefetched) {
+            _file->prefetch(prefetched, end - prefetched);
+            prefetched = end;
+        }
+    };
+
+    // 连续的一批小张量一起并行转换
+    std::vector<size_t> batch;
+    auto flush = [&]() {
+        // 分配依赖线程局部的 Context，在主线程完成
+        std::vector<tensor_t> srcs;
+        for (size_t idx : batch) {
+            srcs.push_back(tensor(_entries[idx]));
+            out[idx] = Tensor::create(_entries[idx].shape, dtype);
+        }
+        ptrdiff_t n = static_cast<ptrdiff_t>(batch.size());
+#pragma omp parallel for schedule(dynamic)
+        for (ptrdiff_t i = 0; i < n; i++) {
+            ops::cast(out[batch[i]], srcs[i]);
+        }
+        batch.clear();
+    };
+
+    auto convert_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < _entries.size(); i++) {
+        const Entry &e = _entries[i];
+        if (first[i] != i) {
+            continue;
+        }
+        if (!needs_cast(e)) {
+            // 零拷贝：页面在首次访问（或拷贝到设备）时才读入
+            out[i] = tensor(e);
+            continue;
+        }
+        prefetch_until(std::min(e.begin + e.nbytes + PREFETCH_BYTES, _file->size()));
+        local.nbytes_read += e.nbytes;
+        local.nbytes_converted += e.nbytes;
+        if (e.nbytes < SMALL_TENSOR_BYTES) {
+            batch.push_back(i);
+            continue;
+        }
+        flush();
+        // 大张量：cast 内部按块多线程
+        tensor_t dst = Tensor::create(e.shape, dtype);
+        ops::cast(dst, tensor(e));
+        out[i] = dst;
+    }
+    flush();
+    local.convert_ms = elapsed_ms(convert_start);
+
+    if (device_type != LLAISYS_DEVICE_CPU) {
+        core::MemoryCategoryScope device_weights(core::context().runtime(device_type, device), LLAISYS_MEMORY_WEIGHTS);
+        auto copy_start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < out.size(); i++) {
+            if (first[i] != i) {
+                continue;
+            }
+            prefetch_until(std::min(_entries[i].begin + _entries[i].nbytes + PREFETCH_BYTES, _file->size()));
+            if (!needs_cast(_entries[i])) {
+                local.nbytes_read += _entries[i].nbytes;
+            }
+            out[i] = out[i]->to(device_type, device);
+        }
+        local.copy_ms = elapsed_ms(copy_start);
+    }
+
+    for (size_t i = 0; i < out.size(); i++) {
+        if (first[i] != i) {
+            out[i] = out[first[i]]->view(_entries[i].shape);
+        }
+    }
+
+    local.total_ms = local.open_ms + elapsed_ms(start);
+    if (stats) {
+        *stats = local;
+    }
+    return out;
+}
+
+} // namespace llaisys::loader
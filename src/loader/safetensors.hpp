@@ -0,0 +1,77 @@
+#pragma once
+#include "mapped_file.hpp"
+
+#include "../tensor/tensor.hpp"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::loader {
+// safetensors 文件读取器。
+//
+// 文件格式：8 字节小端 u64 头长度 N，N 字节 JSON 头，其后为数据区。JSON 头形如
+//     {"__metadata__": {...}, "name": {"dtype": "BF16", "shape": [..], "data_offsets": [begin, end]}, ...}
+// 其中 data_offsets 相对数据区起点。
+//
+// 整个文件被映射到内存，tensor() 返回的张量直接指向映射（零拷贝），并持有映射的引用，
+// 因此 SafeTensors 对象本身可以先于张量销毁。
+class SafeTensors {
+public:
+    // 各阶段耗时（毫秒）与数据量
+    struct LoadStats {
+        double open_ms = 0;    // 映射文件、解析头部
+        double convert_ms = 0; // 分配、类型转换，缺页读盘与之重叠
+        double copy_ms = 0;    // 拷贝到目标设备
+        double total_ms = 0;
+        size_t ntensors = 0;
+        size_t nbytes_read = 0;      // 从文件读取的字节数
+        size_t nbytes_converted = 0; // 经过类型转换的源字节数
+        size_t nbytes_shared = 0;    // 与前面的张量内容相同、共用其存储而省下的字节数
+    };
+
+    struct Entry {
+        std::string name;
+        llaisysDataType_t dtype;
+        std::vector<size_t> shape;
+        size_t begin; // 相对文件起点的字节偏移
+        size_t nbytes;
+    };
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    std::vector<Entry> _entries;
+    std::unordered_map<std::string, size_t> _index;
+    std::map<std::string, std::string> _metadata;
+    core::storage_t _storage;
+    double _open_ms = 0;
+
+    SafeTensors() = default;
+
+public:
+    static std::shared_ptr<SafeTensors> open(const std::string &path);
+
+    const std::vector<Entry> &entries() const;
+    const std::map<std::string, std::string> &metadata() const;
+    // 不存在时返回 nullptr
+    const Entry *find(const std::string &name) const;
+
+    // 指向映射内存的 CPU 张量
+    tensor_t tensor(const Entry &entry) const;
+    tensor_t tensor(const std::string &name) const;
+
+    // 以 dtype 放到指定设备上：类型相同且在 CPU 上时零拷贝，否则转换/拷贝到新张量。
+    // 只转换浮点张量（F32/F16/BF16），其余类型与 dtype 为 INVALID 时保持原类型
+    tensor_t tensor(const Entry &entry, llaisysDataType_t dtype,
+                    llaisysDeviceType_t device_type = LLAISYS_DEVICE_CPU, int device = 0) const;
+
+    // 按文件顺序取出全部张量（与 entries() 一一对应）。大张量按块多线程转换，小张量之间
+    // 多线程并行；同时提前预读后续张量所在的文件区间，使读盘与转换重叠。
+    // 类型、形状与内容都和前面某个张量相同的张量（如 lm_head 与词嵌入相同的检查点）不再
+    // 转换或拷贝，返回共用那个张量存储的视图
+    std::vector<tensor_t> loadAll(llaisysDataType_t dtype,
+                                  llaisysDeviceType_t device_type = LLAISYS_DEVICE_CPU, int device = 0,
+                                  LoadStats *stats = nullptr) const;
+};
+} // namespace llaisys::loader
@@ -1,31 +1,27 @@
 #include "add_cpu.hpp"
 
-#include "../../../utils.hpp"
-
-#include <cmath>
+#include "../../elementwise/cpu/elementwise_cpu.hpp"
 
 template <typename T>
-void add_(T *c, const T *a, const T *b, size_t numel) {
-    for (size_t i = 0; i < numel; i++) {
-        if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-            c[i] = llaisys::utils::cast<T>(llaisys::utils::cast<float>(a[i]) + llaisys::utils::cast<float>(b[i]));
-        } else {
-            c[i] = a[i] + b[i];
-        }
-    }
+void add_(std::byte *c, const std::byte *a, const std::byte *b, const llaisys::shape_t &shape,
+          const llaisys::strides_t &c_strides, const llaisys::strides_t &a_strides,
+          const llaisys::strides_t &b_strides) {
+    namespace ew = llaisys::ops::cpu::elementwise;
+    // c = a + b，广播的输入 stride 为 0
+    ew::assign<T>(c, shape, c_strides, ew::add(ew::input<T>(a, a_strides), ew::input<T>(b, b_strides)));
 }
 
 namespace llaisys::ops::cpu {
-void add(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t numel) {
+void add(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type,
+         const shape_t &shape, const strides_t &c_strides,
+         const strides_t &a_strides, const strides_t &b_strides) {
     switch (type) {
     case LLAISYS_DTYPE_F32:
-        return add_(reinterpret_cast<float *>(c), reinterpret_cast<const float *>(a), reinterpret_cast<const float *>(b), numel);
+        return add_<float>(c, a, b, shape, c_strides, a_strides, b_strides);
     case LLAISYS_DTYPE_BF16:
-        return add_(reinterpret_cast<llaisys::bf16_t *>(c), reinterpret_cast<const llaisys::bf16_t *>(a),
-                    reinterpret_cast<const llaisys::bf16_t *>(b), numel);
+        return add_<llaisys::bf16_t>(c, a, b, shape, c_strides, a_strides, b_strides);
     case LLAISYS_DTYPE_F16:
-        return add_(reinterpret_cast<llaisys::fp16_t *>(c), reinterpret_cast<const llaisys::fp16_t *>(a),
-                    reinterpret_cast<const llaisys::fp16_t *>(b), numel);
+        return add_<llaisys::fp16_t>(c, a, b, shape, c_strides, a_strides, b_strides);
     default:
         EXCEPTION_UNSUPPORTED_DATATYPE(type);
     }
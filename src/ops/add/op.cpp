@@ -8,21 +8,24 @@
 namespace llaisys::ops {
 void add(tensor_t c, tensor_t a, tensor_t b) {
     CHECK_SAME_DEVICE(c, a, b);
-    // Only support contiguous inputs with same shape for now.
-    CHECK_SAME_SHAPE(c->shape(), a->shape(), b->shape());
     CHECK_SAME_DTYPE(c->dtype(), a->dtype(), b->dtype());
-    ASSERT(c->isContiguous() && a->isContiguous() && b->isContiguous(), "Add: all tensors must be contiguous.");
+    // Inputs may have arbitrary strides (e.g. permuted or sliced views) and are
+    // broadcast to the shape of c.
+    tensor_t a_ = a->shape() == c->shape() ? a : a->expand(c->shape());
+    tensor_t b_ = b->shape() == c->shape() ? b : b->expand(c->shape());
 
     // always support cpu calculation
     if (c->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::add(c->data(), a->data(), b->data(), c->dtype(), c->numel());
+        return cpu::add(c->data(), a_->data(), b_->data(), c->dtype(),
+                        c->shape(), c->strides(), a_->strides(), b_->strides());
     }
 
     llaisys::core::context().setDevice(c->deviceType(), c->deviceId());
 
     switch (c->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::add(c->data(), a->data(), b->data(), c->dtype(), c->numel());
+        return cpu::add(c->data(), a_->data(), b_->data(), c->dtype(),
+                        c->shape(), c->strides(), a_->strides(), b_->strides());
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
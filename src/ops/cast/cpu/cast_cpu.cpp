@@ -0,0 +1,43 @@
+#include "cast_cpu.hpp"
+
+#include "../../elementwise/cpu/elementwise_cpu.hpp"
+
+template <typename Tout, typename Tin>
+void cast_(std::byte *out, const std::byte *in, const llaisys::shape_t &shape,
+           const llaisys::strides_t &out_strides, const llaisys::strides_t &in_strides) {
+    namespace ew = llaisys::ops::cpu::elementwise;
+    // 加载时转换为 float，存储时转换为 Tout（就近舍入到偶数）
+    ew::assign<Tout>(out, shape, out_strides, ew::input<Tin>(in, in_strides));
+}
+
+template <typename Tout>
+void cast_(std::byte *out, const std::byte *in, llaisysDataType_t in_type, const llaisys::shape_t &shape,
+           const llaisys::strides_t &out_strides, const llaisys::strides_t &in_strides) {
+    switch (in_type) {
+    case LLAISYS_DTYPE_F32:
+        return cast_<Tout, float>(out, in, shape, out_strides, in_strides);
+    case LLAISYS_DTYPE_BF16:
+        return cast_<Tout, llaisys::bf16_t>(out, in, shape, out_strides, in_strides);
+    case LLAISYS_DTYPE_F16:
+        return cast_<Tout, llaisys::fp16_t>(out, in, shape, out_strides, in_strides);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(in_type);
+    }
+}
+
+namespace llaisys::ops::cpu {
+void cast(std::byte *out, const std::byte *in, llaisysDataType_t out_type, llaisysDataType_t in_type,
+          const shape_t &shape, const strides_t &out_strides,
+          const strides_t &in_strides) {
+    switch (out_type) {
+    case LLAISYS_DTYPE_F32:
+        return cast_<float>(out, in, in_type, shape, out_strides, in_strides);
+    case LLAISYS_DTYPE_BF16:
+        return cast_<llaisys::bf16_t>(out, in, in_type, shape, out_strides, in_strides);
+    case LLAISYS_DTYPE_F16:
+        return cast_<llaisys::fp16_t>(out, in, in_type, shape, out_strides, in_strides);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(out_type);
+    }
+}
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,14 @@
+#pragma once
+#include "llaisys.h"
+
+#include "../../../utils/small_vector.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace llaisys::ops::cpu {
+// 支持 F32/F16/BF16 之间的相互转换
+void cast(std::byte *out, const std::byte *in, llaisysDataType_t out_type, llaisysDataType_t in_type,
+          const shape_t &shape, const strides_t &out_strides,
+          const strides_t &in_strides);
+}
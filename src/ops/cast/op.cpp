@@ -0,0 +1,39 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+
+#include "../rearrange/op.hpp"
+#include "cpu/cast_cpu.hpp"
+
+namespace llaisys::ops {
+void cast(tensor_t out, tensor_t in) {
+    CHECK_SAME_DEVICE(out, in);
+    CHECK_SAME_SHAPE(out->shape(), in->shape());
+
+    // 类型相同时退化为拷贝
+    if (out->dtype() == in->dtype()) {
+        return rearrange(out, in);
+    }
+
+    if (out->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::cast(out->data(), in->data(), out->dtype(), in->dtype(), out->shape(),
+                         out->strides(), in->strides());
+    }
+
+    llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
+
+    switch (out->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::cast(out->data(), in->data(), out->dtype(), in->dtype(), out->shape(),
+                         out->strides(), in->strides());
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
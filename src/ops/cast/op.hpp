@@ -0,0 +1,8 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+// out = in 转换为 out 的数据类型，形状相同，strides 任意
+void cast(tensor_t out, tensor_t in);
+}
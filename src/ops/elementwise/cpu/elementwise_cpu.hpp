@@ -0,0 +1,312 @@
+#pragma once
+// 逐元素算子的表达式模板框架。
+//
+// 把若干逐元素运算（加、乘、除、exp、SiLU、缩放、舍入、类型转换……）在编译期组合成一棵表达式树，
+// 再由 assign() 对输出做一次遍历完成全部计算，中间结果只存在寄存器里：
+//
+//     using namespace elementwise;
+//     assign(out, shape, out_strides, mul(input(up, up_strides), silu(input(gate, gate_strides))));
+//
+// 所有输入与输出形状相同、strides 任意；stride 为 0 的维度即广播（见 Tensor::expand）。
+// 计算统一在 float 中进行，输入输出可以是 f32/f16/bf16 中的任意类型，类型转换在加载、
+// 存储时完成。最内层在所有张量中都连续（或被广播）时使用 SIMD 路径，否则逐元素按 stride
+// 访问；外层维度与长的最内层切块后用 OpenMP 并行。叶子个数在编译期确定，8 维以内的形状
+// 执行时不分配堆内存。
+#include "../../../utils.hpp"
+#include "../../../utils/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace llaisys::ops::cpu::elementwise {
+
+namespace simd = llaisys::utils::simd;
+
+// ---------- 表达式节点 ----------
+// 每个节点提供：
+//   float at(size_t i)        最内层第 i 个元素
+//   simd::VecF vec(size_t i)  从第 i 个元素开始的一个向量
+//   visit(f)                  依次对每个叶子调用 f，用于绑定每行的起始地址
+//   LEAVES                    子树中张量叶子的个数
+
+// 叶子：读取一个张量
+template <typename T>
+struct Input {
+    const T *data;
+    const strides_t *strides;
+    const T *row = nullptr;
+    ptrdiff_t step = 0;
+    static constexpr size_t LEAVES = 1;
+
+    float at(size_t i) const {
+        return simd::to_f32(row[static_cast<ptrdiff_t>(i) * step]);
+    }
+    simd::VecF vec(size_t i) const {
+        return step == 0 ? simd::set1(simd::to_f32(row[0])) : simd::load(row + i);
+    }
+    template <typename F>
+    void visit(F &&f) { f(*this); }
+};
+
+// 叶子：常量
+struct Scalar {
+    float value;
+    static constexpr size_t LEAVES = 0;
+
+    float at(size_t) const { return value; }
+    simd::VecF vec(size_t) const { return simd::set1(value); }
+    template <typename F>
+    void visit(F &&) {}
+};
+
+template <typename Op, typename A>
+struct Unary {
+    A a;
+    static constexpr size_t LEAVES = A::LEAVES;
+
+    float at(size_t i) const { return Op::apply(a.at(i)); }
+    simd::VecF vec(size_t i) const { return Op::apply(a.vec(i)); }
+    template <typename F>
+    void visit(F &&f) { a.visit(f); }
+};
+
+template <typename Op, typename A, typename B>
+struct Binary {
+    A a;
+    B b;
+    static constexpr size_t LEAVES = A::LEAVES + B::LEAVES;
+
+    float at(size_t i) const { return Op::apply(a.at(i), b.at(i)); }
+    simd::VecF vec(size_t i) const { return Op::apply(a.vec(i), b.vec(i)); }
+    template <typename F>
+    void visit(F &&f) {
+        a.visit(f);
+        b.visit(f);
+    }
+};
+
+// 把子表达式的结果舍入到 dtype（BF16/F16），用于按存储类型逐步舍入的精度策略
+template <typename A>
+struct Round {
+    A a;
+    llaisysDataType_t dtype;
+    static constexpr size_t LEAVES = A::LEAVES;
+
+    float at(size_t i) const { return simd::round_to(dtype, a.at(i)); }
+    simd::VecF vec(size_t i) const { return simd::round_to(dtype, a.vec(i)); }
+    template <typename F>
+    void visit(F &&f) { a.visit(f); }
+};
+
+// ---------- 运算 ----------
+// 同时为 float 与 simd::VecF 提供实现
+
+struct AddOp {
+    static float apply(float a, float b) { return a + b; }
+    static simd::VecF apply(simd::VecF a, simd::VecF b) { return simd::add(a, b); }
+};
+
+struct SubOp {
+    static float apply(float a, float b) { return a - b; }
+    static simd::VecF apply(simd::VecF a, simd::VecF b) { return simd::sub(a, b); }
+};
+
+struct MulOp {
+    static float apply(float a, float b) { return a * b; }
+    static simd::VecF apply(simd::VecF a, simd::VecF b) { return simd::mul(a, b); }
+};
+
+struct DivOp {
+    static float apply(float a, float b) { return a / b; }
+    static simd::VecF apply(simd::VecF a, simd::VecF b) { return simd::div(a, b); }
+};
+
+struct ExpOp {
+    static float apply(float x) { return std::exp(x); }
+    static simd::VecF apply(simd::VecF x) { return simd::exp(x); }
+};
+
+// SiLU(x) = x / (1 + e^(-x))
+struct SiluOp {
+    static float apply(float x) { return x / (1.0f + std::exp(-x)); }
+    static simd::VecF apply(simd::VecF x) {
+        simd::VecF one = simd::set1(1.0f);
+        simd::VecF e = simd::exp(simd::sub(simd::set1(0.0f), x));
+        return simd::div(x, simd::add(one, e));
+    }
+};
+
+// ---------- 构造函数 ----------
+
+template <typename T>
+Input<T> input(const T *data, const strides_t &strides) {
+    return Input<T>{data, &strides};
+}
+
+template <typename T>
+Input<T> input(const std::byte *data, const strides_t &strides) {
+    return input(reinterpret_cast<const T *>(data), strides);
+}
+
+inline Scalar scalar(float value) { return Scalar{value}; }
+
+template <typename A, typename B>
+Binary<AddOp, A, B> add(A a, B b) { return {a, b}; }
+
+template <typename A, typename B>
+Binary<SubOp, A, B> sub(A a, B b) { return {a, b}; }
+
+template <typename A, typename B>
+Binary<MulOp, A, B> mul(A a, B b) { return {a, b}; }
+
+template <typename A, typename B>
+Binary<DivOp, A, B> div(A a, B b) { return {a, b}; }
+
+template <typename A>
+Binary<MulOp, A, Scalar> scale(A a, float s) { return {a, Scalar{s}}; }
+
+template <typename A>
+Unary<ExpOp, A> exp(A a) { return {a}; }
+
+template <typename A>
+Unary<SiluOp, A> silu(A a) { return {a}; }
+
+// dtype 为 F32 时不舍入
+template <typename A>
+Round<A> round(A a, llaisysDataType_t dtype) { return {a, dtype}; }
+
+// ---------- 执行 ----------
+
+namespace detail {
+// 总元素数小于该值时不开多线程
+constexpr size_t PARALLEL_MIN_NUMEL = size_t(1) << 15;
+// 最内层切块的长度（元素个数），是向量宽度的整数倍
+constexpr size_t CHUNK = 4096;
+
+// 去掉长度为 1 的维度，并合并在所有张量中都首尾相接的相邻维度。
+// strides[k] 是第 k 个张量（0 为输出）的 strides，原地改写
+template <size_t NT>
+shape_t simplify(const shape_t &shape, std::array<strides_t, NT> &strides) {
+    shape_t new_shape;
+    std::array<strides_t, NT> new_strides;
+    for (size_t d = 0; d < shape.size(); d++) {
+        if (shape[d] == 1) {
+            continue;
+        }
+        bool mergeable = !new_shape.empty();
+        for (size_t k = 0; k < strides.size() && mergeable; k++) {
+            mergeable = new_strides[k].back() == strides[k][d] * static_cast<ptrdiff_t>(shape[d]);
+        }
+        if (mergeable) {
+            new_shape.back() *= shape[d];
+            for (size_t k = 0; k < strides.size(); k++) {
+                new_strides[k].back() = strides[k][d];
+            }
+        } else {
+            new_shape.push_back(shape[d]);
+            for (size_t k = 0; k < strides.size(); k++) {
+                new_strides[k].push_back(strides[k][d]);
+            }
+        }
+    }
+    strides = new_strides;
+    return new_shape;
+}
+} // namespace detail
+
+// out[...] = expr[...]，shape 为输出形状，所有输入 strides 的维度数与之相同
+template <typename T, typename Expr>
+void assign(T *out, const shape_t &shape, const strides_t &out_strides, Expr expr) {
+    size_t numel = 1;
+    for (size_t s : shape) {
+        numel *= s;
+    }
+    if (numel == 0) {
+        return;
+    }
+
+    // 收集所有张量的 strides：0 为输出，之后按叶子的遍历顺序
+    constexpr size_t NT = Expr::LEAVES + 1;
+    std::array<strides_t, NT> strides;
+    strides[0] = out_strides;
+    size_t leaf_index = 1;
+    expr.visit([&](auto &leaf) {
+        ASSERT(leaf.strides->size() == shape.size(), "elementwise: input and output must have the same ndim");
+        strides[leaf_index++] = *leaf.strides;
+    });
+    shape_t dims = detail::simplify(shape, strides);
+    if (dims.empty()) {
+        // 所有维度长度都为 1
+        dims.push_back(1);
+        for (auto &s : strides) {
+            s.push_back(0);
+        }
+    }
+
+    const size_t ndim = dims.size();
+    const size_t inner = dims.back();
+    size_t rows = numel / inner;
+
+    bool vectorizable = strides[0].back() == 1;
+    for (size_t k = 1; k < NT; k++) {
+        vectorizable = vectorizable && (strides[k].back() == 1 || strides[k].back() == 0);
+    }
+
+    size_t n_chunks = (inner + detail::CHUNK - 1) / detail::CHUNK;
+    ptrdiff_t units = static_cast<ptrdiff_t>(rows * n_chunks);
+
+#pragma omp parallel if (numel >= detail::PARALLEL_MIN_NUMEL)
+    {
+        // 每个线程持有一份表达式，叶子的行指针互不干扰
+        Expr e = expr;
+        std::array<ptrdiff_t, NT> offsets;
+
+#pragma omp for schedule(static)
+        for (ptrdiff_t u = 0; u < units; u++) {
+            size_t row = static_cast<size_t>(u) / n_chunks;
+            size_t begin = (static_cast<size_t>(u) % n_chunks) * detail::CHUNK;
+            size_t len = std::min(detail::CHUNK, inner - begin);
+
+            // 外层多维下标 -> 各张量的元素偏移
+            offsets.fill(0);
+            for (size_t d = ndim - 1; d > 0; d--) {
+                ptrdiff_t i = static_cast<ptrdiff_t>(row % dims[d - 1]);
+                row /= dims[d - 1];
+                for (size_t k = 0; k < NT; k++) {
+                    offsets[k] += i * strides[k][d - 1];
+                }
+            }
+            for (size_t k = 0; k < NT; k++) {
+                offsets[k] += static_cast<ptrdiff_t>(begin) * strides[k].back();
+            }
+
+            size_t k = 1;
+            e.visit([&](auto &leaf) {
+                leaf.row = leaf.data + offsets[k];
+                leaf.step = strides[k].back();
+                k++;
+            });
+
+            T *dst = out + offsets[0];
+            size_t i = 0;
+            if (vectorizable) {
+                for (; i + simd::WIDTH <= len; i += simd::WIDTH) {
+                    simd::store(dst + i, e.vec(i));
+                }
+            }
+            const ptrdiff_t step = strides[0].back();
+            for (; i < len; i++) {
+                dst[static_cast<ptrdiff_t>(i) * step] = simd::from_f32<T>(e.at(i));
+            }
+        }
+    }
+}
+
+template <typename T, typename Expr>
+void assign(std::byte *out, const shape_t &shape, const strides_t &out_strides, Expr expr) {
+    assign(reinterpret_cast<T *>(out), shape, out_strides, expr);
+}
+
+} // namespace llaisys::ops::cpu::elementwise
@@ -1,9 +1,14 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../../utils/small_vector.hpp"
+
 #include <cstddef>
+#include <vector>
 
 namespace llaisys::ops::cpu {
 void embedding(std::byte *out, const std::byte *index, const std::byte *weight, 
-               llaisysDataType_t type, size_t idx_size, size_t embd_dim);
+               llaisysDataType_t type, size_t idx_size, size_t embd_dim,
+               const strides_t &out_strides, const strides_t &index_strides,
+               const strides_t &weight_strides);
 }
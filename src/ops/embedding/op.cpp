@@ -25,10 +25,14 @@ void embedding(tensor_t out, tensor_t index, tensor_t weight) {
     ASSERT(out->shape()[0] == idx_size, "embedding: out shape[0] must match index size");
     ASSERT(out->shape()[1] == embd_dim, "embedding: out shape[1] must match weight shape[1]");
 
+    // 行间 stride 任意，但每一行内部必须连续
+    ASSERT(out->strides()[1] == 1 && weight->strides()[1] == 1, "embedding: last dimension must be contiguous");
+
     // 始终支持 CPU 计算
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::embedding(out->data(), index->data(), weight->data(), 
-                             weight->dtype(), idx_size, embd_dim);
+                             weight->dtype(), idx_size, embd_dim,
+                             out->strides(), index->strides(), weight->strides());
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
@@ -36,7 +40,8 @@ void embedding(tensor_t out, tensor_t index, tensor_t weight) {
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
         return cpu::embedding(out->data(), index->data(), weight->data(), 
-                             weight->dtype(), idx_size, embd_dim);
+                             weight->dtype(), idx_size, embd_dim,
+                             out->strides(), index->strides(), weight->strides());
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
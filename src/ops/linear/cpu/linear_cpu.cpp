@@ -1,73 +1,779 @@
 #include "linear_cpu.hpp"
 
+#include "../../../core/llaisys_core.hpp"
 #include "../../../utils.hpp"
+#include "../../../utils/simd.hpp"
 
-template <typename T>
-void linear_(T *out, const T *in, const T *weight, const T *bias,
-             size_t batch, size_t in_features, size_t out_features) {
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace simd = llaisys::utils::simd;
+using llaisys::core::Workspace;
+
+// 微内核一次计算 MB 行输入与 NB 行权重的点积块，权重向量在 MB 行之间复用
+constexpr size_t MB = 2;
+constexpr size_t NB = 4;
+// 输入按 BATCH_BLOCK 行分块，同一块的输入在处理各组权重时留在缓存里
+constexpr size_t BATCH_BLOCK = 64;
+// 计算量（batch * in_features * out_features）小于该值时不开多线程
+constexpr size_t PARALLEL_MIN_WORK = size_t(1) << 15;
+
+#if defined(__AVX512F__)
+// 每个点积只归约一次，直接落到栈上求和（GCC 12 的 512 位归约内在函数会触发 -Wmaybe-uninitialized）
+inline float reduce_add_512(__m512 x) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, x);
+    float sum = 0.0f;
+    for (float v : lanes) {
+        sum += v;
+    }
+    return sum;
+}
+
+// 以掩码加载 16 个元素并转为 f32，掩码外为 0（用 maskz 形式，非掩码形式同样会触发上述告警）
+inline __m512 load16_(const float *p, __mmask16 m) { return _mm512_maskz_loadu_ps(m, p); }
+
+inline __m512 load16_(const llaisys::bf16_t *p, __mmask16 m) {
+    __m256i x = _mm256_maskz_loadu_epi16(m, p);
+    return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(m, _mm512_maskz_cvtepu16_epi32(m, x), 16));
+}
+
+inline __m512 load16_(const llaisys::fp16_t *p, __mmask16 m) {
+    return _mm512_maskz_cvtph_ps(m, _mm256_maskz_loadu_epi16(m, p));
+}
+
+inline __m512 load16_(const int8_t *p, __mmask16 m) {
+    return _mm512_maskz_cvtepi32_ps(m, _mm512_maskz_cvtepi8_epi32(m, _mm_maskz_loadu_epi8(m, p)));
+}
+#endif
+
+// res[i][j] = in_rows[i] · w_rows[j]，f32 累加
+template <typename T, typename Tw, size_t M>
+inline void dot_block_(const T *const *in_rows, const Tw *const *w_rows, size_t k_len, float (&res)[MB][NB]) {
+#if defined(__AVX512BF16__)
+    if constexpr (std::is_same_v<T, llaisys::bf16_t> && std::is_same_v<Tw, llaisys::bf16_t>) {
+        // bf16 原生点积：vdpbf16ps 每次把 32 对 bf16 乘积累加到 16 个 f32 上，省去类型转换
+        __m512 acc[M][NB];
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                acc[i][j] = _mm512_setzero_ps();
+            }
+        }
+        for (size_t k = 0; k < k_len; k += 32) {
+            __mmask32 mask = k + 32 <= k_len ? ~__mmask32(0) : (__mmask32(1) << (k_len - k)) - 1;
+            __m512bh w[NB];
+            for (size_t j = 0; j < NB; j++) {
+                w[j] = (__m512bh)_mm512_maskz_loadu_epi16(mask, w_rows[j] + k);
+            }
+            for (size_t i = 0; i < M; i++) {
+                __m512bh x = (__m512bh)_mm512_maskz_loadu_epi16(mask, in_rows[i] + k);
+                for (size_t j = 0; j < NB; j++) {
+                    acc[i][j] = _mm512_dpbf16_ps(acc[i][j], x, w[j]);
+                }
+            }
+        }
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                res[i][j] = reduce_add_512(acc[i][j]);
+            }
+        }
+        return;
+    }
+#endif
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+    if constexpr (std::is_same_v<Tw, int8_t>) {
+        // int8 权重：每次 16 个在寄存器中转为 f32 后 FMA，内存流量只有 bf16 权重的一半
+        __m512 acc[M][NB];
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                acc[i][j] = _mm512_setzero_ps();
+            }
+        }
+        for (size_t k = 0; k < k_len; k += 16) {
+            __mmask16 mask = k + 16 <= k_len ? ~__mmask16(0) : static_cast<__mmask16>((1u << (k_len - k)) - 1);
+            __m512 w[NB];
+            for (size_t j = 0; j < NB; j++) {
+                w[j] = load16_(w_rows[j] + k, mask);
+            }
+            for (size_t i = 0; i < M; i++) {
+                __m512 x = load16_(in_rows[i] + k, mask);
+                for (size_t j = 0; j < NB; j++) {
+                    acc[i][j] = _mm512_fmadd_ps(x, w[j], acc[i][j]);
+                }
+            }
+        }
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                res[i][j] = reduce_add_512(acc[i][j]);
+            }
+        }
+        return;
+    }
+#endif
+    constexpr size_t W = simd::WIDTH;
+    simd::VecF acc[M][NB];
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            acc[i][j] = simd::set1(0.0f);
+        }
+    }
+    size_t k = 0;
+    for (; k + W <= k_len; k += W) {
+        simd::VecF w[NB];
+        for (size_t j = 0; j < NB; j++) {
+            w[j] = simd::load(w_rows[j] + k);
+        }
+        for (size_t i = 0; i < M; i++) {
+            simd::VecF x = simd::load(in_rows[i] + k);
+            for (size_t j = 0; j < NB; j++) {
+                acc[i][j] = simd::fmadd(x, w[j], acc[i][j]);
+            }
+        }
+    }
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] = simd::reduce_add(acc[i][j]);
+        }
+    }
+    for (; k < k_len; k++) {
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                res[i][j] += simd::to_f32(in_rows[i][k]) * simd::to_f32(w_rows[j][k]);
+            }
+        }
+    }
+}
+
+template <typename T, typename Tw>
+void linear_(T *out, const T *in, const Tw *weight, const T *bias, const float *scale,
+             size_t batch, size_t in_features, size_t out_features,
+             ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t weight_stride) {
     // Y = X * W^T + b
     // X: [batch, in_features]
     // W: [out_features, in_features] (注意：权重未转置)
     // Y: [batch, out_features]
     // b: [out_features] (可选)
-    
-    for (size_t b = 0; b < batch; b++) {
-        for (size_t o = 0; o < out_features; o++) {
-            float sum = 0.0f;
-            
-            // 计算点积: out[b, o] = sum(in[b, :] * weight[o, :])
-            for (size_t i = 0; i < in_features; i++) {
-                if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                    float in_val = llaisys::utils::cast<float>(in[b * in_features + i]);
-                    float w_val = llaisys::utils::cast<float>(weight[o * in_features + i]);
-                    sum += in_val * w_val;
-                } else {
-                    sum += in[b * in_features + i] * weight[o * in_features + i];
+    // scale: [out_features]，int8 权重的逐输出通道缩放，W = W_q * scale（浮点权重时为空）
+    // 各矩阵行内连续，行间 stride 任意
+    size_t n_bblocks = (batch + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    size_t n_oblocks = (out_features + NB - 1) / NB;
+    ptrdiff_t units = static_cast<ptrdiff_t>(n_bblocks * n_oblocks);
+
+#pragma omp parallel for schedule(static) if (batch * in_features * out_features >= PARALLEL_MIN_WORK)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t o0 = (static_cast<size_t>(u) % n_oblocks) * NB;
+        size_t n = std::min(NB, out_features - o0);
+        size_t b_begin = (static_cast<size_t>(u) / n_oblocks) * BATCH_BLOCK;
+        size_t b_end = std::min(batch, b_begin + BATCH_BLOCK);
+
+        // 不足 NB 行时重复最后一行权重，多算的结果丢弃
+        const Tw *w_rows[NB];
+        for (size_t j = 0; j < NB; j++) {
+            w_rows[j] = weight + static_cast<ptrdiff_t>(o0 + std::min(j, n - 1)) * weight_stride;
+        }
+
+        for (size_t b = b_begin; b < b_end; b += MB) {
+            size_t m = std::min(MB, b_end - b);
+            const T *in_rows[MB];
+            for (size_t i = 0; i < MB; i++) {
+                in_rows[i] = in + static_cast<ptrdiff_t>(b + std::min(i, m - 1)) * in_stride;
+            }
+
+            float res[MB][NB];
+            if (m == MB) {
+                dot_block_<T, Tw, MB>(in_rows, w_rows, in_features, res);
+            } else {
+                dot_block_<T, Tw, 1>(in_rows, w_rows, in_features, res);
+            }
+
+            for (size_t i = 0; i < m; i++) {
+                T *out_row = out + static_cast<ptrdiff_t>(b + i) * out_stride;
+                for (size_t j = 0; j < n; j++) {
+                    // 逐通道缩放在点积之后做一次，再加偏置(如果有)
+                    float sum = scale != nullptr ? res[i][j] * scale[o0 + j] : res[i][j];
+                    sum += bias != nullptr ? simd::to_f32(bias[o0 + j]) : 0.0f;
+                    out_row[o0 + j] = simd::from_f32<T>(sum);
+                }
+            }
+        }
+    }
+}
+
+// 参考实现：逐元素双精度累加
+template <typename T, typename Tw>
+void linear_reference_(T *out, const T *in, const Tw *weight, const T *bias, const float *scale,
+                       size_t batch, size_t in_features, size_t out_features,
+                       ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t weight_stride) {
+    ptrdiff_t units = static_cast<ptrdiff_t>(batch * out_features);
+
+#pragma omp parallel for schedule(static) if (batch * in_features * out_features >= PARALLEL_MIN_WORK)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t b = static_cast<size_t>(u) / out_features;
+        size_t o = static_cast<size_t>(u) % out_features;
+        const T *in_row = in + static_cast<ptrdiff_t>(b) * in_stride;
+        const Tw *w_row = weight + static_cast<ptrdiff_t>(o) * weight_stride;
+
+        double sum = 0.0;
+        for (size_t i = 0; i < in_features; i++) {
+            sum += static_cast<double>(simd::to_f32(in_row[i])) * simd::to_f32(w_row[i]);
+        }
+        if (scale != nullptr) {
+            sum *= scale[o];
+        }
+        if (bias != nullptr) {
+            sum += simd::to_f32(bias[o]);
+        }
+        out[static_cast<ptrdiff_t>(b) * out_stride + o] = simd::from_f32<T>(static_cast<float>(sum));
+    }
+}
+
+template <typename T, typename Tw>
+void linear_(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+             const std::byte *weight_scale, size_t batch, size_t in_features, size_t out_features,
+             ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t weight_stride, llaisysDataType_t accumulate) {
+    T *out_ = reinterpret_cast<T *>(out);
+    const T *in_ = reinterpret_cast<const T *>(in);
+    const Tw *weight_ = reinterpret_cast<const Tw *>(weight);
+    const T *bias_ = bias ? reinterpret_cast<const T *>(bias) : nullptr;
+    const float *scale_ = weight_scale ? reinterpret_cast<const float *>(weight_scale) : nullptr;
+    if (accumulate == LLAISYS_DTYPE_F64) {
+        return linear_reference_(out_, in_, weight_, bias_, scale_, batch, in_features, out_features,
+                                 out_stride, in_stride, weight_stride);
+    }
+    linear_(out_, in_, weight_, bias_, scale_, batch, in_features, out_features,
+            out_stride, in_stride, weight_stride);
+}
+
+// ---------- W8A8：int8 激活 × int8 权重 ----------
+
+// int8 点积微内核一次计算的输入行数；int32 累加器不需要转换，可以用更大的块
+constexpr size_t MB_S8 = 4;
+
+// 逐行动态量化激活：scale = max|x| / 127，q = round(x / scale)；qsum 为每行量化值之和
+template <typename T>
+void quantize_rows_(int8_t *q, float *scale, int32_t *qsum, const T *in, size_t batch, size_t k_len,
+                    ptrdiff_t in_stride, bool parallel) {
+#pragma omp parallel for schedule(static) if (parallel)
+    for (ptrdiff_t b = 0; b < static_cast<ptrdiff_t>(batch); b++) {
+        const T *row = in + b * in_stride;
+        int8_t *q_row = q + b * static_cast<ptrdiff_t>(k_len);
+        float amax = 0.0f;
+        for (size_t k = 0; k < k_len; k++) {
+            amax = std::max(amax, std::abs(simd::to_f32(row[k])));
+        }
+        float inv = amax > 0.0f ? 127.0f / amax : 0.0f;
+        int32_t sum = 0;
+        for (size_t k = 0; k < k_len; k++) {
+            float v = std::clamp(std::nearbyint(simd::to_f32(row[k]) * inv), -127.0f, 127.0f);
+            q_row[k] = static_cast<int8_t>(v);
+            sum += q_row[k];
+        }
+        scale[b] = amax / 127.0f;
+        qsum[b] = sum;
+    }
+}
+
+#if defined(__AVX512F__)
+inline int32_t reduce_add_512_epi32(__m512i x) {
+    alignas(64) int32_t lanes[16];
+    _mm512_store_si512(lanes, x);
+    int32_t sum = 0;
+    for (int32_t v : lanes) {
+        sum += v;
+    }
+    return sum;
+}
+#endif
+
+// res[i][j] = x_rows[i] · w_rows[j]，int32 累加
+template <size_t M>
+inline void dot_block_s8_(const int8_t *const *x_rows, const int32_t *const *x_qsums, const int8_t *const *w_rows,
+                          size_t k_len, int32_t (&res)[MB_S8][NB]) {
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    // vpdpbusd 的一侧必须无符号：w ^ 0x80 = w + 128 落在 [1, 255]，点积多出 128 * sum(x)，最后减去。
+    // 尾部掩码外 x 为 0，不影响结果
+    const __m512i flip = _mm512_set1_epi8(static_cast<char>(0x80));
+    __m512i acc[M][NB];
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            acc[i][j] = _mm512_setzero_si512();
+        }
+    }
+    for (size_t k = 0; k < k_len; k += 64) {
+        __mmask64 mask = k + 64 <= k_len ? ~__mmask64(0) : (__mmask64(1) << (k_len - k)) - 1;
+        __m512i w[NB];
+        for (size_t j = 0; j < NB; j++) {
+            w[j] = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, w_rows[j] + k), flip);
+        }
+        for (size_t i = 0; i < M; i++) {
+            __m512i x = _mm512_maskz_loadu_epi8(mask, x_rows[i] + k);
+            for (size_t j = 0; j < NB; j++) {
+                acc[i][j] = _mm512_dpbusd_epi32(acc[i][j], w[j], x);
+            }
+        }
+    }
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] = reduce_add_512_epi32(acc[i][j]) - 128 * *x_qsums[i];
+        }
+    }
+#else
+    (void)x_qsums;
+    size_t k = 0;
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] = 0;
+        }
+    }
+#if defined(__AVX2__)
+    // maddubs 为 u8 × s8 且成对相加时饱和到 int16：取 |w| 与 sign(w) * x，两者都不超过 127，
+    // 成对之和不超过 2 * 127 * 127，不会饱和
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc[M][NB];
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            acc[i][j] = _mm256_setzero_si256();
+        }
+    }
+    for (; k + 32 <= k_len; k += 32) {
+        __m256i w[NB], w_abs[NB];
+        for (size_t j = 0; j < NB; j++) {
+            w[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w_rows[j] + k));
+            w_abs[j] = _mm256_sign_epi8(w[j], w[j]);
+        }
+        for (size_t i = 0; i < M; i++) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x_rows[i] + k));
+            for (size_t j = 0; j < NB; j++) {
+                __m256i p = _mm256_maddubs_epi16(w_abs[j], _mm256_sign_epi8(x, w[j]));
+                acc[i][j] = _mm256_add_epi32(acc[i][j], _mm256_madd_epi16(p, ones));
+            }
+        }
+    }
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            alignas(32) int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc[i][j]);
+            for (int32_t v : lanes) {
+                res[i][j] += v;
+            }
+        }
+    }
+#endif
+    for (; k < k_len; k++) {
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                res[i][j] += static_cast<int32_t>(x_rows[i][k]) * w_rows[j][k];
+            }
+        }
+    }
+#endif
+}
+
+template <typename T>
+void linear_w8a8_(T *out, const T *in, const int8_t *weight, const T *bias, const float *scale,
+                  size_t batch, size_t in_features, size_t out_features,
+                  ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t weight_stride) {
+    // Y[b, o] = (Xq[b] · Wq[o]) * x_scale[b] * scale[o] + bias[o]
+    bool parallel = batch * in_features * out_features >= PARALLEL_MIN_WORK;
+    auto &ws = llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace();
+    std::byte *scratch = ws.shared(Workspace::bytes<int8_t>(batch * in_features) + Workspace::bytes<float>(batch)
+                                   + Workspace::bytes<int32_t>(batch));
+    int8_t *x_q = Workspace::take<int8_t>(scratch, batch * in_features);
+    float *x_scale = Workspace::take<float>(scratch, batch);
+    int32_t *x_qsum = Workspace::take<int32_t>(scratch, batch);
+    quantize_rows_(x_q, x_scale, x_qsum, in, batch, in_features, in_stride, parallel);
+
+    size_t n_bblocks = (batch + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    size_t n_oblocks = (out_features + NB - 1) / NB;
+    ptrdiff_t units = static_cast<ptrdiff_t>(n_bblocks * n_oblocks);
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t o0 = (static_cast<size_t>(u) % n_oblocks) * NB;
+        size_t n = std::min(NB, out_features - o0);
+        size_t b_begin = (static_cast<size_t>(u) / n_oblocks) * BATCH_BLOCK;
+        size_t b_end = std::min(batch, b_begin + BATCH_BLOCK);
+
+        const int8_t *w_rows[NB];
+        for (size_t j = 0; j < NB; j++) {
+            w_rows[j] = weight + static_cast<ptrdiff_t>(o0 + std::min(j, n - 1)) * weight_stride;
+        }
+
+        // 不足 MB_S8 行的尾部逐行计算
+        for (size_t b = b_begin; b < b_end;) {
+            size_t m = b_end - b >= MB_S8 ? MB_S8 : 1;
+            const int8_t *x_rows[MB_S8];
+            const int32_t *x_qsums[MB_S8];
+            for (size_t i = 0; i < m; i++) {
+                x_rows[i] = x_q + (b + i) * in_features;
+                x_qsums[i] = x_qsum + b + i;
+            }
+
+            int32_t res[MB_S8][NB];
+            if (m == MB_S8) {
+                dot_block_s8_<MB_S8>(x_rows, x_qsums, w_rows, in_features, res);
+            } else {
+                dot_block_s8_<1>(x_rows, x_qsums, w_rows, in_features, res);
+            }
+
+            for (size_t i = 0; i < m; i++) {
+                T *out_row = out + static_cast<ptrdiff_t>(b + i) * out_stride;
+                for (size_t j = 0; j < n; j++) {
+                    float sum = static_cast<float>(res[i][j]) * x_scale[b + i] * scale[o0 + j];
+                    sum += bias != nullptr ? simd::to_f32(bias[o0 + j]) : 0.0f;
+                    out_row[o0 + j] = simd::from_f32<T>(sum);
+                }
+            }
+            b += m;
+        }
+    }
+}
+
+template <typename T>
+void linear_w8a8_(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                  const std::byte *weight_scale, size_t batch, size_t in_features, size_t out_features,
+                  ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t weight_stride) {
+    linear_w8a8_(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in), reinterpret_cast<const int8_t *>(weight),
+                 bias ? reinterpret_cast<const T *>(bias) : nullptr, reinterpret_cast<const float *>(weight_scale),
+                 batch, in_features, out_features, out_stride, in_stride, weight_stride);
+}
+
+// ---------- 4 bit 分组量化权重 ----------
+
+// 行内第 k 列的 4 bit 值：每 32 列占 16 字节，第 j 个字节低 4 位为第 j 列、高 4 位为第 j + 16 列
+inline uint8_t int4_at_(const uint8_t *row, size_t k) {
+    uint8_t byte = row[(k / 32) * 16 + k % 16];
+    return k % 32 < 16 ? (byte & 0xF) : (byte >> 4);
+}
+
+// res[i][j] = in_rows[i] · W[j]。W = s * (q - z) 按组拆成 s * (x · q) - s * z * sum(x)：
+// 组内只把 4 bit 值解包为 float 与 x 做 FMA，组末乘一次 scale；sum(x) 由调用方按组预先算好（xsum_rows）
+template <typename T, size_t M>
+inline void dot_block_int4_(const T *const *in_rows, const float *const *xsum_rows, const uint8_t *const *w_rows,
+                            const float *const *s_rows, const uint8_t *const *z_rows, size_t k_len,
+                            size_t group_size, float (&res)[MB][NB]) {
+    float zero_sum[M][NB] = {};
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+    const __mmask16 all = 0xFFFF;
+    const __m512i low4 = _mm512_set1_epi32(0xF);
+    __m512 acc[M][NB];
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            acc[i][j] = _mm512_setzero_ps();
+        }
+    }
+    for (size_t g = 0, k0 = 0; k0 < k_len; g++, k0 += group_size) {
+        __m512 acc_g[M][NB];
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                acc_g[i][j] = _mm512_setzero_ps();
+            }
+        }
+        for (size_t k = k0; k < k0 + group_size; k += 32) {
+            __m512 x_lo[M], x_hi[M];
+            for (size_t i = 0; i < M; i++) {
+                x_lo[i] = load16_(in_rows[i] + k, all);
+                x_hi[i] = load16_(in_rows[i] + k + 16, all);
+            }
+            for (size_t j = 0; j < NB; j++) {
+                __m512i q = _mm512_maskz_cvtepu8_epi32(all, _mm_loadu_si128(reinterpret_cast<const __m128i *>(w_rows[j] + k / 2)));
+                __m512 w_lo = _mm512_maskz_cvtepi32_ps(all, _mm512_and_si512(q, low4));
+                __m512 w_hi = _mm512_maskz_cvtepi32_ps(all, _mm512_maskz_srli_epi32(all, q, 4));
+                for (size_t i = 0; i < M; i++) {
+                    acc_g[i][j] = _mm512_fmadd_ps(x_lo[i], w_lo, acc_g[i][j]);
+                    acc_g[i][j] = _mm512_fmadd_ps(x_hi[i], w_hi, acc_g[i][j]);
+                }
+            }
+        }
+        for (size_t j = 0; j < NB; j++) {
+            float s = s_rows[j][g];
+            float m = -s * static_cast<float>(z_rows[j][g]);
+            for (size_t i = 0; i < M; i++) {
+                acc[i][j] = _mm512_fmadd_ps(acc_g[i][j], _mm512_set1_ps(s), acc[i][j]);
+                zero_sum[i][j] += m * xsum_rows[i][g];
+            }
+        }
+    }
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] = reduce_add_512(acc[i][j]) + zero_sum[i][j];
+        }
+    }
+#elif defined(LLAISYS_SIMD_AVX2)
+    // 16 字节分两半各扩展为 8 个 int32：前半的低/高 4 位为第 0~7/16~23 列，后半为第 8~15/24~31 列
+    const __m256i low4 = _mm256_set1_epi32(0xF);
+    simd::VecF acc[M][NB];
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            acc[i][j] = simd::set1(0.0f);
+        }
+    }
+    for (size_t g = 0, k0 = 0; k0 < k_len; g++, k0 += group_size) {
+        simd::VecF acc_g[M][NB];
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < NB; j++) {
+                acc_g[i][j] = simd::set1(0.0f);
+            }
+        }
+        for (size_t k = k0; k < k0 + group_size; k += 32) {
+            for (size_t j = 0; j < NB; j++) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w_rows[j] + k / 2));
+                __m256i qa = _mm256_cvtepu8_epi32(bytes);
+                __m256i qb = _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8));
+                __m256i q[4] = {_mm256_and_si256(qa, low4), _mm256_and_si256(qb, low4),
+                                _mm256_srli_epi32(qa, 4), _mm256_srli_epi32(qb, 4)};
+                for (size_t t = 0; t < 4; t++) {
+                    simd::VecF w{_mm256_cvtepi32_ps(q[t])};
+                    for (size_t i = 0; i < M; i++) {
+                        acc_g[i][j] = simd::fmadd(simd::load(in_rows[i] + k + 8 * t), w, acc_g[i][j]);
+                    }
                 }
             }
-            
-            // 加偏置(如果有)
-            if (bias != nullptr) {
-                if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                    sum += llaisys::utils::cast<float>(bias[o]);
-                } else {
-                    sum += bias[o];
+        }
+        for (size_t j = 0; j < NB; j++) {
+            float s = s_rows[j][g];
+            float m = -s * static_cast<float>(z_rows[j][g]);
+            for (size_t i = 0; i < M; i++) {
+                acc[i][j] = simd::fmadd(acc_g[i][j], simd::set1(s), acc[i][j]);
+                zero_sum[i][j] += m * xsum_rows[i][g];
+            }
+        }
+    }
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] = simd::reduce_add(acc[i][j]) + zero_sum[i][j];
+        }
+    }
+#else
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] = 0.0f;
+        }
+    }
+    for (size_t g = 0, k0 = 0; k0 < k_len; g++, k0 += group_size) {
+        for (size_t j = 0; j < NB; j++) {
+            float s = s_rows[j][g];
+            for (size_t i = 0; i < M; i++) {
+                float dot = 0.0f;
+                for (size_t k = k0; k < k0 + group_size; k++) {
+                    dot += simd::to_f32(in_rows[i][k]) * static_cast<float>(int4_at_(w_rows[j], k));
                 }
+                res[i][j] += s * dot;
+                zero_sum[i][j] -= s * static_cast<float>(z_rows[j][g]) * xsum_rows[i][g];
+            }
+        }
+    }
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < NB; j++) {
+            res[i][j] += zero_sum[i][j];
+        }
+    }
+#endif
+}
+
+template <typename T>
+void linear_int4_(T *out, const T *in, const uint8_t *weight, const float *scales, const uint8_t *zeros,
+                  const T *bias, size_t batch, size_t in_features, size_t out_features, size_t group_size,
+                  ptrdiff_t out_stride, ptrdiff_t in_stride) {
+    size_t n_groups = in_features / group_size;
+    bool parallel = batch * in_features * out_features >= PARALLEL_MIN_WORK;
+
+    // 每行输入按组求和，所有输出通道共用
+    auto &ws = llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace();
+    float *xsum = reinterpret_cast<float *>(ws.shared(Workspace::bytes<float>(batch * n_groups)));
+#pragma omp parallel for schedule(static) if (parallel)
+    for (ptrdiff_t b = 0; b < static_cast<ptrdiff_t>(batch); b++) {
+        const T *in_row = in + b * in_stride;
+        for (size_t g = 0; g < n_groups; g++) {
+            float sum = 0.0f;
+            for (size_t k = g * group_size; k < (g + 1) * group_size; k++) {
+                sum += simd::to_f32(in_row[k]);
+            }
+            xsum[b * n_groups + g] = sum;
+        }
+    }
+
+    // 分块与 linear_ 相同：NB 行权重在 MB 行输入之间复用，按输出行块并行
+    size_t n_bblocks = (batch + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    size_t n_oblocks = (out_features + NB - 1) / NB;
+    ptrdiff_t units = static_cast<ptrdiff_t>(n_bblocks * n_oblocks);
+
+#pragma omp parallel for schedule(static) if (parallel)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t o0 = (static_cast<size_t>(u) % n_oblocks) * NB;
+        size_t n = std::min(NB, out_features - o0);
+        size_t b_begin = (static_cast<size_t>(u) / n_oblocks) * BATCH_BLOCK;
+        size_t b_end = std::min(batch, b_begin + BATCH_BLOCK);
+
+        const uint8_t *w_rows[NB];
+        const float *s_rows[NB];
+        const uint8_t *z_rows[NB];
+        for (size_t j = 0; j < NB; j++) {
+            size_t o = o0 + std::min(j, n - 1);
+            w_rows[j] = weight + o * (in_features / 2);
+            s_rows[j] = scales + o * n_groups;
+            z_rows[j] = zeros + o * n_groups;
+        }
+
+        for (size_t b = b_begin; b < b_end; b += MB) {
+            size_t m = std::min(MB, b_end - b);
+            const T *in_rows[MB];
+            const float *xsum_rows[MB];
+            for (size_t i = 0; i < MB; i++) {
+                size_t row = b + std::min(i, m - 1);
+                in_rows[i] = in + static_cast<ptrdiff_t>(row) * in_stride;
+                xsum_rows[i] = xsum + row * n_groups;
             }
-            
-            // 存储结果
-            if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                out[b * out_features + o] = llaisys::utils::cast<T>(sum);
+
+            float res[MB][NB];
+            if (m == MB) {
+                dot_block_int4_<T, MB>(in_rows, xsum_rows, w_rows, s_rows, z_rows, in_features, group_size, res);
             } else {
-                out[b * out_features + o] = sum;
+                dot_block_int4_<T, 1>(in_rows, xsum_rows, w_rows, s_rows, z_rows, in_features, group_size, res);
             }
+
+            for (size_t i = 0; i < m; i++) {
+                T *out_row = out + static_cast<ptrdiff_t>(b + i) * out_stride;
+                for (size_t j = 0; j < n; j++) {
+                    float sum = res[i][j] + (bias != nullptr ? simd::to_f32(bias[o0 + j]) : 0.0f);
+                    out_row[o0 + j] = simd::from_f32<T>(sum);
+                }
+            }
+        }
+    }
+}
+
+// 参考实现：逐元素反量化，双精度累加
+template <typename T>
+void linear_int4_reference_(T *out, const T *in, const uint8_t *weight, const float *scales, const uint8_t *zeros,
+                            const T *bias, size_t batch, size_t in_features, size_t out_features, size_t group_size,
+                            ptrdiff_t out_stride, ptrdiff_t in_stride) {
+    size_t n_groups = in_features / group_size;
+    ptrdiff_t units = static_cast<ptrdiff_t>(batch * out_features);
+
+#pragma omp parallel for schedule(static) if (batch * in_features * out_features >= PARALLEL_MIN_WORK)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t b = static_cast<size_t>(u) / out_features;
+        size_t o = static_cast<size_t>(u) % out_features;
+        const T *in_row = in + static_cast<ptrdiff_t>(b) * in_stride;
+        const uint8_t *w_row = weight + o * (in_features / 2);
+
+        double sum = 0.0;
+        for (size_t k = 0; k < in_features; k++) {
+            size_t g = o * n_groups + k / group_size;
+            double w = static_cast<double>(scales[g]) * (static_cast<int>(int4_at_(w_row, k)) - static_cast<int>(zeros[g]));
+            sum += static_cast<double>(simd::to_f32(in_row[k])) * w;
         }
+        if (bias != nullptr) {
+            sum += simd::to_f32(bias[o]);
+        }
+        out[static_cast<ptrdiff_t>(b) * out_stride + o] = simd::from_f32<T>(static_cast<float>(sum));
+    }
+}
+
+template <typename T>
+void linear_int4_(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *scales,
+                  const std::byte *zeros, const std::byte *bias, size_t batch, size_t in_features,
+                  size_t out_features, size_t group_size, ptrdiff_t out_stride, ptrdiff_t in_stride,
+                  llaisysDataType_t accumulate) {
+    T *out_ = reinterpret_cast<T *>(out);
+    const T *in_ = reinterpret_cast<const T *>(in);
+    const uint8_t *weight_ = reinterpret_cast<const uint8_t *>(weight);
+    const float *scales_ = reinterpret_cast<const float *>(scales);
+    const uint8_t *zeros_ = reinterpret_cast<const uint8_t *>(zeros);
+    const T *bias_ = bias ? reinterpret_cast<const T *>(bias) : nullptr;
+    if (accumulate == LLAISYS_DTYPE_F64) {
+        return linear_int4_reference_(out_, in_, weight_, scales_, zeros_, bias_, batch, in_features, out_features,
+                                      group_size, out_stride, in_stride);
     }
+    linear_int4_(out_, in_, weight_, scales_, zeros_, bias_, batch, in_features, out_features, group_size,
+                 out_stride, in_stride);
 }
 
 namespace llaisys::ops::cpu {
 void linear(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
-            llaisysDataType_t type, size_t batch, size_t in_features, size_t out_features) {
-    
+            const std::byte *weight_scale, llaisysDataType_t type, llaisysDataType_t weight_type, size_t batch, size_t in_features,
+            size_t out_features, const strides_t &out_strides, const strides_t &in_strides,
+            const strides_t &weight_strides, llaisysDataType_t compute, llaisysDataType_t accumulate) {
+    ptrdiff_t out_stride = out_strides[0];
+    ptrdiff_t in_stride = in_strides[0];
+    ptrdiff_t weight_stride = weight_strides[0];
+
+    // W8A8：激活也量化为 int8
+    if (weight_type == LLAISYS_DTYPE_I8 && compute == LLAISYS_DTYPE_I8) {
+        switch (type) {
+        case LLAISYS_DTYPE_F32:
+            return linear_w8a8_<float>(out, in, weight, bias, weight_scale, batch, in_features, out_features,
+                                       out_stride, in_stride, weight_stride);
+        case LLAISYS_DTYPE_BF16:
+            return linear_w8a8_<llaisys::bf16_t>(out, in, weight, bias, weight_scale, batch, in_features,
+                                                 out_features, out_stride, in_stride, weight_stride);
+        case LLAISYS_DTYPE_F16:
+            return linear_w8a8_<llaisys::fp16_t>(out, in, weight, bias, weight_scale, batch, in_features,
+                                                 out_features, out_stride, in_stride, weight_stride);
+        default:
+            EXCEPTION_UNSUPPORTED_DATATYPE(type);
+        }
+    }
+
+    // int8 权重：逐元素在寄存器中转为 float，任意浮点激活类型
+    if (weight_type == LLAISYS_DTYPE_I8) {
+        switch (type) {
+        case LLAISYS_DTYPE_F32:
+            return linear_<float, int8_t>(out, in, weight, bias, weight_scale, batch, in_features, out_features,
+                                          out_stride, in_stride, weight_stride, accumulate);
+        case LLAISYS_DTYPE_BF16:
+            return linear_<llaisys::bf16_t, int8_t>(out, in, weight, bias, weight_scale, batch, in_features,
+                                                    out_features, out_stride, in_stride, weight_stride, accumulate);
+        case LLAISYS_DTYPE_F16:
+            return linear_<llaisys::fp16_t, int8_t>(out, in, weight, bias, weight_scale, batch, in_features,
+                                                    out_features, out_stride, in_stride, weight_stride, accumulate);
+        default:
+            EXCEPTION_UNSUPPORTED_DATATYPE(type);
+        }
+    }
+
+    // f32 激活可以搭配低精度权重
+    if (type == LLAISYS_DTYPE_F32 && weight_type == LLAISYS_DTYPE_BF16) {
+        return linear_<float, llaisys::bf16_t>(out, in, weight, bias, nullptr, batch, in_features, out_features,
+                                               out_stride, in_stride, weight_stride, accumulate);
+    }
+    if (type == LLAISYS_DTYPE_F32 && weight_type == LLAISYS_DTYPE_F16) {
+        return linear_<float, llaisys::fp16_t>(out, in, weight, bias, nullptr, batch, in_features, out_features,
+                                               out_stride, in_stride, weight_stride, accumulate);
+    }
+    CHECK_SAME_DTYPE(type, weight_type);
+
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return linear_<float, float>(out, in, weight, bias, nullptr, batch, in_features, out_features,
+                                     out_stride, in_stride, weight_stride, accumulate);
+    case LLAISYS_DTYPE_BF16:
+        return linear_<llaisys::bf16_t, llaisys::bf16_t>(out, in, weight, bias, nullptr, batch, in_features, out_features,
+                                                         out_stride, in_stride, weight_stride, accumulate);
+    case LLAISYS_DTYPE_F16:
+        return linear_<llaisys::fp16_t, llaisys::fp16_t>(out, in, weight, bias, nullptr, batch, in_features, out_features,
+                                                         out_stride, in_stride, weight_stride, accumulate);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+
+void linear_int4(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *scales,
+                 const std::byte *zeros, const std::byte *bias, llaisysDataType_t type, size_t batch,
+                 size_t in_features, size_t out_features, size_t group_size, ptrdiff_t out_stride,
+                 ptrdiff_t in_stride, llaisysDataType_t accumulate) {
     switch (type) {
     case LLAISYS_DTYPE_F32:
-        return linear_(reinterpret_cast<float *>(out), 
-                      reinterpret_cast<const float *>(in),
-                      reinterpret_cast<const float *>(weight),
-                      bias ? reinterpret_cast<const float *>(bias) : nullptr,
-                      batch, in_features, out_features);
+        return linear_int4_<float>(out, in, weight, scales, zeros, bias, batch, in_features, out_features,
+                                   group_size, out_stride, in_stride, accumulate);
     case LLAISYS_DTYPE_BF16:
-        return linear_(reinterpret_cast<llaisys::bf16_t *>(out),
-                      reinterpret_cast<const llaisys::bf16_t *>(in),
-                      reinterpret_cast<const llaisys::bf16_t *>(weight),
-                      bias ? reinterpret_cast<const llaisys::bf16_t *>(bias) : nullptr,
-                      batch, in_features, out_features);
+        return linear_int4_<llaisys::bf16_t>(out, in, weight, scales, zeros, bias, batch, in_features, out_features,
+                                             group_size, out_stride, in_stride, accumulate);
     case LLAISYS_DTYPE_F16:
-        return linear_(reinterpret_cast<llaisys::fp16_t *>(out),
-                      reinterpret_cast<const llaisys::fp16_t *>(in),
-                      reinterpret_cast<const llaisys::fp16_t *>(weight),
-                      bias ? reinterpret_cast<const llaisys::fp16_t *>(bias) : nullptr,
-                      batch, in_features, out_features);
+        return linear_int4_<llaisys::fp16_t>(out, in, weight, scales, zeros, bias, batch, in_features, out_features,
+                                             group_size, out_stride, in_stride, accumulate);
     default:
         EXCEPTION_UNSUPPORTED_DATATYPE(type);
     }
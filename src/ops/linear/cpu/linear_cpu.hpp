@@ -1,9 +1,23 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../../utils/small_vector.hpp"
+
 #include <cstddef>
+#include <vector>
 
 namespace llaisys::ops::cpu {
+// weight_type 与 type 相同，或 type 为 F32 而权重为 BF16/F16，或权重为 I8（此时 weight_scale
+// 为 [out_features] 的 f32 逐通道缩放，否则为空）；bias 与 out 同类型。
+// 权重为 I8 且 compute 为 I8 时激活逐行动态量化为 int8（W8A8）
 void linear(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
-            llaisysDataType_t type, size_t batch, size_t in_features, size_t out_features);
+            const std::byte *weight_scale, llaisysDataType_t type, llaisysDataType_t weight_type, size_t batch, size_t in_features,
+            size_t out_features, const strides_t &out_strides, const strides_t &in_strides,
+            const strides_t &weight_strides, llaisysDataType_t compute, llaisysDataType_t accumulate);
+
+// 4 bit 分组量化权重，布局见 ops::linear_int4；weight、scales、zeros 连续
+void linear_int4(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *scales,
+                 const std::byte *zeros, const std::byte *bias, llaisysDataType_t type, size_t batch,
+                 size_t in_features, size_t out_features, size_t group_size, ptrdiff_t out_stride,
+                 ptrdiff_t in_stride, llaisysDataType_t accumulate);
 }
@@ -3,14 +3,18 @@
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
 
+#include "../precision/precision.hpp"
 #include "cpu/linear_cpu.hpp"
 
 namespace llaisys::ops {
-void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
+void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias, tensor_t weight_scale) {
     CHECK_SAME_DEVICE(out, in, weight);
     if (bias) {
         CHECK_SAME_DEVICE(out, bias);
     }
+    if (weight_scale) {
+        CHECK_SAME_DEVICE(out, weight_scale);
+    }
     
     // 验证维度
     ASSERT(in->ndim() == 2, "linear: in must be a 2D tensor");
@@ -20,9 +24,13 @@ void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
         ASSERT(bias->ndim() == 1, "linear: bias must be a 1D tensor");
     }
     
-    // 验证数据类型相同
+    // 验证数据类型相同；f32 激活可以搭配 bf16/f16 权重，任意浮点激活可以搭配 int8 权重
     CHECK_SAME_DTYPE(out->dtype(), in->dtype());
-    CHECK_SAME_DTYPE(out->dtype(), weight->dtype());
+    bool quantized = weight->dtype() == LLAISYS_DTYPE_I8;
+    if (out->dtype() != LLAISYS_DTYPE_F32 && !quantized) {
+        CHECK_SAME_DTYPE(out->dtype(), weight->dtype());
+    }
+    ASSERT(quantized == (weight_scale != nullptr), "linear: weight_scale is required for (and only for) int8 weights");
     if (bias) {
         CHECK_SAME_DTYPE(out->dtype(), bias->dtype());
     }
@@ -42,12 +50,28 @@ void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
         ASSERT(bias->shape()[0] == out_features, 
                "linear: bias shape[0] must match weight shape[0]");
     }
+    if (weight_scale) {
+        CHECK_SAME_DTYPE(weight_scale->dtype(), LLAISYS_DTYPE_F32);
+        ASSERT(weight_scale->ndim() == 1 && weight_scale->shape()[0] == out_features,
+               "linear: weight_scale must have shape [out_features]");
+        ASSERT(weight_scale->isContiguous(), "linear: weight_scale must be contiguous");
+    }
+
+    // 行间 stride 任意，但每一行内部必须连续
+    ASSERT(out->strides()[1] == 1 && in->strides()[1] == 1 && weight->strides()[1] == 1,
+           "linear: last dimension must be contiguous");
+    if (bias) {
+        ASSERT(bias->isContiguous(), "linear: bias must be contiguous");
+    }
+
+    Precision p = precision(LLAISYS_OP_LINEAR);
 
     // CPU计算
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::linear(out->data(), in->data(), weight->data(), 
-                          bias ? bias->data() : nullptr,
-                          out->dtype(), batch, in_features, out_features);
+                          bias ? bias->data() : nullptr, weight_scale ? weight_scale->data() : nullptr,
+                          out->dtype(), weight->dtype(), batch, in_features, out_features,
+                          out->strides(), in->strides(), weight->strides(), p.compute, p.accumulate);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
@@ -55,8 +79,80 @@ void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
         return cpu::linear(out->data(), in->data(), weight->data(), 
-                          bias ? bias->data() : nullptr,
-                          out->dtype(), batch, in_features, out_features);
+                          bias ? bias->data() : nullptr, weight_scale ? weight_scale->data() : nullptr,
+                          out->dtype(), weight->dtype(), batch, in_features, out_features,
+                          out->strides(), in->strides(), weight->strides(), p.compute, p.accumulate);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+
+void linear_int4(tensor_t out, tensor_t in, tensor_t weight, tensor_t scales, tensor_t zeros, tensor_t bias) {
+    CHECK_SAME_DEVICE(out, in, weight, scales, zeros);
+    if (bias) {
+        CHECK_SAME_DEVICE(out, bias);
+    }
+
+    ASSERT(in->ndim() == 2 && out->ndim() == 2, "linear_int4: in and out must be 2D tensors");
+    ASSERT(weight->ndim() == 2 && scales->ndim() == 2 && zeros->ndim() == 2,
+           "linear_int4: weight, scales and zeros must be 2D tensors");
+    if (bias) {
+        ASSERT(bias->ndim() == 1, "linear_int4: bias must be a 1D tensor");
+    }
+
+    CHECK_SAME_DTYPE(out->dtype(), in->dtype());
+    CHECK_SAME_DTYPE(weight->dtype(), LLAISYS_DTYPE_U8);
+    CHECK_SAME_DTYPE(scales->dtype(), LLAISYS_DTYPE_F32);
+    CHECK_SAME_DTYPE(zeros->dtype(), LLAISYS_DTYPE_U8);
+    if (bias) {
+        CHECK_SAME_DTYPE(out->dtype(), bias->dtype());
+    }
+
+    size_t batch = in->shape()[0];
+    size_t in_features = in->shape()[1];
+    size_t out_features = weight->shape()[0];
+    size_t n_groups = scales->shape()[1];
+
+    ASSERT(in_features % 32 == 0, "linear_int4: in_features must be a multiple of 32");
+    ASSERT(weight->shape()[1] * 2 == in_features, "linear_int4: weight shape[1] must be in_features / 2");
+    ASSERT(out->shape()[0] == batch && out->shape()[1] == out_features,
+           "linear_int4: out must have shape [batch, out_features]");
+    ASSERT(scales->shape()[0] == out_features && n_groups > 0 && in_features % n_groups == 0,
+           "linear_int4: scales must have shape [out_features, n_groups] with n_groups dividing in_features");
+    CHECK_SAME_SHAPE(zeros->shape(), scales->shape());
+    size_t group_size = in_features / n_groups;
+    ASSERT(group_size % 32 == 0, "linear_int4: group size must be a multiple of 32");
+    if (bias) {
+        ASSERT(bias->shape()[0] == out_features, "linear_int4: bias shape[0] must match weight shape[0]");
+    }
+
+    ASSERT(out->strides()[1] == 1 && in->strides()[1] == 1, "linear_int4: last dimension must be contiguous");
+    ASSERT(weight->isContiguous() && scales->isContiguous() && zeros->isContiguous(),
+           "linear_int4: weight, scales and zeros must be contiguous");
+    if (bias) {
+        ASSERT(bias->isContiguous(), "linear_int4: bias must be contiguous");
+    }
+
+    Precision p = precision(LLAISYS_OP_LINEAR);
+
+    if (out->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::linear_int4(out->data(), in->data(), weight->data(), scales->data(), zeros->data(),
+                                bias ? bias->data() : nullptr, out->dtype(), batch, in_features, out_features,
+                                group_size, out->strides()[0], in->strides()[0], p.accumulate);
+    }
+
+    llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
+
+    switch (out->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::linear_int4(out->data(), in->data(), weight->data(), scales->data(), zeros->data(),
+                                bias ? bias->data() : nullptr, out->dtype(), batch, in_features, out_features,
+                                group_size, out->strides()[0], in->strides()[0], p.accumulate);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
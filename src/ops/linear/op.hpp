@@ -3,5 +3,13 @@
 #include "../../tensor/tensor.hpp"
 
 namespace llaisys::ops {
-void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias);
+// weight 为 I8 时需给出 weight_scale：[out_features] 的 F32 逐输出通道缩放，W = W_q * scale
+void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias, tensor_t weight_scale = nullptr);
+
+// 4 bit 分组量化权重，W[o, k] = scales[o, g] * (q[o, k] - zeros[o, g])，g = k / group_size，
+// group_size = in_features / scales.shape[1]，须为 32 的倍数（常用 32/64/128）。
+// weight: [out_features, in_features / 2] U8，按 32 列分块，块内第 j 个字节的低 4 位为第 j 列、
+//         高 4 位为第 j + 16 列（便于 SIMD 解包，GPTQ/AWQ 格式见 repack_int4）
+// scales: [out_features, n_groups] F32；zeros: [out_features, n_groups] U8，取值 0~15
+void linear_int4(tensor_t out, tensor_t in, tensor_t weight, tensor_t scales, tensor_t zeros, tensor_t bias);
 }
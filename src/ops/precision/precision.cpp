@@ -0,0 +1,59 @@
+#include "precision.hpp"
+
+#include "../../utils.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace llaisys::ops {
+namespace {
+// compute 与 accumulate 合成一个 64 位值原子地读写：共享 Runtime 时推理线程可能与
+// setPrecision 并发，读到的总是某一次设置的完整策略，不会一半新一半旧
+uint64_t encode(const Precision &p) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(p.compute))
+         | (static_cast<uint64_t>(static_cast<uint32_t>(p.accumulate)) << 32);
+}
+
+Precision decode(uint64_t v) {
+    return {static_cast<llaisysDataType_t>(static_cast<uint32_t>(v)),
+            static_cast<llaisysDataType_t>(static_cast<uint32_t>(v >> 32))};
+}
+
+struct PrecisionTable {
+    std::array<std::atomic<uint64_t>, LLAISYS_OP_TYPE_COUNT> entries;
+
+    PrecisionTable() {
+        for (auto &entry : entries) {
+            entry.store(encode(Precision{}), std::memory_order_relaxed);
+        }
+    }
+};
+
+std::array<std::atomic<uint64_t>, LLAISYS_OP_TYPE_COUNT> &precision_table() {
+    static PrecisionTable table;
+    return table.entries;
+}
+} // namespace
+
+Precision precision(llaisysOpType_t op) {
+    CHECK_ARGUMENT(op >= 0 && op < LLAISYS_OP_TYPE_COUNT, "precision: invalid op type");
+    return decode(precision_table()[op].load(std::memory_order_relaxed));
+}
+
+void setPrecision(llaisysOpType_t op, const Precision &precision) {
+    CHECK_ARGUMENT(op >= 0 && op < LLAISYS_OP_TYPE_COUNT, "setPrecision: invalid op type");
+    if (precision.compute == LLAISYS_DTYPE_I8) {
+        // W8A8 只用于 linear，int32 累加后以 f32 缩放
+        CHECK_ARGUMENT(op == LLAISYS_OP_LINEAR, "setPrecision: compute type I8 is only supported by linear");
+        CHECK_ARGUMENT(precision.accumulate == LLAISYS_DTYPE_F32, "setPrecision: compute type I8 requires F32 accumulate");
+    } else {
+        CHECK_ARGUMENT(precision.compute == LLAISYS_DTYPE_F32 || precision.compute == LLAISYS_DTYPE_BF16
+                           || precision.compute == LLAISYS_DTYPE_F16,
+                       "setPrecision: compute type must be F32, BF16, F16 or (linear only) I8");
+    }
+    CHECK_ARGUMENT(precision.accumulate == LLAISYS_DTYPE_F32 || precision.accumulate == LLAISYS_DTYPE_F64,
+                   "setPrecision: accumulate type must be F32 or F64");
+    precision_table()[op].store(encode(precision), std::memory_order_relaxed);
+}
+} // namespace llaisys::ops
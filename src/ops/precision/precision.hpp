@@ -0,0 +1,20 @@
+#pragma once
+
+#include "llaisys/ops.h"
+
+namespace llaisys::ops {
+// 算子的精度策略，见 llaisysSetPrecision
+struct Precision {
+    llaisysDataType_t compute = LLAISYS_DTYPE_F32;
+    llaisysDataType_t accumulate = LLAISYS_DTYPE_F32;
+
+    // 默认策略走 SIMD 快路径，其余走逐元素的参考实现
+    bool isDefault() const {
+        return compute == LLAISYS_DTYPE_F32 && accumulate == LLAISYS_DTYPE_F32;
+    }
+};
+
+// 全局生效，可与推理并发读写（逐算子原子），但已开始的算子调用仍按调用时读到的策略执行
+Precision precision(llaisysOpType_t op);
+void setPrecision(llaisysOpType_t op, const Precision &precision);
+} // namespace llaisys::ops
@@ -0,0 +1,236 @@
+#include "quantize_cpu.hpp"
+
+#include "../../../utils.hpp"
+#include "../../../utils/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace simd = llaisys::utils::simd;
+
+template <typename T>
+void quantize_int8_(int8_t *q, float *scale, const T *weight, size_t rows, size_t cols, ptrdiff_t weight_stride) {
+#pragma omp parallel for schedule(static)
+    for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(rows); r++) {
+        const T *w_row = weight + r * weight_stride;
+        int8_t *q_row = q + r * static_cast<ptrdiff_t>(cols);
+
+        float amax = 0.0f;
+        for (size_t c = 0; c < cols; c++) {
+            amax = std::max(amax, std::abs(simd::to_f32(w_row[c])));
+        }
+        // 全零行的 scale 为 0，量化值也全为 0
+        scale[r] = amax / 127.0f;
+        float inv = amax > 0.0f ? 127.0f / amax : 0.0f;
+        for (size_t c = 0; c < cols; c++) {
+            float v = std::nearbyint(simd::to_f32(w_row[c]) * inv);
+            q_row[c] = static_cast<int8_t>(std::clamp(v, -127.0f, 127.0f));
+        }
+    }
+}
+
+// 与 linear_int4 的布局一致：每 32 列占 16 字节，第 j 个字节低 4 位为第 j 列、高 4 位为第 j + 16 列
+inline void pack_int4_(uint8_t *q_row, const uint8_t *values, size_t cols) {
+    for (size_t b = 0; b < cols; b += 32) {
+        for (size_t j = 0; j < 16; j++) {
+            q_row[b / 2 + j] = static_cast<uint8_t>(values[b + j] | (values[b + j + 16] << 4));
+        }
+    }
+}
+
+template <typename T>
+void quantize_int4_(uint8_t *q, float *scales, uint8_t *zeros, const T *weight, size_t rows, size_t cols,
+                    size_t group_size, ptrdiff_t weight_stride) {
+    size_t n_groups = cols / group_size;
+#pragma omp parallel
+    {
+        std::vector<uint8_t> values(cols);
+#pragma omp for schedule(static)
+        for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(rows); r++) {
+            const T *w_row = weight + r * weight_stride;
+            for (size_t g = 0; g < n_groups; g++) {
+                const T *w = w_row + g * group_size;
+                // 区间包含 0，保证 0 可以精确表示
+                float lo = 0.0f, hi = 0.0f;
+                for (size_t c = 0; c < group_size; c++) {
+                    lo = std::min(lo, simd::to_f32(w[c]));
+                    hi = std::max(hi, simd::to_f32(w[c]));
+                }
+                float scale = (hi - lo) / 15.0f;
+                float zero = scale > 0.0f ? std::clamp(std::nearbyint(-lo / scale), 0.0f, 15.0f) : 0.0f;
+                scales[r * n_groups + g] = scale;
+                zeros[r * n_groups + g] = static_cast<uint8_t>(zero);
+                for (size_t c = 0; c < group_size; c++) {
+                    float v = scale > 0.0f ? std::nearbyint(simd::to_f32(w[c]) / scale) + zero : 0.0f;
+                    values[g * group_size + c] = static_cast<uint8_t>(std::clamp(v, 0.0f, 15.0f));
+                }
+            }
+            pack_int4_(q + r * static_cast<ptrdiff_t>(cols / 2), values.data(), cols);
+        }
+    }
+}
+
+template <typename Ts>
+void repack_int4_(uint8_t *q, float *scales, uint8_t *zeros, const uint32_t *src_qweight, const uint32_t *src_qzeros,
+                  const Ts *src_scales, size_t rows, size_t cols, size_t group_size, llaisysInt4Format_t format) {
+    // AWQ 每个 int32 内第 t 列所在的 4 bit 位置
+    constexpr unsigned AWQ_POS[8] = {0, 4, 1, 5, 2, 6, 3, 7};
+    size_t n_groups = cols / group_size;
+    bool awq = format == LLAISYS_INT4_AWQ;
+
+#pragma omp parallel
+    {
+        std::vector<uint8_t> values(cols);
+#pragma omp for schedule(static)
+        for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(rows); r++) {
+            size_t o = static_cast<size_t>(r);
+            unsigned zero_shift = 4 * (awq ? AWQ_POS[o % 8] : o % 8);
+            for (size_t g = 0; g < n_groups; g++) {
+                uint32_t z = (src_qzeros[g * (rows / 8) + o / 8] >> zero_shift) & 0xF;
+                // AutoGPTQ 存储 zero - 1
+                zeros[o * n_groups + g] = static_cast<uint8_t>(awq ? z : (z + 1) & 0xF);
+                scales[o * n_groups + g] = simd::to_f32(src_scales[g * rows + o]);
+            }
+            for (size_t k = 0; k < cols; k++) {
+                uint32_t word = awq ? src_qweight[k * (rows / 8) + o / 8] : src_qweight[(k / 8) * rows + o];
+                unsigned shift = 4 * (awq ? AWQ_POS[o % 8] : k % 8);
+                values[k] = static_cast<uint8_t>((word >> shift) & 0xF);
+            }
+            pack_int4_(q + r * static_cast<ptrdiff_t>(cols / 2), values.data(), cols);
+        }
+    }
+}
+
+// Tq 为 int8_t 或 fp8e4m3_t
+template <typename Tq, typename T>
+void quantize_kv_(Tq *cache, float *scales, const T *src, size_t seq, size_t nkvh, size_t hd,
+                  const llaisys::strides_t &cache_strides, const llaisys::strides_t &scales_strides,
+                  const llaisys::strides_t &src_strides) {
+    constexpr bool INT8 = std::is_same_v<Tq, int8_t>;
+    constexpr float QMAX = INT8 ? 127.0f : 448.0f;
+    ptrdiff_t units = static_cast<ptrdiff_t>(seq * nkvh);
+
+    // 解码一步只写一个 token，量化量很小，只在预填充时开多线程
+#pragma omp parallel for schedule(static) if (seq * nkvh * hd >= (size_t(1) << 15))
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t t = static_cast<size_t>(u) / nkvh;
+        size_t h = static_cast<size_t>(u) % nkvh;
+        const T *x = src + t * src_strides[0] + h * src_strides[1];
+        Tq *q = cache + t * cache_strides[0] + h * cache_strides[1];
+
+        float amax = 0.0f;
+        for (size_t d = 0; d < hd; d++) {
+            amax = std::max(amax, std::abs(simd::to_f32(x[d])));
+        }
+        scales[t * scales_strides[0] + h * scales_strides[1]] = amax / QMAX;
+        float inv = amax > 0.0f ? QMAX / amax : 0.0f;
+        for (size_t d = 0; d < hd; d++) {
+            float v = simd::to_f32(x[d]) * inv;
+            if constexpr (INT8) {
+                q[d] = static_cast<int8_t>(std::clamp(std::nearbyint(v), -127.0f, 127.0f));
+            } else {
+                q[d] = simd::from_f32<llaisys::fp8e4m3_t>(v);
+            }
+        }
+    }
+}
+
+template <typename Tq>
+void quantize_kv_(std::byte *cache, std::byte *scales, const std::byte *src, llaisysDataType_t type, size_t seq,
+                  size_t nkvh, size_t hd, const llaisys::strides_t &cache_strides,
+                  const llaisys::strides_t &scales_strides, const llaisys::strides_t &src_strides) {
+    Tq *cache_ = reinterpret_cast<Tq *>(cache);
+    float *scales_ = reinterpret_cast<float *>(scales);
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return quantize_kv_(cache_, scales_, reinterpret_cast<const float *>(src), seq, nkvh, hd, cache_strides,
+                            scales_strides, src_strides);
+    case LLAISYS_DTYPE_BF16:
+        return quantize_kv_(cache_, scales_, reinterpret_cast<const llaisys::bf16_t *>(src), seq, nkvh, hd,
+                            cache_strides, scales_strides, src_strides);
+    case LLAISYS_DTYPE_F16:
+        return quantize_kv_(cache_, scales_, reinterpret_cast<const llaisys::fp16_t *>(src), seq, nkvh, hd,
+                            cache_strides, scales_strides, src_strides);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+
+namespace llaisys::ops::cpu {
+void quantize_int8(std::byte *q, std::byte *scale, const std::byte *weight, llaisysDataType_t type,
+                   size_t rows, size_t cols, ptrdiff_t weight_stride) {
+    int8_t *q_ = reinterpret_cast<int8_t *>(q);
+    float *scale_ = reinterpret_cast<float *>(scale);
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return quantize_int8_(q_, scale_, reinterpret_cast<const float *>(weight), rows, cols, weight_stride);
+    case LLAISYS_DTYPE_BF16:
+        return quantize_int8_(q_, scale_, reinterpret_cast<const llaisys::bf16_t *>(weight), rows, cols, weight_stride);
+    case LLAISYS_DTYPE_F16:
+        return quantize_int8_(q_, scale_, reinterpret_cast<const llaisys::fp16_t *>(weight), rows, cols, weight_stride);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+
+void quantize_int4(std::byte *q, std::byte *scales, std::byte *zeros, const std::byte *weight,
+                   llaisysDataType_t type, size_t rows, size_t cols, size_t group_size, ptrdiff_t weight_stride) {
+    uint8_t *q_ = reinterpret_cast<uint8_t *>(q);
+    float *scales_ = reinterpret_cast<float *>(scales);
+    uint8_t *zeros_ = reinterpret_cast<uint8_t *>(zeros);
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return quantize_int4_(q_, scales_, zeros_, reinterpret_cast<const float *>(weight), rows, cols, group_size,
+                              weight_stride);
+    case LLAISYS_DTYPE_BF16:
+        return quantize_int4_(q_, scales_, zeros_, reinterpret_cast<const llaisys::bf16_t *>(weight), rows, cols,
+                              group_size, weight_stride);
+    case LLAISYS_DTYPE_F16:
+        return quantize_int4_(q_, scales_, zeros_, reinterpret_cast<const llaisys::fp16_t *>(weight), rows, cols,
+                              group_size, weight_stride);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+
+void repack_int4(std::byte *q, std::byte *scales, std::byte *zeros, const std::byte *src_qweight,
+                 const std::byte *src_qzeros, const std::byte *src_scales, llaisysDataType_t scales_type,
+                 size_t rows, size_t cols, size_t group_size, llaisysInt4Format_t format) {
+    uint8_t *q_ = reinterpret_cast<uint8_t *>(q);
+    float *scales_ = reinterpret_cast<float *>(scales);
+    uint8_t *zeros_ = reinterpret_cast<uint8_t *>(zeros);
+    const uint32_t *qweight_ = reinterpret_cast<const uint32_t *>(src_qweight);
+    const uint32_t *qzeros_ = reinterpret_cast<const uint32_t *>(src_qzeros);
+    switch (scales_type) {
+    case LLAISYS_DTYPE_F32:
+        return repack_int4_(q_, scales_, zeros_, qweight_, qzeros_, reinterpret_cast<const float *>(src_scales),
+                            rows, cols, group_size, format);
+    case LLAISYS_DTYPE_BF16:
+        return repack_int4_(q_, scales_, zeros_, qweight_, qzeros_,
+                            reinterpret_cast<const llaisys::bf16_t *>(src_scales), rows, cols, group_size, format);
+    case LLAISYS_DTYPE_F16:
+        return repack_int4_(q_, scales_, zeros_, qweight_, qzeros_,
+                            reinterpret_cast<const llaisys::fp16_t *>(src_scales), rows, cols, group_size, format);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(scales_type);
+    }
+}
+
+void quantize_kv(std::byte *cache, std::byte *scales, const std::byte *src, llaisysDataType_t cache_type,
+                 llaisysDataType_t type, size_t seq, size_t nkvh, size_t hd,
+                 const strides_t &cache_strides, const strides_t &scales_strides,
+                 const strides_t &src_strides) {
+    switch (cache_type) {
+    case LLAISYS_DTYPE_I8:
+        return quantize_kv_<int8_t>(cache, scales, src, type, seq, nkvh, hd, cache_strides, scales_strides,
+                                    src_strides);
+    case LLAISYS_DTYPE_F8:
+        return quantize_kv_<llaisys::fp8e4m3_t>(cache, scales, src, type, seq, nkvh, hd, cache_strides,
+                                                scales_strides, src_strides);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(cache_type);
+    }
+}
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,27 @@
+#pragma once
+#include "llaisys.h"
+#include "llaisys/ops.h"
+
+#include "../../../utils/small_vector.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace llaisys::ops::cpu {
+void quantize_int8(std::byte *q, std::byte *scale, const std::byte *weight, llaisysDataType_t type,
+                   size_t rows, size_t cols, ptrdiff_t weight_stride);
+
+void quantize_int4(std::byte *q, std::byte *scales, std::byte *zeros, const std::byte *weight,
+                   llaisysDataType_t type, size_t rows, size_t cols, size_t group_size, ptrdiff_t weight_stride);
+
+// src_scales 为 F32/F16/BF16，其余为 I32
+void repack_int4(std::byte *q, std::byte *scales, std::byte *zeros, const std::byte *src_qweight,
+                 const std::byte *src_qzeros, const std::byte *src_scales, llaisysDataType_t scales_type,
+                 size_t rows, size_t cols, size_t group_size, llaisysInt4Format_t format);
+
+// cache_type 为 I8 或 F8，type 为 src 的类型
+void quantize_kv(std::byte *cache, std::byte *scales, const std::byte *src, llaisysDataType_t cache_type,
+                 llaisysDataType_t type, size_t seq, size_t nkvh, size_t hd,
+                 const strides_t &cache_strides, const strides_t &scales_strides,
+                 const strides_t &src_strides);
+}
@@ -0,0 +1,173 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+
+#include "cpu/quantize_cpu.hpp"
+
+namespace llaisys::ops {
+void quantize_int8(tensor_t q, tensor_t scale, tensor_t weight) {
+    CHECK_SAME_DEVICE(q, scale, weight);
+
+    ASSERT(weight->ndim() == 2, "quantize_int8: weight must be a 2D tensor");
+    CHECK_SAME_SHAPE(q->shape(), weight->shape());
+    ASSERT(scale->ndim() == 1 && scale->shape()[0] == weight->shape()[0],
+           "quantize_int8: scale must have shape [out_features]");
+    CHECK_SAME_DTYPE(q->dtype(), LLAISYS_DTYPE_I8);
+    CHECK_SAME_DTYPE(scale->dtype(), LLAISYS_DTYPE_F32);
+    ASSERT(q->isContiguous() && scale->isContiguous() && weight->strides()[1] == 1,
+           "quantize_int8: q and scale must be contiguous, weight rows must be contiguous");
+
+    size_t rows = weight->shape()[0];
+    size_t cols = weight->shape()[1];
+
+    if (weight->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::quantize_int8(q->data(), scale->data(), weight->data(), weight->dtype(), rows, cols,
+                                  weight->strides()[0]);
+    }
+
+    llaisys::core::context().setDevice(weight->deviceType(), weight->deviceId());
+
+    switch (weight->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::quantize_int8(q->data(), scale->data(), weight->data(), weight->dtype(), rows, cols,
+                                  weight->strides()[0]);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+
+void quantize_int4(tensor_t q, tensor_t scales, tensor_t zeros, tensor_t weight) {
+    CHECK_SAME_DEVICE(q, scales, zeros, weight);
+
+    ASSERT(weight->ndim() == 2 && q->ndim() == 2 && scales->ndim() == 2,
+           "quantize_int4: weight, q and scales must be 2D tensors");
+    size_t rows = weight->shape()[0];
+    size_t cols = weight->shape()[1];
+    size_t n_groups = scales->shape()[1];
+    ASSERT(cols % 32 == 0, "quantize_int4: in_features must be a multiple of 32");
+    ASSERT(q->shape()[0] == rows && q->shape()[1] * 2 == cols, "quantize_int4: q must have shape [out, in / 2]");
+    ASSERT(scales->shape()[0] == rows && n_groups > 0 && cols % n_groups == 0 && (cols / n_groups) % 32 == 0,
+           "quantize_int4: scales must have shape [out, n_groups] with a group size that is a multiple of 32");
+    CHECK_SAME_SHAPE(zeros->shape(), scales->shape());
+    CHECK_SAME_DTYPE(q->dtype(), LLAISYS_DTYPE_U8);
+    CHECK_SAME_DTYPE(scales->dtype(), LLAISYS_DTYPE_F32);
+    CHECK_SAME_DTYPE(zeros->dtype(), LLAISYS_DTYPE_U8);
+    ASSERT(q->isContiguous() && scales->isContiguous() && zeros->isContiguous() && weight->strides()[1] == 1,
+           "quantize_int4: q, scales and zeros must be contiguous, weight rows must be contiguous");
+
+    if (weight->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::quantize_int4(q->data(), scales->data(), zeros->data(), weight->data(), weight->dtype(),
+                                  rows, cols, cols / n_groups, weight->strides()[0]);
+    }
+
+    llaisys::core::context().setDevice(weight->deviceType(), weight->deviceId());
+
+    switch (weight->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::quantize_int4(q->data(), scales->data(), zeros->data(), weight->data(), weight->dtype(),
+                                  rows, cols, cols / n_groups, weight->strides()[0]);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+
+void repack_int4(tensor_t q, tensor_t scales, tensor_t zeros, tensor_t src_qweight, tensor_t src_qzeros,
+                 tensor_t src_scales, llaisysInt4Format_t format) {
+    CHECK_SAME_DEVICE(q, scales, zeros, src_qweight, src_qzeros, src_scales);
+    ASSERT(format == LLAISYS_INT4_GPTQ || format == LLAISYS_INT4_AWQ, "repack_int4: unknown format");
+
+    ASSERT(src_qweight->ndim() == 2 && src_qzeros->ndim() == 2 && src_scales->ndim() == 2,
+           "repack_int4: qweight, qzeros and scales must be 2D tensors");
+    CHECK_SAME_DTYPE(src_qweight->dtype(), LLAISYS_DTYPE_I32);
+    CHECK_SAME_DTYPE(src_qzeros->dtype(), LLAISYS_DTYPE_I32);
+    ASSERT(src_qweight->isContiguous() && src_qzeros->isContiguous() && src_scales->isContiguous(),
+           "repack_int4: source tensors must be contiguous");
+
+    size_t n_groups = src_scales->shape()[0];
+    size_t rows = src_scales->shape()[1];
+    size_t cols = format == LLAISYS_INT4_GPTQ ? src_qweight->shape()[0] * 8 : src_qweight->shape()[0];
+    size_t qweight_cols = format == LLAISYS_INT4_GPTQ ? rows : rows / 8;
+    ASSERT(rows % 8 == 0 && src_qweight->shape()[1] == qweight_cols, "repack_int4: qweight shape does not match scales");
+    ASSERT(src_qzeros->shape()[0] == n_groups && src_qzeros->shape()[1] * 8 == rows,
+           "repack_int4: qzeros must have shape [n_groups, out / 8]");
+    ASSERT(cols % 32 == 0 && cols % n_groups == 0 && (cols / n_groups) % 32 == 0,
+           "repack_int4: group size must be a multiple of 32");
+
+    ASSERT(q->ndim() == 2 && q->shape()[0] == rows && q->shape()[1] * 2 == cols,
+           "repack_int4: q must have shape [out, in / 2]");
+    ASSERT(scales->ndim() == 2 && scales->shape()[0] == rows && scales->shape()[1] == n_groups,
+           "repack_int4: scales must have shape [out, n_groups]");
+    CHECK_SAME_SHAPE(zeros->shape(), scales->shape());
+    CHECK_SAME_DTYPE(q->dtype(), LLAISYS_DTYPE_U8);
+    CHECK_SAME_DTYPE(scales->dtype(), LLAISYS_DTYPE_F32);
+    CHECK_SAME_DTYPE(zeros->dtype(), LLAISYS_DTYPE_U8);
+    ASSERT(q->isContiguous() && scales->isContiguous() && zeros->isContiguous(),
+           "repack_int4: q, scales and zeros must be contiguous");
+
+    if (q->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::repack_int4(q->data(), scales->data(), zeros->data(), src_qweight->data(), src_qzeros->data(),
+                                src_scales->data(), src_scales->dtype(), rows, cols, cols / n_groups, format);
+    }
+
+    llaisys::core::context().setDevice(q->deviceType(), q->deviceId());
+
+    switch (q->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::repack_int4(q->data(), scales->data(), zeros->data(), src_qweight->data(), src_qzeros->data(),
+                                src_scales->data(), src_scales->dtype(), rows, cols, cols / n_groups, format);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+
+void quantize_kv(tensor_t cache, tensor_t scales, tensor_t src) {
+    CHECK_SAME_DEVICE(cache, scales, src);
+
+    ASSERT(src->ndim() == 3, "quantize_kv: src must be a 3D tensor [seq, nkvh, hd]");
+    CHECK_SAME_SHAPE(cache->shape(), src->shape());
+    ASSERT(scales->ndim() == 2 && scales->shape()[0] == src->shape()[0] && scales->shape()[1] == src->shape()[1],
+           "quantize_kv: scales must have shape [seq, nkvh]");
+    ASSERT(cache->dtype() == LLAISYS_DTYPE_I8 || cache->dtype() == LLAISYS_DTYPE_F8,
+           "quantize_kv: cache must be I8 or F8");
+    CHECK_SAME_DTYPE(scales->dtype(), LLAISYS_DTYPE_F32);
+    ASSERT(cache->strides()[2] == 1 && src->strides()[2] == 1, "quantize_kv: last dimension must be contiguous");
+
+    if (src->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::quantize_kv(cache->data(), scales->data(), src->data(), cache->dtype(), src->dtype(),
+                                src->shape()[0], src->shape()[1], src->shape()[2], cache->strides(),
+                                scales->strides(), src->strides());
+    }
+
+    llaisys::core::context().setDevice(src->deviceType(), src->deviceId());
+
+    switch (src->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::quantize_kv(cache->data(), scales->data(), src->data(), cache->dtype(), src->dtype(),
+                                src->shape()[0], src->shape()[1], src->shape()[2], cache->strides(),
+                                scales->strides(), src->strides());
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include "llaisys/ops.h"
+
+namespace llaisys::ops {
+// 逐输出通道（行）对称 int8 量化：scale[o] = max|weight[o, :]| / 127，q = round(weight / scale)
+// weight: [out, in] 浮点；q: [out, in] I8；scale: [out] F32
+void quantize_int8(tensor_t q, tensor_t scale, tensor_t weight);
+
+// 4 bit 非对称分组量化（区间包含 0）：scale = (max - min) / 15，zero = round(-min / scale)，
+// q = clamp(round(weight / scale) + zero, 0, 15)；组大小由 scales.shape[1] 推出。
+// 输出 q、scales、zeros 的布局见 ops::linear_int4
+void quantize_int4(tensor_t q, tensor_t scales, tensor_t zeros, tensor_t weight);
+
+// 把 GPTQ/AWQ 的 qweight/qzeros/scales 重排为 linear_int4 的布局（要求 desc_act = false，
+// 即第 k 列属于第 k / group_size 组）
+void repack_int4(tensor_t q, tensor_t scales, tensor_t zeros, tensor_t src_qweight, tensor_t src_qzeros,
+                 tensor_t src_scales, llaisysInt4Format_t format);
+
+// 写 KV cache 时的逐 token、逐 head 对称量化：scales[t, h] = max|src[t, h, :]| / qmax，
+// cache[t, h, :] = src[t, h, :] / scales[t, h]；cache 为 I8 时 qmax = 127（就近取整），
+// 为 F8（E4M3）时 qmax = 448（就近舍入到 fp8）。
+// src、cache: [seq, nkvh, hd]；scales: [seq, nkvh] F32。前两维 stride 任意（如 cache 的切片），hd 维连续
+void quantize_kv(tensor_t cache, tensor_t scales, tensor_t src);
+}
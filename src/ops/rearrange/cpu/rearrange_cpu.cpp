@@ -0,0 +1,222 @@
+#include "rearrange_cpu.hpp"
+
+#include "../../../utils.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+// 以字节为单位描述一个维度
+struct Dim {
+    size_t size;
+    ptrdiff_t out;
+    ptrdiff_t in;
+};
+
+// 8 维以内不分配堆内存
+using Dims = llaisys::utils::SmallVector<Dim, llaisys::MAX_INLINE_DIMS>;
+
+// 转置分块的边长（元素个数），两个方向各 TILE 个元素，保证分块在 L1 内
+constexpr size_t TILE = 32;
+// 总拷贝量小于该值时不值得开多线程
+constexpr size_t PARALLEL_MIN_BYTES = size_t(1) << 16;
+// 单段连续拷贝超过该长度时再切分，让一次大的 memcpy 也能分摊到多个线程
+constexpr size_t MEMCPY_CHUNK_BYTES = size_t(1) << 18;
+
+// N 为元素字节数，N == 0 表示运行时大小
+template <size_t N>
+inline void copy_elem(std::byte *dst, const std::byte *src, size_t elem_size) {
+    if constexpr (N == 0) {
+        std::memcpy(dst, src, elem_size);
+    } else {
+        std::memcpy(dst, src, N);
+    }
+}
+
+// 去掉长度为 1 的维度，按输出 stride 从大到小排序（输出最内层放最后），
+// 再把在输入、输出中都首尾相接的相邻维度合并成一个维度
+Dims simplify(const llaisys::shape_t &shape, const llaisys::strides_t &out_strides,
+              const llaisys::strides_t &in_strides, size_t elem_size) {
+    Dims dims;
+    for (size_t i = 0; i < shape.size(); i++) {
+        if (shape[i] != 1) {
+            dims.push_back({shape[i], out_strides[i] * static_cast<ptrdiff_t>(elem_size),
+                            in_strides[i] * static_cast<ptrdiff_t>(elem_size)});
+        }
+    }
+    // 维度很少，原地插入排序（稳定，且不像 std::stable_sort 那样申请临时缓冲）
+    for (size_t i = 1; i < dims.size(); i++) {
+        Dim d = dims[i];
+        size_t j = i;
+        for (; j > 0 && std::abs(dims[j - 1].out) < std::abs(d.out); j--) {
+            dims[j] = dims[j - 1];
+        }
+        dims[j] = d;
+    }
+
+    Dims merged;
+    for (const Dim &d : dims) {
+        if (!merged.empty()) {
+            Dim &last = merged.back();
+            ptrdiff_t n = static_cast<ptrdiff_t>(d.size);
+            if (last.out == d.out * n && last.in == d.in * n) {
+                last = {last.size * d.size, d.out, d.in};
+                continue;
+            }
+        }
+        merged.push_back(d);
+    }
+    return merged;
+}
+
+size_t count(const Dims &dims) {
+    size_t n = 1;
+    for (const Dim &d : dims) {
+        n *= d.size;
+    }
+    return n;
+}
+
+// 计算外层第 idx 个位置在输出、输入中的字节偏移
+inline void outer_offsets(const Dims &outer, size_t idx, ptrdiff_t &out_off, ptrdiff_t &in_off) {
+    out_off = 0;
+    in_off = 0;
+    for (size_t d = outer.size(); d > 0; d--) {
+        const Dim &dim = outer[d - 1];
+        ptrdiff_t i = static_cast<ptrdiff_t>(idx % dim.size);
+        idx /= dim.size;
+        out_off += i * dim.out;
+        in_off += i * dim.in;
+    }
+}
+
+// 最内层在输入、输出中都连续：按段 memcpy
+void rearrange_memcpy(std::byte *out, const std::byte *in, const Dims &outer, size_t run_bytes) {
+    size_t n_outer = count(outer);
+    size_t n_chunks = std::max<size_t>(1, run_bytes / MEMCPY_CHUNK_BYTES);
+    size_t chunk = (run_bytes + n_chunks - 1) / n_chunks;
+    ptrdiff_t units = static_cast<ptrdiff_t>(n_outer * n_chunks);
+
+#pragma omp parallel for schedule(static) if (n_outer * run_bytes >= PARALLEL_MIN_BYTES)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        ptrdiff_t out_off, in_off;
+        outer_offsets(outer, static_cast<size_t>(u) / n_chunks, out_off, in_off);
+        size_t begin = (static_cast<size_t>(u) % n_chunks) * chunk;
+        size_t len = std::min(chunk, run_bytes - begin);
+        std::memcpy(out + out_off + begin, in + in_off + begin, len);
+    }
+}
+
+// 输出最内层（cols）连续、输入在另一维（rows）上连续：按 TILE x TILE 分块转置，
+// 块内读写涉及的缓存行都留在 L1 中
+template <size_t N>
+void rearrange_transpose(std::byte *out, const std::byte *in, const Dims &outer,
+                         const Dim &rows, const Dim &cols, size_t elem_size) {
+    size_t n_outer = count(outer);
+    size_t row_tiles = (rows.size + TILE - 1) / TILE;
+    size_t col_tiles = (cols.size + TILE - 1) / TILE;
+    ptrdiff_t units = static_cast<ptrdiff_t>(n_outer * row_tiles * col_tiles);
+
+#pragma omp parallel for schedule(static) if (n_outer * rows.size * cols.size * elem_size >= PARALLEL_MIN_BYTES)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        size_t idx = static_cast<size_t>(u);
+        size_t ct = idx % col_tiles;
+        idx /= col_tiles;
+        size_t rt = idx % row_tiles;
+        idx /= row_tiles;
+
+        ptrdiff_t out_off, in_off;
+        outer_offsets(outer, idx, out_off, in_off);
+
+        size_t r0 = rt * TILE, nr = std::min(TILE, rows.size - r0);
+        size_t c0 = ct * TILE, nc = std::min(TILE, cols.size - c0);
+        const std::byte *src = in + in_off + static_cast<ptrdiff_t>(r0) * rows.in + static_cast<ptrdiff_t>(c0) * cols.in;
+        std::byte *dst = out + out_off + static_cast<ptrdiff_t>(r0) * rows.out + static_cast<ptrdiff_t>(c0) * cols.out;
+
+        // 内层沿输出连续方向写，每行读入的 TILE 个输入缓存行在块内被复用
+        for (size_t r = 0; r < nr; r++) {
+            std::byte *dst_row = dst + static_cast<ptrdiff_t>(r) * rows.out;
+            const std::byte *src_row = src + static_cast<ptrdiff_t>(r) * rows.in;
+            for (size_t c = 0; c < nc; c++) {
+                copy_elem<N>(dst_row + static_cast<ptrdiff_t>(c) * cols.out, src_row + static_cast<ptrdiff_t>(c) * cols.in, elem_size);
+            }
+        }
+    }
+}
+
+// 通用情况：外层并行，最内层逐元素按 stride 拷贝
+template <size_t N>
+void rearrange_strided(std::byte *out, const std::byte *in, const Dims &outer,
+                       const Dim &inner, size_t elem_size) {
+    size_t n_outer = count(outer);
+    ptrdiff_t units = static_cast<ptrdiff_t>(n_outer);
+
+#pragma omp parallel for schedule(static) if (n_outer * inner.size * elem_size >= PARALLEL_MIN_BYTES)
+    for (ptrdiff_t u = 0; u < units; u++) {
+        ptrdiff_t out_off, in_off;
+        outer_offsets(outer, static_cast<size_t>(u), out_off, in_off);
+        std::byte *dst = out + out_off;
+        const std::byte *src = in + in_off;
+        for (size_t i = 0; i < inner.size; i++) {
+            copy_elem<N>(dst + static_cast<ptrdiff_t>(i) * inner.out, src + static_cast<ptrdiff_t>(i) * inner.in, elem_size);
+        }
+    }
+}
+
+template <size_t N>
+void rearrange_(std::byte *out, const std::byte *in, size_t elem_size, const llaisys::shape_t &shape,
+                const llaisys::strides_t &out_strides, const llaisys::strides_t &in_strides) {
+    for (size_t s : shape) {
+        if (s == 0) {
+            return;
+        }
+    }
+
+    Dims dims = simplify(shape, out_strides, in_strides, elem_size);
+    if (dims.empty()) {
+        // 标量或所有维度长度都为 1
+        return copy_elem<N>(out, in, elem_size);
+    }
+
+    const ptrdiff_t elem = static_cast<ptrdiff_t>(elem_size);
+    const Dim inner = dims.back();
+    Dims outer(dims.begin(), dims.end() - 1);
+
+    // 1. 最内层两边都连续：取最大的连续段整段 memcpy
+    if (inner.out == elem && inner.in == elem) {
+        return rearrange_memcpy(out, in, outer, inner.size * elem_size);
+    }
+
+    // 2. 输出最内层连续，输入在另一维上连续：分块转置
+    if (inner.out == elem) {
+        auto it = std::find_if(outer.begin(), outer.end(), [elem](const Dim &d) { return d.in == elem; });
+        if (it != outer.end()) {
+            Dim rows = *it;
+            outer.erase(it);
+            return rearrange_transpose<N>(out, in, outer, rows, inner, elem_size);
+        }
+    }
+
+    // 3. 其余情况逐元素拷贝
+    return rearrange_strided<N>(out, in, outer, inner, elem_size);
+}
+} // namespace
+
+namespace llaisys::ops::cpu {
+void rearrange(std::byte *out, const std::byte *in, size_t elem_size, const shape_t &shape,
+               const strides_t &out_strides, const strides_t &in_strides) {
+    switch (elem_size) {
+    case 1:
+        return rearrange_<1>(out, in, elem_size, shape, out_strides, in_strides);
+    case 2:
+        return rearrange_<2>(out, in, elem_size, shape, out_strides, in_strides);
+    case 4:
+        return rearrange_<4>(out, in, elem_size, shape, out_strides, in_strides);
+    case 8:
+        return rearrange_<8>(out, in, elem_size, shape, out_strides, in_strides);
+    default:
+        return rearrange_<0>(out, in, elem_size, shape, out_strides, in_strides);
+    }
+}
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,13 @@
+#pragma once
+#include "llaisys.h"
+
+#include "../../../utils/small_vector.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace llaisys::ops::cpu {
+// 按 strides（以元素为单位）把 in 的数据拷贝到 out，两者形状相同、元素大小为 elem_size 字节
+void rearrange(std::byte *out, const std::byte *in, size_t elem_size, const shape_t &shape,
+               const strides_t &out_strides, const strides_t &in_strides);
+}
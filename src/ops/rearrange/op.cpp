@@ -1,7 +1,96 @@
 #include "op.hpp"
 
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+
+#include "cpu/rearrange_cpu.hpp"
+
 namespace llaisys::ops {
+bool copy2d(std::byte *dst, const strides_t &dst_strides, const std::byte *src, const strides_t &src_strides,
+            const shape_t &shape, size_t elem_size, llaisysMemcpyKind_t kind, llaisysDeviceType_t device_type,
+            int device) {
+    // 去掉长度为 1 的维度，合并在两边都首尾相接的相邻维度
+    shape_t dims;
+    strides_t ds, ss;
+    for (size_t i = 0; i < shape.size(); i++) {
+        if (shape[i] == 0) {
+            return true;
+        }
+        if (shape[i] == 1) {
+            continue;
+        }
+        ptrdiff_t n = static_cast<ptrdiff_t>(shape[i]);
+        if (!dims.empty() && ds.back() == dst_strides[i] * n && ss.back() == src_strides[i] * n) {
+            dims.back() *= shape[i];
+            ds.back() = dst_strides[i];
+            ss.back() = src_strides[i];
+            continue;
+        }
+        dims.push_back(shape[i]);
+        ds.push_back(dst_strides[i]);
+        ss.push_back(src_strides[i]);
+    }
+    if (dims.empty()) {
+        dims.push_back(1);
+        ds.push_back(1);
+        ss.push_back(1);
+    }
+    if (dims.size() > 2 || ds.back() != 1 || ss.back() != 1) {
+        return false;
+    }
+    size_t width = dims.back() * elem_size;
+    size_t height = 1;
+    size_t dpitch = width;
+    size_t spitch = width;
+    if (dims.size() == 2) {
+        if (ds[0] < 0 || ss[0] < 0) {
+            return false;
+        }
+        height = dims[0];
+        dpitch = static_cast<size_t>(ds[0]) * elem_size;
+        spitch = static_cast<size_t>(ss[0]) * elem_size;
+        if (dpitch < width || spitch < width) {
+            return false;
+        }
+    }
+    core::context().runtime(device_type, device).api()->memcpy2d_sync(dst, dpitch, src, spitch, width, height, kind);
+    return true;
+}
+
 void rearrange(tensor_t out, tensor_t in) {
-    TO_BE_IMPLEMENTED();
+    CHECK_SAME_DEVICE(out, in);
+    // 形状、类型相同，strides 任意
+    CHECK_SAME_SHAPE(out->shape(), in->shape());
+    CHECK_SAME_DTYPE(out->dtype(), in->dtype());
+
+    // 能表示为二维拷贝时（如写入 KV cache 的切片）交给运行时的 memcpy2d
+    // 始终支持 CPU 计算
+    if (out->deviceType() == LLAISYS_DEVICE_CPU) {
+        if (copy2d(out->data(), out->strides(), in->data(), in->strides(), out->shape(), out->elementSize(),
+                   LLAISYS_MEMCPY_H2H, LLAISYS_DEVICE_CPU, 0)) {
+            return;
+        }
+        return cpu::rearrange(out->data(), in->data(), out->elementSize(),
+                              out->shape(), out->strides(), in->strides());
+    }
+
+    llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
+    if (copy2d(out->data(), out->strides(), in->data(), in->strides(), out->shape(), out->elementSize(),
+               LLAISYS_MEMCPY_D2D, out->deviceType(), out->deviceId())) {
+        return;
+    }
+
+    switch (out->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::rearrange(out->data(), in->data(), out->elementSize(),
+                              out->shape(), out->strides(), in->strides());
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
 }
 } // namespace llaisys::ops
@@ -4,4 +4,11 @@
 
 namespace llaisys::ops {
 void rearrange(tensor_t out, tensor_t in);
+
+// 按 strides（以元素为单位）把 src 拷贝到 dst，两者形状相同、元素大小为 elem_size 字节。
+// 合并后不超过两维且最后一维连续时（如连续张量、补齐行距的张量、KV cache 的切片）用设备
+// Runtime 的 memcpy2d 完成并返回 true，否则不拷贝并返回 false。非 CPU 设备需已是当前设备
+bool copy2d(std::byte *dst, const strides_t &dst_strides, const std::byte *src, const strides_t &src_strides,
+            const shape_t &shape, size_t elem_size, llaisysMemcpyKind_t kind, llaisysDeviceType_t device_type,
+            int device);
 }
@@ -1,78 +1,139 @@
 #include "rms_norm_cpu.hpp"
 
 #include "../../../utils.hpp"
+#include "../../../utils/dispatch.hpp"
+#include "../../../utils/simd.hpp"
 
 #include <cmath>
 
-template <typename T>
-void rms_norm_(T *out, const T *in, const T *weight, float eps, size_t batch, size_t dim) {
+namespace simd = llaisys::utils::simd;
+
+// 总元素数小于该值时不开多线程
+constexpr size_t PARALLEL_MIN_NUMEL = size_t(1) << 15;
+
+// DIM 非 0 时行长为编译期常量，向量循环可以完全展开；DIM 为 0 时使用运行时的 dim_
+template <typename T, typename Tw, size_t DIM>
+void rms_norm_(T *out, const T *in, const Tw *weight, float eps, size_t batch, size_t dim_,
+               ptrdiff_t out_stride, ptrdiff_t in_stride) {
     // RMS Normalization: Y_i = W_i * X_i / sqrt(mean(X^2) + eps)
     // 对每一行进行归一化
-    
-    for (size_t b = 0; b < batch; b++) {
-        const T *in_row = in + b * dim;
-        T *out_row = out + b * dim;
-        
-        // 步骤1: 计算平方和的均值 mean(X^2)
-        float sum_squares = 0.0f;
-        for (size_t d = 0; d < dim; d++) {
-            float val;
-            if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                val = llaisys::utils::cast<float>(in_row[d]);
-            } else {
-                val = in_row[d];
-            }
-            sum_squares += val * val;
+    const size_t dim = DIM != 0 ? DIM : dim_;
+    constexpr size_t W = simd::WIDTH;
+
+#pragma omp parallel for schedule(static) if (batch * dim >= PARALLEL_MIN_NUMEL)
+    for (ptrdiff_t b = 0; b < static_cast<ptrdiff_t>(batch); b++) {
+        const T *in_row = in + b * in_stride;
+        T *out_row = out + b * out_stride;
+
+        // 步骤1: 计算平方和，4 路累加器隐藏 FMA 延迟
+        simd::VecF acc0 = simd::set1(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        size_t d = 0;
+        for (; d + 4 * W <= dim; d += 4 * W) {
+            simd::VecF x0 = simd::load(in_row + d);
+            simd::VecF x1 = simd::load(in_row + d + W);
+            simd::VecF x2 = simd::load(in_row + d + 2 * W);
+            simd::VecF x3 = simd::load(in_row + d + 3 * W);
+            acc0 = simd::fmadd(x0, x0, acc0);
+            acc1 = simd::fmadd(x1, x1, acc1);
+            acc2 = simd::fmadd(x2, x2, acc2);
+            acc3 = simd::fmadd(x3, x3, acc3);
+        }
+        for (; d + W <= dim; d += W) {
+            simd::VecF x = simd::load(in_row + d);
+            acc0 = simd::fmadd(x, x, acc0);
+        }
+        float sum_squares = simd::reduce_add(simd::add(simd::add(acc0, acc1), simd::add(acc2, acc3)));
+        for (; d < dim; d++) {
+            float x = simd::to_f32(in_row[d]);
+            sum_squares += x * x;
         }
-        float mean_squares = sum_squares / static_cast<float>(dim);
-        
-        // 步骤2: 计算 RMS = sqrt(mean(X^2) + eps)
-        float rms = std::sqrt(mean_squares + eps);
-        
+
+        // 步骤2: 1 / RMS = 1 / sqrt(mean(X^2) + eps)
+        float inv_rms = 1.0f / std::sqrt(sum_squares / static_cast<float>(dim) + eps);
+
         // 步骤3: 归一化并应用权重 Y_i = W_i * X_i / RMS
+        simd::VecF scale = simd::set1(inv_rms);
+        d = 0;
+        for (; d + W <= dim; d += W) {
+            simd::VecF y = simd::mul(simd::mul(simd::load(in_row + d), scale), simd::load(weight + d));
+            simd::store(out_row + d, y);
+        }
+        for (; d < dim; d++) {
+            out_row[d] = simd::from_f32<T>(simd::to_f32(in_row[d]) * inv_rms * simd::to_f32(weight[d]));
+        }
+    }
+}
+
+// 参考实现：以 Acc 累加，每一步中间结果都舍入到 compute 类型，
+// 与 PyTorch 逐算子计算 x * rsqrt(mean(x^2) + eps) * w 的顺序一致
+template <typename T, typename Tw, typename Acc>
+void rms_norm_reference_(T *out, const T *in, const Tw *weight, float eps, size_t batch, size_t dim,
+                         ptrdiff_t out_stride, ptrdiff_t in_stride, llaisysDataType_t compute) {
+    auto r = [compute](float x) { return simd::round_to(compute, x); };
+
+#pragma omp parallel for schedule(static) if (batch * dim >= PARALLEL_MIN_NUMEL)
+    for (ptrdiff_t b = 0; b < static_cast<ptrdiff_t>(batch); b++) {
+        const T *in_row = in + b * in_stride;
+        T *out_row = out + b * out_stride;
+
+        Acc sum_squares = 0;
         for (size_t d = 0; d < dim; d++) {
-            float in_val, w_val;
-            
-            if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                in_val = llaisys::utils::cast<float>(in_row[d]);
-                w_val = llaisys::utils::cast<float>(weight[d]);
-            } else {
-                in_val = in_row[d];
-                w_val = weight[d];
-            }
-            
-            float normalized = in_val / rms;
-            float result = w_val * normalized;
-            
-            if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                out_row[d] = llaisys::utils::cast<T>(result);
-            } else {
-                out_row[d] = result;
-            }
+            Acc x = simd::to_f32(in_row[d]);
+            sum_squares += static_cast<Acc>(r(static_cast<float>(x * x)));
         }
+        float mean = r(static_cast<float>(sum_squares / static_cast<Acc>(dim)));
+        float inv_rms = r(static_cast<float>(1 / std::sqrt(static_cast<Acc>(r(mean + eps)))));
+
+        for (size_t d = 0; d < dim; d++) {
+            float normalized = r(simd::to_f32(in_row[d]) * inv_rms);
+            out_row[d] = simd::from_f32<T>(normalized * simd::to_f32(weight[d]));
+        }
+    }
+}
+
+template <typename T, typename Tw>
+void rms_norm_(std::byte *out, const std::byte *in, const std::byte *weight, float eps, size_t batch, size_t dim,
+               ptrdiff_t out_stride, ptrdiff_t in_stride, llaisysDataType_t compute, llaisysDataType_t accumulate) {
+    T *out_ = reinterpret_cast<T *>(out);
+    const T *in_ = reinterpret_cast<const T *>(in);
+    const Tw *weight_ = reinterpret_cast<const Tw *>(weight);
+
+    if (accumulate == LLAISYS_DTYPE_F64) {
+        return rms_norm_reference_<T, Tw, double>(out_, in_, weight_, eps, batch, dim, out_stride, in_stride, compute);
     }
+    if (compute != LLAISYS_DTYPE_F32) {
+        return rms_norm_reference_<T, Tw, float>(out_, in_, weight_, eps, batch, dim, out_stride, in_stride, compute);
+    }
+    // Qwen2 系列常见的 hidden_size
+    llaisys::utils::dispatch_size<896, 1536, 2048, 3584>(dim, [&](auto DIM) {
+        rms_norm_<T, Tw, decltype(DIM)::value>(out_, in_, weight_, eps, batch, dim, out_stride, in_stride);
+    });
 }
 
 namespace llaisys::ops::cpu {
 void rms_norm(std::byte *out, const std::byte *in, const std::byte *weight, float eps,
-              llaisysDataType_t type, size_t batch, size_t dim) {
-    
+              llaisysDataType_t type, llaisysDataType_t weight_type, size_t batch, size_t dim,
+              const strides_t &out_strides, const strides_t &in_strides,
+              llaisysDataType_t compute, llaisysDataType_t accumulate) {
+    ptrdiff_t out_stride = out_strides[0];
+    ptrdiff_t in_stride = in_strides[0];
+
+    // f32 激活可以搭配低精度权重
+    if (type == LLAISYS_DTYPE_F32 && weight_type == LLAISYS_DTYPE_BF16) {
+        return rms_norm_<float, llaisys::bf16_t>(out, in, weight, eps, batch, dim, out_stride, in_stride, compute, accumulate);
+    }
+    if (type == LLAISYS_DTYPE_F32 && weight_type == LLAISYS_DTYPE_F16) {
+        return rms_norm_<float, llaisys::fp16_t>(out, in, weight, eps, batch, dim, out_stride, in_stride, compute, accumulate);
+    }
+    CHECK_SAME_DTYPE(type, weight_type);
+
     switch (type) {
     case LLAISYS_DTYPE_F32:
-        return rms_norm_(reinterpret_cast<float *>(out),
-                        reinterpret_cast<const float *>(in),
-                        reinterpret_cast<const float *>(weight),
-                        eps, batch, dim);
+        return rms_norm_<float, float>(out, in, weight, eps, batch, dim, out_stride, in_stride, compute, accumulate);
     case LLAISYS_DTYPE_BF16:
-        return rms_norm_(reinterpret_cast<llaisys::bf16_t *>(out),
-                        reinterpret_cast<const llaisys::bf16_t *>(in),
-                        reinterpret_cast<const llaisys::bf16_t *>(weight),
-                        eps, batch, dim);
+        return rms_norm_<llaisys::bf16_t, llaisys::bf16_t>(out, in, weight, eps, batch, dim, out_stride, in_stride, compute, accumulate);
     case LLAISYS_DTYPE_F16:
-        return rms_norm_(reinterpret_cast<llaisys::fp16_t *>(out),
-                        reinterpret_cast<const llaisys::fp16_t *>(in),
-                        reinterpret_cast<const llaisys::fp16_t *>(weight),
-                        eps, batch, dim);
+        return rms_norm_<llaisys::fp16_t, llaisys::fp16_t>(out, in, weight, eps, batch, dim, out_stride, in_stride, compute, accumulate);
     default:
         EXCEPTION_UNSUPPORTED_DATATYPE(type);
     }
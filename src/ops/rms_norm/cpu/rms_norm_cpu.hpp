@@ -1,9 +1,15 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../../utils/small_vector.hpp"
+
 #include <cstddef>
+#include <vector>
 
 namespace llaisys::ops::cpu {
+// weight_type 与 type 相同，或 type 为 F32 而权重为 BF16/F16
 void rms_norm(std::byte *out, const std::byte *in, const std::byte *weight, float eps,
-              llaisysDataType_t type, size_t batch, size_t dim);
+              llaisysDataType_t type, llaisysDataType_t weight_type, size_t batch, size_t dim,
+              const strides_t &out_strides, const strides_t &in_strides,
+              llaisysDataType_t compute, llaisysDataType_t accumulate);
 }
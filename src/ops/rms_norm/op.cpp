@@ -3,6 +3,7 @@
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
 
+#include "../precision/precision.hpp"
 #include "cpu/rms_norm_cpu.hpp"
 
 namespace llaisys::ops {
@@ -14,9 +15,11 @@ void rms_norm(tensor_t out, tensor_t in, tensor_t weight, float eps) {
     ASSERT(out->ndim() == 2, "rms_norm: out must be a 2D tensor");
     ASSERT(weight->ndim() == 1, "rms_norm: weight must be a 1D tensor");
     
-    // 验证数据类型相同
+    // 验证数据类型相同；f32 激活可以搭配 bf16/f16 权重
     CHECK_SAME_DTYPE(out->dtype(), in->dtype());
-    CHECK_SAME_DTYPE(out->dtype(), weight->dtype());
+    if (out->dtype() != LLAISYS_DTYPE_F32) {
+        CHECK_SAME_DTYPE(out->dtype(), weight->dtype());
+    }
     
     // 验证形状匹配
     size_t batch = in->shape()[0];
@@ -26,10 +29,17 @@ void rms_norm(tensor_t out, tensor_t in, tensor_t weight, float eps) {
     ASSERT(out->shape()[1] == dim, "rms_norm: out shape[1] must match in shape[1]");
     ASSERT(weight->shape()[0] == dim, "rms_norm: weight shape[0] must match in shape[1]");
 
+    // 行间 stride 任意，但每一行内部必须连续
+    ASSERT(out->strides()[1] == 1 && in->strides()[1] == 1, "rms_norm: last dimension must be contiguous");
+    ASSERT(weight->isContiguous(), "rms_norm: weight must be contiguous");
+
+    Precision p = precision(LLAISYS_OP_RMS_NORM);
+
     // CPU计算
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::rms_norm(out->data(), in->data(), weight->data(), eps,
-                            out->dtype(), batch, dim);
+                            out->dtype(), weight->dtype(), batch, dim, out->strides(), in->strides(),
+                            p.compute, p.accumulate);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
@@ -37,7 +47,8 @@ void rms_norm(tensor_t out, tensor_t in, tensor_t weight, float eps) {
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
         return cpu::rms_norm(out->data(), in->data(), weight->data(), eps,
-                            out->dtype(), batch, dim);
+                            out->dtype(), weight->dtype(), batch, dim, out->strides(), in->strides(),
+                            p.compute, p.accumulate);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -1,83 +1,115 @@
 #include "rope_cpu.hpp"
 
+#include "../../../core/llaisys_core.hpp"
 #include "../../../utils.hpp"
+#include "../../../utils/dispatch.hpp"
+#include "../../../utils/simd.hpp"
 
 #include <cmath>
 
-template <typename T>
+#include <omp.h>
+
+namespace simd = llaisys::utils::simd;
+using llaisys::core::Workspace;
+
+// 总元素数小于该值时不开多线程
+constexpr size_t PARALLEL_MIN_NUMEL = size_t(1) << 14;
+
+// HD 非 0 时 head_dim 为编译期常量，旋转循环可以完全展开；HD 为 0 时使用运行时的 head_dim_
+template <typename T, size_t HD>
 void rope_(T *out, const T *in, const int64_t *pos_ids, float theta,
-           size_t seq_len, size_t n_heads, size_t head_dim) {
-    // 输入形状: [seq_len, n_heads, head_dim]
+           size_t seq_len, size_t n_heads, size_t head_dim_,
+           const llaisys::strides_t &out_strides, const llaisys::strides_t &in_strides,
+           ptrdiff_t pos_stride) {
+    // 输入形状: [seq_len, n_heads, head_dim]，seq/head 维 stride 任意，head_dim 维连续
     // head_dim 必须是偶数，前半部分和后半部分配对进行旋转
-    
-    size_t half_dim = head_dim / 2;
-    
-    // 对每个序列位置
-    for (size_t s = 0; s < seq_len; s++) {
-        int64_t pos = pos_ids[s];
-        
-        // 对每个头
-        for (size_t h = 0; h < n_heads; h++) {
-            size_t base_idx = s * n_heads * head_dim + h * head_dim;
-            
-            // 对每个维度对 (前半部分和后半部分)
+    const size_t head_dim = HD != 0 ? HD : head_dim_;
+    const size_t half_dim = head_dim / 2;
+    constexpr size_t W = simd::WIDTH;
+
+    auto &ws = llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace();
+    ws.reserve(omp_get_max_threads(), 2 * Workspace::bytes<float>(half_dim));
+
+    // 角度 φ = pos / theta^(2j/d)，分母只与 j 有关，预先算好
+    float *denom = reinterpret_cast<float *>(ws.shared(Workspace::bytes<float>(half_dim)));
+    for (size_t j = 0; j < half_dim; j++) {
+        float exponent = (2.0f * static_cast<float>(j)) / static_cast<float>(head_dim);
+        denom[j] = std::pow(theta, exponent);
+    }
+
+#pragma omp parallel if (seq_len * n_heads * head_dim >= PARALLEL_MIN_NUMEL)
+    {
+        // 同一位置的 cos/sin 被所有头共用
+        std::byte *scratch = ws.worker(omp_get_thread_num());
+        float *cos_buf = Workspace::take<float>(scratch, half_dim);
+        float *sin_buf = Workspace::take<float>(scratch, half_dim);
+
+#pragma omp for schedule(static)
+        for (ptrdiff_t s = 0; s < static_cast<ptrdiff_t>(seq_len); s++) {
+            float pos = static_cast<float>(pos_ids[s * pos_stride]);
             for (size_t j = 0; j < half_dim; j++) {
-                // 计算角度: φ = pos / theta^(2j/d)
-                float exponent = (2.0f * static_cast<float>(j)) / static_cast<float>(head_dim);
-                float freq = static_cast<float>(pos) / std::pow(theta, exponent);
-                
-                float cos_val = std::cos(freq);
-                float sin_val = std::sin(freq);
-                
-                // 获取 a 和 b (前半部分和后半部分)
-                float a_val, b_val;
-                
-                if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                    a_val = llaisys::utils::cast<float>(in[base_idx + j]);
-                    b_val = llaisys::utils::cast<float>(in[base_idx + half_dim + j]);
-                } else {
-                    a_val = in[base_idx + j];
-                    b_val = in[base_idx + half_dim + j];
-                }
-                
-                // 应用旋转
+                float freq = pos / denom[j];
+                cos_buf[j] = std::cos(freq);
+                sin_buf[j] = std::sin(freq);
+            }
+
+            for (size_t h = 0; h < n_heads; h++) {
+                const T *in_vec = in + s * in_strides[0] + h * in_strides[1];
+                T *out_vec = out + s * out_strides[0] + h * out_strides[1];
+
                 // a' = a * cos - b * sin
                 // b' = b * cos + a * sin
-                float a_new = a_val * cos_val - b_val * sin_val;
-                float b_new = b_val * cos_val + a_val * sin_val;
-                
-                // 写回输出
-                if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                    out[base_idx + j] = llaisys::utils::cast<T>(a_new);
-                    out[base_idx + half_dim + j] = llaisys::utils::cast<T>(b_new);
-                } else {
-                    out[base_idx + j] = a_new;
-                    out[base_idx + half_dim + j] = b_new;
+                size_t j = 0;
+                for (; j + W <= half_dim; j += W) {
+                    simd::VecF a = simd::load(in_vec + j);
+                    simd::VecF b = simd::load(in_vec + half_dim + j);
+                    simd::VecF c = simd::load(cos_buf + j);
+                    simd::VecF sn = simd::load(sin_buf + j);
+                    simd::store(out_vec + j, simd::sub(simd::mul(a, c), simd::mul(b, sn)));
+                    simd::store(out_vec + half_dim + j, simd::fmadd(a, sn, simd::mul(b, c)));
+                }
+                for (; j < half_dim; j++) {
+                    float a = simd::to_f32(in_vec[j]);
+                    float b = simd::to_f32(in_vec[half_dim + j]);
+                    out_vec[j] = simd::from_f32<T>(a * cos_buf[j] - b * sin_buf[j]);
+                    out_vec[half_dim + j] = simd::from_f32<T>(b * cos_buf[j] + a * sin_buf[j]);
                 }
             }
         }
     }
 }
 
+template <typename T>
+void rope_(std::byte *out, const std::byte *in, const int64_t *pos_ids, float theta,
+           size_t seq_len, size_t n_heads, size_t head_dim,
+           const llaisys::strides_t &out_strides, const llaisys::strides_t &in_strides,
+           ptrdiff_t pos_stride) {
+    // 常见的 head_dim
+    llaisys::utils::dispatch_size<64, 128>(head_dim, [&](auto HD) {
+        rope_<T, decltype(HD)::value>(reinterpret_cast<T *>(out), reinterpret_cast<const T *>(in),
+                                      pos_ids, theta, seq_len, n_heads, head_dim,
+                                      out_strides, in_strides, pos_stride);
+    });
+}
+
 namespace llaisys::ops::cpu {
 void rope(std::byte *out, const std::byte *in, const std::byte *pos_ids, float theta,
-          llaisysDataType_t type, size_t seq_len, size_t n_heads, size_t head_dim) {
+          llaisysDataType_t type, size_t seq_len, size_t n_heads, size_t head_dim,
+          const strides_t &out_strides, const strides_t &in_strides,
+          const strides_t &pos_strides) {
     // pos_ids 始终是 int64_t 类型
     const int64_t *pos_ptr = reinterpret_cast<const int64_t *>(pos_ids);
     
     switch (type) {
     case LLAISYS_DTYPE_F32:
-        return rope_(reinterpret_cast<float *>(out),
-                    reinterpret_cast<const float *>(in),
-                    pos_ptr, theta, seq_len, n_heads, head_dim);
+        return rope_<float>(out, in, pos_ptr, theta, seq_len, n_heads, head_dim,
+                            out_strides, in_strides, pos_strides[0]);
     case LLAISYS_DTYPE_BF16:
-        return rope_(reinterpret_cast<llaisys::bf16_t *>(out),
-                    reinterpret_cast<const llaisys::bf16_t *>(in),
-                    pos_ptr, theta, seq_len, n_heads, head_dim);
+        return rope_<llaisys::bf16_t>(out, in, pos_ptr, theta, seq_len, n_heads, head_dim,
+                                      out_strides, in_strides, pos_strides[0]);
     case LLAISYS_DTYPE_F16:
-        return rope_(reinterpret_cast<llaisys::fp16_t *>(out),
-                    reinterpret_cast<const llaisys::fp16_t *>(in),
-                    pos_ptr, theta, seq_len, n_heads, head_dim);
+        return rope_<llaisys::fp16_t>(out, in, pos_ptr, theta, seq_len, n_heads, head_dim,
+                                      out_strides, in_strides, pos_strides[0]);
     default:
         EXCEPTION_UNSUPPORTED_DATATYPE(type);
     }
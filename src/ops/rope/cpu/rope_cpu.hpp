@@ -1,9 +1,14 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../../utils/small_vector.hpp"
+
 #include <cstddef>
+#include <vector>
 
 namespace llaisys::ops::cpu {
 void rope(std::byte *out, const std::byte *in, const std::byte *pos_ids, float theta,
-          llaisysDataType_t type, size_t seq_len, size_t n_heads, size_t head_dim);
+          llaisysDataType_t type, size_t seq_len, size_t n_heads, size_t head_dim,
+          const strides_t &out_strides, const strides_t &in_strides,
+          const strides_t &pos_strides);
 }
@@ -33,10 +33,14 @@ void rope(tensor_t out, tensor_t in, tensor_t pos_ids, float theta) {
     // head_dim 必须是偶数
     ASSERT(head_dim % 2 == 0, "rope: head_dim must be even");
 
+    // seq/head 维 stride 任意，但 head_dim 维必须连续
+    ASSERT(out->strides()[2] == 1 && in->strides()[2] == 1, "rope: last dimension must be contiguous");
+
     // CPU计算
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::rope(out->data(), in->data(), pos_ids->data(), theta,
-                        in->dtype(), seq_len, n_heads, head_dim);
+                        in->dtype(), seq_len, n_heads, head_dim,
+                        out->strides(), in->strides(), pos_ids->strides());
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
@@ -44,7 +48,8 @@ void rope(tensor_t out, tensor_t in, tensor_t pos_ids, float theta) {
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
         return cpu::rope(out->data(), in->data(), pos_ids->data(), theta,
-                        in->dtype(), seq_len, n_heads, head_dim);
+                        in->dtype(), seq_len, n_heads, head_dim,
+                        out->strides(), in->strides(), pos_ids->strides());
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
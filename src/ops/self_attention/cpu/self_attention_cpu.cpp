@@ -1,148 +1,315 @@
 #include "self_attention_cpu.hpp"
 
+#include "../../../core/llaisys_core.hpp"
 #include "../../../utils.hpp"
+#include "../../../utils/dispatch.hpp"
+#include "../../../utils/simd.hpp"
 
 #include <cmath>
 #include <limits>
 #include <vector>
 #include <algorithm>
+#include <type_traits>
 
-template <typename T>
-void self_attention_(T *attn_val, const T *q, const T *k, const T *v, float scale,
-                    size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd) {
+#include <omp.h>
+
+namespace simd = llaisys::utils::simd;
+using llaisys::core::Workspace;
+
+// 计算量（qlen * nh * kvlen * hd）小于该值时不开多线程
+constexpr size_t PARALLEL_MIN_WORK = size_t(1) << 15;
+
+// a · b，a 已转换为 float
+template <typename T, size_t HD>
+inline float dot_(const float *a, const T *b, size_t hd_) {
+    const size_t hd = HD != 0 ? HD : hd_;
+    constexpr size_t W = simd::WIDTH;
+    simd::VecF acc0 = simd::set1(0.0f), acc1 = acc0;
+    size_t d = 0;
+    for (; d + 2 * W <= hd; d += 2 * W) {
+        acc0 = simd::fmadd(simd::load(a + d), simd::load(b + d), acc0);
+        acc1 = simd::fmadd(simd::load(a + d + W), simd::load(b + d + W), acc1);
+    }
+    for (; d + W <= hd; d += W) {
+        acc0 = simd::fmadd(simd::load(a + d), simd::load(b + d), acc0);
+    }
+    float sum = simd::reduce_add(simd::add(acc0, acc1));
+    for (; d < hd; d++) {
+        sum += a[d] * simd::to_f32(b[d]);
+    }
+    return sum;
+}
+
+// acc += w * b
+template <typename T, size_t HD>
+inline void axpy_(float *acc, float w, const T *b, size_t hd_) {
+    const size_t hd = HD != 0 ? HD : hd_;
+    constexpr size_t W = simd::WIDTH;
+    simd::VecF wv = simd::set1(w);
+    size_t d = 0;
+    for (; d + W <= hd; d += W) {
+        simd::store(acc + d, simd::fmadd(wv, simd::load(b + d), simd::load(acc + d)));
+    }
+    for (; d < hd; d++) {
+        acc[d] += w * simd::to_f32(b[d]);
+    }
+}
+
+// 量化 KV cache 的逐 token、逐 head 缩放；Tkv 与 T 相同时不使用
+struct KVScales {
+    const float *k;
+    const float *v;
+    ptrdiff_t k_strides[2];
+    ptrdiff_t v_strides[2];
+
+    float k_at(size_t pos, size_t h) const { return k[pos * k_strides[0] + h * k_strides[1]]; }
+    float v_at(size_t pos, size_t h) const { return v[pos * v_strides[0] + h * v_strides[1]]; }
+};
+
+// HD 非 0 时 head_dim 为编译期常量，点积与加权累加循环可以完全展开；HD 为 0 时使用运行时的 hd_。
+// Tkv 为 int8_t/fp8e4m3_t 时 k、v 在寄存器中反量化：k 的缩放乘到点积上，v 的缩放乘到注意力权重上
+template <typename T, typename Tkv, size_t HD>
+void self_attention_(T *attn_val, const T *q, const Tkv *k, const Tkv *v, const KVScales &kv_scales, float scale,
+                    size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd_,
+                    const llaisys::strides_t &out_strides, const llaisys::strides_t &q_strides,
+                    const llaisys::strides_t &k_strides, const llaisys::strides_t &v_strides) {
     // q: [qlen, nh, hd]
     // k: [kvlen, nkvh, hd]
     // v: [kvlen, nkvh, hd]
     // attn_val: [qlen, nh, hd]
-    
+    // 前两维 stride 任意（如 KV cache 切片、QKV 拆分得到的视图），hd 维连续
+    const size_t hd = HD != 0 ? HD : hd_;
+    constexpr size_t W = simd::WIDTH;
+    constexpr bool QUANTIZED = !std::is_same_v<T, Tkv>;
+
     // 计算 head 重复次数（Grouped Query Attention）
     size_t head_repeat = nh / nkvh;
-    
-    // 对每个 query 位置
-    for (size_t q_pos = 0; q_pos < qlen; q_pos++) {
-        // 对每个 query head
-        for (size_t h = 0; h < nh; h++) {
+    ptrdiff_t units = static_cast<ptrdiff_t>(qlen * nh);
+
+    auto &ws = llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace();
+    ws.reserve(omp_get_max_threads(), Workspace::bytes<float>(kvlen) + 2 * Workspace::bytes<float>(hd));
+
+#pragma omp parallel if (qlen * nh * kvlen * hd >= PARALLEL_MIN_WORK)
+    {
+        // 每个线程的注意力分数、float 形式的 q 与输出累加器
+        std::byte *scratch = ws.worker(omp_get_thread_num());
+        float *scores = Workspace::take<float>(scratch, kvlen);
+        float *q_buf = Workspace::take<float>(scratch, hd);
+        float *acc = Workspace::take<float>(scratch, hd);
+
+#pragma omp for schedule(static)
+        for (ptrdiff_t u = 0; u < units; u++) {
+            size_t q_pos = static_cast<size_t>(u) / nh;
+            size_t h = static_cast<size_t>(u) % nh;
             // 确定对应的 kv head（GQA: 多个 q head 共享一个 kv head）
             size_t kv_h = h / head_repeat;
-            
-            // 临时存储注意力分数和权重
-            std::vector<float> attn_scores(kvlen);
-            
+            const T *q_vec = q + q_pos * q_strides[0] + h * q_strides[1];
+            T *out_vec = attn_val + q_pos * out_strides[0] + h * out_strides[1];
+
+            // 因果掩码：当前 query 在整个序列中的绝对位置为 kvlen - qlen + q_pos，
+            // 只能看到不晚于它的 key，被掩掉的位置权重为 0，直接跳过
+            size_t n_visible = kvlen - qlen + q_pos + 1;
+
             // 步骤1: 计算 Q·K^T * scale
-            for (size_t kv_pos = 0; kv_pos < kvlen; kv_pos++) {
-                float score = 0.0f;
-                
-                // 点积: q[q_pos, h, :] · k[kv_pos, kv_h, :]
-                for (size_t d = 0; d < hd; d++) {
-                    size_t q_idx = q_pos * nh * hd + h * hd + d;
-                    size_t k_idx = kv_pos * nkvh * hd + kv_h * hd + d;
-                    
-                    float q_val, k_val;
-                    if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                        q_val = llaisys::utils::cast<float>(q[q_idx]);
-                        k_val = llaisys::utils::cast<float>(k[k_idx]);
-                    } else {
-                        q_val = q[q_idx];
-                        k_val = k[k_idx];
-                    }
-                    
-                    score += q_val * k_val;
-                }
-                
-                // 应用 scale
-                score *= scale;
-                
-                // 步骤2: 应用因果掩码（causal mask）
-                // 当前 query 位置在整个序列中的绝对位置
-                size_t abs_q_pos = (kvlen - qlen) + q_pos;
-                
-                // 只能看到不晚于当前位置的 key
-                if (kv_pos > abs_q_pos) {
-                    score = -std::numeric_limits<float>::infinity();
-                }
-                
-                attn_scores[kv_pos] = score;
+            for (size_t d = 0; d < hd; d++) {
+                q_buf[d] = simd::to_f32(q_vec[d]) * scale;
             }
-            
-            // 步骤3: Softmax (数值稳定版本)
-            // 找到最大值用于数值稳定
             float max_score = -std::numeric_limits<float>::infinity();
-            for (size_t kv_pos = 0; kv_pos < kvlen; kv_pos++) {
-                if (std::isfinite(attn_scores[kv_pos])) {
-                    max_score = std::max(max_score, attn_scores[kv_pos]);
+            for (size_t kv_pos = 0; kv_pos < n_visible; kv_pos++) {
+                const Tkv *k_vec = k + kv_pos * k_strides[0] + kv_h * k_strides[1];
+                scores[kv_pos] = dot_<Tkv, HD>(q_buf, k_vec, hd);
+                if constexpr (QUANTIZED) {
+                    scores[kv_pos] *= kv_scales.k_at(kv_pos, kv_h);
                 }
+                max_score = std::max(max_score, scores[kv_pos]);
+            }
+
+            // 步骤2: Softmax (数值稳定版本)
+            simd::VecF max_v = simd::set1(max_score);
+            simd::VecF sum_v = simd::set1(0.0f);
+            size_t i = 0;
+            for (; i + W <= n_visible; i += W) {
+                simd::VecF e = simd::exp(simd::sub(simd::load(scores + i), max_v));
+                simd::store(scores + i, e);
+                sum_v = simd::add(sum_v, e);
+            }
+            float sum_exp = simd::reduce_add(sum_v);
+            for (; i < n_visible; i++) {
+                scores[i] = std::exp(scores[i] - max_score);
+                sum_exp += scores[i];
             }
-            
-            // 计算 exp 和 sum
-            std::vector<float> attn_weights(kvlen);
-            float sum_exp = 0.0f;
-            for (size_t kv_pos = 0; kv_pos < kvlen; kv_pos++) {
-                if (std::isfinite(attn_scores[kv_pos])) {
-                    attn_weights[kv_pos] = std::exp(attn_scores[kv_pos] - max_score);
-                    sum_exp += attn_weights[kv_pos];
-                } else {
-                    attn_weights[kv_pos] = 0.0f;
+
+            // 步骤3: 加权求和 attn_weights · V，最后统一除以 sum_exp
+            std::fill(acc, acc + hd, 0.0f);
+            for (size_t kv_pos = 0; kv_pos < n_visible; kv_pos++) {
+                const Tkv *v_vec = v + kv_pos * v_strides[0] + kv_h * v_strides[1];
+                float w = scores[kv_pos];
+                if constexpr (QUANTIZED) {
+                    w *= kv_scales.v_at(kv_pos, kv_h);
                 }
+                axpy_<Tkv, HD>(acc, w, v_vec, hd);
             }
-            
-            // 归一化
-            for (size_t kv_pos = 0; kv_pos < kvlen; kv_pos++) {
-                attn_weights[kv_pos] /= sum_exp;
+
+            // 写回输出
+            simd::VecF inv_sum = simd::set1(1.0f / sum_exp);
+            size_t d = 0;
+            for (; d + W <= hd; d += W) {
+                simd::store(out_vec + d, simd::mul(simd::load(acc + d), inv_sum));
             }
-            
-            // 步骤4: 加权求和 attn_weights · V
-            for (size_t d = 0; d < hd; d++) {
-                float output = 0.0f;
-                
-                for (size_t kv_pos = 0; kv_pos < kvlen; kv_pos++) {
-                    size_t v_idx = kv_pos * nkvh * hd + kv_h * hd + d;
-                    
-                    float v_val;
-                    if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                        v_val = llaisys::utils::cast<float>(v[v_idx]);
-                    } else {
-                        v_val = v[v_idx];
-                    }
-                    
-                    output += attn_weights[kv_pos] * v_val;
+            for (; d < hd; d++) {
+                out_vec[d] = simd::from_f32<T>(acc[d] / sum_exp);
+            }
+        }
+    }
+}
+
+// 参考实现：以 Acc 累加，中间结果按 PyTorch 逐算子计算的顺序舍入到 compute 类型：
+// scores = (q @ k^T) * scale，p = softmax(scores)，out = p @ v。量化的 k、v 先反量化
+template <typename T, typename Tkv, typename Acc>
+void self_attention_reference_(T *attn_val, const T *q, const Tkv *k, const Tkv *v, const KVScales &kv_scales,
+                               float scale,
+                               size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd,
+                               const llaisys::strides_t &out_strides, const llaisys::strides_t &q_strides,
+                               const llaisys::strides_t &k_strides, const llaisys::strides_t &v_strides,
+                               llaisysDataType_t compute) {
+    auto r = [compute](float x) { return simd::round_to(compute, x); };
+    constexpr bool QUANTIZED = !std::is_same_v<T, Tkv>;
+    size_t head_repeat = nh / nkvh;
+    ptrdiff_t units = static_cast<ptrdiff_t>(qlen * nh);
+
+    auto &ws = llaisys::core::context().runtime(LLAISYS_DEVICE_CPU, 0).workspace();
+    ws.reserve(omp_get_max_threads(), Workspace::bytes<Acc>(kvlen) + Workspace::bytes<Acc>(hd));
+
+#pragma omp parallel if (qlen * nh * kvlen * hd >= PARALLEL_MIN_WORK)
+    {
+        std::byte *scratch = ws.worker(omp_get_thread_num());
+        Acc *probs = Workspace::take<Acc>(scratch, kvlen);
+        Acc *acc = Workspace::take<Acc>(scratch, hd);
+
+#pragma omp for schedule(static)
+        for (ptrdiff_t u = 0; u < units; u++) {
+            size_t q_pos = static_cast<size_t>(u) / nh;
+            size_t h = static_cast<size_t>(u) % nh;
+            size_t kv_h = h / head_repeat;
+            const T *q_vec = q + q_pos * q_strides[0] + h * q_strides[1];
+            T *out_vec = attn_val + q_pos * out_strides[0] + h * out_strides[1];
+            size_t n_visible = kvlen - qlen + q_pos + 1;
+
+            Acc max_score = -std::numeric_limits<Acc>::infinity();
+            for (size_t kv_pos = 0; kv_pos < n_visible; kv_pos++) {
+                const Tkv *k_vec = k + kv_pos * k_strides[0] + kv_h * k_strides[1];
+                float k_scale = QUANTIZED ? kv_scales.k_at(kv_pos, kv_h) : 1.0f;
+                Acc dot = 0;
+                for (size_t d = 0; d < hd; d++) {
+                    dot += static_cast<Acc>(simd::to_f32(q_vec[d])) * (simd::to_f32(k_vec[d]) * k_scale);
                 }
-                
-                // 写回输出
-                size_t out_idx = q_pos * nh * hd + h * hd + d;
-                if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                    attn_val[out_idx] = llaisys::utils::cast<T>(output);
-                } else {
-                    attn_val[out_idx] = output;
+                probs[kv_pos] = r(r(static_cast<float>(dot)) * scale);
+                max_score = std::max(max_score, probs[kv_pos]);
+            }
+
+            Acc sum_exp = 0;
+            for (size_t kv_pos = 0; kv_pos < n_visible; kv_pos++) {
+                probs[kv_pos] = std::exp(probs[kv_pos] - max_score);
+                sum_exp += probs[kv_pos];
+            }
+
+            std::fill(acc, acc + hd, Acc(0));
+            for (size_t kv_pos = 0; kv_pos < n_visible; kv_pos++) {
+                const Tkv *v_vec = v + kv_pos * v_strides[0] + kv_h * v_strides[1];
+                float v_scale = QUANTIZED ? kv_scales.v_at(kv_pos, kv_h) : 1.0f;
+                Acc p = r(static_cast<float>(probs[kv_pos] / sum_exp));
+                for (size_t d = 0; d < hd; d++) {
+                    acc[d] += p * (simd::to_f32(v_vec[d]) * v_scale);
                 }
             }
+            for (size_t d = 0; d < hd; d++) {
+                out_vec[d] = simd::from_f32<T>(static_cast<float>(acc[d]));
+            }
         }
     }
 }
 
+template <typename T, typename Tkv>
+void self_attention_(std::byte *attn_val, const std::byte *q, const std::byte *k, const std::byte *v,
+                    const KVScales &kv_scales, float scale,
+                    size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd,
+                    const llaisys::strides_t &out_strides, const llaisys::strides_t &q_strides,
+                    const llaisys::strides_t &k_strides, const llaisys::strides_t &v_strides,
+                    llaisysDataType_t compute, llaisysDataType_t accumulate) {
+    T *out_ = reinterpret_cast<T *>(attn_val);
+    const T *q_ = reinterpret_cast<const T *>(q);
+    const Tkv *k_ = reinterpret_cast<const Tkv *>(k);
+    const Tkv *v_ = reinterpret_cast<const Tkv *>(v);
+
+    if (accumulate == LLAISYS_DTYPE_F64) {
+        return self_attention_reference_<T, Tkv, double>(out_, q_, k_, v_, kv_scales, scale, qlen, kvlen, nh, nkvh,
+                                                         hd, out_strides, q_strides, k_strides, v_strides, compute);
+    }
+    if (compute != LLAISYS_DTYPE_F32) {
+        return self_attention_reference_<T, Tkv, float>(out_, q_, k_, v_, kv_scales, scale, qlen, kvlen, nh, nkvh,
+                                                        hd, out_strides, q_strides, k_strides, v_strides, compute);
+    }
+    // 常见的 head_dim
+    llaisys::utils::dispatch_size<64, 128>(hd, [&](auto HD) {
+        self_attention_<T, Tkv, decltype(HD)::value>(out_, q_, k_, v_, kv_scales, scale, qlen, kvlen, nh, nkvh, hd,
+                                                     out_strides, q_strides, k_strides, v_strides);
+    });
+}
+
+template <typename T>
+void self_attention_(std::byte *attn_val, const std::byte *q, const std::byte *k, const std::byte *v,
+                    const KVScales &kv_scales, float scale, llaisysDataType_t kv_type,
+                    size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd,
+                    const llaisys::strides_t &out_strides, const llaisys::strides_t &q_strides,
+                    const llaisys::strides_t &k_strides, const llaisys::strides_t &v_strides,
+                    llaisysDataType_t compute, llaisysDataType_t accumulate) {
+    switch (kv_type) {
+    case LLAISYS_DTYPE_I8:
+        return self_attention_<T, int8_t>(attn_val, q, k, v, kv_scales, scale, qlen, kvlen, nh, nkvh, hd,
+                                          out_strides, q_strides, k_strides, v_strides, compute, accumulate);
+    case LLAISYS_DTYPE_F8:
+        return self_attention_<T, llaisys::fp8e4m3_t>(attn_val, q, k, v, kv_scales, scale, qlen, kvlen, nh, nkvh,
+                                                      hd, out_strides, q_strides, k_strides, v_strides, compute,
+                                                      accumulate);
+    default:
+        return self_attention_<T, T>(attn_val, q, k, v, kv_scales, scale, qlen, kvlen, nh, nkvh, hd,
+                                     out_strides, q_strides, k_strides, v_strides, compute, accumulate);
+    }
+}
+
 namespace llaisys::ops::cpu {
 void self_attention(std::byte *attn_val, const std::byte *q, const std::byte *k,
-                   const std::byte *v, float scale, llaisysDataType_t type,
-                   size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd) {
-    
+                   const std::byte *v, const std::byte *k_scale, const std::byte *v_scale,
+                   float scale, llaisysDataType_t type, llaisysDataType_t kv_type,
+                   size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd,
+                   const strides_t &attn_val_strides, const strides_t &q_strides,
+                   const strides_t &k_strides, const strides_t &v_strides,
+                   const strides_t &k_scale_strides, const strides_t &v_scale_strides,
+                   llaisysDataType_t compute, llaisysDataType_t accumulate) {
+    KVScales kv_scales{reinterpret_cast<const float *>(k_scale), reinterpret_cast<const float *>(v_scale), {}, {}};
+    if (k_scale != nullptr) {
+        kv_scales.k_strides[0] = k_scale_strides[0];
+        kv_scales.k_strides[1] = k_scale_strides[1];
+        kv_scales.v_strides[0] = v_scale_strides[0];
+        kv_scales.v_strides[1] = v_scale_strides[1];
+    }
+
     switch (type) {
     case LLAISYS_DTYPE_F32:
-        return self_attention_(reinterpret_cast<float *>(attn_val),
-                              reinterpret_cast<const float *>(q),
-                              reinterpret_cast<const float *>(k),
-                              reinterpret_cast<const float *>(v),
-                              scale, qlen, kvlen, nh, nkvh, hd);
+        return self_attention_<float>(attn_val, q, k, v, kv_scales,
+                              scale, kv_type, qlen, kvlen, nh, nkvh, hd,
+                              attn_val_strides, q_strides, k_strides, v_strides,
+                              compute, accumulate);
     case LLAISYS_DTYPE_BF16:
-        return self_attention_(reinterpret_cast<llaisys::bf16_t *>(attn_val),
-                              reinterpret_cast<const llaisys::bf16_t *>(q),
-                              reinterpret_cast<const llaisys::bf16_t *>(k),
-                              reinterpret_cast<const llaisys::bf16_t *>(v),
-                              scale, qlen, kvlen, nh, nkvh, hd);
+        return self_attention_<llaisys::bf16_t>(attn_val, q, k, v, kv_scales,
+                              scale, kv_type, qlen, kvlen, nh, nkvh, hd,
+                              attn_val_strides, q_strides, k_strides, v_strides,
+                              compute, accumulate);
     case LLAISYS_DTYPE_F16:
-        return self_attention_(reinterpret_cast<llaisys::fp16_t *>(attn_val),
-                              reinterpret_cast<const llaisys::fp16_t *>(q),
-                              reinterpret_cast<const llaisys::fp16_t *>(k),
-                              reinterpret_cast<const llaisys::fp16_t *>(v),
-                              scale, qlen, kvlen, nh, nkvh, hd);
+        return self_attention_<llaisys::fp16_t>(attn_val, q, k, v, kv_scales,
+                              scale, kv_type, qlen, kvlen, nh, nkvh, hd,
+                              attn_val_strides, q_strides, k_strides, v_strides,
+                              compute, accumulate);
     default:
         EXCEPTION_UNSUPPORTED_DATATYPE(type);
     }
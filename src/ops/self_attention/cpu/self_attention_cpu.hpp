@@ -1,10 +1,20 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../../utils/small_vector.hpp"
+
 #include <cstddef>
+#include <vector>
 
 namespace llaisys::ops::cpu {
+// kv_type 与 type 相同，或为 I8/F8（量化 KV cache，此时 k_scale、v_scale 为 [kvlen, nkvh] 的 f32 缩放，
+// 否则为空）
 void self_attention(std::byte *attn_val, const std::byte *q, const std::byte *k, 
-                   const std::byte *v, float scale, llaisysDataType_t type,
-                   size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd);
+                   const std::byte *v, const std::byte *k_scale, const std::byte *v_scale,
+                   float scale, llaisysDataType_t type, llaisysDataType_t kv_type,
+                   size_t qlen, size_t kvlen, size_t nh, size_t nkvh, size_t hd,
+                   const strides_t &attn_val_strides, const strides_t &q_strides,
+                   const strides_t &k_strides, const strides_t &v_strides,
+                   const strides_t &k_scale_strides, const strides_t &v_scale_strides,
+                   llaisysDataType_t compute, llaisysDataType_t accumulate);
 }
@@ -3,11 +3,16 @@
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
 
+#include "../precision/precision.hpp"
 #include "cpu/self_attention_cpu.hpp"
 
 namespace llaisys::ops {
-void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float scale) {
+void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float scale,
+                    tensor_t k_scale, tensor_t v_scale) {
     CHECK_SAME_DEVICE(attn_val, q, k, v);
+    bool quantized = k->dtype() == LLAISYS_DTYPE_I8 || k->dtype() == LLAISYS_DTYPE_F8;
+    ASSERT(quantized == (k_scale != nullptr) && quantized == (v_scale != nullptr),
+           "self_attention: k_scale and v_scale are required for (and only for) a quantized KV cache");
     
     // 验证维度
     ASSERT(q->ndim() == 3, "self_attention: q must be a 3D tensor [qlen, nh, hd]");
@@ -17,8 +22,15 @@ void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float
     
     // 验证数据类型相同
     CHECK_SAME_DTYPE(attn_val->dtype(), q->dtype());
-    CHECK_SAME_DTYPE(attn_val->dtype(), k->dtype());
-    CHECK_SAME_DTYPE(attn_val->dtype(), v->dtype());
+    if (quantized) {
+        CHECK_SAME_DEVICE(attn_val, k_scale, v_scale);
+        CHECK_SAME_DTYPE(k->dtype(), v->dtype());
+        CHECK_SAME_DTYPE(k_scale->dtype(), LLAISYS_DTYPE_F32);
+        CHECK_SAME_DTYPE(v_scale->dtype(), LLAISYS_DTYPE_F32);
+    } else {
+        CHECK_SAME_DTYPE(attn_val->dtype(), k->dtype());
+        CHECK_SAME_DTYPE(attn_val->dtype(), v->dtype());
+    }
     
     // 提取形状参数
     size_t qlen = q->shape()[0];
@@ -39,22 +51,42 @@ void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float
     ASSERT(v->shape()[1] == nkvh, "self_attention: k shape[1] must match v shape[1]");
     ASSERT(k->shape()[2] == hd, "self_attention: k shape[2] must match q shape[2]");
     ASSERT(v->shape()[2] == hd, "self_attention: v shape[2] must match q shape[2]");
+    ASSERT(kvlen >= qlen, "self_attention: kvlen must not be less than qlen");
+    if (quantized) {
+        ASSERT(k_scale->ndim() == 2 && k_scale->shape()[0] == kvlen && k_scale->shape()[1] == nkvh,
+               "self_attention: k_scale must have shape [kvlen, nkvh]");
+        CHECK_SAME_SHAPE(v_scale->shape(), k_scale->shape());
+    }
     
     // 验证 Grouped Query Attention: nh 必须是 nkvh 的倍数
     ASSERT(nh % nkvh == 0, "self_attention: nh must be divisible by nkvh (Grouped Query Attention)");
 
+    // 前两维 stride 任意，但 head_dim 维必须连续
+    ASSERT(attn_val->strides()[2] == 1 && q->strides()[2] == 1 && k->strides()[2] == 1 && v->strides()[2] == 1,
+           "self_attention: last dimension must be contiguous");
+
+    Precision p = precision(LLAISYS_OP_SELF_ATTENTION);
+    const std::byte *k_scale_data = quantized ? k_scale->data() : nullptr;
+    const std::byte *v_scale_data = quantized ? v_scale->data() : nullptr;
+    strides_t k_scale_strides = quantized ? k_scale->strides() : strides_t{};
+    strides_t v_scale_strides = quantized ? v_scale->strides() : strides_t{};
+
     // CPU计算
     if (attn_val->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(),
-                                  scale, q->dtype(), qlen, kvlen, nh, nkvh, hd);
+        return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(), k_scale_data, v_scale_data,
+                                  scale, q->dtype(), k->dtype(), qlen, kvlen, nh, nkvh, hd,
+                                  attn_val->strides(), q->strides(), k->strides(), v->strides(),
+                                  k_scale_strides, v_scale_strides, p.compute, p.accumulate);
     }
 
     llaisys::core::context().setDevice(attn_val->deviceType(), attn_val->deviceId());
 
     switch (attn_val->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(),
-                                  scale, q->dtype(), qlen, kvlen, nh, nkvh, hd);
+        return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(), k_scale_data, v_scale_data,
+                                  scale, q->dtype(), k->dtype(), qlen, kvlen, nh, nkvh, hd,
+                                  attn_val->strides(), q->strides(), k->strides(), v->strides(),
+                                  k_scale_strides, v_scale_strides, p.compute, p.accumulate);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
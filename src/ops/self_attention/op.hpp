@@ -3,5 +3,8 @@
 #include "../../tensor/tensor.hpp"
 
 namespace llaisys::ops {
-void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float scale);
+// k、v 为 I8 或 F8（E4M3）的量化 KV cache 时需给出 k_scale、v_scale：[kvlen, nkvh] 的 F32
+// 逐 token、逐 head 缩放（由 quantize_kv 写入），K = K_q * k_scale，反量化在内核中完成
+void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float scale,
+                    tensor_t k_scale = nullptr, tensor_t v_scale = nullptr);
 }
@@ -1,59 +1,38 @@
 #include "swiglu_cpu.hpp"
 
-#include "../../../utils.hpp"
-
-#include <cmath>
+#include "../../elementwise/cpu/elementwise_cpu.hpp"
 
 template <typename T>
-void swiglu_(T *out, const T *gate, const T *up, size_t numel) {
+void swiglu_(std::byte *out, const std::byte *gate, const std::byte *up, size_t seqlen, size_t dim,
+             const llaisys::strides_t &out_strides, const llaisys::strides_t &gate_strides,
+             const llaisys::strides_t &up_strides, llaisysDataType_t compute) {
+    namespace ew = llaisys::ops::cpu::elementwise;
     // SwiGLU: out[i] = up[i] * (gate[i] / (1 + e^(-gate[i])))
     // 其中 gate[i] / (1 + e^(-gate[i])) 是 Swish/SiLU 激活函数
-
-    for (size_t i = 0; i < numel; i++) {
-        float gate_val, up_val;
-        
-        if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-            gate_val = llaisys::utils::cast<float>(gate[i]);
-            up_val = llaisys::utils::cast<float>(up[i]);
-        } else {
-            gate_val = gate[i];
-            up_val = up[i];
-        }
-        
-        // 计算 Swish(gate) = gate / (1 + exp(-gate))
-        float swish = gate_val / (1.0f + std::exp(-gate_val));
-        
-        // SwiGLU: up * swish(gate)
-        float result = up_val * swish;
-        
-        if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-            out[i] = llaisys::utils::cast<T>(result);
-        } else {
-            out[i] = result;
-        }
+    auto gate_ = ew::input<T>(gate, gate_strides);
+    auto up_ = ew::input<T>(up, up_strides);
+    if (compute == LLAISYS_DTYPE_F32) {
+        return ew::assign<T>(out, {seqlen, dim}, out_strides, ew::mul(up_, ew::silu(gate_)));
     }
+    // 中间结果逐步舍入到 compute 类型：e = exp(-gate)，s = gate / (1 + e)，out = up * s
+    auto e = ew::round(ew::exp(ew::sub(ew::scalar(0.0f), gate_)), compute);
+    auto s = ew::round(ew::div(gate_, ew::round(ew::add(ew::scalar(1.0f), e), compute)), compute);
+    ew::assign<T>(out, {seqlen, dim}, out_strides, ew::mul(up_, s));
 }
 
 namespace llaisys::ops::cpu {
 void swiglu(std::byte *out, const std::byte *gate, const std::byte *up,
-           llaisysDataType_t type, size_t numel) {
+           llaisysDataType_t type, size_t seqlen, size_t dim,
+           const strides_t &out_strides, const strides_t &gate_strides,
+           const strides_t &up_strides, llaisysDataType_t compute) {
     
     switch (type) {
     case LLAISYS_DTYPE_F32:
-        return swiglu_(reinterpret_cast<float *>(out),
-                      reinterpret_cast<const float *>(gate),
-                      reinterpret_cast<const float *>(up),
-                      numel);
+        return swiglu_<float>(out, gate, up, seqlen, dim, out_strides, gate_strides, up_strides, compute);
     case LLAISYS_DTYPE_BF16:
-        return swiglu_(reinterpret_cast<llaisys::bf16_t *>(out),
-                      reinterpret_cast<const llaisys::bf16_t *>(gate),
-                      reinterpret_cast<const llaisys::bf16_t *>(up),
-                      numel);
+        return swiglu_<llaisys::bf16_t>(out, gate, up, seqlen, dim, out_strides, gate_strides, up_strides, compute);
     case LLAISYS_DTYPE_F16:
-        return swiglu_(reinterpret_cast<llaisys::fp16_t *>(out),
-                      reinterpret_cast<const llaisys::fp16_t *>(gate),
-                      reinterpret_cast<const llaisys::fp16_t *>(up),
-                      numel);
+        return swiglu_<llaisys::fp16_t>(out, gate, up, seqlen, dim, out_strides, gate_strides, up_strides, compute);
     default:
         EXCEPTION_UNSUPPORTED_DATATYPE(type);
     }
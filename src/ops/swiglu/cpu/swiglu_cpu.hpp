@@ -1,9 +1,14 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../../utils/small_vector.hpp"
+
 #include <cstddef>
+#include <vector>
 
 namespace llaisys::ops::cpu {
 void swiglu(std::byte *out, const std::byte *gate, const std::byte *up,
-           llaisysDataType_t type, size_t numel);
+           llaisysDataType_t type, size_t seqlen, size_t dim,
+           const strides_t &out_strides, const strides_t &gate_strides,
+           const strides_t &up_strides, llaisysDataType_t compute);
 }
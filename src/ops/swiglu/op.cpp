@@ -3,6 +3,7 @@
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
 
+#include "../precision/precision.hpp"
 #include "cpu/swiglu_cpu.hpp"
 
 namespace llaisys::ops {
@@ -24,12 +25,14 @@ void swiglu(tensor_t out, tensor_t gate, tensor_t up) {
     ASSERT(out->shape()[1] == gate->shape()[1] && out->shape()[1] == up->shape()[1],
            "swiglu: all tensors must have the same shape[1]");
     
-    size_t numel = out->numel();
+    size_t seqlen = out->shape()[0];
+    size_t dim = out->shape()[1];
+    Precision p = precision(LLAISYS_OP_SWIGLU);
 
     // CPU计算
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::swiglu(out->data(), gate->data(), up->data(),
-                          out->dtype(), numel);
+                          out->dtype(), seqlen, dim, out->strides(), gate->strides(), up->strides(), p.compute);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
@@ -37,7 +40,7 @@ void swiglu(tensor_t out, tensor_t gate, tensor_t up) {
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
         return cpu::swiglu(out->data(), gate->data(), up->data(),
-                          out->dtype(), numel);
+                          out->dtype(), seqlen, dim, out->strides(), gate->strides(), up->strides(), p.compute);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
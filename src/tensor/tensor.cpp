@@ -1,41 +1,72 @@
 #include "tensor.hpp"
 
+#include "../ops/rearrange/op.hpp"
 #include "../utils.hpp"
+#include "../utils/object_pool.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <numeric>
 #include <sstream>
 
 namespace llaisys {
 
-Tensor::Tensor(TensorMeta meta, core::storage_t storage, size_t offset)
+Tensor::Tensor(Private, TensorMeta meta, core::storage_t storage, size_t offset)
     : _meta(std::move(meta)), _storage(std::move(storage)), _offset(offset) {}
 
-tensor_t Tensor::create(const std::vector<size_t> &shape,
+tensor_t Tensor::make(TensorMeta meta, core::storage_t storage, size_t offset) {
+    return std::allocate_shared<Tensor>(utils::PoolAllocator<Tensor>(), Private{}, std::move(meta), std::move(storage), offset);
+}
+
+tensor_t Tensor::create(const shape_t &shape,
                         llaisysDataType_t dtype,
                         llaisysDeviceType_t device_type,
-                        int device) {
+                        int device,
+                        size_t row_alignment) {
     size_t ndim_ = shape.size();
-    std::vector<ptrdiff_t> strides(ndim_);
+    size_t dtype_size = utils::dsize(dtype);
+    CHECK_ARGUMENT(row_alignment % dtype_size == 0, "tensor: row alignment must be a multiple of the element size");
+    strides_t strides(ndim_);
     size_t stride = 1;
     for (size_t i = 1; i <= ndim_; i++) {
         strides[ndim_ - i] = stride;
         stride *= shape[ndim_ - i];
+        if (i == 1 && ndim_ > 1 && row_alignment > 0) {
+            size_t pitch = row_alignment / dtype_size;
+            stride = (stride + pitch - 1) / pitch * pitch;
+        }
     }
     TensorMeta meta{dtype, shape, strides};
     size_t total_elems = stride;
-    size_t dtype_size = utils::dsize(dtype);
 
     if (device_type == LLAISYS_DEVICE_CPU && core::context().runtime().deviceType() != LLAISYS_DEVICE_CPU) {
         auto storage = core::context().runtime().allocateHostStorage(total_elems * dtype_size);
-        return std::shared_ptr<Tensor>(new Tensor(meta, storage));
+        return make(meta, storage);
     } else {
         core::context().setDevice(device_type, device);
         auto storage = core::context().runtime().allocateDeviceStorage(total_elems * dtype_size);
-        return std::shared_ptr<Tensor>(new Tensor(meta, storage));
+        return make(meta, storage);
     }
 }
 
+tensor_t Tensor::create(const shape_t &shape,
+                        llaisysDataType_t dtype,
+                        core::storage_t storage,
+                        size_t offset) {
+    size_t ndim_ = shape.size();
+    strides_t strides(ndim_);
+    size_t stride = 1;
+    for (size_t i = 1; i <= ndim_; i++) {
+        strides[ndim_ - i] = stride;
+        stride *= shape[ndim_ - i];
+    }
+    CHECK_ARGUMENT(offset + stride * utils::dsize(dtype) <= storage->size(), "tensor exceeds storage bounds");
+    TensorMeta meta{dtype, shape, strides};
+    return make(meta, std::move(storage), offset);
+}
+
 std::byte *Tensor::data() {
     return _storage->memory() + _offset;
 }
@@ -48,11 +79,11 @@ size_t Tensor::ndim() const {
     return _meta.shape.size();
 }
 
-const std::vector<size_t> &Tensor::shape() const {
+const shape_t &Tensor::shape() const {
     return _meta.shape;
 }
 
-const std::vector<ptrdiff_t> &Tensor::strides() const {
+const strides_t &Tensor::strides() const {
     return _meta.strides;
 }
 
@@ -94,7 +125,7 @@ std::string Tensor::info() const {
 }
 
 template <typename T>
-void print_data(const T *data, const std::vector<size_t> &shape, const std::vector<ptrdiff_t> &strides, size_t dim) {
+void print_data(const T *data, const shape_t &shape, const strides_t &strides, size_t dim) {
     if (dim == shape.size() - 1) {
         for (size_t i = 0; i < shape[dim]; i++) {
             if constexpr (std::is_same_v<T, bf16_t> || std::is_same_v<T, fp16_t>) {
@@ -111,7 +142,7 @@ void print_data(const T *data, const std::vector<size_t> &shape, const std::vect
     }
 }
 
-void debug_print(const std::byte *data, const std::vector<size_t> &shape, const std::vector<ptrdiff_t> &strides, llaisysDataType_t dtype) {
+void debug_print(const std::byte *data, const shape_t &shape, const strides_t &strides, llaisysDataType_t dtype) {
     switch (dtype) {
     case LLAISYS_DTYPE_BYTE:
         return print_data(reinterpret_cast<const char *>(data), shape, strides, 0);
@@ -183,14 +214,28 @@ bool Tensor::isContiguous() const {
     return true;
 }
 
-tensor_t Tensor::permute(const std::vector<size_t> &order) const {
+bool Tensor::isAligned(size_t alignment) const {
+    if (reinterpret_cast<uintptr_t>(this->data()) % alignment != 0) {
+        return false;
+    }
+    // 长度为 1 的维度不产生新的行
+    for (size_t i = 0; i + 1 < _meta.shape.size(); i++) {
+        size_t row_bytes = static_cast<size_t>(std::abs(_meta.strides[i])) * this->elementSize();
+        if (_meta.shape[i] > 1 && row_bytes % alignment != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+tensor_t Tensor::permute(const shape_t &order) const {
     // 验证order的长度与张量的维度数一致
     ASSERT(order.size() == this->ndim(), 
            "permute: order size must match tensor dim");
     
     // 根据order重新排列shape和strides
-    std::vector<size_t> new_shape(this->ndim());
-    std::vector<ptrdiff_t> new_strides(this->ndim());
+    shape_t new_shape(this->ndim());
+    strides_t new_strides(this->ndim());
     
     for (size_t i = 0; i < order.size(); ++i) {
         new_shape[i] = _meta.shape[order[i]];
@@ -199,22 +244,85 @@ tensor_t Tensor::permute(const std::vector<size_t> &order) const {
     
     // 创建新的TensorMeta，共享同一个storage
     TensorMeta new_meta{this->dtype(), new_shape, new_strides};
-    return std::shared_ptr<Tensor>(new Tensor(new_meta, _storage, _offset));
+    return make(new_meta, _storage, _offset);
 }
 
-tensor_t Tensor::view(const std::vector<size_t> &shape) const {
-    // 计算新的strides
-    size_t new_ndim = shape.size();
-    std::vector<ptrdiff_t> new_strides(new_ndim);
-    ptrdiff_t stride = 1;
-    for (size_t i = 1; i <= new_ndim; ++i) {
-        new_strides[new_ndim - i] = stride;
-        stride *= shape[new_ndim - i];
+// 按广播规则把张量扩展到更大的形状：从最后一维开始对齐，长度为 1 或缺失的维度
+// stride 置 0，不拷贝数据
+tensor_t Tensor::expand(const shape_t &shape) const {
+    ASSERT(shape.size() >= this->ndim(), "expand: target shape must have at least as many dims as the tensor");
+
+    size_t lead = shape.size() - this->ndim();
+    strides_t new_strides(shape.size(), 0);
+    for (size_t i = 0; i < this->ndim(); ++i) {
+        size_t size = _meta.shape[i];
+        ASSERT(size == shape[lead + i] || size == 1, "expand: shape is not broadcastable to the target shape");
+        new_strides[lead + i] = size == 1 ? 0 : _meta.strides[i];
     }
-    
+
+    TensorMeta new_meta{this->dtype(), shape, new_strides};
+    return make(new_meta, _storage, _offset);
+}
+
+// 按 PyTorch 的规则为新形状推导 strides：只有当新形状的每一段都能映射到原张量中
+// 一段内存连续（stride 满足乘积关系）的维度块上时，才能不拷贝数据得到视图。
+static bool compute_view_strides(const shape_t &old_shape,
+                                 const strides_t &old_strides,
+                                 const shape_t &new_shape,
+                                 strides_t &new_strides) {
+    new_strides.assign(new_shape.size(), 0);
+    size_t numel = std::accumulate(old_shape.begin(), old_shape.end(), size_t(1), std::multiplies<size_t>());
+
+    // 空张量或标量：任意形状都可以按连续布局表示
+    if (old_shape.empty() || numel == 0) {
+        ptrdiff_t stride = 1;
+        for (size_t i = new_shape.size(); i > 0; --i) {
+            new_strides[i - 1] = stride;
+            stride *= static_cast<ptrdiff_t>(std::max<size_t>(new_shape[i - 1], 1));
+        }
+        return true;
+    }
+
+    ptrdiff_t view_d = static_cast<ptrdiff_t>(new_shape.size()) - 1;
+    ptrdiff_t chunk_base_stride = old_strides.back();
+    size_t tensor_numel = 1;
+    size_t view_numel = 1;
+    for (ptrdiff_t tensor_d = static_cast<ptrdiff_t>(old_shape.size()) - 1; tensor_d >= 0; --tensor_d) {
+        tensor_numel *= old_shape[tensor_d];
+        // 到达一个连续块的边界
+        if (tensor_d == 0
+            || (old_shape[tensor_d - 1] != 1
+                && old_strides[tensor_d - 1] != static_cast<ptrdiff_t>(tensor_numel) * chunk_base_stride)) {
+            while (view_d >= 0 && (view_numel < tensor_numel || new_shape[view_d] == 1)) {
+                new_strides[view_d] = static_cast<ptrdiff_t>(view_numel) * chunk_base_stride;
+                view_numel *= new_shape[view_d];
+                view_d--;
+            }
+            if (view_numel != tensor_numel) {
+                return false;
+            }
+            if (tensor_d > 0) {
+                chunk_base_stride = old_strides[tensor_d - 1];
+                tensor_numel = 1;
+                view_numel = 1;
+            }
+        }
+    }
+    return view_d == -1;
+}
+
+tensor_t Tensor::view(const shape_t &shape) const {
+    size_t new_numel = std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+    ASSERT(new_numel == this->numel(), "view: shape is invalid for the number of elements");
+
+    // 计算新的strides，不兼容时报错（需要拷贝的情况请使用 reshape）
+    strides_t new_strides;
+    ASSERT(compute_view_strides(_meta.shape, _meta.strides, shape, new_strides),
+           "view: shape is not compatible with the strides of the tensor, use reshape() instead");
+
     // 创建新的TensorMeta，共享同一个storage
     TensorMeta new_meta{this->dtype(), shape, new_strides};
-    return std::shared_ptr<Tensor>(new Tensor(new_meta, _storage, _offset));
+    return make(new_meta, _storage, _offset);
 }
 
 tensor_t Tensor::slice(size_t dim, size_t start, size_t end) const {
@@ -229,11 +337,11 @@ tensor_t Tensor::slice(size_t dim, size_t start, size_t end) const {
            "slice: end index out of range");
     
     // 创建新的shape（只有被切片的维度大小改变）
-    std::vector<size_t> new_shape = _meta.shape;
+    shape_t new_shape = _meta.shape;
     new_shape[dim] = end - start;
     
     // strides保持不变（访问模式不变）
-    std::vector<ptrdiff_t> new_strides = _meta.strides;
+    strides_t new_strides = _meta.strides;
     
     // 计算新的offset（数据起始位置前移）
     // offset增加量 = start * stride[dim] * elementSize
@@ -241,15 +349,12 @@ tensor_t Tensor::slice(size_t dim, size_t start, size_t end) const {
     
     // 创建新的TensorMeta，共享同一个storage，但offset改变
     TensorMeta new_meta{this->dtype(), new_shape, new_strides};
-    return std::shared_ptr<Tensor>(new Tensor(new_meta, _storage, new_offset));
+    return make(new_meta, _storage, new_offset);
 }
 
 void Tensor::load(const void *src_) {
     core::context().setDevice(this->deviceType(), this->deviceId());
-    
-    // 总字节数
-    size_t total_bytes = this->numel() * this->elementSize();
-    
+
     // copy方向
     llaisysMemcpyKind_t memcpy_kind;
     if (this->deviceType() == LLAISYS_DEVICE_CPU) {
@@ -257,29 +362,86 @@ void Tensor::load(const void *src_) {
     } else {
         memcpy_kind = LLAISYS_MEMCPY_H2D;
     }
-    
-    // Copy data
-    core::context().runtime().api()->memcpy_sync(
-        this->data(),
-        src_,
-        total_bytes,
-        memcpy_kind
-    );
+
+    // src 为紧密排列的数据。连续张量、补齐行距的张量等能表示为二维拷贝时直接写入
+    strides_t dense_strides(this->ndim());
+    size_t stride = 1;
+    for (size_t i = this->ndim(); i-- > 0;) {
+        dense_strides[i] = static_cast<ptrdiff_t>(stride);
+        stride *= _meta.shape[i];
+    }
+    if (ops::copy2d(this->data(), this->strides(), static_cast<const std::byte *>(src_), dense_strides,
+                    this->shape(), this->elementSize(), memcpy_kind, this->deviceType(), this->deviceId())) {
+        return;
+    }
+
+    // 其余情况先载入连续张量，再按 strides 写入
+    auto dense = create(this->shape(), this->dtype(), this->deviceType(), this->deviceId());
+    dense->load(src_);
+    ops::rearrange(make(_meta, _storage, _offset), dense);
 }
 
 tensor_t Tensor::contiguous() const {
-    TO_BE_IMPLEMENTED();
-    return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
+    // 已经连续时直接返回共享 storage 的视图
+    auto self = make(_meta, _storage, _offset);
+    if (this->isContiguous()) {
+        return self;
+    }
+
+    auto out = create(this->shape(), this->dtype(), this->deviceType(), this->deviceId());
+    ops::rearrange(out, self);
+    return out;
 }
 
-tensor_t Tensor::reshape(const std::vector<size_t> &shape) const {
-    TO_BE_IMPLEMENTED();
-    return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
+tensor_t Tensor::reshape(const shape_t &shape) const {
+    size_t new_numel = std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+    ASSERT(new_numel == this->numel(), "reshape: shape is invalid for the number of elements");
+
+    // strides 允许时直接返回零拷贝视图，否则先整理成连续张量再 view
+    strides_t new_strides;
+    if (compute_view_strides(_meta.shape, _meta.strides, shape, new_strides)) {
+        TensorMeta new_meta{this->dtype(), shape, new_strides};
+        return make(new_meta, _storage, _offset);
+    }
+    return this->contiguous()->view(shape);
 }
 
 tensor_t Tensor::to(llaisysDeviceType_t device_type, int device) const {
-    TO_BE_IMPLEMENTED();
-    return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
+    // device < 0 表示同类型设备上沿用当前设备号，否则使用 0 号设备
+    if (device < 0) {
+        device = device_type == this->deviceType() ? this->deviceId() : 0;
+    }
+    if (device_type == this->deviceType() && device == this->deviceId()) {
+        return make(_meta, _storage, _offset);
+    }
+
+    // 先在源设备上整理成连续布局，再整块拷贝
+    auto src = this->contiguous();
+    auto dst = create(this->shape(), this->dtype(), device_type, device);
+
+    llaisysMemcpyKind_t memcpy_kind;
+    if (src->deviceType() == LLAISYS_DEVICE_CPU && device_type == LLAISYS_DEVICE_CPU) {
+        memcpy_kind = LLAISYS_MEMCPY_H2H;
+    } else if (src->deviceType() == LLAISYS_DEVICE_CPU) {
+        memcpy_kind = LLAISYS_MEMCPY_H2D;
+    } else if (device_type == LLAISYS_DEVICE_CPU) {
+        memcpy_kind = LLAISYS_MEMCPY_D2H;
+    } else {
+        memcpy_kind = LLAISYS_MEMCPY_D2D;
+    }
+
+    // 拷贝在设备一侧的 runtime 上发起
+    if (device_type != LLAISYS_DEVICE_CPU) {
+        core::context().setDevice(device_type, device);
+    } else {
+        core::context().setDevice(src->deviceType(), src->deviceId());
+    }
+    core::context().runtime().api()->memcpy_sync(
+        dst->data(),
+        src->data(),
+        this->numel() * this->elementSize(),
+        memcpy_kind);
+    return dst;
 }
 
 } // namespace llaisys
@@ -1,5 +1,6 @@
 #pragma once
 #include "../core/llaisys_core.hpp"
+#include "../utils/small_vector.hpp"
 
 #include <vector>
 namespace llaisys {
@@ -8,8 +9,8 @@ using tensor_t = std::shared_ptr<Tensor>;
 
 struct TensorMeta {
     llaisysDataType_t dtype;
-    std::vector<size_t> shape;
-    std::vector<ptrdiff_t> strides;
+    shape_t shape;
+    strides_t strides;
 };
 
 class Tensor {
@@ -17,21 +18,35 @@ private:
     TensorMeta _meta;
     core::storage_t _storage;
     size_t _offset;
-    Tensor(TensorMeta meta, core::storage_t storage, size_t offset = 0);
+
+    // 仅供 make 使用的构造标记：构造函数需要对 std::allocate_shared 公开
+    struct Private {};
+    // 从线程局部的对象池分配 Tensor 与其引用计数，创建视图不走全局堆
+    static tensor_t make(TensorMeta meta, core::storage_t storage, size_t offset = 0);
 
 public:
+    Tensor(Private, TensorMeta meta, core::storage_t storage, size_t offset);
+    // row_alignment 非 0 时每行（最后一维）的起始地址按 row_alignment 字节对齐：行间距
+    // （倒数第二维的 stride）补齐到其整数倍，行尾的填充不属于张量，张量因此不再连续
     static tensor_t create(
-        const std::vector<size_t> &shape,
+        const shape_t &shape,
         llaisysDataType_t dtype,
         llaisysDeviceType_t device_type = LLAISYS_DEVICE_CPU,
-        int device = 0);
+        int device = 0,
+        size_t row_alignment = 0);
+    // 以已有 Storage 中 offset 字节处开始的连续内存构造张量，不分配、不拷贝
+    static tensor_t create(
+        const shape_t &shape,
+        llaisysDataType_t dtype,
+        core::storage_t storage,
+        size_t offset = 0);
     ~Tensor() = default;
     // Info
     std::byte *data();
     const std::byte *data() const;
     size_t ndim() const;
-    const std::vector<size_t> &shape() const;
-    const std::vector<ptrdiff_t> &strides() const;
+    const shape_t &shape() const;
+    const strides_t &strides() const;
     llaisysDataType_t dtype() const;
     llaisysDeviceType_t deviceType() const;
     int deviceId() const;
@@ -42,18 +57,21 @@ public:
     void debug() const;
 
     bool isContiguous() const;
+    // 起始地址以及每一行的起始地址都按 alignment 字节对齐，核函数据此选择对齐的快速路径
+    bool isAligned(size_t alignment = 64) const;
 
     // Meta Transform
-    tensor_t permute(const std::vector<size_t> &order) const;
+    tensor_t permute(const shape_t &order) const;
     tensor_t slice(size_t dim, size_t start, size_t end) const;
-    tensor_t view(const std::vector<size_t> &shape) const;
+    tensor_t view(const shape_t &shape) const;
+    tensor_t expand(const shape_t &shape) const;
 
     // Load data from host memory
     void load(const void *src);
 
     // Challenging features
     tensor_t contiguous() const;
-    tensor_t reshape(const std::vector<size_t> &shape) const;
+    tensor_t reshape(const shape_t &shape) const;
     tensor_t to(llaisysDeviceType_t device_type, int device = -1) const;
 };
 
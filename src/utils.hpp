@@ -1,3 +1,5 @@
 #pragma once
 #include "utils/check.hpp"
 #include "utils/types.hpp"
+#include "utils/small_vector.hpp"
+#include "utils/checked_math.hpp"
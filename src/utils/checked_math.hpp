@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace llaisys::utils {
+// 带溢出检查的整数运算，用于校验文件头中不可信的形状与大小：溢出时返回 false，不写 out
+
+inline bool checked_mul(size_t a, size_t b, size_t &out) {
+    if (b != 0 && a > SIZE_MAX / b) {
+        return false;
+    }
+    out = a * b;
+    return true;
+}
+
+// shape 的元素个数
+inline bool checked_numel(const std::vector<size_t> &shape, size_t &out) {
+    size_t numel = 1;
+    for (size_t s : shape) {
+        if (!checked_mul(numel, s, numel)) {
+            return false;
+        }
+    }
+    out = numel;
+    return true;
+}
+} // namespace llaisys::utils
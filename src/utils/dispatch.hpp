@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+namespace llaisys::utils {
+// 把运行时尺寸分派到编译期常量，用于按常见模型维度（如 head_dim = 128）实例化内核：
+// size 等于 Sizes... 中某一个时以 std::integral_constant<size_t, size> 调用 f，
+// 否则以 std::integral_constant<size_t, 0> 调用，约定 0 表示使用运行时尺寸的通用实现。
+//
+//     dispatch_size<64, 128>(head_dim, [&](auto HD) { kernel<T, decltype(HD)::value>(...); });
+template <size_t... Sizes, typename F>
+void dispatch_size(size_t size, F &&f) {
+    bool matched = ((size == Sizes && (f(std::integral_constant<size_t, Sizes>{}), true)) || ...);
+    if (!matched) {
+        f(std::integral_constant<size_t, 0>{});
+    }
+}
+} // namespace llaisys::utils
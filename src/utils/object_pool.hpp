@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace llaisys::utils {
+// 固定大小内存块的线程局部空闲链表。释放的块留在释放线程的链表中供下次分配，
+// 每个线程最多缓存 MAX_CACHED 块，超出或线程退出后直接归还堆
+template <size_t Size>
+class FreeList {
+private:
+    static constexpr size_t MAX_CACHED = 4096;
+
+    struct Node {
+        Node *next;
+    };
+
+    struct List {
+        Node *head = nullptr;
+        size_t count = 0;
+        ~List() {
+            while (head != nullptr) {
+                Node *next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+            destroyed() = true;
+        }
+    };
+
+    static List &local() {
+        thread_local List list;
+        return list;
+    }
+    // 线程退出时局部链表可能先于仍在使用的块析构，之后释放的块直接归还堆
+    static bool &destroyed() {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+public:
+    static constexpr size_t BLOCK_SIZE = Size < sizeof(Node) ? sizeof(Node) : Size;
+
+    static void *allocate() {
+        if (!destroyed()) {
+            List &list = local();
+            if (list.head != nullptr) {
+                Node *node = list.head;
+                list.head = node->next;
+                list.count--;
+                return node;
+            }
+        }
+        return ::operator new(BLOCK_SIZE);
+    }
+
+    static void deallocate(void *p) {
+        if (!destroyed()) {
+            List &list = local();
+            if (list.count < MAX_CACHED) {
+                list.head = new (p) Node{list.head};
+                list.count++;
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+};
+
+// 单个对象从 FreeList 分配的分配器，配合 std::allocate_shared 使对象与控制块共用一块
+// 池化内存：
+//     std::allocate_shared<Tensor>(PoolAllocator<Tensor>(), ...)
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator: over-aligned type");
+        if (n != 1) {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T *>(FreeList<sizeof(T)>::allocate());
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        FreeList<sizeof(T)>::deallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &) const { return false; }
+};
+} // namespace llaisys::utils
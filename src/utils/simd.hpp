@@ -0,0 +1,227 @@
+#pragma once
+// CPU 向量化基础设施：统一的 float 向量类型 VecF，以及 f32/f16/bf16 与 float 之间的
+// 内联加载、存储转换。编译时开启 AVX2 + FMA + F16C 时一个 VecF 为 8 个 float，
+// 否则退化为单个 float，调用方代码无需区分两种情况。
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+#define LLAISYS_SIMD_AVX2 1
+#endif
+
+#if defined(__F16C__)
+// llaisys.h 定义的 __C 宏与内在函数头文件中的形参名冲突，引入时临时取消
+#pragma push_macro("__C")
+#undef __C
+#include <immintrin.h>
+#pragma pop_macro("__C")
+#endif
+
+#include "types.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace llaisys::utils::simd {
+
+// ---------- 标量转换（内联，便于编译器在循环中展开） ----------
+
+inline float to_f32(float v) { return v; }
+
+inline float to_f32(int8_t v) { return static_cast<float>(v); }
+
+inline float to_f32(bf16_t v) {
+    uint32_t bits = static_cast<uint32_t>(v._v) << 16;
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+inline float to_f32(fp8e4m3_t v) { return _f8e4m3_to_f32(v); }
+
+inline float to_f32(fp16_t v) {
+#if defined(__F16C__)
+    return _cvtsh_ss(v._v);
+#else
+    return _f16_to_f32(v);
+#endif
+}
+
+template <typename T>
+inline T from_f32(float v);
+
+template <>
+inline float from_f32<float>(float v) { return v; }
+
+template <>
+inline bf16_t from_f32<bf16_t>(float v) {
+    // 与 _f32_to_bf16 相同：就近舍入到偶数
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return bf16_t{static_cast<uint16_t>(bits >> 16)};
+}
+
+template <>
+inline fp16_t from_f32<fp16_t>(float v) {
+#if defined(__F16C__)
+    return fp16_t{_cvtss_sh(v, _MM_FROUND_TO_NEAREST_INT)};
+#else
+    return _f32_to_f16(v);
+#endif
+}
+
+template <>
+inline fp8e4m3_t from_f32<fp8e4m3_t>(float v) { return _f32_to_f8e4m3(v); }
+
+// 把 f32 值舍入为 dtype（BF16/F16）可表示的最近值，其余类型原样返回
+inline float round_to(llaisysDataType_t dtype, float v) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_BF16:
+        return to_f32(from_f32<bf16_t>(v));
+    case LLAISYS_DTYPE_F16:
+        return to_f32(from_f32<fp16_t>(v));
+    default:
+        return v;
+    }
+}
+
+#if defined(LLAISYS_SIMD_AVX2)
+
+constexpr size_t WIDTH = 8;
+
+struct VecF {
+    __m256 v;
+};
+
+inline VecF set1(float x) { return {_mm256_set1_ps(x)}; }
+
+inline VecF load(const float *p) { return {_mm256_loadu_ps(p)}; }
+
+inline VecF load(const bf16_t *p) {
+    __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    return {_mm256_castsi256_ps(_mm256_slli_epi32(x, 16))};
+}
+
+inline VecF load(const fp16_t *p) {
+    return {_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)))};
+}
+
+// int8 权重在寄存器中反量化（不含 scale）
+inline VecF load(const int8_t *p) {
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+    return {_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(x))};
+}
+
+// fp8 E4M3 解码：左移 8 位后符号位已就位，指数与尾数再右移 1 位即为 f16 的位模式
+// （f16 指数偏置 15，比 E4M3 多 8），用 F16C 转成 f32 后乘 2^8。不区分 NaN
+inline VecF load(const fp8e4m3_t *p) {
+    __m128i x = _mm_slli_epi16(_mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))), 8);
+    __m128i h = _mm_and_si128(_mm_srai_epi16(x, 1), _mm_set1_epi16(static_cast<short>(0xBFFF)));
+    return {_mm256_mul_ps(_mm256_cvtph_ps(h), _mm256_set1_ps(256.0f))};
+}
+
+inline void store(float *p, VecF x) { _mm256_storeu_ps(p, x.v); }
+
+inline void store(bf16_t *p, VecF x) {
+    __m256i bits = _mm256_castps_si256(x.v);
+    __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    bits = _mm256_add_epi32(bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+    bits = _mm256_srli_epi32(bits, 16);
+    // packus 按 128 位通道交错，再把两个 64 位结果排到一起
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(bits, bits), 0xD8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_castsi256_si128(packed));
+}
+
+inline void store(fp16_t *p, VecF x) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_cvtps_ph(x.v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+inline VecF round_to(llaisysDataType_t dtype, VecF x) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_BF16: {
+        __m256i bits = _mm256_castps_si256(x.v);
+        __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+        bits = _mm256_add_epi32(bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+        return {_mm256_castsi256_ps(_mm256_and_si256(bits, _mm256_set1_epi32(static_cast<int>(0xFFFF0000u))))};
+    }
+    case LLAISYS_DTYPE_F16:
+        return {_mm256_cvtph_ps(_mm256_cvtps_ph(x.v, _MM_FROUND_TO_NEAREST_INT))};
+    default:
+        return x;
+    }
+}
+
+inline VecF add(VecF a, VecF b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline VecF sub(VecF a, VecF b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline VecF mul(VecF a, VecF b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline VecF div(VecF a, VecF b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline VecF fmadd(VecF a, VecF b, VecF c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+inline VecF max(VecF a, VecF b) { return {_mm256_max_ps(a.v, b.v)}; }
+
+inline float reduce_add(VecF x) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(x.v), _mm256_extractf128_ps(x.v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+inline float reduce_max(VecF x) {
+    __m128 s = _mm_max_ps(_mm256_castps256_ps128(x.v), _mm256_extractf128_ps(x.v, 1));
+    s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_max_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+// e^x：x = n*ln2 + r，2^n 直接拼到指数位，e^r 用 5 次多项式近似（Cephes expf），
+// 相对误差约 2e-7
+inline VecF exp(VecF x) {
+    const __m256 hi = _mm256_set1_ps(88.3762626647949f);
+    const __m256 lo = _mm256_set1_ps(-88.3762626647949f);
+    __m256 v = _mm256_max_ps(_mm256_min_ps(x.v, hi), lo);
+
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(v, _mm256_set1_ps(1.44269504088896341f)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    v = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), v);
+    v = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), v);
+
+    __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+    p = _mm256_fmadd_ps(p, v, _mm256_set1_ps(1.3981999507e-3f));
+    p = _mm256_fmadd_ps(p, v, _mm256_set1_ps(8.3334519073e-3f));
+    p = _mm256_fmadd_ps(p, v, _mm256_set1_ps(4.1665795894e-2f));
+    p = _mm256_fmadd_ps(p, v, _mm256_set1_ps(1.6666665459e-1f));
+    p = _mm256_fmadd_ps(p, v, _mm256_set1_ps(5.0000001201e-1f));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(v, v), _mm256_add_ps(v, _mm256_set1_ps(1.0f)));
+
+    __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return {_mm256_mul_ps(p, _mm256_castsi256_ps(e))};
+}
+
+#else
+
+constexpr size_t WIDTH = 1;
+
+struct VecF {
+    float v;
+};
+
+inline VecF set1(float x) { return {x}; }
+
+template <typename T>
+inline VecF load(const T *p) { return {to_f32(*p)}; }
+
+template <typename T>
+inline void store(T *p, VecF x) { *p = from_f32<T>(x.v); }
+
+inline VecF round_to(llaisysDataType_t dtype, VecF x) { return {round_to(dtype, x.v)}; }
+
+inline VecF add(VecF a, VecF b) { return {a.v + b.v}; }
+inline VecF sub(VecF a, VecF b) { return {a.v - b.v}; }
+inline VecF mul(VecF a, VecF b) { return {a.v * b.v}; }
+inline VecF div(VecF a, VecF b) { return {a.v / b.v}; }
+inline VecF fmadd(VecF a, VecF b, VecF c) { return {a.v * b.v + c.v}; }
+inline VecF max(VecF a, VecF b) { return {a.v > b.v ? a.v : b.v}; }
+inline float reduce_add(VecF x) { return x.v; }
+inline float reduce_max(VecF x) { return x.v; }
+inline VecF exp(VecF x) { return {std::exp(x.v)}; }
+
+#endif
+
+} // namespace llaisys::utils::simd
@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace llaisys::utils {
+// 元素不超过 N 个时存放在对象内部、不在堆上分配的 vector，用于张量的形状与 strides。
+// 只支持可平凡拷贝的元素类型；可以与 std::vector<T> 相互转换
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable types");
+
+private:
+    T *_heap = nullptr; // 超过 N 个元素时的堆内存，否则为空
+    size_t _size = 0;
+    size_t _capacity = N;
+    T _inline[N];
+
+    void grow(size_t capacity) {
+        if (capacity <= _capacity) {
+            return;
+        }
+        capacity = std::max(capacity, _capacity * 2);
+        T *heap = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        std::memcpy(heap, data(), _size * sizeof(T));
+        ::operator delete(_heap);
+        _heap = heap;
+        _capacity = capacity;
+    }
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+    explicit SmallVector(size_t n, const T &value = T()) {
+        resize(n, value);
+    }
+    SmallVector(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+    }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    SmallVector(It first, It last) {
+        assign(first, last);
+    }
+    SmallVector(const std::vector<T> &other) {
+        assign(other.begin(), other.end());
+    }
+    SmallVector(const SmallVector &other) {
+        assign(other.begin(), other.end());
+    }
+    SmallVector(SmallVector &&other) noexcept {
+        *this = std::move(other);
+    }
+    ~SmallVector() {
+        ::operator delete(_heap);
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+    SmallVector &operator=(SmallVector &&other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        if (other._heap != nullptr) {
+            // 接管对方的堆内存
+            ::operator delete(_heap);
+            _heap = other._heap;
+            _capacity = other._capacity;
+            other._heap = nullptr;
+            other._capacity = N;
+        } else {
+            ::operator delete(_heap);
+            _heap = nullptr;
+            _capacity = N;
+            std::memcpy(_inline, other._inline, other._size * sizeof(T));
+        }
+        _size = other._size;
+        other._size = 0;
+        return *this;
+    }
+
+    operator std::vector<T>() const {
+        return std::vector<T>(begin(), end());
+    }
+
+    void assign(size_t n, const T &value) {
+        _size = 0;
+        resize(n, value);
+    }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    void assign(It first, It last) {
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        _size = 0;
+        grow(n);
+        std::copy(first, last, data());
+        _size = n;
+    }
+
+    T *data() { return _heap != nullptr ? _heap : _inline; }
+    const T *data() const { return _heap != nullptr ? _heap : _inline; }
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+
+    T &operator[](size_t i) { return data()[i]; }
+    const T &operator[](size_t i) const { return data()[i]; }
+    T &front() { return data()[0]; }
+    const T &front() const { return data()[0]; }
+    T &back() { return data()[_size - 1]; }
+    const T &back() const { return data()[_size - 1]; }
+
+    T *begin() { return data(); }
+    T *end() { return data() + _size; }
+    const T *begin() const { return data(); }
+    const T *end() const { return data() + _size; }
+
+    void reserve(size_t capacity) { grow(capacity); }
+    void resize(size_t n, const T &value = T()) {
+        grow(n);
+        if (n > _size) {
+            std::fill(data() + _size, data() + n, value);
+        }
+        _size = n;
+    }
+    void clear() { _size = 0; }
+    void push_back(const T &value) {
+        // value 可能引用本容器中的元素，先拷贝再扩容
+        T copy = value;
+        grow(_size + 1);
+        data()[_size++] = copy;
+    }
+    void pop_back() { _size--; }
+    T *insert(const T *pos, const T &value) {
+        size_t i = static_cast<size_t>(pos - data());
+        T copy = value;
+        grow(_size + 1);
+        std::memmove(data() + i + 1, data() + i, (_size - i) * sizeof(T));
+        data()[i] = copy;
+        _size++;
+        return data() + i;
+    }
+    T *erase(const T *pos) {
+        size_t i = static_cast<size_t>(pos - data());
+        std::memmove(data() + i, data() + i + 1, (_size - i - 1) * sizeof(T));
+        _size--;
+        return data() + i;
+    }
+
+    friend bool operator==(const SmallVector &a, const SmallVector &b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVector &a, const SmallVector &b) {
+        return !(a == b);
+    }
+};
+} // namespace llaisys::utils
+
+namespace llaisys {
+// 张量的形状与 strides：8 维以内内联存储，创建视图时不分配内存
+constexpr size_t MAX_INLINE_DIMS = 8;
+using shape_t = utils::SmallVector<size_t, MAX_INLINE_DIMS>;
+using strides_t = utils::SmallVector<ptrdiff_t, MAX_INLINE_DIMS>;
+} // namespace llaisys
@@ -1,6 +1,9 @@
 #include "types.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
 
 namespace llaisys::utils {
 float _f16_to_f32(fp16_t val) {
@@ -82,4 +85,28 @@ bf16_t _f32_to_bf16(float val) {
 
     return bf16_t{bf16_bits};
 }
+
+float _f8e4m3_to_f32(fp8e4m3_t val) {
+    // 指数与尾数整体左移 20 位后，按 f32 解释的值恰为原值的 2^-120（非规格数同样成立）
+    uint32_t bits = (static_cast<uint32_t>(val._v & 0x7F) << 20) | (static_cast<uint32_t>(val._v & 0x80) << 24);
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    if ((val._v & 0x7F) == 0x7F) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    return out * 0x1p120f;
+}
+
+fp8e4m3_t _f32_to_f8e4m3(float val) {
+    if (std::isnan(val)) {
+        return fp8e4m3_t{0x7F};
+    }
+    uint8_t sign = std::signbit(val) ? 0x80 : 0x00;
+    // 缩放 2^-120 后尾数的高 3 位即 E4M3 的尾数，在第 20 位上就近舍入到偶数
+    float a = std::min(std::fabs(val), 448.0f) * 0x1p-120f;
+    uint32_t bits;
+    std::memcpy(&bits, &a, sizeof(bits));
+    bits += 0x7FFFF + ((bits >> 20) & 1);
+    return fp8e4m3_t{static_cast<uint8_t>(sign | std::min<uint32_t>(bits >> 20, 0x7E))};
+}
 } // namespace llaisys::utils
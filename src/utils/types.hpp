@@ -1,3 +1,4 @@
+#pragma once
 #include "llaisys.h"
 
 #include <iostream>
@@ -14,6 +15,13 @@ struct CustomBFloat16 {
 };
 typedef struct CustomBFloat16 bf16_t;
 
+// LLAISYS_DTYPE_F8 的存储格式：E4M3（1 位符号、4 位指数、3 位尾数，偏置 7），
+// 没有无穷大，0x7F/0xFF 为 NaN，最大有限值 448
+struct CustomFloat8E4M3 {
+    uint8_t _v;
+};
+typedef struct CustomFloat8E4M3 fp8e4m3_t;
+
 namespace utils {
 inline size_t dsize(llaisysDataType_t dtype) {
     switch (dtype) {
@@ -113,6 +121,10 @@ fp16_t _f32_to_f16(float val);
 float _bf16_to_f32(bf16_t val);
 bf16_t _f32_to_bf16(float val);
 
+float _f8e4m3_to_f32(fp8e4m3_t val);
+// 就近舍入到偶数，超出范围的值饱和到 ±448
+fp8e4m3_t _f32_to_f8e4m3(float val);
+
 template <typename TypeTo, typename TypeFrom>
 TypeTo cast(TypeFrom val) {
     if constexpr (std::is_same<TypeTo, TypeFrom>::value) {
@@ -133,6 +145,10 @@ TypeTo cast(TypeFrom val) {
         return _bf16_to_f32(val);
     } else if constexpr (std::is_same<TypeFrom, bf16_t>::value && !std::is_same<TypeTo, float>::value) {
         return static_cast<TypeTo>(_bf16_to_f32(val));
+    } else if constexpr (std::is_same<TypeTo, fp8e4m3_t>::value) {
+        return _f32_to_f8e4m3(static_cast<float>(val));
+    } else if constexpr (std::is_same<TypeFrom, fp8e4m3_t>::value) {
+        return static_cast<TypeTo>(_f8e4m3_to_f32(val));
     } else {
         return static_cast<TypeTo>(val);
     }
@@ -0,0 +1,69 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_tensor, check_equal, benchmark
+
+
+def torch_cast(out, inp):
+    out.copy_(inp.to(out.dtype))
+
+
+def test_op_cast(
+    shape,
+    in_dtype_name="bf16",
+    out_dtype_name="f32",
+    transpose=False,
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   shape {shape} <{in_dtype_name}> -> <{out_dtype_name}> transpose {transpose}")
+    inp, inp_ = random_tensor(shape, in_dtype_name, device_name, scale=100.0, bias=-50.0)
+    out_shape = shape
+    if transpose:
+        inp, inp_ = inp.t(), inp_.permute(1, 0)
+        out_shape = (shape[1], shape[0])
+
+    out, out_ = random_tensor(out_shape, out_dtype_name, device_name)
+    torch_cast(out, inp)
+    llaisys.Ops.cast(out_, inp_)
+
+    # 转换结果应与 PyTorch 的就近舍入逐位一致
+    assert check_equal(out_, out, atol=0, rtol=0)
+
+    if profile:
+        benchmark(
+            lambda: torch_cast(out, inp),
+            lambda: llaisys.Ops.cast(out_, inp_),
+            device_name,
+        )
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testShapes = [(2, 3), (512, 4096)]
+    testDtypePairs = [
+        # in, out
+        ("bf16", "f32"),
+        ("f16", "f32"),
+        ("f32", "bf16"),
+        ("f32", "f16"),
+        ("bf16", "f16"),
+        ("f16", "bf16"),
+    ]
+    print(f"Testing Ops.cast on {args.device}")
+    for shape in testShapes:
+        for in_dtype_name, out_dtype_name in testDtypePairs:
+            test_op_cast(shape, in_dtype_name, out_dtype_name, False, args.device, args.profile)
+    for in_dtype_name, out_dtype_name in testDtypePairs:
+        test_op_cast((64, 100), in_dtype_name, out_dtype_name, True, args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
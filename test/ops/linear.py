@@ -5,7 +5,7 @@ parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
 sys.path.insert(0, parent_dir)
 import llaisys
 import torch
-from test_utils import random_tensor, check_equal, benchmark
+from test_utils import random_tensor, check_equal, benchmark, llaisys_device
 
 
 def torch_linear(out, x, w, bias):
@@ -45,6 +45,202 @@ def test_op_linear(
         )
 
 
+def test_op_linear_mixed(
+    out_shape,
+    x_shape,
+    w_shape,
+    w_dtype_name="bf16",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+):
+    # f32 activations with low-precision weights
+    print(f"   out {out_shape}, x {x_shape}, w {w_shape}, dtype <f32> weight <{w_dtype_name}>")
+    x, x_ = random_tensor(x_shape, "f32", device_name, scale=0.1)
+    w, w_ = random_tensor(w_shape, w_dtype_name, device_name, scale=0.01)
+    bias, bias_ = random_tensor((w_shape[0],), "f32", device_name)
+
+    out, out_ = random_tensor(out_shape, "f32", device_name)
+    torch_linear(out, x, w.float(), bias)
+    llaisys.Ops.linear(out_, x_, w_, bias_)
+
+    assert check_equal(out_, out, atol=atol, rtol=rtol)
+
+
+def test_op_linear_int8(
+    out_shape,
+    x_shape,
+    w_shape,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    # Per-channel int8 weights: compare against PyTorch with the same quantization
+    # and report the error relative to the f32 weights
+    print(f"   out {out_shape}, x {x_shape}, w {w_shape}, dtype <{dtype_name}> weight <i8>")
+    x, x_ = random_tensor(x_shape, dtype_name, device_name, scale=0.1)
+    w, w_ = random_tensor(w_shape, "f32", device_name, scale=0.02, bias=-0.01)
+    bias, bias_ = random_tensor((w_shape[0],), dtype_name, device_name)
+
+    q_ = llaisys.Tensor(w_shape, dtype=llaisys.DataType.I8, device=llaisys_device(device_name))
+    scale_ = llaisys.Tensor((w_shape[0],), dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+    llaisys.Ops.quantize_int8(q_, scale_, w_)
+
+    scale = w.abs().amax(dim=1) / 127
+    w_deq = torch.round(w / scale[:, None]).clamp(-127, 127) * scale[:, None]
+
+    out, out_ = random_tensor(out_shape, dtype_name, device_name)
+    out.copy_(torch.nn.functional.linear(x.float(), w_deq, bias.float()))
+    llaisys.Ops.linear_int8(out_, x_, q_, scale_, bias_)
+
+    assert check_equal(out_, out, atol=atol, rtol=rtol)
+
+    ref = torch.nn.functional.linear(x.float(), w, bias.float())
+    ref_bf16 = torch.nn.functional.linear(x.float(), w.bfloat16().float(), bias.float())
+    err_int8 = ((out.float() - ref).norm() / ref.norm()).item()
+    err_bf16 = ((ref_bf16 - ref).norm() / ref.norm()).item()
+    print(f"      relative error vs f32 weights: int8 {err_int8:.2e}, bf16 {err_bf16:.2e}")
+    assert err_int8 < 1e-2
+
+    if profile:
+        w_bf16, w_bf16_ = random_tensor(w_shape, dtype_name, device_name)
+        benchmark(
+            lambda: llaisys.Ops.linear(out_, x_, w_bf16_, bias_),
+            lambda: llaisys.Ops.linear_int8(out_, x_, q_, scale_, bias_),
+            device_name,
+        )
+
+
+def test_op_linear_w8a8(
+    out_shape,
+    x_shape,
+    w_shape,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    # W8A8: activations quantized per token on the fly, compared against PyTorch
+    # with the same quantization; the output is then treated as logits and
+    # checked against f32 weights and activations (KL divergence, top-1 agreement)
+    print(f"   out {out_shape}, x {x_shape}, w {w_shape}, dtype <{dtype_name}> compute <i8>")
+    x, x_ = random_tensor(x_shape, dtype_name, device_name, scale=2.0, bias=-1.0)
+    w, w_ = random_tensor(w_shape, "f32", device_name, scale=0.2, bias=-0.1)
+    bias, bias_ = random_tensor((w_shape[0],), dtype_name, device_name, scale=0.1)
+
+    device = llaisys_device(device_name)
+    q_ = llaisys.Tensor(w_shape, dtype=llaisys.DataType.I8, device=device)
+    scale_ = llaisys.Tensor((w_shape[0],), dtype=llaisys.DataType.F32, device=device)
+    llaisys.Ops.quantize_int8(q_, scale_, w_)
+
+    w_scale = w.abs().amax(dim=1) / 127
+    w_q = torch.round(w / w_scale[:, None]).clamp(-127, 127)
+    xf = x.float()
+    x_amax = xf.abs().amax(dim=1)
+    x_q = torch.round(xf * (127 / x_amax)[:, None]).clamp(-127, 127)
+    x_scale = x_amax / 127
+
+    out, out_ = random_tensor(out_shape, dtype_name, device_name)
+    dot = (x_q.double() @ w_q.double().T).float()
+    out.copy_(dot * x_scale[:, None] * w_scale[None, :] + bias.float())
+
+    llaisys.Ops.set_precision(llaisys.OpType.LINEAR, compute=llaisys.DataType.I8)
+    try:
+        llaisys.Ops.linear_int8(out_, x_, q_, scale_, bias_)
+    finally:
+        llaisys.Ops.set_precision(llaisys.OpType.LINEAR)
+
+    assert check_equal(out_, out, atol=atol, rtol=rtol)
+
+    ref = torch.nn.functional.linear(xf, w, bias.float())
+    log_p = torch.log_softmax(ref, dim=-1)
+    log_q = torch.log_softmax(out.float(), dim=-1)
+    kl = (log_p.exp() * (log_p - log_q)).sum(dim=-1).mean().item()
+    top1 = (ref.argmax(dim=-1) == out.float().argmax(dim=-1)).float().mean().item()
+    print(f"      vs f32: KL {kl:.2e}, top-1 agreement {top1:.3f}")
+    assert kl < 1e-2
+    if x_shape[0] >= 64:
+        # With few rows a single mismatch falls below the threshold
+        assert top1 >= 0.9
+
+    if profile:
+        w_float, w_float_ = random_tensor(w_shape, dtype_name, device_name)
+        llaisys.Ops.set_precision(llaisys.OpType.LINEAR, compute=llaisys.DataType.I8)
+        try:
+            benchmark(
+                lambda: llaisys.Ops.linear(out_, x_, w_float_, bias_),
+                lambda: llaisys.Ops.linear_int8(out_, x_, q_, scale_, bias_),
+                device_name,
+            )
+        finally:
+            llaisys.Ops.set_precision(llaisys.OpType.LINEAR)
+
+
+def dequantize_int4(w, group_size):
+    # Same asymmetric group quantization as Ops.quantize_int4, returned dequantized
+    out_features, in_features = w.shape
+    wg = w.reshape(out_features, in_features // group_size, group_size)
+    lo = wg.amin(-1).clamp(max=0)
+    hi = wg.amax(-1).clamp(min=0)
+    scale = (hi - lo) / 15
+    safe = torch.where(scale > 0, scale, torch.ones_like(scale))
+    zero = torch.where(scale > 0, torch.round(-lo / safe).clamp(0, 15), torch.zeros_like(scale))
+    q = (torch.round(wg / safe[..., None]) + zero[..., None]).clamp(0, 15)
+    q = torch.where(scale[..., None] > 0, q, torch.zeros_like(q))
+    return ((q - zero[..., None]) * scale[..., None]).reshape(out_features, in_features)
+
+
+def test_op_linear_int4(
+    out_shape,
+    x_shape,
+    w_shape,
+    group_size,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    # 4-bit group-quantized weights: compare against PyTorch with the same
+    # quantization and report the error relative to the f32 weights
+    print(
+        f"   out {out_shape}, x {x_shape}, w {w_shape}, dtype <{dtype_name}> weight <int4, group {group_size}>"
+    )
+    x, x_ = random_tensor(x_shape, dtype_name, device_name, scale=0.1)
+    w, w_ = random_tensor(w_shape, "f32", device_name, scale=0.02, bias=-0.01)
+    bias, bias_ = random_tensor((w_shape[0],), dtype_name, device_name)
+
+    out_features, in_features = w_shape
+    device = llaisys_device(device_name)
+    q_ = llaisys.Tensor((out_features, in_features // 2), dtype=llaisys.DataType.U8, device=device)
+    groups = (out_features, in_features // group_size)
+    scales_ = llaisys.Tensor(groups, dtype=llaisys.DataType.F32, device=device)
+    zeros_ = llaisys.Tensor(groups, dtype=llaisys.DataType.U8, device=device)
+    llaisys.Ops.quantize_int4(q_, scales_, zeros_, w_)
+
+    out, out_ = random_tensor(out_shape, dtype_name, device_name)
+    out.copy_(torch.nn.functional.linear(x.float(), dequantize_int4(w, group_size), bias.float()))
+    llaisys.Ops.linear_int4(out_, x_, q_, scales_, zeros_, bias_)
+
+    assert check_equal(out_, out, atol=atol, rtol=rtol)
+
+    ref = torch.nn.functional.linear(x.float(), w, bias.float())
+    err_int4 = ((out.float() - ref).norm() / ref.norm()).item()
+    print(f"      relative error vs f32 weights: int4 {err_int4:.2e}")
+    assert err_int4 < 5e-2
+
+    if profile:
+        w_bf16, w_bf16_ = random_tensor(w_shape, dtype_name, device_name)
+        benchmark(
+            lambda: llaisys.Ops.linear(out_, x_, w_bf16_, bias_),
+            lambda: llaisys.Ops.linear_int4(out_, x_, q_, scales_, zeros_, bias_),
+            device_name,
+        )
+
+
 if __name__ == "__main__":
     import argparse
 
@@ -66,5 +262,44 @@ if __name__ == "__main__":
     for shapes in testShapes:
         for dtype_name, atol, rtol in testDtypePrec:
             test_op_linear(*shapes, dtype_name, atol, rtol, args.device, args.profile)
+    for shapes in testShapes:
+        for w_dtype_name in ["f16", "bf16"]:
+            test_op_linear_mixed(*shapes[:3], w_dtype_name, 1e-5, 1e-5, args.device)
+    # f64 accumulation runs the scalar reference kernel, so keep the shapes small
+    print(f"Testing Ops.linear with f64 accumulation on {args.device}")
+    llaisys.Ops.set_precision(llaisys.OpType.LINEAR, llaisys.DataType.F32, llaisys.DataType.F64)
+    for shapes in [testShapes[0], ((64, 1536), (64, 1536), (1536, 1536), True)]:
+        for dtype_name, atol, rtol in testDtypePrec:
+            test_op_linear(*shapes, dtype_name, atol, rtol, args.device)
+    llaisys.Ops.set_precision(llaisys.OpType.LINEAR)
+    print(f"Testing Ops.linear_int8 on {args.device}")
+    for shapes in testShapes + [((1, 4096), (1, 4096), (4096, 4096), True)]:
+        for dtype_name, atol, rtol in testDtypePrec:
+            test_op_linear_int8(*shapes[:3], dtype_name, atol, rtol, args.device, args.profile)
+    print(f"Testing Ops.linear_int8 with int8 activations (W8A8) on {args.device}")
+    w8a8Shapes = [
+        ((2, 3), (2, 100), (3, 100)),
+        ((64, 4096), (64, 1536), (4096, 1536)),
+        ((512, 1536), (512, 1536), (1536, 1536)),
+    ]
+    for shapes in w8a8Shapes:
+        for dtype_name, atol, rtol in testDtypePrec:
+            test_op_linear_w8a8(*shapes, dtype_name, max(atol, 1e-4), max(rtol, 1e-4), args.device, args.profile)
+    print(f"Testing Ops.linear_int4 on {args.device}")
+    int4Shapes = [
+        ((2, 3), (2, 128), (3, 128)),
+        ((512, 4096), (512, 4096), (4096, 4096)),
+        ((1, 4096), (1, 4096), (4096, 4096)),
+    ]
+    int4DtypePrec = [
+        # type, atol, rtol
+        ("f32", 1e-4, 1e-4),
+        ("f16", 1e-3, 1e-3),
+        ("bf16", 1e-2, 1e-2),
+    ]
+    for shapes in int4Shapes:
+        for group_size in [32, 64, 128]:
+            for dtype_name, atol, rtol in int4DtypePrec:
+                test_op_linear_int4(*shapes, group_size, dtype_name, atol, rtol, args.device, args.profile)
 
     print("\033[92mTest passed!\033[0m\n")
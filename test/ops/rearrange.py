@@ -0,0 +1,77 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_tensor, check_equal, benchmark
+
+
+def torch_rearrange(out, inp):
+    out.copy_(inp)
+
+
+def test_op_rearrange(
+    shape,
+    perm,
+    dtype_name="f32",
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   shape {shape} perm {perm} dtype <{dtype_name}>")
+    inp, inp_ = random_tensor(shape, dtype_name, device_name)
+    inp, inp_ = inp.permute(*perm), inp_.permute(*perm)
+
+    out_shape = tuple(shape[p] for p in perm)
+    out, out_ = random_tensor(out_shape, dtype_name, device_name)
+    torch_rearrange(out, inp)
+    llaisys.Ops.rearrange(out_, inp_)
+
+    assert check_equal(out_, out, atol=0, rtol=0)
+
+    if profile:
+        benchmark(
+            lambda: torch_rearrange(out, inp),
+            lambda: llaisys.Ops.rearrange(out_, inp_),
+            device_name,
+        )
+
+
+def test_op_rearrange_sliced(
+    shape,
+    dtype_name="f32",
+    device_name="cpu",
+):
+    print(f"   shape {shape} dtype <{dtype_name}> (sliced input, contiguous())")
+    inp, inp_ = random_tensor((shape[0], shape[1] + 4), dtype_name, device_name)
+    inp, inp_ = inp[:, 2 : shape[1] + 2], inp_.slice(1, 2, shape[1] + 2)
+
+    out_ = inp_.contiguous()
+    assert out_.is_contiguous()
+    assert check_equal(out_, inp.contiguous(), atol=0, rtol=0)
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testShapes = [
+        # shape, perm
+        ((2, 3), (1, 0)),
+        ((512, 4096), (1, 0)),
+        ((128, 12, 64), (1, 0, 2)),
+        ((4, 16, 8, 32), (0, 2, 1, 3)),
+    ]
+    testDtypes = ["f32", "f16", "bf16"]
+    print(f"Testing Ops.rearrange on {args.device}")
+    for shape, perm in testShapes:
+        for dtype_name in testDtypes:
+            test_op_rearrange(shape, perm, dtype_name, args.device, args.profile)
+    for dtype_name in testDtypes:
+        test_op_rearrange_sliced((64, 100), dtype_name, args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
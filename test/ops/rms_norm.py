@@ -5,7 +5,7 @@ parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
 sys.path.insert(0, parent_dir)
 import llaisys
 import torch
-from test_utils import random_tensor, check_equal, benchmark
+from test_utils import random_tensor, check_equal, benchmark, llaisys_dtype
 
 
 def torch_rms_norm(ans, x, w, eps):
@@ -51,7 +51,7 @@ if __name__ == "__main__":
     parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
     parser.add_argument("--profile", action="store_true")
     args = parser.parse_args()
-    testShapes = [(1, 4), (512, 4096)]
+    testShapes = [(1, 4), (7, 1536), (512, 4096)]
     testDtypePrec = [
         # type, atol, rtol
         ("f32", 1e-5, 1e-5),
@@ -63,4 +63,26 @@ if __name__ == "__main__":
         for dtype_name, atol, rtol in testDtypePrec:
             test_op_rms_norm(shape, dtype_name, atol, rtol, args.device, args.profile)
 
+    # Rounding every intermediate to the storage type reproduces PyTorch's
+    # result bit for bit. This relies on torch >= 2.1 computing a half/bfloat16
+    # mean on CPU as an fp32 sum and divide rounded once; the remaining
+    # difference, the order of the fp32 sum, was measured to vanish in that rounding.
+    print(f"Testing Ops.rms_norm parity precision on {args.device}")
+    for shape in testShapes:
+        for dtype_name in ["f16", "bf16"]:
+            llaisys.Ops.set_precision(llaisys.OpType.RMS_NORM, llaisys_dtype(dtype_name))
+            test_op_rms_norm(shape, dtype_name, 0, 0, args.device)
+    llaisys.Ops.set_precision(llaisys.OpType.RMS_NORM)
+
+    # f64 accumulation, with and without per-step rounding
+    print(f"Testing Ops.rms_norm with f64 accumulation on {args.device}")
+    for shape in testShapes:
+        for dtype_name, atol, rtol in testDtypePrec:
+            for compute in sorted({"f32", dtype_name}):
+                llaisys.Ops.set_precision(
+                    llaisys.OpType.RMS_NORM, llaisys_dtype(compute), llaisys.DataType.F64
+                )
+                test_op_rms_norm(shape, dtype_name, atol, rtol, args.device)
+    llaisys.Ops.set_precision(llaisys.OpType.RMS_NORM)
+
     print("\033[92mTest passed!\033[0m\n")
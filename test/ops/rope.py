@@ -68,6 +68,7 @@ if __name__ == "__main__":
     args = parser.parse_args()
     testShapes = [
         ((2, 1, 4), (0, 2)), 
+        ((16, 12, 128), (100, 116)),
         ((512, 4, 4096), (512, 1024))]
     testDtypePrec = [
         # type, atol, rtol
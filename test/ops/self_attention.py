@@ -5,7 +5,7 @@ parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
 sys.path.insert(0, parent_dir)
 import llaisys
 import torch
-from test_utils import random_tensor, check_equal, benchmark
+from test_utils import random_tensor, check_equal, benchmark, llaisys_dtype
 
 
 def torch_self_attention(attn_val, query, key, value, scale):
@@ -61,6 +61,106 @@ def test_op_self_attention(
         )
 
 
+def test_op_self_attention_fused_qkv(
+    qlen,
+    kvlen,
+    nh,
+    nkvh,
+    hd,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+):
+    print(
+        f"   qlen={qlen} kvlen={kvlen} nh={nh} nkvh={nkvh} hd={hd} dtype <{dtype_name}> (views of fused qkv)"
+    )
+    # q, k and v are strided views into one [kvlen, nh + 2 * nkvh, hd] buffer
+    qkv, qkv_ = random_tensor((kvlen, nh + 2 * nkvh, hd), dtype_name, device_name)
+    q = qkv[kvlen - qlen :, :nh]
+    k = qkv[:, nh : nh + nkvh]
+    v = qkv[:, nh + nkvh :]
+    q_ = qkv_.slice(0, kvlen - qlen, kvlen).slice(1, 0, nh)
+    k_ = qkv_.slice(1, nh, nh + nkvh)
+    v_ = qkv_.slice(1, nh + nkvh, nh + 2 * nkvh)
+    scale = 1.0 / (hd**0.5)
+
+    attn_val, attn_val_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    torch_self_attention(attn_val, q, k, v, scale)
+    llaisys.Ops.self_attention(attn_val_, q_, k_, v_, scale)
+    assert check_equal(attn_val_, attn_val, atol=atol, rtol=rtol)
+
+
+def torch_quantize_kv(x, kv_dtype_name):
+    # per-token, per-head symmetric quantization, dequantized back to f32
+    qmax = 127.0 if kv_dtype_name == "i8" else 448.0
+    x = x.float()
+    amax = x.abs().amax(dim=-1, keepdim=True)
+    inv = torch.where(amax > 0, qmax / amax, torch.zeros_like(amax))
+    if kv_dtype_name == "i8":
+        q = (x * inv).round().clamp(-127, 127)
+    else:
+        q = (x * inv).to(torch.float8_e4m3fn).float()
+    return q * (amax / qmax)
+
+
+def test_op_self_attention_quant_kv(
+    qlen,
+    kvlen,
+    nh,
+    nkvh,
+    hd,
+    kv_dtype_name,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    print(
+        f"   qlen={qlen} kvlen={kvlen} nh={nh} nkvh={nkvh} hd={hd} dtype <{dtype_name}> kv cache <{kv_dtype_name}>"
+    )
+    q, q_ = random_tensor((qlen, nh, hd), dtype_name, device_name, scale=2.0, bias=-1.0)
+    k, k_ = random_tensor((kvlen, nkvh, hd), dtype_name, device_name, scale=2.0, bias=-1.0)
+    v, v_ = random_tensor((kvlen, nkvh, hd), dtype_name, device_name, scale=2.0, bias=-1.0)
+    scale = 1.0 / (hd**0.5)
+
+    # the cache has room for more tokens than are filled; attention reads a slice of it
+    capacity = kvlen + 3
+    kv_dtype = llaisys_dtype(kv_dtype_name)
+    k_cache = llaisys.Tensor((capacity, nkvh, hd), dtype=kv_dtype, device=q_.device_type())
+    v_cache = llaisys.Tensor((capacity, nkvh, hd), dtype=kv_dtype, device=q_.device_type())
+    k_scale = llaisys.Tensor((capacity, nkvh), dtype=llaisys.DataType.F32, device=q_.device_type())
+    v_scale = llaisys.Tensor((capacity, nkvh), dtype=llaisys.DataType.F32, device=q_.device_type())
+    # write the prompt and the last token separately, as prefill and decode would
+    for begin, end in ((0, kvlen - 1), (kvlen - 1, kvlen)):
+        if end > begin:
+            llaisys.Ops.quantize_kv(
+                k_cache.slice(0, begin, end), k_scale.slice(0, begin, end), k_.slice(0, begin, end)
+            )
+            llaisys.Ops.quantize_kv(
+                v_cache.slice(0, begin, end), v_scale.slice(0, begin, end), v_.slice(0, begin, end)
+            )
+    k_cache, v_cache = k_cache.slice(0, 0, kvlen), v_cache.slice(0, 0, kvlen)
+    k_scale, v_scale = k_scale.slice(0, 0, kvlen), v_scale.slice(0, 0, kvlen)
+
+    attn_val, attn_val_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    k_deq = torch_quantize_kv(k, kv_dtype_name).to(k.dtype)
+    v_deq = torch_quantize_kv(v, kv_dtype_name).to(v.dtype)
+    torch_self_attention(attn_val, q, k_deq, v_deq, scale)
+    llaisys.Ops.self_attention_quant_kv(attn_val_, q_, k_cache, v_cache, k_scale, v_scale, scale)
+    assert check_equal(attn_val_, attn_val, atol=atol, rtol=rtol)
+
+    if profile:
+        benchmark(
+            lambda: torch_self_attention(attn_val, q, k, v, scale),
+            lambda: llaisys.Ops.self_attention_quant_kv(
+                attn_val_, q_, k_cache, v_cache, k_scale, v_scale, scale
+            ),
+            device_name,
+        )
+
+
 if __name__ == "__main__":
     import argparse
 
@@ -72,6 +172,7 @@ if __name__ == "__main__":
         # qlen, kvlen, nh, nkvh, hd
         (2, 2, 1, 1, 4),
         (5, 11, 4, 2, 8),
+        (4, 37, 12, 2, 128),
     ]
     testDtypePrec = [
         # type, atol, rtol
@@ -85,5 +186,33 @@ if __name__ == "__main__":
             test_op_self_attention(
                 *shape, dtype_name, atol, rtol, args.device, args.profile
             )
+            test_op_self_attention_fused_qkv(
+                *shape, dtype_name, atol, rtol, args.device
+            )
+
+    # Precision policies: f64 accumulation, and rounding each step to the
+    # storage type. PyTorch's matmuls accumulate in a different order, so the
+    # result is not bit-identical and is held to the default tolerances.
+    print(f"Testing Ops.self_attention precision policies on {args.device}")
+    for shape in testShapes:
+        for dtype_name, atol, rtol in testDtypePrec:
+            # (f32, f32) is the default policy tested above
+            policies = {("f32", "f64"), (dtype_name, "f32"), (dtype_name, "f64")} - {("f32", "f32")}
+            for compute, accumulate in sorted(policies):
+                llaisys.Ops.set_precision(
+                    llaisys.OpType.SELF_ATTENTION, llaisys_dtype(compute), llaisys_dtype(accumulate)
+                )
+                test_op_self_attention(*shape, dtype_name, atol, rtol, args.device)
+    llaisys.Ops.set_precision(llaisys.OpType.SELF_ATTENTION)
+
+    # quantized KV cache: compared against attention over the dequantized cache
+    # (rounding boundaries may differ by one level, hence the looser tolerance)
+    print(f"Testing Ops.self_attention with a quantized KV cache on {args.device}")
+    for shape in testShapes:
+        for kv_dtype_name in ["i8", "f8"]:
+            for dtype_name, atol, rtol in [("f32", 2e-2, 2e-2), ("bf16", 3e-2, 3e-2)]:
+                test_op_self_attention_quant_kv(
+                    *shape, kv_dtype_name, dtype_name, atol, rtol, args.device, args.profile
+                )
 
     print("\033[92mTest passed!\033[0m\n")
@@ -5,7 +5,7 @@ parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
 sys.path.insert(0, parent_dir)
 import llaisys
 import torch
-from test_utils import random_tensor, check_equal, benchmark
+from test_utils import random_tensor, check_equal, benchmark, llaisys_dtype
 
 
 def torch_swiglu(out, gate, up):
@@ -57,4 +57,14 @@ if __name__ == "__main__":
         for dtype_name, atol, rtol in testDtypePrec:
             test_op_swiglu(shape, dtype_name, atol, rtol, args.device, args.profile)
 
+    # Rounding every intermediate to the storage type reproduces PyTorch's
+    # result bit for bit: exp is evaluated in fp32 and a one-ulp difference
+    # there does not change its rounding to f16/bf16 for these inputs.
+    print(f"Testing Ops.swiglu parity precision on {args.device}")
+    for shape in testShapes:
+        for dtype_name in ["f16", "bf16"]:
+            llaisys.Ops.set_precision(llaisys.OpType.SWIGLU, llaisys_dtype(dtype_name))
+            test_op_swiglu(shape, dtype_name, 0, 0, args.device)
+    llaisys.Ops.set_precision(llaisys.OpType.SWIGLU)
+
     print("\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,264 @@
+import llaisys
+
+import torch
+from test_utils import *
+import json
+import os
+import random
+import struct
+import tempfile
+
+# ggml type id, elements per block, bytes per block
+GGML_TYPES = {
+    "F32": (0, 1, 4),
+    "F16": (1, 1, 2),
+    "Q4_0": (2, 32, 18),
+    "Q4_1": (3, 32, 20),
+    "Q5_0": (6, 32, 22),
+    "Q5_1": (7, 32, 24),
+    "Q8_0": (8, 32, 34),
+    "Q4_K": (12, 256, 144),
+    "Q5_K": (13, 256, 176),
+    "Q6_K": (14, 256, 210),
+}
+
+
+def gguf_string(s):
+    s = s.encode()
+    return struct.pack("<Q", len(s)) + s
+
+
+def gguf_value(v):
+    # Returns (type id, payload) for the metadata types this test needs
+    if isinstance(v, str):
+        return 8, gguf_string(v)
+    if isinstance(v, float):
+        return 6, struct.pack("<f", v)
+    if isinstance(v, int):
+        return 4, struct.pack("<I", v)
+    if isinstance(v, list):
+        t, _ = gguf_value(v[0])
+        return 9, struct.pack("<IQ", t, len(v)) + b"".join(gguf_value(x)[1] for x in v)
+    raise TypeError(type(v))
+
+
+def write_gguf(path, tensors, metadata, alignment=32):
+    # tensors: gguf name -> (ggml type name, shape, raw bytes)
+    out = struct.pack("<IIQQ", 0x46554747, 3, len(tensors), len(metadata))
+    for key, v in metadata.items():
+        t, payload = gguf_value(v)
+        out += gguf_string(key) + struct.pack("<I", t) + payload
+    blobs, offset = b"", 0
+    for name, (type_name, shape, data) in tensors.items():
+        # ne[0] is the innermost dimension
+        out += gguf_string(name) + struct.pack("<I", len(shape))
+        out += b"".join(struct.pack("<Q", n) for n in reversed(shape))
+        out += struct.pack("<IQ", GGML_TYPES[type_name][0], offset)
+        data += b"\0" * (-len(data) % alignment)
+        blobs += data
+        offset += len(data)
+    out += b"\0" * (-len(out) % alignment)
+    with open(path, "wb") as f:
+        f.write(out + blobs)
+
+
+def f16_at(b, o):
+    return struct.unpack("<e", b[o : o + 2])[0]
+
+
+def random_blocks(type_name, nblocks):
+    # Random quants with small, finite f16 super-scales
+    _, _, size = GGML_TYPES[type_name]
+    raw = bytearray(random.getrandbits(8) for _ in range(nblocks * size))
+    for b in range(nblocks):
+        o = b * size
+        if type_name == "Q6_K":
+            raw[o + 208 : o + 210] = struct.pack("<e", random.uniform(-0.01, 0.01))
+            continue
+        raw[o : o + 2] = struct.pack("<e", random.uniform(-0.05, 0.05))
+        if type_name in ("Q4_1", "Q5_1", "Q4_K", "Q5_K"):
+            raw[o + 2 : o + 4] = struct.pack("<e", random.uniform(-0.05, 0.05))
+    return bytes(raw)
+
+
+def scale_min_k4(j, q):
+    if j < 4:
+        return q[j] & 63, q[j + 4] & 63
+    return (q[j + 4] & 0xF) | ((q[j - 4] >> 6) << 4), (q[j + 4] >> 4) | ((q[j] >> 6) << 4)
+
+
+def dequantize_block(type_name, b):
+    # Straight transcription of ggml's dequantize_row_* for a single block
+    if type_name == "Q4_0":
+        d, qs = f16_at(b, 0), b[2:18]
+        return [((q & 15) - 8) * d for q in qs] + [((q >> 4) - 8) * d for q in qs]
+    if type_name == "Q4_1":
+        d, m, qs = f16_at(b, 0), f16_at(b, 2), b[4:20]
+        return [(q & 15) * d + m for q in qs] + [(q >> 4) * d + m for q in qs]
+    if type_name in ("Q5_0", "Q5_1"):
+        o = 2 if type_name == "Q5_0" else 4
+        d = f16_at(b, 0)
+        qh, qs = struct.unpack("<I", b[o : o + 4])[0], b[o + 4 : o + 20]
+        lo = [(qs[j] & 15) | (((qh >> j) & 1) << 4) for j in range(16)]
+        hi = [(qs[j] >> 4) | (((qh >> (j + 16)) & 1) << 4) for j in range(16)]
+        if type_name == "Q5_0":
+            return [(q - 16) * d for q in lo + hi]
+        m = f16_at(b, 2)
+        return [q * d + m for q in lo + hi]
+    if type_name == "Q8_0":
+        d = f16_at(b, 0)
+        return [q * d for q in struct.unpack("<32b", b[2:34])]
+    if type_name in ("Q4_K", "Q5_K"):
+        d, dmin, sc = f16_at(b, 0), f16_at(b, 2), b[4:16]
+        qh = b[16:48] if type_name == "Q5_K" else None
+        qs = b[48:176] if type_name == "Q5_K" else b[16:144]
+        y = []
+        for sub in range(8):
+            s, m = scale_min_k4(sub, sc)
+            chunk = qs[(sub // 2) * 32 : (sub // 2) * 32 + 32]
+            for l in range(32):
+                q = (chunk[l] & 15) if sub % 2 == 0 else (chunk[l] >> 4)
+                if qh is not None and (qh[l] >> sub) & 1:
+                    q += 16
+                y.append(d * s * q - dmin * m)
+        return y
+    if type_name == "Q6_K":
+        ql, qh, sc, d = b[0:128], b[128:192], struct.unpack("<16b", b[192:208]), f16_at(b, 208)
+        y = [0.0] * 256
+        for n in range(2):
+            L, H, S = ql[64 * n :], qh[32 * n :], sc[8 * n :]
+            for l in range(32):
+                i = l // 16
+                y[128 * n + l] = d * S[i] * (((L[l] & 15) | ((H[l] & 3) << 4)) - 32)
+                y[128 * n + l + 32] = d * S[i + 2] * (((L[l + 32] & 15) | (((H[l] >> 2) & 3) << 4)) - 32)
+                y[128 * n + l + 64] = d * S[i + 4] * (((L[l] >> 4) | (((H[l] >> 4) & 3) << 4)) - 32)
+                y[128 * n + l + 96] = d * S[i + 6] * (((L[l + 32] >> 4) | (((H[l] >> 6) & 3) << 4)) - 32)
+        return y
+    raise ValueError(type_name)
+
+
+def dequantize(type_name, raw, shape):
+    _, block, size = GGML_TYPES[type_name]
+    values = []
+    for i in range(len(raw) // size):
+        values += dequantize_block(type_name, raw[i * size : (i + 1) * size])
+    return torch.tensor(values, dtype=torch.float64).reshape(shape).float()
+
+
+QWEN2_METADATA = {
+    "general.architecture": "qwen2",
+    "general.alignment": 64,
+    "qwen2.block_count": 1,
+    "qwen2.embedding_length": 256,
+    "qwen2.attention.head_count": 4,
+    "qwen2.attention.head_count_kv": 2,
+    "qwen2.feed_forward_length": 512,
+    "qwen2.context_length": 4096,
+    "qwen2.attention.layer_norm_rms_epsilon": 1e-6,
+    "qwen2.rope.freq_base": 1000000.0,
+    "tokenizer.ggml.eos_token_id": 151643,
+    "tokenizer.ggml.tokens": ["a", "b", "c"],
+}
+
+
+def build_model(path):
+    # One layer of a Qwen2 model, every projection in a different ggml type
+    layout = {
+        "blk.0.attn_q.weight": ("Q4_0", (256, 256)),
+        "blk.0.attn_k.weight": ("Q4_1", (128, 256)),
+        "blk.0.attn_v.weight": ("Q5_0", (128, 256)),
+        "blk.0.attn_output.weight": ("Q5_1", (256, 256)),
+        "blk.0.ffn_gate.weight": ("Q8_0", (512, 256)),
+        "blk.0.ffn_up.weight": ("Q4_K", (512, 256)),
+        "blk.0.ffn_down.weight": ("Q5_K", (256, 512)),
+        "output.weight": ("Q6_K", (16, 256)),
+    }
+    tensors, answers = {}, {}
+    for name, (type_name, shape) in layout.items():
+        raw = random_blocks(type_name, shape[0] * shape[1] // GGML_TYPES[type_name][1])
+        tensors[name] = (type_name, shape, raw)
+        answers[name] = dequantize(type_name, raw, shape)
+    embed = torch.randn(16, 256, dtype=torch.float16)
+    norm = torch.randn(256)
+    tensors["token_embd.weight"] = ("F16", embed.shape, embed.view(torch.uint8).numpy().tobytes())
+    tensors["blk.0.attn_norm.weight"] = ("F32", norm.shape, norm.view(torch.uint8).numpy().tobytes())
+    answers["token_embd.weight"] = embed
+    answers["blk.0.attn_norm.weight"] = norm
+    write_gguf(path, tensors, QWEN2_METADATA, alignment=64)
+    return tensors, answers
+
+
+def test_gguf():
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "model.gguf")
+        tensors, answers = build_model(path)
+        model = llaisys.GGUFModel(path)
+
+        print("===Test names and metadata===")
+        assert "model.layers.0.self_attn.q_proj.weight" in model.keys()
+        assert "model.embed_tokens.weight" in model.keys()
+        assert "lm_head.weight" in model.keys()
+        assert model.tensor_type("blk.0.ffn_up.weight") == "Q4_K"
+        assert model.meta("general.architecture") == "qwen2"
+        assert model.meta("tokenizer.ggml.tokens.length") == "3"
+        meta = model.qwen2_meta()
+        assert meta["dtype"] == llaisys_dtype("f16")
+        assert (meta["nlayer"], meta["hs"], meta["nh"], meta["nkvh"], meta["dh"]) == (1, 256, 4, 2, 64)
+        assert (meta["di"], meta["maxseq"], meta["voc"], meta["end_token"]) == (512, 4096, 16, 151643)
+        assert meta["theta"] == 1000000.0
+
+        print("===Test dequantization===")
+        for name, (type_name, _, _) in tensors.items():
+            answer = answers[name]
+            if type_name == "F16":
+                # unquantized tensors keep their storage type
+                assert check_equal(model.get_tensor(name), answer, strict=True)
+                continue
+            assert check_equal(model.get_tensor(name), answer.float(), atol=1e-6, rtol=1e-6), type_name
+            assert check_equal(
+                model.get_tensor(name, llaisys_dtype("bf16")), answer.to(torch.bfloat16), atol=0, rtol=1e-2
+            ), type_name
+        # HuggingFace names resolve to the same tensors
+        assert check_equal(
+            model.get_tensor("model.layers.0.mlp.down_proj.weight"), answers["blk.0.ffn_down.weight"], atol=1e-6, rtol=1e-6
+        )
+
+        print("===Test Q4_0 as int4===")
+        # Q4_0 blocks are the kernel-native int4 layout: d becomes the group
+        # scale, the 16 quant bytes are copied as-is and the zero point is 8
+        raw = tensors["blk.0.attn_q.weight"][2]
+        blocks = torch.frombuffer(bytearray(raw), dtype=torch.uint8).reshape(256, 8, 18)
+        q = blocks[:, :, 2:].reshape(256, 128).contiguous()
+        scales = blocks[:, :, :2].contiguous().view(torch.float16).reshape(256, 8).float()
+        q_, scales_, zeros_ = model.get_int4("blk.0.attn_q.weight")
+        assert model.get_int4("blk.0.attn_k.weight") is None
+        assert check_equal(q_, q, strict=True)
+        assert check_equal(scales_, scales, strict=True)
+        assert check_equal(zeros_, torch.full((256, 8), 8, dtype=torch.uint8), strict=True)
+        x, x_ = random_tensor((4, 256), "f32", "cpu")
+        out, out_ = zero_tensor((4, 256), "f32", "cpu")
+        llaisys.Ops.linear_int4(out_, x_, q_, scales_, zeros_)
+        assert check_equal(out_, x @ answers["blk.0.attn_q.weight"].T, atol=1e-4, rtol=1e-4)
+
+        print("===Test pack===")
+        packed_path = os.path.join(tmp, "model.llaisys")
+        llaisys.pack(path, packed_path, llaisys_dtype("bf16"))
+        packed = llaisys.PackedModel(packed_path)
+        assert packed.meta("quantize") == "int4"
+        config = json.loads(packed.meta("config"))
+        assert config["model_type"] == "qwen2" and config["num_key_value_heads"] == 2
+        prefix = "model.layers.0."
+        assert check_equal(packed.get_tensor(prefix + "self_attn.q_proj.weight"), q, strict=True)
+        assert check_equal(packed.get_tensor(prefix + "self_attn.q_proj.weight_scale"), scales, strict=True)
+        # only projections of the same kind are fused; gate/up are both dequantized
+        fused = torch.cat([answers["blk.0.ffn_gate.weight"], answers["blk.0.ffn_up.weight"]]).to(torch.bfloat16)
+        assert check_equal(packed.get_tensor(prefix + "mlp.gate_up_proj.weight"), fused, atol=0, rtol=1e-2)
+        assert check_equal(packed.get_tensor("lm_head.weight"), answers["output.weight"].to(torch.bfloat16), atol=0, rtol=1e-2)
+
+
+if __name__ == "__main__":
+    random.seed(0)
+    torch.manual_seed(0)
+    test_gguf()
+
+    print("\n\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,233 @@
+import llaisys
+
+import torch
+from test_utils import *
+from test_safetensors import write_safetensors
+import json
+import os
+import tempfile
+
+
+def test_packed():
+    tensors = {}
+    for i in range(2):
+        prefix = f"model.layers.{i}."
+        tensors[prefix + "self_attn.q_proj.weight"] = torch.rand(16, 8)
+        tensors[prefix + "self_attn.k_proj.weight"] = torch.rand(4, 8)
+        tensors[prefix + "self_attn.v_proj.weight"] = torch.rand(4, 8)
+        tensors[prefix + "mlp.gate_proj.weight"] = torch.rand(32, 8)
+        tensors[prefix + "mlp.up_proj.weight"] = torch.rand(32, 8)
+        tensors[prefix + "mlp.down_proj.weight"] = torch.rand(8, 32)
+    tensors["model.norm.weight"] = torch.rand(8)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        write_safetensors(os.path.join(tmp, "model.safetensors"), tensors)
+        with open(os.path.join(tmp, "config.json"), "w") as f:
+            f.write('{"hidden_size": 8}')
+        path = os.path.join(tmp, "model.llaisys")
+
+        print("===Test pack===")
+        llaisys.pack(tmp, path, llaisys_dtype("bf16"))
+
+        print("===Test open===")
+        packed = llaisys.PackedModel(path)
+        assert json.loads(packed.meta("config")) == {"hidden_size": 8}
+        fusions = json.loads(packed.meta("fusions"))
+
+        print("===Test fused weights===")
+        for i in range(2):
+            prefix = f"model.layers.{i}."
+            for fused, parts in [
+                ("self_attn.qkv_proj.weight", ["q_proj", "k_proj", "v_proj"]),
+                ("mlp.gate_up_proj.weight", ["gate_proj", "up_proj"]),
+            ]:
+                group = fused.split(".")[0]
+                part_names = [f"{prefix}{group}.{p}.weight" for p in parts]
+                assert [p for p, _ in fusions[prefix + fused]] == part_names
+                t_ = packed.get_tensor(prefix + fused)
+                t = torch.cat([tensors[p] for p in part_names]).to(torch.bfloat16)
+                assert t_.shape() == t.shape
+                assert t_.dtype() == llaisys_dtype("bf16")
+                # page-aligned for mmap
+                assert t_.data_ptr() % 4096 == 0
+                assert check_equal(t_, t, atol=0, rtol=0)
+
+        print("===Test passthrough weights===")
+        for name in ["model.layers.0.mlp.down_proj.weight", "model.norm.weight"]:
+            assert check_equal(packed.get_tensor(name), tensors[name].to(torch.bfloat16), atol=0, rtol=0)
+        assert "model.layers.0.self_attn.q_proj.weight" not in packed.keys()
+
+        print("===Test int8 quantized pack===")
+        path = os.path.join(tmp, "model-int8.llaisys")
+        llaisys.pack(tmp, path, llaisys_dtype("bf16"), quantize="int8")
+        packed = llaisys.PackedModel(path)
+        assert packed.meta("quantize") == "int8"
+        for name, parts in [
+            ("model.layers.1.self_attn.qkv_proj.weight", ["q_proj", "k_proj", "v_proj"]),
+            ("model.layers.1.mlp.down_proj.weight", ["down_proj"]),
+        ]:
+            group = name.split(".")[3]
+            w = torch.cat([tensors[f"model.layers.1.{group}.{p}.weight"] for p in parts])
+            q_ = packed.get_tensor(name)
+            scale_ = packed.get_tensor(name + "_scale")
+            assert q_.dtype() == llaisys_dtype("i8")
+            scale = w.abs().amax(dim=1) / 127
+            assert check_equal(scale_, scale, atol=0, rtol=1e-6)
+            q = torch.round(w / scale[:, None]).clamp(-127, 127).to(torch.int8)
+            assert check_equal(q_, q, atol=0, rtol=0)
+        assert check_equal(packed.get_tensor("model.norm.weight"), tensors["model.norm.weight"].to(torch.bfloat16), atol=0, rtol=0)
+
+
+def pack_nibbles(values, dim, order=range(8)):
+    # Packs 8 4-bit values along dim into one int32, the k-th value of each
+    # run of 8 taken from position order[k]
+    values = values.to(torch.int64).movedim(dim, -1)
+    packed = torch.zeros(values.shape[:-1] + (values.shape[-1] // 8,), dtype=torch.int64)
+    for k, src in enumerate(order):
+        packed |= values[..., src::8] << (4 * k)
+    packed = torch.where(packed >= 2**31, packed - 2**32, packed)
+    return packed.to(torch.int32).movedim(-1, dim).contiguous()
+
+
+def test_packed_int4_import():
+    out_features, in_features, group_size = 16, 64, 32
+    q = torch.randint(0, 16, (out_features, in_features))
+    zeros = torch.randint(0, 16, (out_features, in_features // group_size))
+    scales = torch.rand(out_features, in_features // group_size, dtype=torch.float16) / 100
+    # Kernel-native layout: within each 32 columns, byte j holds column j
+    # (low nibble) and column j + 16 (high nibble)
+    blocks = q.reshape(out_features, -1, 2, 16)
+    q_native = (blocks[:, :, 0] | (blocks[:, :, 1] << 4)).reshape(out_features, -1).to(torch.uint8)
+
+    layers = {
+        # qweight [in / 8, out] packed along in; qzeros store zero - 1
+        "gptq": {
+            "qweight": pack_nibbles(q.T, 0),
+            "qzeros": pack_nibbles((zeros.T - 1) & 0xF, 1),
+        },
+        # qweight [in, out / 8] packed along out in the order 0 2 4 6 1 3 5 7
+        "awq": {
+            "qweight": pack_nibbles(q.T, 1, [0, 2, 4, 6, 1, 3, 5, 7]),
+            "qzeros": pack_nibbles(zeros.T, 1, [0, 2, 4, 6, 1, 3, 5, 7]),
+        },
+    }
+
+    for method, layer in layers.items():
+        print(f"===Test {method} import===")
+        with tempfile.TemporaryDirectory() as tmp:
+            prefix = "model.layers.0.mlp.down_proj."
+            tensors = {prefix + k: v for k, v in layer.items()}
+            tensors[prefix + "scales"] = scales.T.contiguous()
+            write_safetensors(os.path.join(tmp, "model.safetensors"), tensors)
+            config = {"quantization_config": {"quant_method": method, "bits": 4, "group_size": group_size}}
+            with open(os.path.join(tmp, "config.json"), "w") as f:
+                json.dump(config, f)
+            path = os.path.join(tmp, "model.llaisys")
+            llaisys.pack(tmp, path)
+
+            packed = llaisys.PackedModel(path)
+            assert packed.meta("quantize") == "int4"
+            assert sorted(packed.keys()) == [prefix + "weight", prefix + "weight_scale", prefix + "weight_zero"]
+            assert check_equal(packed.get_tensor(prefix + "weight"), q_native, strict=True)
+            assert check_equal(packed.get_tensor(prefix + "weight_zero"), zeros.to(torch.uint8), strict=True)
+            assert check_equal(packed.get_tensor(prefix + "weight_scale"), scales.float(), strict=True)
+
+
+def test_packed_shared():
+    embed = torch.rand(64, 8)
+    down = torch.rand(8, 32)
+    tensors = {
+        "model.embed_tokens.weight": embed,
+        "model.layers.0.mlp.down_proj.weight": down,
+        "model.layers.1.mlp.down_proj.weight": down.clone(),
+        "model.norm.weight": torch.rand(8),
+    }
+
+    with tempfile.TemporaryDirectory() as tmp:
+        write_safetensors(os.path.join(tmp, "model.safetensors"), tensors)
+        path = os.path.join(tmp, "model.llaisys")
+
+        print("===Test tied embeddings and identical tensors===")
+        shared = llaisys.pack(tmp, path, llaisys_dtype("bf16"))
+        # lm_head aliases the embedding, the second down_proj is stored once
+        assert shared == (64 * 8 + 8 * 32) * 2
+        packed = llaisys.PackedModel(path)
+        embed_, lm_head_ = packed.get_tensor("model.embed_tokens.weight"), packed.get_tensor("lm_head.weight")
+        assert lm_head_.data_ptr() == embed_.data_ptr()
+        assert check_equal(lm_head_, embed.to(torch.bfloat16), atol=0, rtol=0)
+        down0 = packed.get_tensor("model.layers.0.mlp.down_proj.weight")
+        down1 = packed.get_tensor("model.layers.1.mlp.down_proj.weight")
+        assert down1.data_ptr() == down0.data_ptr()
+        assert check_equal(down1, down.to(torch.bfloat16), atol=0, rtol=0)
+        assert packed.get_tensor("model.norm.weight").data_ptr() != lm_head_.data_ptr()
+
+
+def test_packed_memory():
+    def pack_peak(tmp, nlayer, quantize):
+        tensors = {f"model.layers.{i}.mlp.down_proj.weight": torch.rand(256, 1024) for i in range(nlayer)}
+        write_safetensors(os.path.join(tmp, "model.safetensors"), tensors)
+        llaisys.reset_peak_memory_stats()
+        before = llaisys.memory_stats()["categories"]["other"]["in_use_bytes"]
+        llaisys.pack(tmp, os.path.join(tmp, "model.llaisys"), llaisys_dtype("bf16"), quantize=quantize)
+        return llaisys.memory_stats()["categories"]["other"]["peak_bytes"] - before
+
+    print("===Test quantized pack memory===")
+    # quantized pieces are freshly allocated per weight; the writer must not
+    # keep them alive, so the peak does not grow with the number of layers
+    for quantize in ["int8", "int4"]:
+        with tempfile.TemporaryDirectory() as tmp:
+            small = pack_peak(tmp, 2, quantize)
+        with tempfile.TemporaryDirectory() as tmp:
+            large = pack_peak(tmp, 8, quantize)
+        assert large == small, (quantize, small, large)
+
+
+def test_packed_stream():
+    nlayer = 4
+    tensors = {"model.embed_tokens.weight": torch.rand(64, 8)}
+    for i in range(nlayer):
+        tensors[f"model.layers.{i}.mlp.down_proj.weight"] = torch.rand(256, 1024)
+        tensors[f"model.layers.{i}.input_layernorm.weight"] = torch.rand(256)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        write_safetensors(os.path.join(tmp, "model.safetensors"), tensors)
+        path = os.path.join(tmp, "model.llaisys")
+        llaisys.pack(tmp, path)
+        packed = llaisys.PackedModel(path)
+
+        print("===Test layer streaming===")
+        stream = packed.stream_layers(depth=1)
+        assert stream.num_layers() == nlayer
+        nsteps = 2
+        for _ in range(nsteps):
+            for i in range(nlayer):
+                with stream.layer(i):
+                    name = f"model.layers.{i}.mlp.down_proj.weight"
+                    assert check_equal(packed.get_tensor(name), tensors[name], atol=0, rtol=0)
+        stats = stream.stats()
+        print(stats)
+        layer_bytes = (256 * 1024 + 256) * 4
+        assert stats["acquires"] == nsteps * nlayer
+        assert 0 <= stats["hits"] <= stats["acquires"]
+        assert stats["nbytes_released"] == nsteps * nlayer * layer_bytes
+        # every acquire is served either by the prefetcher or on the caller
+        assert stats["nbytes_prefetched"] + stats["nbytes_loaded"] >= (nsteps * nlayer - stats["hits"]) * layer_bytes
+
+        print("===Test streaming without prefetch===")
+        stream = packed.stream_layers(depth=0)
+        for i in range(nlayer):
+            stream.acquire(i)
+            stream.release(i)
+        stats = stream.stats()
+        assert stats["hits"] == 0 and stats["nbytes_prefetched"] == 0
+        assert stats["nbytes_loaded"] == nlayer * layer_bytes
+
+
+if __name__ == "__main__":
+    test_packed()
+    test_packed_int4_import()
+    test_packed_shared()
+    test_packed_memory()
+    test_packed_stream()
+
+    print("\n\033[92mTest passed!\033[0m\n")
@@ -2,6 +2,8 @@ import llaisys
 import torch
 from test_utils import *
 import argparse
+import threading
+import time
 
 
 def test_basic_runtime_api(device_name: str = "cpu"):
@@ -18,6 +20,9 @@ def test_basic_runtime_api(device_name: str = "cpu"):
         print("Testing device {i}...")
         api.set_device(i)
         test_memcpy(api, 1024 * 1024)
+        test_stream(api, 1024 * 1024)
+        test_device_synchronize(api, device_name)
+        test_memcpy2d(api, 1000, 1024)
 
         print("     Passed")
 
@@ -53,10 +58,352 @@ def test_memcpy(api, size_bytes: int):
     torch.testing.assert_close(a, b)
 
 
+def test_stream(api, size_bytes: int):
+    a = torch.randint(0, 255, (size_bytes,), dtype=torch.uint8, device=torch_device("cpu"))
+    b = torch.zeros_like(a)
+    c = torch.zeros_like(a)
+    device_a = api.malloc_device(size_bytes)
+    stream = api.create_stream()
+    other = api.create_stream()
+    start, copied = api.create_event(), api.create_event()
+
+    # a -> device_a -> b in order on one stream
+    api.event_record(start, stream)
+    api.memcpy_async(device_a, a.data_ptr(), size_bytes, llaisys.MemcpyKind.H2D, stream)
+    api.memcpy_async(b.data_ptr(), device_a, size_bytes, llaisys.MemcpyKind.D2H, stream)
+    api.event_record(copied, stream)
+    # the second stream starts only after the copies
+    api.stream_wait_event(other, copied)
+    api.memcpy_async(c.data_ptr(), device_a, size_bytes, llaisys.MemcpyKind.D2H, other)
+    order = []
+    api.launch_host_func(other, lambda: order.append(api.event_query(copied)))
+    api.stream_synchronize(other)
+    assert order == [True]
+    assert api.event_query(copied)
+    assert api.event_elapsed_time(start, copied) >= 0
+    assert api.event_elapsed_time(copied, copied) == 0
+    torch.testing.assert_close(a, b)
+    torch.testing.assert_close(a, c)
+
+    api.destroy_event(start)
+    api.destroy_event(copied)
+    api.destroy_stream(stream)
+    api.destroy_stream(other)
+    api.free_device(device_a)
+
+
+def test_device_synchronize(api, device_name: str = "cpu"):
+    # a host func that first uses the runtime on its worker thread (creating the
+    # worker's own stream) and synchronizes the device must not deadlock with a
+    # device synchronize issued meanwhile from another thread
+    stream = api.create_stream()
+    created = []
+
+    def host_func():
+        time.sleep(0.1)
+        # the tensor belongs to the worker's own context, so it must not outlive the stream
+        tensor = llaisys.Tensor((16,), device=llaisys_device(device_name))
+        api.device_synchronize()
+        created.append(tensor.shape())
+        del tensor
+
+    api.launch_host_func(stream, host_func)
+    syncer = threading.Thread(target=api.device_synchronize)
+    syncer.start()
+    syncer.join(timeout=10)
+    assert not syncer.is_alive(), "device synchronize deadlocked"
+    api.stream_synchronize(stream)
+    assert len(created) == 1
+    api.destroy_stream(stream)
+
+
+def test_memcpy2d(api, height: int, width: int):
+    # rows of a padded source go to a device buffer with a different pitch
+    spitch, dpitch = width + 24, width + 64
+    a = torch.randint(0, 255, (height, spitch), dtype=torch.uint8, device=torch_device("cpu"))
+    b = torch.zeros((height, width), dtype=torch.uint8, device=torch_device("cpu"))
+    device_a = api.malloc_device(height * dpitch)
+    api.memset_sync(device_a, 0, height * dpitch)
+
+    api.memcpy2d_sync(device_a, dpitch, a.data_ptr(), spitch, width, height, llaisys.MemcpyKind.H2D)
+    stream = api.create_stream()
+    api.memcpy2d_async(b.data_ptr(), width, device_a, dpitch, width, height, llaisys.MemcpyKind.D2H, stream)
+    api.stream_synchronize(stream)
+    torch.testing.assert_close(a[:, :width], b)
+
+    # the padding between device rows is untouched
+    padding = torch.ones((height, dpitch - width), dtype=torch.uint8, device=torch_device("cpu"))
+    api.memcpy2d_sync(
+        padding.data_ptr(), dpitch - width, device_a + width, dpitch, dpitch - width, height, llaisys.MemcpyKind.D2H
+    )
+    assert padding.eq(0).all()
+
+    api.destroy_stream(stream)
+    api.free_device(device_a)
+
+
+def test_allocator(device_name: str = "cpu"):
+    # allocator functions act on the runtime tensors were last created on
+    llaisys.Tensor((1,), device=llaisys_device(device_name))
+    assert llaisys.get_allocator() == llaisys.AllocatorType.CACHING
+
+    print("Testing caching allocator...")
+    llaisys.trim_allocator()
+    before = llaisys.allocator_stats()
+    tensors = [zero_tensor((n,), "f32", device_name) for n in [1, 100, 4096, 300_000, 1_000_000]]
+    stats = llaisys.allocator_stats()
+    assert stats["num_allocs"] - before["num_allocs"] == len(tensors)
+    assert stats["allocated_bytes"] >= 4 * (1 + 100 + 4096 + 300_000 + 1_000_000)
+    assert stats["reserved_bytes"] >= stats["allocated_bytes"]
+    for t, t_ in tensors:
+        assert check_equal(t_, t)
+    del tensors, t, t_
+
+    # Same-shaped temporaries reuse cached blocks: no device allocation
+    # once the first round has populated the cache
+    def step():
+        return [llaisys.Tensor((64, 512), device=llaisys_device(device_name)) for _ in range(4)]
+
+    step()
+    device_allocs = llaisys.allocator_stats()["num_device_allocs"]
+    for _ in range(10):
+        step()
+    assert llaisys.allocator_stats()["num_device_allocs"] == device_allocs
+
+    llaisys.trim_allocator()
+    stats = llaisys.allocator_stats()
+    assert stats["allocated_bytes"] == 0 and stats["reserved_bytes"] == 0
+    assert stats["num_device_allocs"] == stats["num_device_frees"]
+
+    print("Testing allocator switch...")
+    kept, kept_ = zero_tensor((1024,), "f32", device_name)
+    llaisys.set_allocator(llaisys.AllocatorType.NAIVE)
+    t, t_ = zero_tensor((1024,), "f32", device_name)
+    assert llaisys.allocator_stats()["num_device_allocs"] == 1
+    # allocated by the caching allocator, released through it
+    del kept_
+    assert check_equal(t_, t)
+    llaisys.set_allocator(llaisys.AllocatorType.CACHING)
+    print("     Passed")
+
+
+def check_arena_plan(lifetimes, offsets, total, alignment=64):
+    # buffers whose step ranges overlap must not share any bytes
+    for i, (size_i, first_i, last_i) in enumerate(lifetimes):
+        assert offsets[i] % alignment == 0 and offsets[i] + size_i <= total
+        for j, (size_j, first_j, last_j) in enumerate(lifetimes[:i]):
+            if first_i <= last_j and first_j <= last_i:
+                assert offsets[i] + size_i <= offsets[j] or offsets[j] + size_j <= offsets[i], (i, j)
+
+
+def test_arena(device_name: str = "cpu"):
+    llaisys.Tensor((1,), device=llaisys_device(device_name))
+
+    print("Testing arena planner...")
+    # (size, first, last): a chain where each buffer only overlaps its neighbours
+    lifetimes = [(1000, 0, 1), (2000, 1, 2), (1000, 2, 3), (3000, 3, 4), (500, 0, 4)]
+    offsets, total = llaisys.plan_arena(lifetimes, 64)
+    assert total < sum(size for size, _, _ in lifetimes)
+    check_arena_plan(lifetimes, offsets, total)
+
+    print("Testing arena tensors...")
+    llaisys.arena_reset()
+    llaisys.arena_reserve(total)
+    tensors = [llaisys.arena_tensor((size // 4,), llaisys.DataType.F32, off) for (size, _, _), off in zip(lifetimes, offsets)]
+    base = tensors[0].data_ptr() - offsets[0]
+    for t, off in zip(tensors, offsets):
+        assert t.data_ptr() == base + off
+    del tensors
+
+    # Steps of the same shape run entirely in the slab of the first step
+    def step():
+        llaisys.arena_reset()
+        x = llaisys.arena_tensor((64, 512))
+        ys = [llaisys.arena_tensor((64, 2048)) for _ in range(3)]
+        return x, ys
+
+    step()
+    # the first reset after a step that outgrew the slab sizes it to the peak
+    llaisys.arena_reset()
+    device_allocs = llaisys.allocator_stats()["num_device_allocs"]
+    capacity = llaisys.arena_stats()["capacity"]
+    for _ in range(10):
+        x, ys = step()
+        assert x.data_ptr() % 64 == 0
+    stats = llaisys.arena_stats()
+    assert stats["capacity"] == capacity
+    assert stats["used"] >= 4 * 64 * (512 + 3 * 2048) and stats["peak"] >= stats["used"]
+    assert llaisys.allocator_stats()["num_device_allocs"] == device_allocs
+    print("     Passed")
+
+
+def test_activation_plan():
+    from llaisys.models.qwen2 import activation_lifetimes, plan_activations
+
+    print("Testing Qwen2 activation plan...")
+    metas = [
+        # Qwen2-1.5B
+        {"hs": 1536, "nh": 12, "nkvh": 2, "dh": 128, "di": 8960, "voc": 151936, "dtype": llaisys.DataType.BF16},
+        # small model, where the vocabulary dominates
+        {"hs": 64, "nh": 4, "nkvh": 2, "dh": 16, "di": 128, "voc": 5000, "dtype": llaisys.DataType.F32},
+    ]
+    for meta in metas:
+        for ntoken in [1, 7, 512]:
+            plan, total = plan_activations(meta, ntoken)
+            esize = 4 if meta["dtype"] == llaisys.DataType.F32 else 2
+            lifetimes, offsets = [], []
+            for name, (shape, first, last) in activation_lifetimes(meta, ntoken).items():
+                size = esize
+                for d in shape:
+                    size *= d
+                lifetimes.append((size, first, last))
+                offsets.append(plan[name][1])
+            check_arena_plan(lifetimes, offsets, total)
+    print("     Passed")
+
+
+def test_host_memory():
+    print("Testing host memory options...")
+    options = llaisys.host_memory_options()
+    assert options["huge_pages"] == llaisys.HugePages.TRANSPARENT
+    assert options["numa_policy"] == llaisys.NumaPolicy.DEFAULT
+    assert llaisys.numa_node_count() >= 1
+
+    llaisys.Tensor((1,), device=llaisys.DeviceType.CPU)
+    llaisys.set_allocator(llaisys.AllocatorType.NAIVE)
+    huge = 2 << 20
+    # large allocations start on a huge page boundary
+    t, t_ = random_tensor((3 << 20,), "f32", "cpu")
+    assert t_.data_ptr() % huge == 0
+    assert check_equal(t_, t)
+
+    policies = [llaisys.NumaPolicy.INTERLEAVE, llaisys.NumaPolicy.BLOCKED, llaisys.NumaPolicy.NODE]
+    for huge_pages in [llaisys.HugePages.NONE, llaisys.HugePages.EXPLICIT]:
+        for numa_policy in policies:
+            llaisys.set_host_memory_options(huge_pages=huge_pages, numa_policy=numa_policy, numa_node=0)
+            llaisys.bind_threads()
+            t, t_ = random_tensor((1 << 20,), "f32", "cpu")
+            assert check_equal(t_, t)
+            # small allocations are not affected
+            t, t_ = random_tensor((100,), "f32", "cpu")
+            assert check_equal(t_, t)
+
+    llaisys.set_host_memory_options(**options)
+    llaisys.set_allocator(llaisys.AllocatorType.CACHING)
+    print("     Passed")
+
+
+def test_workspace():
+    print("Testing CPU kernel workspace...")
+    llaisys.release_cpu_workspace()
+    assert llaisys.cpu_workspace_size() == 0
+
+    def attention(kvlen):
+        q, q_ = random_tensor((4, 8, 64), "f32", "cpu")
+        k, k_ = random_tensor((kvlen, 2, 64), "f32", "cpu")
+        v, v_ = random_tensor((kvlen, 2, 64), "f32", "cpu")
+        out, out_ = zero_tensor((4, 8, 64), "f32", "cpu")
+        llaisys.Ops.self_attention(out_, q_, k_, v_, 0.125)
+        return out_
+
+    # scratch grows to the longest sequence and is then reused
+    attention(512)
+    size = llaisys.cpu_workspace_size()
+    assert size > 0
+    for kvlen in [16, 128, 511, 512]:
+        attention(kvlen)
+        assert llaisys.cpu_workspace_size() == size
+    print("     Passed")
+
+
+def test_memory_stats(device_name: str = "cpu"):
+    print("Testing memory accounting...")
+    device = llaisys_device(device_name)
+    llaisys.Tensor((1,), device=device)
+    assert llaisys.get_memory_category() == llaisys.MemoryCategory.OTHER
+
+    def in_use(category):
+        return llaisys.memory_stats()["categories"][category]["in_use_bytes"]
+
+    before = llaisys.memory_stats()
+    with llaisys.memory_category(llaisys.MemoryCategory.KV_CACHE):
+        cache = llaisys.Tensor((2, 16, 64), dtype=llaisys_dtype("f32"), device=device)
+    assert llaisys.get_memory_category() == llaisys.MemoryCategory.OTHER
+    weights = []
+    with llaisys.memory_category(llaisys.MemoryCategory.WEIGHTS):
+        weights.append(llaisys.Tensor((256, 64), dtype=llaisys_dtype("f32"), device=device))
+    temp = llaisys.Tensor((1000,), dtype=llaisys_dtype("f32"), device=device)
+
+    stats = llaisys.memory_stats()
+    assert in_use("kv_cache") - before["categories"]["kv_cache"]["in_use_bytes"] == 2 * 16 * 64 * 4
+    assert in_use("weights") - before["categories"]["weights"]["in_use_bytes"] == 256 * 64 * 4
+    assert stats["categories"]["other"]["num_allocs"] > before["categories"]["other"]["num_allocs"]
+    assert stats["in_use_bytes"] == sum(c["in_use_bytes"] for c in stats["categories"].values())
+
+    # releasing a tensor leaves its peak, reset_peak brings the peak back down
+    del temp
+    stats = llaisys.memory_stats()
+    assert stats["peak_bytes"] >= stats["in_use_bytes"] + 4000
+    assert stats["reserved_bytes"] >= stats["cached_bytes"]
+    llaisys.reset_peak_memory_stats()
+    stats = llaisys.memory_stats()
+    assert stats["peak_bytes"] == stats["in_use_bytes"]
+    assert stats["categories"]["other"]["peak_bytes"] == stats["categories"]["other"]["in_use_bytes"]
+    del cache
+    assert in_use("kv_cache") == before["categories"]["kv_cache"]["in_use_bytes"]
+    print("     Passed")
+
+
+def test_shared_runtime(device_name: str = "cpu", num_threads: int = 4):
+    print("Testing shared runtime...")
+    device = llaisys_device(device_name)
+    assert not llaisys.runtime_sharing()
+    llaisys.set_runtime_sharing(True)
+    try:
+        size = 64 * 1024
+        barrier = threading.Barrier(num_threads)
+        results = [None] * num_threads
+        errors = []
+
+        def worker(i):
+            try:
+                # each thread keeps its own memory category
+                with llaisys.memory_category(llaisys.MemoryCategory.KV_CACHE):
+                    cache = llaisys.Tensor((size // 4,), dtype=llaisys_dtype("f32"), device=device)
+                    barrier.wait()
+                    results[i] = llaisys.memory_stats()["categories"]["kv_cache"]["in_use_bytes"]
+                    barrier.wait()
+                assert llaisys.get_memory_category() == llaisys.MemoryCategory.OTHER
+                del cache
+            except Exception as e:
+                errors.append(e)
+                barrier.abort()
+
+        threads = [threading.Thread(target=worker, args=(i,)) for i in range(num_threads)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        assert not errors, errors
+        # every thread sees the allocations of all threads in one pool
+        assert all(r >= num_threads * size for r in results), results
+    finally:
+        llaisys.set_runtime_sharing(False)
+    print("     Passed")
+
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser()
     parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
     args = parser.parse_args()
     test_basic_runtime_api(args.device)
+    test_allocator(args.device)
+    test_arena(args.device)
+    test_activation_plan()
+    test_memory_stats(args.device)
+    test_shared_runtime(args.device)
+    if args.device == "cpu":
+        test_host_memory()
+        test_workspace()
     
     print("\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,130 @@
+import llaisys
+
+import torch
+from test_utils import *
+import json
+import os
+import struct
+import tempfile
+
+
+def write_safetensors(path, tensors, metadata=None):
+    header = {}
+    blobs = []
+    offset = 0
+    for name, t in tensors.items():
+        data = t.contiguous().view(torch.uint8).numpy().tobytes()
+        header[name] = {
+            "dtype": {"f32": "F32", "f16": "F16", "bf16": "BF16", "i32": "I32", "i64": "I64"}[dtype_name_of(t)],
+            "shape": list(t.shape),
+            "data_offsets": [offset, offset + len(data)],
+        }
+        blobs.append(data)
+        offset += len(data)
+    if metadata is not None:
+        header["__metadata__"] = metadata
+    header_bytes = json.dumps(header).encode()
+    header_bytes += b" " * (-len(header_bytes) % 8)
+    with open(path, "wb") as f:
+        f.write(struct.pack("<Q", len(header_bytes)))
+        f.write(header_bytes)
+        for data in blobs:
+            f.write(data)
+
+
+def dtype_name_of(t):
+    return {
+        torch.float32: "f32",
+        torch.float16: "f16",
+        torch.bfloat16: "bf16",
+        torch.int32: "i32",
+        torch.int64: "i64",
+    }[t.dtype]
+
+
+def test_safetensors():
+    tensors = {
+        "model.embed_tokens.weight": torch.rand(16, 8, dtype=torch.bfloat16),
+        "model.norm.weight": torch.rand(8, dtype=torch.float32),
+        "lm_head.weight": torch.rand(16, 8, dtype=torch.float16),
+        "position_ids": torch.arange(12, dtype=torch.int64).reshape(3, 4),
+    }
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "model.safetensors")
+        write_safetensors(path, tensors, {"format": "pt"})
+
+        print("===Test open===")
+        st = llaisys.SafeTensors(path)
+        assert st.keys() == list(tensors.keys())
+
+        print("===Test tensors===")
+        loaded = {}
+        for name, t in tensors.items():
+            t_ = st.get_tensor(name)
+            assert t_.shape() == t.shape
+            assert t_.strides() == t.stride()
+            assert t_.dtype() == llaisys_dtype(dtype_name_of(t))
+            assert t_.device_type() == llaisys.DeviceType.CPU
+            assert check_equal(t_, t)
+            loaded[name] = t_
+
+        print("===Test load_all with conversion===")
+        converted, stats = st.load_all(llaisys_dtype("f32"))
+        print(stats)
+        assert stats["ntensors"] == len(tensors)
+        for name, t in tensors.items():
+            t_ = converted[name]
+            if t.is_floating_point():
+                assert t_.dtype() == llaisys_dtype("f32")
+                assert check_equal(t_, t.float(), atol=0, rtol=0)
+            else:
+                assert t_.dtype() == llaisys_dtype(dtype_name_of(t))
+                assert check_equal(t_, t)
+
+        print("===Test load_all shares identical tensors===")
+        tied = {"model.embed_tokens.weight": tensors["model.embed_tokens.weight"]}
+        tied["lm_head.weight"] = tied["model.embed_tokens.weight"].clone()
+        tied_path = os.path.join(tmp, "tied.safetensors")
+        write_safetensors(tied_path, tied)
+        with llaisys.SafeTensors(tied_path) as tied_st:
+            for dtype in [None, llaisys_dtype("f32")]:
+                shared, stats = tied_st.load_all(dtype)
+                embed_, lm_head_ = shared["model.embed_tokens.weight"], shared["lm_head.weight"]
+                assert lm_head_.data_ptr() == embed_.data_ptr()
+                assert stats["nbytes_shared"] == 16 * 8 * 2
+                assert check_equal(lm_head_, tied["lm_head.weight"].to(torch_dtype(dtype_name(embed_.dtype()))))
+
+        print("===Test lifetime===")
+        # tensors keep the mapping alive after the file handle is closed
+        st.close()
+        for name, t in tensors.items():
+            assert check_equal(loaded[name], t)
+
+        print("===Test overflowing header===")
+        # shapes whose integers or element count wrap around size_t must be
+        # rejected, not matched against a small data range
+        for shape, nbytes in [([2**32, 2**32], 0), ([2**64 + 1], 4), ([2**62], 0)]:
+            header = json.dumps({"x": {"dtype": "F32", "shape": shape, "data_offsets": [0, nbytes]}}).encode()
+            header += b" " * (-len(header) % 8)
+            bad_path = os.path.join(tmp, "bad.safetensors")
+            with open(bad_path, "wb") as f:
+                f.write(struct.pack("<Q", len(header)) + header + b"\0" * nbytes)
+            try:
+                llaisys.SafeTensors(bad_path)
+                assert False, shape
+            except RuntimeError:
+                pass
+
+        print("===Test missing===")
+        try:
+            llaisys.SafeTensors(os.path.join(tmp, "missing.safetensors"))
+            assert False
+        except RuntimeError:
+            pass
+
+
+if __name__ == "__main__":
+    test_safetensors()
+
+    print("\n\033[92mTest passed!\033[0m\n")
@@ -48,6 +48,43 @@ def test_tensor():
     assert llaisys_tensor.is_contiguous() == torch_tensor.is_contiguous()
     assert check_equal(llaisys_tensor_slice, torch_tensor_slice)
 
+    # Test reshape
+    print("===Test reshape===")
+    torch_tensor_reshape = torch_tensor.permute(2, 0, 1).reshape(5, 12)
+    llaisys_tensor_reshape = llaisys_tensor.permute(2, 0, 1).reshape(5, 12)
+    llaisys_tensor_reshape.debug()
+    assert llaisys_tensor_reshape.shape() == torch_tensor_reshape.shape
+    assert llaisys_tensor_reshape.strides() == torch_tensor_reshape.stride()
+    assert check_equal(llaisys_tensor_reshape, torch_tensor_reshape)
+
+    # Test alignment
+    print("===Test alignment===")
+    # storage starts on a 64-byte boundary, but 40-byte rows do not
+    assert llaisys_tensor.view(60).is_aligned(64)
+    assert not llaisys_tensor.is_aligned(64)
+    assert not llaisys_tensor_slice.is_aligned(64)
+    torch_tensor_f = torch.rand((5, 7, 9), dtype=torch_dtype("f32"))
+    llaisys_tensor_padded = llaisys.Tensor(
+        (5, 7, 9), dtype=llaisys_dtype("f32"), device=llaisys_device("cpu"), row_alignment=64
+    )
+    assert llaisys_tensor_padded.strides() == (7 * 16, 16, 1)
+    assert llaisys_tensor_padded.is_aligned(64) and not llaisys_tensor_padded.is_contiguous()
+    # load takes densely packed data and writes it row by row
+    llaisys_tensor_padded.load(torch_tensor_f.data_ptr())
+    assert check_equal(llaisys_tensor_padded, torch_tensor_f)
+    assert check_equal(llaisys_tensor_padded.contiguous(), torch_tensor_f)
+
+    # Test shapes beyond the inline capacity
+    print("===Test high rank===")
+    torch_tensor_hr = torch_tensor.view(1, 3, 1, 4, 1, 5, 1, 1, 1, 1)
+    llaisys_tensor_hr = llaisys_tensor.view(1, 3, 1, 4, 1, 5, 1, 1, 1, 1)
+    assert llaisys_tensor_hr.shape() == torch_tensor_hr.shape
+    assert llaisys_tensor_hr.strides() == torch_tensor_hr.stride()
+    torch_tensor_hr = torch_tensor_hr.permute(9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+    llaisys_tensor_hr = llaisys_tensor_hr.permute(9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+    assert llaisys_tensor_hr.strides() == torch_tensor_hr.stride()
+    assert check_equal(llaisys_tensor_hr.contiguous(), torch_tensor_hr)
+
 
 if __name__ == "__main__":
     test_tensor()
@@ -95,6 +95,25 @@ target("llaisys-ops")
     on_install(function (target) end)
 target_end()
 
+target("llaisys-loader")
+    set_kind("static")
+    add_deps("llaisys-tensor")
+    add_deps("llaisys-ops")
+
+    set_languages("cxx17")
+    set_warnings("all", "error")
+    if not is_plat("windows") then
+        add_cxflags("-fPIC", "-Wno-unknown-pragmas")
+        add_cxflags("-fopenmp")
+    else
+        add_cxflags("/openmp")
+    end
+
+    add_files("src/loader/*.cpp")
+
+    on_install(function (target) end)
+target_end()
+
 target("llaisys")
     set_kind("shared")
     add_deps("llaisys-utils")
@@ -102,6 +121,7 @@ target("llaisys")
     add_deps("llaisys-core")
     add_deps("llaisys-tensor")
     add_deps("llaisys-ops")
+    add_deps("llaisys-loader")
 
     set_languages("cxx17")
     set_warnings("all", "error")
@@ -4,6 +4,11 @@ target("llaisys-device-cpu")
     set_warnings("all", "error")
     if not is_plat("windows") then
         add_cxflags("-fPIC", "-Wno-unknown-pragmas")
+        add_cxflags("-fopenmp")
+        add_ldflags("-fopenmp", {public = true})
+        add_shflags("-fopenmp", {public = true})
+    else
+        add_cxflags("/openmp")
     end
 
     add_files("../src/device/cpu/*.cpp")
@@ -18,6 +23,13 @@ target("llaisys-ops-cpu")
     set_warnings("all", "error")
     if not is_plat("windows") then
         add_cxflags("-fPIC", "-Wno-unknown-pragmas")
+        add_cxflags("-fopenmp")
+        add_cxflags("-march=native")
+        add_ldflags("-fopenmp", {public = true})
+        add_shflags("-fopenmp", {public = true})
+    else
+        add_cxflags("/openmp")
+        add_cxflags("/arch:AVX2")
     end
 
     add_files("../src/ops/*/cpu/*.cpp")